@@ -2,6 +2,7 @@
 
 #include "aio_service.h"
 
+#include <algorithm>
 #include <atomic>
 #include <iostream>
 #include <memory>
@@ -9,6 +10,7 @@
 
 #include <QtCore/QThread>
 
+#include <nx/network/nx_network_ini.h>
 #include <nx/utils/log/log.h>
 #include <nx/utils/random.h>
 #include <nx/utils/std/cpp14.h>
@@ -154,19 +156,51 @@ void AIOService::initializeAioThreadPool(unsigned int threadCount)
 
 AbstractAioThread* AIOService::findLeastUsedAioThread() const
 {
-    aio::AioThread* threadToUse = nullptr;
+    if (!ini().aioThreadLoadAwarePlacement)
+    {
+        aio::AioThread* threadToUse = nullptr;
+        for (const auto& thread: m_aioThreadPool)
+        {
+            if (threadToUse && threadToUse->socketsHandled() < thread->socketsHandled())
+                continue;
+            threadToUse = thread.get();
+        }
+        return threadToUse;
+    }
 
-    for (auto
-        threadIter = m_aioThreadPool.cbegin();
-        threadIter != m_aioThreadPool.cend();
-        ++threadIter)
+    const auto threadStatistics = statistics();
+    if (threadStatistics.empty())
+        return nullptr;
+
+    const auto minLoadPercent = std::min_element(
+        threadStatistics.begin(), threadStatistics.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.loadPercent < rhs.loadPercent; }
+    )->loadPercent;
+
+    std::optional<std::size_t> threadToUse;
+    for (std::size_t i = 0; i < threadStatistics.size(); ++i)
     {
-        if (threadToUse && threadToUse->socketsHandled() < (*threadIter)->socketsHandled())
+        if (threadStatistics[i].loadPercent >= minLoadPercent + kLoadTolerancePercent)
+            continue;
+
+        if (threadToUse
+            && threadStatistics[*threadToUse].socketCount < threadStatistics[i].socketCount)
+        {
             continue;
-        threadToUse = threadIter->get();
+        }
+        threadToUse = i;
     }
 
-    return threadToUse;
+    return m_aioThreadPool[*threadToUse].get();
+}
+
+std::vector<AioThreadStatistics> AIOService::statistics() const
+{
+    std::vector<AioThreadStatistics> result;
+    result.reserve(m_aioThreadPool.size());
+    for (const auto& thread: m_aioThreadPool)
+        result.push_back(thread->statistics());
+    return result;
 }
 
 } // namespace nx::network::aio
@@ -5,6 +5,7 @@
 #include <atomic>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include <nx/utils/move_only_func.h>
 
@@ -108,8 +109,20 @@ public:
     std::vector<AbstractAioThread*> getAllAioThreads() const;
     bool isInAnyAioThread() const;
 
+    /**
+     * Selects a thread for a new socket.
+     * Threads whose load (see AioThreadStatistics::loadPercent) exceeds the lowest one by less
+     * than AIOService::kLoadTolerancePercent are considered equally loaded. Of them, the thread
+     * handling the fewest sockets is selected.
+     * The load is considered only if load-aware placement is enabled with nx_network.ini.
+     * Otherwise, the thread handling the fewest sockets is selected.
+     */
     AbstractAioThread* findLeastUsedAioThread() const;
 
+    std::vector<AioThreadStatistics> statistics() const;
+
+    static constexpr int kLoadTolerancePercent = 10;
+
 private:
     void initializeAioThreadPool(unsigned int threadCount);
 
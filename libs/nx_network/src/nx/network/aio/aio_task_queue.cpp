@@ -2,6 +2,11 @@
 
 #include "aio_task_queue.h"
 
+#include <array>
+#include <limits>
+
+#include <concurrentqueue.h>
+
 #include <nx/utils/log/log.h>
 #include <nx/utils/scope_guard.h>
 #include <nx/utils/std/algorithm.h>
@@ -12,9 +17,21 @@ namespace nx::network::aio::detail {
 
 static constexpr int kAbnormalProcessTimeFactor = 1000;
 static constexpr auto kAbnormalProcessTimeDetectionPeriod = std::chrono::seconds(20);
+static constexpr std::size_t kPostedCallQueueInitialCapacity = 1024;
+static constexpr std::size_t kPostedCallDequeueBulkSize = 32;
+
+class AioTaskQueue::PostedCallQueue:
+    public moodycamel::ConcurrentQueue<std::optional<SocketAddRemoveTask>>
+{
+    using base_type = moodycamel::ConcurrentQueue<std::optional<SocketAddRemoveTask>>;
+
+public:
+    using base_type::base_type;
+};
 
 AioTaskQueue::AioTaskQueue(AbstractPollSet* pollSet):
     m_pollSet(pollSet),
+    m_postedCallQueue(std::make_unique<PostedCallQueue>(kPostedCallQueueInitialCapacity)),
     m_abnormalProcessingTimeDetector(
         kAbnormalProcessTimeFactor,
         kAbnormalProcessTimeDetectionPeriod,
@@ -25,12 +42,35 @@ AioTaskQueue::AioTaskQueue(AbstractPollSet* pollSet):
 {
 }
 
+AioTaskQueue::~AioTaskQueue() = default;
+
 void AioTaskQueue::addTask(SocketAddRemoveTask task)
 {
+    if (task.type == TaskType::tCallFunc)
+    {
+        addPostedCall(std::move(task));
+        return;
+    }
+
+    if (task.type == TaskType::tCancelPostedCalls)
+        task.postedCallSequence = m_prevPostedCallSequence.load();
+
     NX_MUTEX_LOCKER lock(&m_mutex);
     addTask(lock, std::move(task));
 }
 
+bool AioTaskQueue::addPostedCall(SocketAddRemoveTask task)
+{
+    NX_ASSERT(task.type == TaskType::tCallFunc && task.postHandler);
+
+    task.postedCallSequence = ++m_prevPostedCallSequence;
+    m_postedCallQueue->enqueue(std::move(task));
+
+    // The counter is incremented after the call is in the queue, so the AIO thread either sees
+    // a non-zero value before going to poll or is woken up by the caller.
+    return m_queuedPostedCallCount.fetch_add(1) == 0;
+}
+
 bool AioTaskQueue::taskExists(
     Pollable* const socket,
     aio::EventType eventType,
@@ -112,25 +152,31 @@ qint64 AioTaskQueue::nextPeriodicEventClock() const
 {
     NX_MUTEX_LOCKER lock(&m_mutex);
 
-    return m_periodicTasksByClock.empty()
-        ? 0
-        : m_periodicTasksByClock.cbegin()->first;
+    return m_periodicTasks.nextClock();
 }
 
 std::size_t AioTaskQueue::periodicTasksCount() const
 {
     NX_MUTEX_LOCKER lock(&m_mutex);
 
-    return m_periodicTasksByClock.size();
+    return m_periodicTasks.size();
+}
+
+TimerWheel<PeriodicTaskData>::Statistics AioTaskQueue::periodicTaskStatistics() const
+{
+    NX_MUTEX_LOCKER lock(&m_mutex);
+
+    return m_periodicTasks.statistics();
 }
 
 void AioTaskQueue::clear()
 {
     NX_MUTEX_LOCKER lock(&m_mutex);
 
+    takeQueuedPostedCalls(lock);
     auto postedCalls = std::exchange(m_postedCalls, {});
     auto pollSetModificationQueue = std::exchange(m_pollSetModificationQueue, {});
-    auto periodicTasksByClock = std::exchange(m_periodicTasksByClock, {});
+    auto periodicTasks = std::exchange(m_periodicTasks, {});
 
     lock.unlock();
 
@@ -142,8 +188,9 @@ bool AioTaskQueue::empty() const
     NX_MUTEX_LOCKER lock(&m_mutex);
 
     return m_postedCalls.empty()
+        && m_queuedPostedCallCount == 0
         && m_pollSetModificationQueue.empty()
-        && m_periodicTasksByClock.empty();
+        && m_periodicTasks.empty();
 }
 
 void AioTaskQueue::processPollSetModificationQueue(TaskType taskFilter)
@@ -154,6 +201,8 @@ void AioTaskQueue::processPollSetModificationQueue(TaskType taskFilter)
 
     NX_MUTEX_LOCKER lock(&m_mutex);
 
+    takeQueuedPostedCalls(lock);
+
     for (typename std::deque<SocketAddRemoveTask>::iterator
         it = m_pollSetModificationQueue.begin();
         it != m_pollSetModificationQueue.end();
@@ -182,10 +231,6 @@ void AioTaskQueue::processPollSetModificationQueue(TaskType taskFilter)
                 processRemoveTask(lock, task);
                 break;
 
-            case TaskType::tCallFunc:
-                processCallFuncTask(lock, task);
-                break;
-
             case TaskType::tCancelPostedCalls:
                 elementsToRemove = processCancelPostedCallTask(lock, task);
                 break;
@@ -360,7 +405,7 @@ void AioTaskQueue::processPostedCalls()
         m_postedCalls.erase(m_postedCalls.begin());
 
         // NOTE: User handler may cancel some calls, so m_postedCalls may change.
-        // But, new calls cannot be added there (they are added via m_pollSetModificationQueue).
+        // But, new calls cannot be added there (they are added via m_postedCallQueue).
 
         nx::Unlocker<nx::Mutex> unlock(&lock);
 
@@ -387,14 +432,27 @@ std::vector<SocketAddRemoveTask> AioTaskQueue::cancelPostedCalls(
 {
     NX_MUTEX_LOCKER lock(&m_mutex);
 
-    return cancelPostedCalls(lock, socketSequence);
+    // Called within the AIO thread, so every call of the socket has been posted before.
+    takeQueuedPostedCalls(lock);
+    return cancelPostedCalls(
+        lock, socketSequence, std::numeric_limits<std::uint64_t>::max());
 }
 
 std::size_t AioTaskQueue::postedCallCount() const
 {
     NX_MUTEX_LOCKER lock(&m_mutex);
 
-    return m_postedCalls.size();
+    return m_postedCalls.size() + m_queuedPostedCallCount.load();
+}
+
+std::uint64_t AioTaskQueue::handlerCallCount() const
+{
+    return m_handlerCallCount.load(std::memory_order_relaxed);
+}
+
+std::chrono::microseconds AioTaskQueue::handlerCallTime() const
+{
+    return std::chrono::microseconds(m_handlerCallTimeUsec.load(std::memory_order_relaxed));
 }
 
 qint64 AioTaskQueue::getMonotonicTime()
@@ -545,12 +603,7 @@ void AioTaskQueue::processChangeTimeoutTask(
             }
             else
             {
-                replacePeriodicTask(
-                    lock,
-                    handlingData,
-                    newClock,
-                    task.socket,
-                    task.eventType);
+                replacePeriodicTask(lock, handlingData, newClock);
             }
         }
         else
@@ -578,24 +631,11 @@ void AioTaskQueue::processRemoveTask(
     removeSocketFromPollSet(lock, task.socket, task.eventType);
 }
 
-void AioTaskQueue::processCallFuncTask(
-    const nx::Locker<nx::Mutex>& /*lock*/,
-    SocketAddRemoveTask& task)
-{
-    NX_ASSERT(task.postHandler);
-    NX_ASSERT(!task.taskCompletionEvent && !task.taskCompletionHandler);
-    m_postedCalls.push_back(std::move(task));
-
-    // This task differs from every else in a way that it is not processed here,
-    // just moved to another container.
-    // TODO #akolesnikov Is it really needed to move to another container?
-}
-
 std::vector<SocketAddRemoveTask> AioTaskQueue::processCancelPostedCallTask(
     const nx::Locker<nx::Mutex>& lock,
     SocketAddRemoveTask& task)
 {
-    return cancelPostedCalls(lock, task.socketSequence);
+    return cancelPostedCalls(lock, task.socketSequence, task.postedCallSequence);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -654,7 +694,7 @@ void AioTaskQueue::removeSocketFromPollSet(
     if (handlingData)
     {
         if (handlingData->nextTimeoutClock != 0)
-            cancelPeriodicTask(lock, handlingData.get(), eventType);
+            cancelPeriodicTask(lock, handlingData.get());
 
         handlingData = nullptr;
     }
@@ -673,7 +713,7 @@ void AioTaskQueue::addPeriodicTask(
     aio::EventType eventType)
 {
     handlingData->nextTimeoutClock = taskClock;
-    m_periodicTasksByClock.emplace(
+    handlingData->periodicTaskId = m_periodicTasks.add(
         taskClock,
         PeriodicTaskData(handlingData, _socket, eventType));
 }
@@ -682,89 +722,69 @@ std::optional<PeriodicTaskData> AioTaskQueue::takeNextExpiredPeriodicTask(qint64
 {
     NX_MUTEX_LOCKER lock(&m_mutex);
 
-    // Taking task from queue.
-    auto it = m_periodicTasksByClock.begin();
-    if (it == m_periodicTasksByClock.end() || it->first > curClock)
-        return std::nullopt;
-
-    auto periodicTaskData = std::move(it->second);
-    m_periodicTasksByClock.erase(it);
+    auto periodicTaskData = m_periodicTasks.takeNextExpired(curClock);
+    if (periodicTaskData)
+        periodicTaskData->data->periodicTaskId = kInvalidTimerId;
 
     return periodicTaskData;
 }
 
 void AioTaskQueue::replacePeriodicTask(
-    const nx::Locker<nx::Mutex>& lock,
+    const nx::Locker<nx::Mutex>& /*lock*/,
     const std::shared_ptr<AioEventHandlingData>& handlingData,
-    qint64 newClock,
-    Pollable* socket,
-    aio::EventType eventType)
+    qint64 newClock)
 {
-    for (auto it = m_periodicTasksByClock.lower_bound(handlingData->nextTimeoutClock);
-        it != m_periodicTasksByClock.end() && it->first == handlingData->nextTimeoutClock;
-        ++it)
-    {
-        if (it->second.socket == socket)
-        {
-            m_periodicTasksByClock.erase(it);
-            addPeriodicTask(
-                lock, newClock, handlingData, socket, eventType);
-            break;
-        }
-    }
+    if (handlingData->periodicTaskId == kInvalidTimerId)
+        return;
+
+    handlingData->nextTimeoutClock = newClock;
+    m_periodicTasks.reschedule(handlingData->periodicTaskId, newClock);
 }
 
 void AioTaskQueue::cancelPeriodicTask(
     const nx::Locker<nx::Mutex>& /*lock*/,
-    AioEventHandlingData* handlingData,
-    aio::EventType eventType)
+    AioEventHandlingData* handlingData)
 {
-    for (auto it = m_periodicTasksByClock.lower_bound(handlingData->nextTimeoutClock);
-        it != m_periodicTasksByClock.end() && it->first == handlingData->nextTimeoutClock;
-        ++it)
-    {
-        if (it->second.data.get() == handlingData && it->second.eventType == eventType)
-        {
-            m_periodicTasksByClock.erase(it);
-            return;
-        }
-    }
+    if (handlingData->periodicTaskId == kInvalidTimerId)
+        return;
+
+    m_periodicTasks.remove(std::exchange(handlingData->periodicTaskId, kInvalidTimerId));
 }
 
 //-------------------------------------------------------------------------------------------------
 
+void AioTaskQueue::takeQueuedPostedCalls(const nx::Locker<nx::Mutex>& /*lock*/)
+{
+    std::array<std::optional<SocketAddRemoveTask>, kPostedCallDequeueBulkSize> calls;
+    for (;;)
+    {
+        const auto count = m_postedCallQueue->try_dequeue_bulk(calls.begin(), calls.size());
+        for (std::size_t i = 0; i < count; ++i)
+            m_postedCalls.push_back(std::move(*calls[i]));
+        m_queuedPostedCallCount -= count;
+
+        if (count < calls.size())
+            break;
+    }
+}
+
 std::vector<SocketAddRemoveTask> AioTaskQueue::cancelPostedCalls(
     const nx::Locker<nx::Mutex>& /*lock*/,
-    SocketSequence socketSequence)
+    SocketSequence socketSequence,
+    std::uint64_t postedCallSequenceBound)
 {
     std::vector<SocketAddRemoveTask> elementsToRemove;
 
-    // TODO: #akolesnikov This method has O(m_pollSetModificationQueue.size())
-    // which can be quite large in Cloud, for example.
-    // Should optimize it here.
-    // Probably, it can become O(C) after some refactoring.
-
-    //detecting range of elements to remove
-    const auto tasksToRemoveRangeStart = nx::utils::move_if(
-        m_pollSetModificationQueue.begin(),
-        m_pollSetModificationQueue.end(),
-        std::back_inserter(elementsToRemove),
-        [socketSequence](const SocketAddRemoveTask& val)
-        {
-            return val.type == TaskType::tCallFunc
-                && val.socketSequence == socketSequence;
-        });
-    m_pollSetModificationQueue.erase(
-        tasksToRemoveRangeStart,
-        m_pollSetModificationQueue.end());
-
+    // NOTE: Posted calls are never put to m_pollSetModificationQueue, so only m_postedCalls has to
+    // be checked. The caller has taken calls from m_postedCallQueue already.
     const auto postedCallsRemoveRangeStart = nx::utils::move_if(
         m_postedCalls.begin(),
         m_postedCalls.end(),
         std::back_inserter(elementsToRemove),
-        [socketSequence](const SocketAddRemoveTask& val)
+        [socketSequence, postedCallSequenceBound](const SocketAddRemoveTask& val)
         {
-            return val.socketSequence == socketSequence;
+            return val.socketSequence == socketSequence
+                && val.postedCallSequence <= postedCallSequenceBound;
         });
     m_postedCalls.erase(
         postedCallsRemoveRangeStart,
@@ -781,7 +801,11 @@ void AioTaskQueue::callAndReportAbnormalProcessingTime(
     nx::utils::BasicElapsedTimer<std::chrono::microseconds> timer(
         nx::utils::ElapsedTimerState::started);
     func();
-    m_abnormalProcessingTimeDetector.add(timer.elapsed(), description);
+
+    const auto elapsed = timer.elapsed();
+    m_handlerCallCount.fetch_add(1, std::memory_order_relaxed);
+    m_handlerCallTimeUsec.fetch_add(elapsed.count(), std::memory_order_relaxed);
+    m_abnormalProcessingTimeDetector.add(elapsed, description);
 }
 
 void AioTaskQueue::reportAbnormalProcessingTime(
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <optional>
@@ -14,6 +15,7 @@
 #include "../detail/socket_sequence.h"
 #include "abstract_pollset.h"
 #include "aio_event_handler.h"
+#include "detail/timer_wheel.h"
 #include "pollable.h"
 
 namespace nx::network::aio::detail {
@@ -47,6 +49,8 @@ public:
     qint64 updatedPeriodicTaskClock = 0;
     /** Clock when timer will be triggered. 0 - no clock. */
     qint64 nextTimeoutClock = 0;
+    /** Id of the periodic task in AioTaskQueue timer wheel. */
+    TimerId periodicTaskId = kInvalidTimerId;
 
     AioEventHandlingData(AIOEventHandler* _eventHandler):
         eventHandler(_eventHandler)
@@ -69,6 +73,13 @@ public:
     std::atomic<int>* taskCompletionEvent;
     nx::utils::MoveOnlyFunc<void()> postHandler;
     nx::utils::MoveOnlyFunc<void()> taskCompletionHandler;
+    /**
+     * tCallFunc: sequence number of the call.
+     * tCancelPostedCalls: only calls with sequence number not greater than this one are cancelled.
+     * So, a call posted after the cancellation has been requested is not cancelled even if the
+     * AIO thread takes it from the queue before the cancellation task.
+     */
+    std::uint64_t postedCallSequence = 0;
 
     /**
      * @param taskCompletionEvent if not NULL, set to 1 after processing task.
@@ -171,12 +182,20 @@ class NX_NETWORK_API AioTaskQueue
 {
 public:
     AioTaskQueue(AbstractPollSet* pollSet);
+    ~AioTaskQueue();
 
     //---------------------------------------------------------------------------------------------
     // Methods that are called within any thread.
 
     void addTask(SocketAddRemoveTask task);
 
+    /**
+     * Adds a tCallFunc task to the lock-free posted call queue.
+     * @return true if the queue has been empty. Otherwise, the AIO thread has been woken up by
+     *     another call already, so there is no need to interrupt the poll set.
+     */
+    bool addPostedCall(SocketAddRemoveTask task);
+
     bool taskExists(
         Pollable* const sock,
         aio::EventType eventType,
@@ -218,6 +237,8 @@ public:
 
     std::size_t periodicTasksCount() const;
 
+    TimerWheel<PeriodicTaskData>::Statistics periodicTaskStatistics() const;
+
     void clear();
 
     bool empty() const;
@@ -251,8 +272,24 @@ public:
     std::vector<SocketAddRemoveTask> cancelPostedCalls(
         SocketSequence socketSequence);
 
+    /**
+     * Includes calls which are still in the lock-free queue.
+     * NOTE: Can be called within any thread.
+     */
     std::size_t postedCallCount() const;
 
+    /**
+     * Number of user handlers (socket events, timers, posted calls) invoked.
+     * NOTE: Can be called within any thread.
+     */
+    std::uint64_t handlerCallCount() const;
+
+    /**
+     * Total time spent in user handlers.
+     * NOTE: Can be called within any thread.
+     */
+    std::chrono::microseconds handlerCallTime() const;
+
     //---------------------------------------------------------------------------------------------
 
     /**
@@ -262,20 +299,31 @@ public:
     static qint64 getMonotonicTime();
 
 private:
+    class PostedCallQueue;
+
     AbstractPollSet* m_pollSet = nullptr;
+    /**
+     * Calls posted within any thread. Lock-free multiple-producer, single-consumer queue.
+     * The AIO thread moves calls from it to m_postedCalls.
+     */
+    std::unique_ptr<PostedCallQueue> m_postedCallQueue;
+    /** Number of calls in m_postedCallQueue. */
+    std::atomic<std::size_t> m_queuedPostedCallCount = 0;
+    std::atomic<std::uint64_t> m_prevPostedCallSequence = 0;
     // TODO #akolesnikov: Use cyclic array here to minimize allocations.
     /**
      * NOTE: This variable can be accessed within aio thread only.
      */
     std::deque<SocketAddRemoveTask> m_postedCalls;
     std::deque<SocketAddRemoveTask> m_pollSetModificationQueue;
-    // TODO: #akolesnikov Get rid of map here to avoid undesired allocations.
-    std::multimap<qint64, PeriodicTaskData> m_periodicTasksByClock;
+    TimerWheel<PeriodicTaskData> m_periodicTasks;
     mutable nx::Mutex m_mutex;
     nx::utils::math::AbnormalValueDetector<
         std::chrono::microseconds, int, const char*> m_abnormalProcessingTimeDetector;
     std::atomic<std::size_t> m_newReadMonitorTaskCount = 0;
     std::atomic<std::size_t> m_newWriteMonitorTaskCount = 0;
+    std::atomic<std::uint64_t> m_handlerCallCount = 0;
+    std::atomic<std::int64_t> m_handlerCallTimeUsec = 0;
 
     void addTask(
         const nx::Locker<nx::Mutex>&,
@@ -312,10 +360,6 @@ private:
         const nx::Locker<nx::Mutex>& lock,
         SocketAddRemoveTask& task);
 
-    void processCallFuncTask(
-        const nx::Locker<nx::Mutex>& lock,
-        SocketAddRemoveTask& task);
-
     std::vector<SocketAddRemoveTask> processCancelPostedCallTask(
         const nx::Locker<nx::Mutex>& lock,
         SocketAddRemoveTask& task);
@@ -348,20 +392,23 @@ private:
     void replacePeriodicTask(
         const nx::Locker<nx::Mutex>& lock,
         const std::shared_ptr<AioEventHandlingData>& handlingData,
-        qint64 newClock,
-        Pollable* socket,
-        aio::EventType eventType);
+        qint64 newClock);
 
     void cancelPeriodicTask(
         const nx::Locker<nx::Mutex>& /*lock*/,
-        AioEventHandlingData* eventHandlingData,
-        aio::EventType eventType);
+        AioEventHandlingData* eventHandlingData);
 
     //---------------------------------------------------------------------------------------------
 
+    /**
+     * Moves calls from the lock-free queue to m_postedCalls.
+     */
+    void takeQueuedPostedCalls(const nx::Locker<nx::Mutex>& /*lock*/);
+
     std::vector<SocketAddRemoveTask> cancelPostedCalls(
         const nx::Locker<nx::Mutex>& /*lock*/,
-        SocketSequence socketSequence);
+        SocketSequence socketSequence,
+        std::uint64_t postedCallSequenceBound);
 
     template<typename Func>
     void callAndReportAbnormalProcessingTime(Func func, const char* description);
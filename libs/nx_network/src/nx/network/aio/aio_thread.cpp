@@ -2,6 +2,7 @@
 
 #include "aio_thread.h"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -100,11 +101,12 @@ void AioThread::stopMonitoring(
 
 void AioThread::post(Pollable* const sock, nx::utils::MoveOnlyFunc<void()> functor)
 {
-    m_taskQueue->addTask(
+    const bool postedCallQueueWasEmpty = m_taskQueue->addPostedCall(
         detail::PostAsyncCallTask(sock, std::move(functor)));
 
     // If eventTriggered is lower on stack, socket will be added to pollset before the next poll call.
-    if (currentThreadSystemId() != systemThreadId())
+    // If the queue was not empty, the poll set has been interrupted by the previous call already.
+    if (postedCallQueueWasEmpty && currentThreadSystemId() != systemThreadId())
         m_pollSet->interrupt();
 }
 
@@ -177,6 +179,34 @@ bool AioThread::isSocketBeingMonitored(Pollable* sock) const
     return false;
 }
 
+AioThreadStatistics AioThread::statistics() const
+{
+    AioThreadStatistics result;
+    result.socketCount = socketsHandled();
+    result.handlerCallCount = m_taskQueue->handlerCallCount();
+    result.handlerCallTime = m_taskQueue->handlerCallTime();
+    result.loadPercent = m_loadPercent.load(std::memory_order_relaxed);
+    return result;
+}
+
+int AioThread::sampleLoadIfNeeded(qint64 curClock)
+{
+    const qint64 periodMs = kLoadMeasurementPeriod.count();
+    const qint64 elapsedMs = curClock - m_loadMeasurementStartClock;
+    if (elapsedMs < periodMs)
+        return (int) (periodMs - elapsedMs);
+
+    const auto handlerCallTime = m_taskQueue->handlerCallTime();
+    const auto busyTime = handlerCallTime - m_loadMeasurementStartHandlerCallTime;
+    m_loadPercent.store(
+        (int) std::clamp<std::int64_t>(busyTime.count() * 100 / (elapsedMs * 1000), 0, 100),
+        std::memory_order_relaxed);
+    m_loadMeasurementStartClock = curClock;
+    m_loadMeasurementStartHandlerCallTime = handlerCallTime;
+
+    return (int) periodMs;
+}
+
 const detail::AioTaskQueue& AioThread::taskQueue() const
 {
     return *m_taskQueue;
@@ -189,6 +219,8 @@ void AioThread::run()
     initSystemThreadId();
     NX_DEBUG(this, "AIO thread started");
 
+    m_loadMeasurementStartClock = m_taskQueue->getMonotonicTime();
+
     while (!needToStop())
     {
         //setting m_processingPostedCalls flag before processPollSetModificationQueue
@@ -219,8 +251,16 @@ void AioThread::run()
             ? aio::kInfiniteTimeout    //no periodic task
             : (nextPeriodicEventClock < curClock ? 0 : nextPeriodicEventClock - curClock);
 
+        // Waking up for the load sample even if there is nothing to do, so that an idle thread
+        // reports zero load instead of the load of its last busy period.
+        const int millisToTheNextLoadSample = sampleLoadIfNeeded(curClock);
+
         //if there are posted calls, just checking sockets state in non-blocking mode
-        const int pollTimeout = (m_taskQueue->postedCallCount() == 0) ? millisToTheNextPeriodicEvent : 0;
+        const int pollTimeout = (m_taskQueue->postedCallCount() == 0)
+            ? (millisToTheNextPeriodicEvent == aio::kInfiniteTimeout
+                ? millisToTheNextLoadSample
+                : std::min(millisToTheNextPeriodicEvent, millisToTheNextLoadSample))
+            : 0;
         const int triggeredSocketCount = m_pollSet->poll(pollTimeout);
 
         if (needToStop())
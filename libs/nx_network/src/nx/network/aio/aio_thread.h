@@ -3,6 +3,8 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <optional>
 
@@ -43,6 +45,21 @@ public:
     virtual bool isSocketBeingMonitored(Pollable* sock) const = 0;
 };
 
+struct AioThreadStatistics
+{
+    /** Number of sockets monitored by the thread (including those being added). */
+    std::size_t socketCount = 0;
+    /** Number of socket event, timer and posted call handlers invoked. */
+    std::uint64_t handlerCallCount = 0;
+    /** Total time spent in the handlers. */
+    std::chrono::microseconds handlerCallTime{0};
+    /**
+     * Percentage of time spent in the handlers during the last AioThread::kLoadMeasurementPeriod
+     * (or longer if a handler was running when the period ended).
+     */
+    int loadPercent = 0;
+};
+
 /**
  * This class implements socket event loop using PollSet class to do actual polling.
  * Also supports:
@@ -98,8 +115,16 @@ public:
 
     virtual bool isSocketBeingMonitored(Pollable* sock) const override;
 
+    /**
+     * NOTE: Does not change the thread state. The load is sampled by the thread itself every
+     * AioThread::kLoadMeasurementPeriod.
+     */
+    AioThreadStatistics statistics() const;
+
     const detail::AioTaskQueue& taskQueue() const;
 
+    static constexpr std::chrono::milliseconds kLoadMeasurementPeriod = std::chrono::seconds(1);
+
 protected:
     virtual void run() override;
 
@@ -109,6 +134,15 @@ private:
     std::atomic<int> m_processingPostedCalls{0};
     // TODO: #akolesnikov This mutex seem to be redundant after introduction of detail::AioTaskQueue.
     mutable nx::Mutex m_mutex;
+    std::atomic<int> m_loadPercent{0};
+    // Accessed within the AIO thread only.
+    qint64 m_loadMeasurementStartClock = 0;
+    std::chrono::microseconds m_loadMeasurementStartHandlerCallTime{0};
+
+    /**
+     * @return Milliseconds to the next load sample.
+     */
+    int sampleLoadIfNeeded(qint64 curClock);
 
     bool getSocketTimeout(
         Pollable* const sock,
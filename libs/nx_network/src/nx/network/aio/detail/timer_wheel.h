@@ -0,0 +1,306 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <nx/utils/log/assert.h>
+
+namespace nx::network::aio::detail {
+
+using TimerId = std::uint32_t;
+static constexpr TimerId kInvalidTimerId = std::numeric_limits<TimerId>::max();
+
+/**
+ * Hashed hierarchical timing wheel (G. Varghese, A. Lauck "Hashed and Hierarchical Timing
+ * Wheels").
+ * Clock is measured in milliseconds. Level l consists of kSlotCount slots, each covering
+ * kSlotCount^l milliseconds, so all levels together cover about two years. A timer is put to
+ * the level of the highest 6-bit group in which its clock differs from the current wheel clock.
+ * When the wheel clock reaches a slot of a non-zero level, the timers of the slot are moved
+ * (cascaded) to the lower levels. Timers of a level-0 slot are expired.
+ *
+ * add, reschedule and remove are O(1). Timer nodes are pooled and linked by indices, so
+ * rescheduling a timer or adding a timer after another one has been removed does not allocate.
+ * NOTE: The class is not thread-safe.
+ */
+template<typename Value>
+class TimerWheel
+{
+public:
+    struct Statistics
+    {
+        std::uint64_t added = 0;
+        std::uint64_t rescheduled = 0;
+        std::uint64_t removed = 0;
+        std::uint64_t expired = 0;
+        /** Number of times a timer has been moved to a lower level. */
+        std::uint64_t cascaded = 0;
+    };
+
+    TimerId add(std::int64_t clock, Value value)
+    {
+        TimerId id = m_freeNodes;
+        if (id == kInvalidTimerId)
+        {
+            id = (TimerId) m_nodes.size();
+            m_nodes.emplace_back();
+        }
+        else
+        {
+            m_freeNodes = m_nodes[id].next;
+        }
+
+        Node& node = m_nodes[id];
+        node.clock = clock;
+        node.value = std::move(value);
+        insert(id);
+
+        ++m_size;
+        ++m_statistics.added;
+        return id;
+    }
+
+    void reschedule(TimerId id, std::int64_t clock)
+    {
+        NX_ASSERT(isActive(id));
+
+        unlink(id);
+        m_nodes[id].clock = clock;
+        insert(id);
+
+        ++m_statistics.rescheduled;
+    }
+
+    /**
+     * @return The value of the removed timer.
+     */
+    Value remove(TimerId id)
+    {
+        NX_ASSERT(isActive(id));
+
+        unlink(id);
+        ++m_statistics.removed;
+        return release(id);
+    }
+
+    /**
+     * Removes the next timer with clock not greater than now and returns its value.
+     * Timers are taken in the order of their clocks with 1 millisecond precision. A timer added
+     * with a clock in the past is considered due at the current clock of the wheel.
+     */
+    std::optional<Value> takeNextExpired(std::int64_t now)
+    {
+        for (;;)
+        {
+            if (const TimerId id = m_lists[kExpiredList].first; id != kInvalidTimerId)
+            {
+                unlink(id);
+                ++m_statistics.expired;
+                return release(id);
+            }
+
+            const auto slot = nextSlot();
+            if (!slot || slot->clock > now)
+            {
+                if (m_size == 0)
+                    m_clock = std::max(m_clock, now);
+                return std::nullopt;
+            }
+
+            m_clock = slot->clock;
+            processSlot(slot->level, slot->index);
+        }
+    }
+
+    /**
+     * @return Clock of the slot containing the earliest timer. It is not later than the clock of
+     * the timer itself and is equal to it if the timer is on the lowest level (i.e., it is due in
+     * the current 64-millisecond interval). 0 if there are no timers.
+     */
+    std::int64_t nextClock() const
+    {
+        if (m_lists[kExpiredList].first != kInvalidTimerId)
+            return m_clock;
+
+        const auto slot = nextSlot();
+        return slot ? slot->clock : 0;
+    }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const Statistics& statistics() const { return m_statistics; }
+
+    bool isActive(TimerId id) const
+    {
+        return id < m_nodes.size() && m_nodes[id].list != kFreeList;
+    }
+
+private:
+    static constexpr int kBitsPerLevel = 6;
+    static constexpr int kSlotCount = 1 << kBitsPerLevel;
+    static constexpr int kLevelCount = 6;
+    /**
+     * A timer is never put to the current slot of the top level, so the top level may wrap
+     * around only once.
+     */
+    static constexpr std::int64_t kMaxDelay =
+        (std::int64_t(kSlotCount - 1) << (kBitsPerLevel * (kLevelCount - 1))) - 1;
+    static constexpr std::uint16_t kExpiredList = kLevelCount * kSlotCount;
+    static constexpr std::uint16_t kFreeList = kExpiredList + 1;
+
+    struct Node
+    {
+        std::int64_t clock = 0;
+        std::optional<Value> value;
+        TimerId prev = kInvalidTimerId;
+        TimerId next = kInvalidTimerId;
+        std::uint16_t list = kFreeList;
+    };
+
+    struct List
+    {
+        TimerId first = kInvalidTimerId;
+        TimerId last = kInvalidTimerId;
+    };
+
+    struct Slot
+    {
+        int level = 0;
+        int index = 0;
+        std::int64_t clock = 0;
+    };
+
+    std::vector<Node> m_nodes;
+    TimerId m_freeNodes = kInvalidTimerId;
+    std::array<List, kLevelCount * kSlotCount + 1> m_lists;
+    std::array<std::uint64_t, kLevelCount> m_occupiedSlots{};
+    std::int64_t m_clock = 0;
+    std::size_t m_size = 0;
+    Statistics m_statistics;
+
+    void insert(TimerId id)
+    {
+        // Timers in the past expire with the nearest slot. Timers that are too far in the future
+        // are put to the farthest slot and are cascaded there again until they fit.
+        const std::int64_t clock =
+            std::clamp(m_nodes[id].clock, m_clock, m_clock + kMaxDelay);
+
+        const auto masked = (std::uint64_t) (clock ^ m_clock) | (kSlotCount - 1);
+        const int level =
+            std::min((63 - std::countl_zero(masked)) / kBitsPerLevel, kLevelCount - 1);
+        const int index = (int) ((clock >> (level * kBitsPerLevel)) & (kSlotCount - 1));
+
+        link(id, (std::uint16_t) (level * kSlotCount + index));
+    }
+
+    std::optional<Slot> nextSlot() const
+    {
+        // Timers of a lower level always expire before timers of a higher level.
+        for (int level = 0; level < kLevelCount; ++level)
+        {
+            const std::uint64_t occupied = m_occupiedSlots[level];
+            if (occupied == 0)
+                continue;
+
+            const int shift = level * kBitsPerLevel;
+            const int currentIndex = (int) ((m_clock >> shift) & (kSlotCount - 1));
+            const int distance = std::countr_zero(std::rotr(occupied, currentIndex));
+            const int index = (currentIndex + distance) & (kSlotCount - 1);
+
+            const std::int64_t levelRange = std::int64_t(1) << (shift + kBitsPerLevel);
+            std::int64_t clock = (m_clock & ~(levelRange - 1)) + (std::int64_t(index) << shift);
+            if (index < currentIndex)
+                clock += levelRange;
+
+            return Slot{level, index, std::max(clock, m_clock)};
+        }
+
+        return std::nullopt;
+    }
+
+    void processSlot(int level, int index)
+    {
+        const auto listIndex = (std::uint16_t) (level * kSlotCount + index);
+        while (m_lists[listIndex].first != kInvalidTimerId)
+        {
+            const TimerId id = m_lists[listIndex].first;
+            unlink(id);
+            if (level == 0)
+            {
+                link(id, kExpiredList);
+            }
+            else
+            {
+                insert(id);
+                ++m_statistics.cascaded;
+            }
+        }
+    }
+
+    void link(TimerId id, std::uint16_t listIndex)
+    {
+        Node& node = m_nodes[id];
+        List& list = m_lists[listIndex];
+
+        node.list = listIndex;
+        node.prev = list.last;
+        node.next = kInvalidTimerId;
+        if (list.last != kInvalidTimerId)
+            m_nodes[list.last].next = id;
+        else
+            list.first = id;
+        list.last = id;
+
+        if (listIndex != kExpiredList)
+            m_occupiedSlots[listIndex / kSlotCount] |= std::uint64_t(1) << (listIndex % kSlotCount);
+    }
+
+    void unlink(TimerId id)
+    {
+        Node& node = m_nodes[id];
+        List& list = m_lists[node.list];
+
+        if (node.prev != kInvalidTimerId)
+            m_nodes[node.prev].next = node.next;
+        else
+            list.first = node.next;
+
+        if (node.next != kInvalidTimerId)
+            m_nodes[node.next].prev = node.prev;
+        else
+            list.last = node.prev;
+
+        if (list.first == kInvalidTimerId && node.list != kExpiredList)
+        {
+            m_occupiedSlots[node.list / kSlotCount] &=
+                ~(std::uint64_t(1) << (node.list % kSlotCount));
+        }
+
+        node.prev = kInvalidTimerId;
+        node.next = kInvalidTimerId;
+    }
+
+    Value release(TimerId id)
+    {
+        Node& node = m_nodes[id];
+        Value value = std::move(*node.value);
+        node.value.reset();
+        node.list = kFreeList;
+        node.next = m_freeNodes;
+        m_freeNodes = id;
+
+        --m_size;
+        return value;
+    }
+};
+
+} // namespace nx::network::aio::detail
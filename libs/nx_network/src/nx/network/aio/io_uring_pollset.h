@@ -0,0 +1,119 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "abstract_pollset.h"
+#include "event_type.h"
+
+namespace nx::network::aio {
+
+/**
+ * Poll set implemented on top of Linux io_uring.
+ * Every socket is monitored with a single one-shot IORING_OP_POLL_ADD request which is re-armed
+ * by the next IoUringPollSet::poll call, so the poll set is level-triggered just like the
+ * epoll-based PollSet.
+ * IoUringPollSet::add and IoUringPollSet::remove do not make any system calls. The resulting
+ * poll/cancel requests are queued and submitted to the kernel together with waiting for the
+ * completions in a single io_uring_enter call made by IoUringPollSet::poll. So, an AIO thread
+ * iteration costs one system call regardless of the number of sockets being (re)subscribed.
+ * NOTE: Requires Linux 5.5+. If io_uring is not supported by the kernel (or is forbidden by
+ *   seccomp), IoUringPollSet::isValid returns false and the caller is expected to fall back to
+ *   the epoll-based PollSet. PollSetFactory does that.
+ * NOTE: This class is not thread-safe. IoUringPollSet::interrupt is the only exception.
+ */
+class NX_NETWORK_API IoUringPollSet:
+    public AbstractPollSet
+{
+public:
+    struct Statistics
+    {
+        /** Number of system calls made by IoUringPollSet::poll. */
+        std::uint64_t syscalls = 0;
+        /** Number of submission queue entries passed to the kernel. */
+        std::uint64_t submissions = 0;
+        /** Number of completion queue entries reaped. */
+        std::uint64_t completions = 0;
+    };
+
+    static constexpr unsigned int kDefaultQueueDepth = 256;
+
+    IoUringPollSet(unsigned int queueDepth = kDefaultQueueDepth);
+    virtual ~IoUringPollSet() override;
+
+    IoUringPollSet(const IoUringPollSet&) = delete;
+    IoUringPollSet& operator=(const IoUringPollSet&) = delete;
+
+    virtual bool isValid() const override;
+    virtual void interrupt() override;
+    virtual bool add(Pollable* const sock, EventType eventType, void* userData = nullptr) override;
+    virtual void remove(Pollable* const sock, EventType eventType) override;
+    virtual size_t size() const override;
+    virtual int poll(int millisToWait = kInfiniteTimeout) override;
+    virtual std::unique_ptr<AbstractPollSetIterator> getSocketEventsIterator() override;
+
+    const Statistics& statistics() const;
+
+    /**
+     * @return true if the running kernel provides io_uring with all features required by
+     * IoUringPollSet.
+     */
+    static bool isSupported();
+
+private:
+    struct Ring;
+
+    struct SocketContext
+    {
+        Pollable* socket = nullptr;
+        int handle = -1;
+        /** Bit mask of aio::EventType values being monitored. */
+        int eventMask = 0;
+        /** Token of the poll request currently armed in the kernel. 0 if none. */
+        std::uint64_t armedToken = 0;
+        /** Poll mask (POLLIN, POLLOUT, etc...) of the armed request. */
+        unsigned int armedPollMask = 0;
+        bool scheduledForArm = false;
+    };
+
+    struct SocketEvent
+    {
+        /** Set to null when the event is cancelled by IoUringPollSet::remove. */
+        Pollable* socket = nullptr;
+        /** The handler the event is reported to: aio::etRead or aio::etWrite. */
+        aio::EventType handler = aio::etNone;
+        aio::EventType eventType = aio::etNone;
+    };
+
+    class Iterator;
+
+    std::unique_ptr<Ring> m_ring;
+    int m_eventFd = -1;
+    bool m_interruptPollArmed = false;
+    std::uint64_t m_prevToken = 0;
+    std::uint64_t m_armedTimeoutToken = 0;
+    std::map<Pollable*, SocketContext> m_sockets;
+    std::unordered_map<std::uint64_t, SocketContext*> m_armedPolls;
+    std::vector<Pollable*> m_socketsToArm;
+    std::vector<std::uint64_t> m_pollsToCancel;
+    std::vector<SocketEvent> m_events;
+    Statistics m_statistics;
+
+    void scheduleArm(SocketContext* context);
+    void cancelArmedPoll(SocketContext* context);
+    void queuePendingRequests();
+    void queueTimeout(int millisToWait);
+    /**
+     * @return true if poll has to return: an interrupt or the timeout has been reported.
+     */
+    bool processCompletions();
+    void processSocketCompletion(SocketContext* context, int result);
+    void addEvent(SocketContext* context, aio::EventType handler, aio::EventType eventType);
+};
+
+} // namespace nx::network::aio
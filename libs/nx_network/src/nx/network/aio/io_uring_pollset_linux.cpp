@@ -0,0 +1,615 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "io_uring_pollset.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    #define NX_NETWORK_IO_URING_AVAILABLE
+#endif
+
+#include <nx/utils/log/log.h>
+#include <nx/utils/system_error.h>
+
+#include "pollable.h"
+
+namespace nx::network::aio {
+
+//-------------------------------------------------------------------------------------------------
+// IoUringPollSet::Iterator.
+
+class IoUringPollSet::Iterator:
+    public AbstractPollSetIterator
+{
+public:
+    Iterator(const std::vector<SocketEvent>* events):
+        m_events(events)
+    {
+    }
+
+    virtual bool next() override
+    {
+        // Skipping events cancelled by IoUringPollSet::remove.
+        do
+        {
+            ++m_index;
+        }
+        while (m_index < m_events->size() && (*m_events)[m_index].socket == nullptr);
+
+        return m_index < m_events->size();
+    }
+
+    virtual Pollable* socket() override
+    {
+        return (*m_events)[m_index].socket;
+    }
+
+    virtual const Pollable* socket() const override
+    {
+        return (*m_events)[m_index].socket;
+    }
+
+    virtual aio::EventType eventReceived() const override
+    {
+        return (*m_events)[m_index].eventType;
+    }
+
+private:
+    const std::vector<SocketEvent>* m_events = nullptr;
+    std::size_t m_index = (std::size_t) -1;
+};
+
+#if defined(NX_NETWORK_IO_URING_AVAILABLE)
+
+namespace {
+
+static constexpr std::uint64_t kInterruptToken = 1;
+static constexpr std::uint64_t kCancelToken = 2;
+static constexpr std::uint64_t kFirstRequestToken = 16;
+
+static constexpr int kRequiredFeatures = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP;
+
+int ioUringSetup(unsigned int entries, io_uring_params* params)
+{
+    return (int) ::syscall(__NR_io_uring_setup, entries, params);
+}
+
+int ioUringEnter(int fd, unsigned int toSubmit, unsigned int minComplete, unsigned int flags)
+{
+    return (int) ::syscall(
+        __NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+}
+
+unsigned int toPollMask(int eventMask)
+{
+    unsigned int pollMask = POLLRDHUP;
+    if (eventMask & aio::etRead)
+        pollMask |= POLLIN;
+    if (eventMask & aio::etWrite)
+        pollMask |= POLLOUT;
+    return pollMask;
+}
+
+} // namespace
+
+//-------------------------------------------------------------------------------------------------
+// IoUringPollSet::Ring.
+
+/**
+ * Submission and completion queues shared with the kernel.
+ */
+struct IoUringPollSet::Ring
+{
+    int fd = -1;
+    void* ringMemory = MAP_FAILED;
+    std::size_t ringMemorySize = 0;
+    io_uring_sqe* sqes = (io_uring_sqe*) MAP_FAILED;
+    std::size_t sqesSize = 0;
+
+    unsigned int* sqHead = nullptr;
+    unsigned int* sqTail = nullptr;
+    unsigned int sqMask = 0;
+    unsigned int sqEntries = 0;
+    /** Number of entries put to the submission queue, but not consumed by the kernel yet. */
+    unsigned int toSubmit = 0;
+
+    unsigned int* cqHead = nullptr;
+    unsigned int* cqTail = nullptr;
+    unsigned int cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    /** Has to stay valid until the timeout request is consumed by the kernel. */
+    __kernel_timespec timeout;
+
+    ~Ring()
+    {
+        if (sqes != MAP_FAILED)
+            munmap(sqes, sqesSize);
+        if (ringMemory != MAP_FAILED)
+            munmap(ringMemory, ringMemorySize);
+        if (fd >= 0)
+            close(fd);
+    }
+
+    bool initialize(unsigned int queueDepth)
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        fd = ioUringSetup(queueDepth, &params);
+        if (fd < 0)
+            return false;
+
+        if ((params.features & kRequiredFeatures) != kRequiredFeatures)
+        {
+            errno = ENOSYS;
+            return false;
+        }
+
+        // Since IORING_FEAT_SINGLE_MMAP the submission and completion queue rings share memory.
+        ringMemorySize = std::max<std::size_t>(
+            params.sq_off.array + params.sq_entries * sizeof(unsigned int),
+            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+        ringMemory = mmap(
+            nullptr, ringMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            fd, IORING_OFF_SQ_RING);
+        if (ringMemory == MAP_FAILED)
+            return false;
+
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = (io_uring_sqe*) mmap(
+            nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+            return false;
+
+        char* const ring = (char*) ringMemory;
+        sqHead = (unsigned int*) (ring + params.sq_off.head);
+        sqTail = (unsigned int*) (ring + params.sq_off.tail);
+        sqMask = *(unsigned int*) (ring + params.sq_off.ring_mask);
+        sqEntries = *(unsigned int*) (ring + params.sq_off.ring_entries);
+        cqHead = (unsigned int*) (ring + params.cq_off.head);
+        cqTail = (unsigned int*) (ring + params.cq_off.tail);
+        cqMask = *(unsigned int*) (ring + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe*) (ring + params.cq_off.cqes);
+
+        // Submission queue entry i is always placed to the slot i, so the index array is constant.
+        unsigned int* const sqArray = (unsigned int*) (ring + params.sq_off.array);
+        for (unsigned int i = 0; i < sqEntries; ++i)
+            sqArray[i] = i;
+
+        return true;
+    }
+
+    /**
+     * @return nullptr if the submission queue is full and the kernel cannot consume it right now.
+     */
+    io_uring_sqe* nextSqe(Statistics* statistics)
+    {
+        if (*sqTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+        {
+            // Passing the queued entries to the kernel to free space.
+            if (enter(/*minComplete*/ 0, /*flags*/ 0, statistics) <= 0)
+                return nullptr;
+        }
+
+        io_uring_sqe* sqe = &sqes[*sqTail & sqMask];
+        memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    void commitSqe()
+    {
+        __atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+        ++toSubmit;
+    }
+
+    bool hasCompletions() const
+    {
+        return *cqHead != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    }
+
+    int enter(unsigned int minComplete, unsigned int flags, Statistics* statistics)
+    {
+        const int result = ioUringEnter(fd, toSubmit, minComplete, flags);
+        ++statistics->syscalls;
+        if (result < 0)
+            return result;
+
+        toSubmit -= result;
+        statistics->submissions += result;
+        return result;
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+// IoUringPollSet.
+
+IoUringPollSet::IoUringPollSet(unsigned int queueDepth):
+    m_ring(std::make_unique<Ring>()),
+    m_prevToken(kFirstRequestToken)
+{
+    if (!m_ring->initialize(queueDepth))
+    {
+        NX_DEBUG(this, "io_uring is not available. %1",
+            SystemError::toString(SystemError::getLastOSErrorCode()));
+        m_ring.reset();
+        return;
+    }
+
+    m_eventFd = eventfd(0, EFD_NONBLOCK);
+}
+
+IoUringPollSet::~IoUringPollSet()
+{
+    // Closing the ring cancels all requests still armed in the kernel.
+    m_ring.reset();
+
+    if (m_eventFd >= 0)
+        close(m_eventFd);
+}
+
+bool IoUringPollSet::isValid() const
+{
+    return m_ring && m_eventFd >= 0;
+}
+
+void IoUringPollSet::interrupt()
+{
+    std::uint64_t value = 1;
+    if (write(m_eventFd, &value, sizeof(value)) != sizeof(value))
+    {
+        // The eventfd counter overflow is the only possible reason. The poll is interrupted anyway.
+    }
+}
+
+bool IoUringPollSet::add(Pollable* const sock, EventType eventType, void* /*userData*/)
+{
+    if (sock->handle() < 0)
+        return false;
+
+    auto [it, inserted] = m_sockets.emplace(sock, SocketContext());
+    SocketContext& context = it->second;
+    if (inserted)
+    {
+        context.socket = sock;
+        context.handle = sock->handle();
+    }
+
+    if (context.eventMask & eventType)
+        return true; //< Event is already monitored.
+
+    context.eventMask |= eventType;
+    scheduleArm(&context);
+    return true;
+}
+
+void IoUringPollSet::remove(Pollable* const sock, EventType eventType)
+{
+    auto it = m_sockets.find(sock);
+    if (it == m_sockets.end() || (it->second.eventMask & eventType) == 0)
+        return;
+
+    SocketContext& context = it->second;
+    context.eventMask &= ~eventType;
+
+    // Ignoring not yet reported events for the handler which has just been removed.
+    for (auto& event: m_events)
+    {
+        if (event.socket == sock && event.handler == eventType)
+            event.socket = nullptr;
+    }
+
+    if (context.eventMask == 0)
+    {
+        cancelArmedPoll(&context);
+        // Not letting the arm queue grow when sockets are added and removed between polls.
+        if (context.scheduledForArm && m_socketsToArm.back() == sock)
+            m_socketsToArm.pop_back();
+        m_sockets.erase(it);
+    }
+    else
+    {
+        // Re-arming with the reduced mask.
+        scheduleArm(&context);
+    }
+}
+
+size_t IoUringPollSet::size() const
+{
+    return m_sockets.size();
+}
+
+int IoUringPollSet::poll(int millisToWait)
+{
+    m_events.clear();
+
+    if (!isValid())
+    {
+        errno = EBADF;
+        return -1;
+    }
+
+    queuePendingRequests();
+    if (millisToWait > 0)
+        queueTimeout(millisToWait);
+
+    for (;;)
+    {
+        const bool wait = millisToWait != 0 && !m_ring->hasCompletions();
+        if (wait || m_ring->toSubmit > 0)
+        {
+            const int result = m_ring->enter(
+                wait ? 1 : 0,
+                wait ? IORING_ENTER_GETEVENTS : 0,
+                &m_statistics);
+            // EBUSY means the completion queue is overflown. Reaping completions resolves it.
+            if (result < 0 && errno != EBUSY && errno != EAGAIN)
+                return -1;
+        }
+
+        const bool interruptedOrTimedOut = processCompletions();
+        if (interruptedOrTimedOut || !m_events.empty() || millisToWait == 0)
+            break;
+
+        // Only the completions of the cancelled requests or the completions filtered out have been
+        // reaped. Re-arming the requests and waiting further.
+        queuePendingRequests();
+    }
+
+    return (int) m_events.size();
+}
+
+std::unique_ptr<AbstractPollSetIterator> IoUringPollSet::getSocketEventsIterator()
+{
+    return std::make_unique<Iterator>(&m_events);
+}
+
+const IoUringPollSet::Statistics& IoUringPollSet::statistics() const
+{
+    return m_statistics;
+}
+
+bool IoUringPollSet::isSupported()
+{
+    Ring ring;
+    return ring.initialize(/*queueDepth*/ 1);
+}
+
+void IoUringPollSet::scheduleArm(SocketContext* context)
+{
+    if (context->scheduledForArm)
+        return;
+
+    context->scheduledForArm = true;
+    m_socketsToArm.push_back(context->socket);
+}
+
+void IoUringPollSet::cancelArmedPoll(SocketContext* context)
+{
+    if (context->armedToken == 0)
+        return;
+
+    // The completion of the cancelled request (if any) is ignored since the token is forgotten.
+    m_armedPolls.erase(context->armedToken);
+    m_pollsToCancel.push_back(context->armedToken);
+    context->armedToken = 0;
+}
+
+void IoUringPollSet::queuePendingRequests()
+{
+    std::size_t armedCount = 0;
+    for (; armedCount < m_socketsToArm.size(); ++armedCount)
+    {
+        // The socket could have been removed or removed and added again after scheduling.
+        auto it = m_sockets.find(m_socketsToArm[armedCount]);
+        if (it == m_sockets.end() || !it->second.scheduledForArm)
+            continue;
+
+        SocketContext& context = it->second;
+        const auto pollMask = toPollMask(context.eventMask);
+        if (context.armedToken != 0)
+        {
+            if (context.armedPollMask == pollMask)
+            {
+                context.scheduledForArm = false;
+                continue;
+            }
+            cancelArmedPoll(&context);
+        }
+
+        auto sqe = m_ring->nextSqe(&m_statistics);
+        if (!sqe)
+            break; //< Arming the rest on the next poll.
+
+        context.scheduledForArm = false;
+        context.armedToken = ++m_prevToken;
+        context.armedPollMask = pollMask;
+        m_armedPolls.emplace(context.armedToken, &context);
+
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = context.handle;
+        sqe->poll_events = (decltype(sqe->poll_events)) pollMask;
+        sqe->user_data = context.armedToken;
+        m_ring->commitSqe();
+    }
+    m_socketsToArm.erase(m_socketsToArm.begin(), m_socketsToArm.begin() + armedCount);
+
+    std::size_t cancelledCount = 0;
+    for (; cancelledCount < m_pollsToCancel.size(); ++cancelledCount)
+    {
+        auto sqe = m_ring->nextSqe(&m_statistics);
+        if (!sqe)
+            break;
+
+        sqe->opcode = IORING_OP_POLL_REMOVE;
+        sqe->fd = -1;
+        sqe->addr = m_pollsToCancel[cancelledCount];
+        sqe->user_data = kCancelToken;
+        m_ring->commitSqe();
+    }
+    m_pollsToCancel.erase(m_pollsToCancel.begin(), m_pollsToCancel.begin() + cancelledCount);
+
+    if (!m_interruptPollArmed)
+    {
+        if (auto sqe = m_ring->nextSqe(&m_statistics))
+        {
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = m_eventFd;
+            sqe->poll_events = POLLIN;
+            sqe->user_data = kInterruptToken;
+            m_ring->commitSqe();
+            m_interruptPollArmed = true;
+        }
+    }
+}
+
+void IoUringPollSet::queueTimeout(int millisToWait)
+{
+    if (m_armedTimeoutToken != 0)
+    {
+        // The previous poll has returned before its timeout expired.
+        if (auto sqe = m_ring->nextSqe(&m_statistics))
+        {
+            sqe->opcode = IORING_OP_TIMEOUT_REMOVE;
+            sqe->fd = -1;
+            sqe->addr = m_armedTimeoutToken;
+            sqe->user_data = kCancelToken;
+            m_ring->commitSqe();
+        }
+        m_armedTimeoutToken = 0;
+    }
+
+    auto sqe = m_ring->nextSqe(&m_statistics);
+    if (!sqe)
+        return;
+
+    m_ring->timeout.tv_sec = millisToWait / 1000;
+    m_ring->timeout.tv_nsec = (long long) (millisToWait % 1000) * 1000 * 1000;
+
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = (std::uint64_t) &m_ring->timeout;
+    sqe->len = 1;
+    sqe->user_data = m_armedTimeoutToken = ++m_prevToken;
+    m_ring->commitSqe();
+}
+
+bool IoUringPollSet::processCompletions()
+{
+    bool interruptedOrTimedOut = false;
+
+    unsigned int head = *m_ring->cqHead;
+    const unsigned int tail = __atomic_load_n(m_ring->cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head)
+    {
+        const io_uring_cqe& cqe = m_ring->cqes[head & m_ring->cqMask];
+        ++m_statistics.completions;
+
+        if (cqe.user_data == kInterruptToken)
+        {
+            m_interruptPollArmed = false;
+            std::uint64_t value = 0;
+            if (read(m_eventFd, &value, sizeof(value)) == -1)
+            {
+                // The eventfd has been read already. Nothing to do.
+            }
+            ++m_statistics.syscalls;
+            interruptedOrTimedOut = true;
+        }
+        else if (cqe.user_data == m_armedTimeoutToken)
+        {
+            m_armedTimeoutToken = 0;
+            interruptedOrTimedOut = true;
+        }
+        else if (auto it = m_armedPolls.find(cqe.user_data); it != m_armedPolls.end())
+        {
+            SocketContext* context = it->second;
+            m_armedPolls.erase(it);
+            context->armedToken = 0;
+            processSocketCompletion(context, cqe.res);
+        }
+        // Otherwise, it is a completion of a cancelled request.
+    }
+
+    __atomic_store_n(m_ring->cqHead, head, __ATOMIC_RELEASE);
+    return interruptedOrTimedOut;
+}
+
+void IoUringPollSet::processSocketCompletion(SocketContext* context, int result)
+{
+    const unsigned int revents = result < 0 ? (unsigned int) POLLERR : (unsigned int) result;
+    const bool monitorsRead = (context->eventMask & aio::etRead) != 0;
+    const bool monitorsWrite = (context->eventMask & aio::etWrite) != 0;
+
+    if (revents & (POLLERR | POLLNVAL))
+    {
+        // Reporting the error to every one who listens.
+        if (monitorsRead)
+            addEvent(context, aio::etRead, aio::etError);
+        if (monitorsWrite)
+            addEvent(context, aio::etWrite, aio::etError);
+    }
+    else if (revents & (POLLHUP | POLLRDHUP))
+    {
+        // Reporting connection closure as an error when writing data to provide behavior similar
+        // to recv/send functions. Same as the epoll-based PollSet does.
+        if (monitorsRead)
+            addEvent(context, aio::etRead, aio::etRead);
+        if (monitorsWrite)
+            addEvent(context, aio::etWrite, aio::etError);
+    }
+    else
+    {
+        if ((revents & POLLIN) && monitorsRead)
+            addEvent(context, aio::etRead, aio::etRead);
+        if ((revents & POLLOUT) && monitorsWrite)
+            addEvent(context, aio::etWrite, aio::etWrite);
+    }
+
+    // Poll requests are one-shot. Re-arming to keep the poll set level-triggered.
+    scheduleArm(context);
+}
+
+void IoUringPollSet::addEvent(
+    SocketContext* context,
+    aio::EventType handler,
+    aio::EventType eventType)
+{
+    m_events.push_back(SocketEvent{context->socket, handler, eventType});
+}
+
+#else // defined(NX_NETWORK_IO_URING_AVAILABLE)
+
+// The system headers do not provide io_uring. The poll set is always invalid.
+
+struct IoUringPollSet::Ring {};
+
+IoUringPollSet::IoUringPollSet(unsigned int /*queueDepth*/) {}
+IoUringPollSet::~IoUringPollSet() = default;
+bool IoUringPollSet::isValid() const { return false; }
+void IoUringPollSet::interrupt() {}
+bool IoUringPollSet::add(Pollable* const, EventType, void*) { return false; }
+void IoUringPollSet::remove(Pollable* const, EventType) {}
+size_t IoUringPollSet::size() const { return 0; }
+int IoUringPollSet::poll(int) { errno = ENOSYS; return -1; }
+
+std::unique_ptr<AbstractPollSetIterator> IoUringPollSet::getSocketEventsIterator()
+{
+    return std::make_unique<Iterator>(&m_events);
+}
+
+const IoUringPollSet::Statistics& IoUringPollSet::statistics() const { return m_statistics; }
+bool IoUringPollSet::isSupported() { return false; }
+
+#endif // defined(NX_NETWORK_IO_URING_AVAILABLE)
+
+} // namespace nx::network::aio
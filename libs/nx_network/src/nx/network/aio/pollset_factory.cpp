@@ -2,8 +2,13 @@
 
 #include "pollset_factory.h"
 
+#include <nx/network/nx_network_ini.h>
+#include <nx/utils/log/log.h>
 #include <nx/utils/std/cpp14.h>
 
+#if defined(__linux__)
+    #include "io_uring_pollset.h"
+#endif
 #include "pollset.h"
 #include "pollset_wrapper.h"
 #include "unified_pollset.h"
@@ -15,7 +20,8 @@ namespace aio {
 PollSetFactory* s_instance = nullptr;
 
 PollSetFactory::PollSetFactory():
-    m_udtEnabled(true)
+    m_udtEnabled(true),
+    m_ioUringEnabled(ini().useIoUringPollSet)
 {
     if (s_instance)
         NX_ERROR(this, "Singleton is created more than once.");
@@ -33,8 +39,20 @@ std::unique_ptr<AbstractPollSet> PollSetFactory::create()
 {
     if (m_udtEnabled)
         return std::make_unique<PollSetWrapper<UnifiedPollSet>>();
-    else
-        return std::make_unique<PollSetWrapper<PollSet>>();
+
+    #if defined(__linux__)
+        // UDT sockets cannot be polled by io_uring, so it is used only when UDT is disabled.
+        if (m_ioUringEnabled)
+        {
+            auto pollSet = std::make_unique<IoUringPollSet>();
+            if (pollSet->isValid())
+                return pollSet;
+
+            NX_INFO(this, "io_uring poll set is not supported. Falling back to epoll");
+        }
+    #endif
+
+    return std::make_unique<PollSetWrapper<PollSet>>();
 }
 
 void PollSetFactory::enableUdt()
@@ -47,6 +65,16 @@ void PollSetFactory::disableUdt()
     m_udtEnabled = false;
 }
 
+void PollSetFactory::enableIoUring()
+{
+    m_ioUringEnabled = true;
+}
+
+void PollSetFactory::disableIoUring()
+{
+    m_ioUringEnabled = false;
+}
+
 PollSetFactory* PollSetFactory::instance()
 {
     return s_instance;
@@ -21,10 +21,20 @@ public:
     void enableUdt();
     void disableUdt();
 
+    /**
+     * Makes PollSetFactory::create use the io_uring based poll set when UDT is disabled.
+     * If the kernel does not support io_uring, the epoll-based PollSet is used.
+     * Enabled by default if nx_network.ini has useIoUringPollSet set.
+     * NOTE: Has effect on Linux only.
+     */
+    void enableIoUring();
+    void disableIoUring();
+
     static PollSetFactory* instance();
 
 private:
     bool m_udtEnabled;
+    bool m_ioUringEnabled;
 };
 
 } // namespace aio
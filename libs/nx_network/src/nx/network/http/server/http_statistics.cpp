@@ -9,24 +9,32 @@ namespace nx::network::http::server {
 //-------------------------------------------------------------------------------------------------
 // RequestStatisticsCalculator
 
+namespace {
+
+static constexpr std::array<double, 3> kRequestProcessingTimePercentiles = {0.5, 0.95, 0.99};
+
+// Longer processing times are reported as this value.
+static constexpr std::chrono::hours kMaxRequestProcessingTime(1);
+
+// Processing times are reported with an error of up to 1/32.
+static constexpr int kRequestProcessingTimePrecisionBits = 6;
+
+} // namespace
+
 RequestStatisticsCalculator::RequestStatisticsCalculator():
-    m_averageRequestProcessingTime(std::chrono::minutes(1))
+    m_averageRequestProcessingTime(std::chrono::minutes(1)),
+    m_requestProcessingTimes(
+        std::chrono::minutes(1),
+        kMaxRequestProcessingTime,
+        kRequestProcessingTimePrecisionBits)
 {
-    static constexpr std::array<double, 3> percentiles = {0.5, 0.95, 0.99};
-    for (const auto& p: percentiles)
-    {
-        m_requestProcessingTimePercentiles.emplace(
-            p,
-            PercentilePerPeriod{p, std::chrono::minutes(1), 2});
-    }
 }
 
 void RequestStatisticsCalculator::processedRequest(std::chrono::microseconds duration)
 {
     m_averageRequestProcessingTime.add(duration.count());
     m_maxRequestProcessingTime.add(duration);
-    for (auto& p: m_requestProcessingTimePercentiles)
-        p.second.add(duration);
+    m_requestProcessingTimes.add(duration);
     m_requestsServedPerMinute.add(1);
 }
 
@@ -37,10 +45,11 @@ RequestStatistics RequestStatisticsCalculator::requestStatistics() const
         std::chrono::microseconds(m_averageRequestProcessingTime.getAveragePerLastPeriod());
     stats.maxRequestProcessingTimeUsec = m_maxRequestProcessingTime.getMaxPerLastPeriod();
 
-    for (const auto& [key, calculator]: m_requestProcessingTimePercentiles)
+    const auto& requestProcessingTimes = m_requestProcessingTimes.histogram();
+    for (const auto& percentile: kRequestProcessingTimePercentiles)
     {
         std::ostringstream ss;
-        ss << std::setprecision(2) << std::fixed << key * 100;
+        ss << std::setprecision(2) << std::fixed << percentile * 100;
         auto k = ss.str();
 
         while (k.back() == '0') //< Drop trailing zeros after the decimal.
@@ -48,7 +57,8 @@ RequestStatistics RequestStatisticsCalculator::requestStatistics() const
         while (k.back() == '.') //< If all decimals points were 0, then drop the decimal.
             k.pop_back();
 
-        stats.requestProcessingTimePercentilesUsec[std::move(k)] = calculator.get();
+        stats.requestProcessingTimePercentilesUsec[std::move(k)] =
+            requestProcessingTimes.valueAtPercentile(percentile);
     }
 
     stats.requestsServedPerMinute = m_requestsServedPerMinute.getSumPerLastPeriod();
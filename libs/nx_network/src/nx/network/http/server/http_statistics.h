@@ -5,8 +5,8 @@
 #include <nx/network/connection_server/server_statistics.h>
 #include <nx/reflect/instrument.h>
 #include <nx/utils/math/average_per_period.h>
+#include <nx/utils/math/histogram_per_period.h>
 #include <nx/utils/math/max_per_period.h>
-#include <nx/utils/math/percentile_per_period.h>
 
 namespace nx::network::http::server {
 
@@ -72,14 +72,12 @@ public:
     RequestStatistics requestStatistics() const;
 
 private:
-    using PercentilePerPeriod = nx::utils::math::PercentilePerPeriod<std::chrono::microseconds>;
-
     // AveragePerPeriod does not compile when std::chrono::microseconds is used directly.
     nx::utils::math::AveragePerPeriod<std::chrono::microseconds::rep>
         m_averageRequestProcessingTime;
 
     nx::utils::math::MaxPerMinute<std::chrono::microseconds> m_maxRequestProcessingTime;
-    std::map<double, PercentilePerPeriod> m_requestProcessingTimePercentiles;
+    nx::utils::math::HistogramPerPeriod<std::chrono::microseconds> m_requestProcessingTimes;
     nx::utils::math::SumPerMinute<int> m_requestsServedPerMinute;
 };
 
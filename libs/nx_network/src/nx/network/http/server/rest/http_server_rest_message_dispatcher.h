@@ -6,7 +6,7 @@
 
 #include "../http_message_dispatcher.h"
 #include "base_request_handler.h"
-#include "http_server_rest_path_matcher.h"
+#include "http_server_rest_radix_path_matcher.h"
 
 namespace nx::network::http::server::rest {
 
@@ -17,7 +17,7 @@ namespace nx::network::http::server::rest {
  * ("accountId": "vpupkin") pair is added to RequestContext::requestPathParams.
  */
 class MessageDispatcher:
-    public BasicMessageDispatcher<PathMatcher>
+    public BasicMessageDispatcher<RadixPathMatcher>
 {
 public:
     /**
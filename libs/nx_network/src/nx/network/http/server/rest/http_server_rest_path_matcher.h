@@ -5,13 +5,69 @@
 #include <algorithm>
 #include <optional>
 #include <regex>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "../../http_types.h"
 #include "../request_matcher.h"
 
 namespace nx::network::http::server::rest {
 
+namespace detail {
+
+/**
+ * Converts the path template to the regular expression which captures every REST parameter.
+ */
+inline std::regex convertToRegex(const std::string_view& pathTemplate)
+{
+    const std::regex replaceRestParams(
+        "{[0-9a-zA-Z_-]*}", std::regex_constants::basic);
+    const std::string replacement("\\([^/]*\\)");
+
+    std::string restPathMatchRegex;
+    restPathMatchRegex += "^";
+    std::regex_replace(
+        std::back_inserter(restPathMatchRegex),
+        pathTemplate.begin(), pathTemplate.end(),
+        replaceRestParams,
+        replacement);
+    restPathMatchRegex += "$";
+
+    return std::regex(
+        std::move(restPathMatchRegex),
+        std::regex::icase | std::regex_constants::basic);
+}
+
+/**
+ * @return false if the path template contains parameters with the same name.
+ */
+inline bool fetchParamNames(
+    const std::string_view& pathTemplateView, std::vector<std::string>* names)
+{
+    std::string pathTemplate(pathTemplateView);
+    std::set<std::string> uniqueNames;
+
+    const std::regex findRestParamsRegex(
+        "{\\([0-9a-zA-Z_-]*\\)}", std::regex_constants::basic);
+
+    std::smatch matchResult;
+    while (std::regex_search(pathTemplate, matchResult, findRestParamsRegex))
+    {
+        for (size_t i = 1; i < matchResult.size(); ++i)
+        {
+            names->push_back(matchResult[i].str());
+            if (!uniqueNames.emplace(matchResult[i].str()).second)
+                return false;
+        }
+        pathTemplate = matchResult.suffix();
+    }
+
+    return true;
+}
+
+} // namespace detail
+
 /**
  * Usage example:
  * - Register path "/account/{accountId}/systems".
@@ -35,8 +91,8 @@ public:
     bool add(const std::string_view& pathTemplate, Mapped mapped)
     {
         MatchContext matchContext;
-        matchContext.regex = convertToRegex(pathTemplate);
-        if (!fetchParamNames(pathTemplate, &matchContext.paramNames))
+        matchContext.regex = detail::convertToRegex(pathTemplate);
+        if (!detail::fetchParamNames(pathTemplate, &matchContext.paramNames))
             return false;
 
         matchContext.mapped = std::move(mapped);
@@ -105,49 +161,6 @@ private:
 
     /** REST path template, context */
     std::vector<std::pair<std::string, MatchContext>> m_restPathToMatchContext;
-
-    std::regex convertToRegex(const std::string_view& pathTemplate)
-    {
-        const std::regex replaceRestParams(
-            "{[0-9a-zA-Z_-]*}", std::regex_constants::basic);
-        const std::string replacement("\\([^/]*\\)");
-
-        std::string restPathMatchRegex;
-        restPathMatchRegex += "^";
-        std::regex_replace(
-            std::back_inserter(restPathMatchRegex),
-            pathTemplate.begin(), pathTemplate.end(),
-            replaceRestParams,
-            replacement);
-        restPathMatchRegex += "$";
-
-        return std::regex(
-            std::move(restPathMatchRegex),
-            std::regex::icase | std::regex_constants::basic);
-    }
-
-    bool fetchParamNames(const std::string_view& pathTemplateView, std::vector<std::string>* names)
-    {
-        std::string pathTemplate(pathTemplateView);
-        std::set<std::string> uniqueNames;
-
-        const std::regex findRestParamsRegex(
-            "{\\([0-9a-zA-Z_-]*\\)}", std::regex_constants::basic);
-
-        std::smatch matchResult;
-        while (std::regex_search(pathTemplate, matchResult, findRestParamsRegex))
-        {
-            for (size_t i = 1; i < matchResult.size(); ++i)
-            {
-                names->push_back(matchResult[i].str());
-                if (!uniqueNames.emplace(matchResult[i].str()).second)
-                    return false;
-            }
-            pathTemplate = matchResult.suffix();
-        }
-
-        return true;
-    }
 };
 
 } // namespace nx::network::http::server::rest
@@ -0,0 +1,469 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "http_server_rest_path_matcher.h"
+
+namespace nx::network::http::server::rest {
+
+/**
+ * Matches the same path templates as PathMatcher, but the templates are compiled to a radix
+ * tree, so the matching time depends on the path length rather than on the number of registered
+ * templates, and no memory is allocated until the result is built.
+ *
+ * As with PathMatcher, the literal parts are matched case-insensitively, empty parameter values
+ * are not matched and the template registered first wins if several ones match the path.
+ *
+ * Templates with the regular expression special characters outside of the parameters are
+ * matched by std::regex as PathMatcher does. The only exception is the trailing ".*" that is
+ * matched by the tree as an arbitrary path suffix.
+ */
+template<typename Mapped>
+class RadixPathMatcher
+{
+public:
+    using MatchResult = RequestMatchResult<Mapped>;
+
+    static constexpr size_t kMaxParamCount = 16;
+
+    struct MatchView
+    {
+        const Mapped& value;
+        std::string_view pathTemplate;
+        /** Parameter names in the order they are present in the template. */
+        const std::vector<std::string>& paramNames;
+        /** Values of paramNames referencing the matched path. */
+        std::array<std::string_view, kMaxParamCount> paramValues;
+    };
+
+    /**
+     * Registers path that may contain REST parameters. See PathMatcher::add().
+     * @return true if path registered. false if a duplicate or an invalid path template, or
+     *     the template has more than kMaxParamCount parameters.
+     */
+    bool add(const std::string_view& pathTemplate, Mapped mapped)
+    {
+        if (std::any_of(
+            m_entries.begin(), m_entries.end(),
+            [&pathTemplate](const auto& entry) { return entry.pathTemplate == pathTemplate; }))
+        {
+            // Duplicate entry.
+            return false;
+        }
+
+        std::vector<std::string> paramNames;
+        if (!detail::fetchParamNames(pathTemplate, &paramNames)
+            || paramNames.size() > kMaxParamCount)
+        {
+            return false;
+        }
+
+        const size_t index = m_entries.size();
+        std::optional<std::regex> regex;
+        if (auto tokens = parse(pathTemplate))
+        {
+            addToTree(*tokens, index);
+        }
+        else
+        {
+            regex = detail::convertToRegex(pathTemplate);
+            m_regexEntries.push_back(index);
+        }
+
+        m_entries.push_back(Entry{
+            .pathTemplate = std::string(pathTemplate),
+            .paramNames = std::move(paramNames),
+            .regex = std::move(regex),
+            .regexPrefix = literalPrefix(pathTemplate),
+            .mapped = std::move(mapped)});
+        return true;
+    }
+
+    /**
+     * Matches registered paths. If multiple templates match the path, the one registered first
+     * is selected.
+     */
+    std::optional<MatchResult> match(const std::string_view& path) const
+    {
+        const auto view = matchView(path);
+        if (!view)
+            return std::nullopt;
+
+        RequestPathParams params;
+        for (size_t i = 0; i < view->paramNames.size(); ++i)
+            params.emplace(view->paramNames[i], std::string(view->paramValues[i]));
+
+        return MatchResult{
+            .value = view->value,
+            .pathTemplate = view->pathTemplate,
+            .pathParams = std::move(params)};
+    }
+
+    /**
+     * Same as match(), but the parameter values are not copied. The result is valid until the
+     * path is destroyed or a new template is added.
+     */
+    std::optional<MatchView> matchView(const std::string_view& path) const
+    {
+        Match best;
+        Captures captures;
+        matchNode(m_root, path, &captures, /*paramCount*/ 0, &best);
+
+        for (const size_t index: m_regexEntries)
+        {
+            if (index >= best.entry)
+                break;
+
+            const Entry& entry = m_entries[index];
+            if (startsWithIgnoreCase(path, entry.regexPrefix)
+                && matchRegex(*entry.regex, path, &captures))
+            {
+                best.entry = index;
+                best.paramValues = captures;
+                break;
+            }
+        }
+
+        if (best.entry == kNoEntry)
+            return std::nullopt;
+
+        const Entry& entry = m_entries[best.entry];
+        return MatchView{
+            .value = entry.mapped,
+            .pathTemplate = entry.pathTemplate,
+            .paramNames = entry.paramNames,
+            .paramValues = best.paramValues};
+    }
+
+private:
+    static constexpr size_t kNoEntry = std::numeric_limits<size_t>::max();
+
+    using Captures = std::array<std::string_view, kMaxParamCount>;
+
+    struct Entry
+    {
+        std::string pathTemplate;
+        std::vector<std::string> paramNames;
+        /** Set if the template cannot be matched by the tree. */
+        std::optional<std::regex> regex;
+        /** Lower-case literal start of the template, checked before the regex is run. */
+        std::string regexPrefix;
+        Mapped mapped;
+    };
+
+    struct Token
+    {
+        enum class Type { literal, param, anySuffix };
+
+        Type type = Type::literal;
+        /** Lower-case text of a literal. */
+        std::string text;
+    };
+
+    struct Node
+    {
+        /** Lower-case literal leading from the parent node. Empty for the parameter nodes. */
+        std::string label;
+        /** The labels of the children start with different characters. */
+        std::vector<std::unique_ptr<Node>> children;
+        /** Reached after a parameter value. */
+        std::unique_ptr<Node> paramChild;
+        /**
+         * Whether the parameter value preceding paramChild can be followed by something but '/'
+         * or the path end, so all the value lengths must be tried.
+         */
+        bool paramEndsInsideSegment = false;
+
+        /** The template ending at this node. */
+        size_t entry = kNoEntry;
+        /** The template ending at this node with ".*". */
+        size_t anySuffixEntry = kNoEntry;
+        /** The first registered template in the subtree. */
+        size_t minEntry = kNoEntry;
+    };
+
+    struct Match
+    {
+        size_t entry = kNoEntry;
+        Captures paramValues;
+        std::vector<size_t> rejectedEntries;
+    };
+
+    Node m_root;
+    std::vector<Entry> m_entries;
+    /** Indexes of the entries matched by std::regex in the ascending order. */
+    std::vector<size_t> m_regexEntries;
+
+    static char toLower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? (char) (c - 'A' + 'a') : c;
+    }
+
+    static bool startsWithIgnoreCase(std::string_view text, const std::string& lowerCasePrefix)
+    {
+        return lowerCasePrefix.size() <= text.size()
+            && std::equal(
+                lowerCasePrefix.begin(), lowerCasePrefix.end(), text.begin(),
+                [](char left, char right) { return left == toLower(right); });
+    }
+
+    static std::string literalPrefix(std::string_view pathTemplate)
+    {
+        std::string prefix;
+        for (const char c: pathTemplate)
+        {
+            if (c == '{' || isRegexSpecialChar(c))
+                break;
+            prefix += toLower(c);
+        }
+        return prefix;
+    }
+
+    static bool isParamNameChar(char c)
+    {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+            || c == '_' || c == '-';
+    }
+
+    static bool isRegexSpecialChar(char c)
+    {
+        return c == '.' || c == '*' || c == '[' || c == '\\' || c == '^' || c == '$';
+    }
+
+    /**
+     * Splits the template into the same parts detail::convertToRegex() produces.
+     * @return std::nullopt if the template cannot be represented in the tree.
+     */
+    static std::optional<std::vector<Token>> parse(std::string_view pathTemplate)
+    {
+        std::vector<Token> tokens;
+
+        static constexpr std::string_view kAnySuffix = ".*";
+        const bool hasAnySuffix = pathTemplate.ends_with(kAnySuffix);
+        if (hasAnySuffix)
+            pathTemplate.remove_suffix(kAnySuffix.size());
+
+        for (size_t pos = 0; pos < pathTemplate.size(); )
+        {
+            if (pathTemplate[pos] == '{')
+            {
+                const auto end = pathTemplate.find('}', pos);
+                if (end != std::string_view::npos
+                    && std::all_of(
+                        pathTemplate.begin() + pos + 1, pathTemplate.begin() + end,
+                        &isParamNameChar))
+                {
+                    tokens.push_back({Token::Type::param, {}});
+                    pos = end + 1;
+                    continue;
+                }
+            }
+
+            if (isRegexSpecialChar(pathTemplate[pos]))
+                return std::nullopt;
+
+            if (tokens.empty() || tokens.back().type != Token::Type::literal)
+                tokens.push_back({Token::Type::literal, {}});
+            tokens.back().text += toLower(pathTemplate[pos]);
+            ++pos;
+        }
+
+        if (hasAnySuffix)
+            tokens.push_back({Token::Type::anySuffix, {}});
+
+        return tokens;
+    }
+
+    void addToTree(const std::vector<Token>& tokens, size_t index)
+    {
+        Node* node = &m_root;
+        node->minEntry = std::min(node->minEntry, index);
+
+        for (auto token = tokens.begin(); token != tokens.end(); ++token)
+        {
+            switch (token->type)
+            {
+                case Token::Type::literal:
+                    node = addLiteral(node, token->text, index);
+                    break;
+
+                case Token::Type::param:
+                {
+                    if (!node->paramChild)
+                        node->paramChild = std::make_unique<Node>();
+
+                    const auto next = std::next(token);
+                    if (next != tokens.end()
+                        && (next->type != Token::Type::literal || next->text.front() != '/'))
+                    {
+                        node->paramEndsInsideSegment = true;
+                    }
+
+                    node = node->paramChild.get();
+                    node->minEntry = std::min(node->minEntry, index);
+                    break;
+                }
+
+                case Token::Type::anySuffix:
+                    // The first registered template of the same matching rules wins.
+                    node->anySuffixEntry = std::min(node->anySuffixEntry, index);
+                    return;
+            }
+        }
+
+        node->entry = std::min(node->entry, index);
+    }
+
+    static Node* addLiteral(Node* node, std::string_view text, size_t index)
+    {
+        while (!text.empty())
+        {
+            auto child = std::find_if(
+                node->children.begin(), node->children.end(),
+                [&text](const auto& child) { return child->label.front() == text.front(); });
+
+            if (child == node->children.end())
+            {
+                auto& newChild = node->children.emplace_back(std::make_unique<Node>());
+                newChild->label = std::string(text);
+                newChild->minEntry = index;
+                return newChild.get();
+            }
+
+            const auto& label = (*child)->label;
+            const size_t commonLength =
+                std::mismatch(label.begin(), label.end(), text.begin(), text.end()).first
+                    - label.begin();
+
+            if (commonLength < label.size())
+            {
+                // Splitting the edge.
+                auto middle = std::make_unique<Node>();
+                middle->label = label.substr(0, commonLength);
+                middle->minEntry = (*child)->minEntry;
+                (*child)->label.erase(0, commonLength);
+                middle->children.push_back(std::move(*child));
+                *child = std::move(middle);
+            }
+
+            node = child->get();
+            node->minEntry = std::min(node->minEntry, index);
+            text.remove_prefix(commonLength);
+        }
+
+        return node;
+    }
+
+    void matchNode(
+        const Node& node,
+        std::string_view path,
+        Captures* captures,
+        size_t paramCount,
+        Match* best) const
+    {
+        if (node.minEntry >= best->entry)
+            return;
+
+        if (path.empty())
+            acceptEntry(node.entry, *captures, paramCount, best);
+        acceptEntry(node.anySuffixEntry, *captures, paramCount, best);
+
+        if (!path.empty())
+        {
+            const char first = toLower(path.front());
+            for (const auto& child: node.children)
+            {
+                if (child->label.front() != first)
+                    continue;
+
+                if (startsWithIgnoreCase(path, child->label))
+                {
+                    matchNode(
+                        *child, path.substr(child->label.size()), captures, paramCount, best);
+                }
+                break;
+            }
+        }
+
+        if (node.paramChild)
+        {
+            const size_t segmentEnd = std::min(path.find('/'), path.size());
+            if (!node.paramEndsInsideSegment)
+            {
+                (*captures)[paramCount] = path.substr(0, segmentEnd);
+                matchNode(
+                    *node.paramChild, path.substr(segmentEnd), captures, paramCount + 1, best);
+                return;
+            }
+
+            // The longest values first, as the regular expression captures them. Empty values
+            // are captured as well, since the regular expression does not look for another
+            // match if the first one has an empty value.
+            for (size_t length = segmentEnd + 1; length-- > 0; )
+            {
+                (*captures)[paramCount] = path.substr(0, length);
+                matchNode(
+                    *node.paramChild, path.substr(length), captures, paramCount + 1, best);
+            }
+        }
+    }
+
+    /**
+     * The first match of a template found by the tree is the one found by its regular
+     * expression. So the template is rejected if some value of the first match is empty, even
+     * if the path can be split differently.
+     */
+    static void acceptEntry(
+        size_t entry, const Captures& captures, size_t paramCount, Match* best)
+    {
+        if (entry >= best->entry
+            || std::find(best->rejectedEntries.begin(), best->rejectedEntries.end(), entry)
+                != best->rejectedEntries.end())
+        {
+            return;
+        }
+
+        if (std::any_of(
+            captures.begin(), captures.begin() + paramCount,
+            [](const auto& value) { return value.empty(); }))
+        {
+            // Allocates only when an empty value is captured, which is unusual for valid paths.
+            best->rejectedEntries.push_back(entry);
+            return;
+        }
+
+        best->entry = entry;
+        best->paramValues = captures;
+    }
+
+    static bool matchRegex(
+        const std::regex& regex, const std::string_view& path, Captures* paramValues)
+    {
+        std::match_results<std::string_view::const_iterator> matchResult;
+        if (!std::regex_search(path.begin(), path.end(), matchResult, regex))
+            return false;
+
+        for (size_t i = 1; i < matchResult.size(); ++i)
+        {
+            if (matchResult[i].length() == 0)
+                return false;
+
+            (*paramValues)[i - 1] = path.substr(
+                matchResult[i].first - path.begin(), matchResult[i].length());
+        }
+
+        return true;
+    }
+};
+
+} // namespace nx::network::http::server::rest
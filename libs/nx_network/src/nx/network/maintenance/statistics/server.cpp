@@ -2,8 +2,10 @@
 
 #include "server.h"
 
+#include <nx/network/aio/aio_service.h>
 #include <nx/network/http/buffer_source.h>
 #include <nx/network/http/http_types.h>
+#include <nx/network/socket_global.h>
 #include <nx/reflect/json.h>
 
 #include <nx/network/url/url_parse_helper.h>
@@ -36,6 +38,15 @@ void Server::getStatisticsGeneral(
     Statistics stats{
         duration_cast<milliseconds>(steady_clock::now() - m_processStartTime)};
 
+    for (const auto& thread: SocketGlobals::aioService().statistics())
+    {
+        stats.aioThreads.push_back(AioThreadStatistics{
+            thread.socketCount,
+            thread.handlerCallCount,
+            thread.handlerCallTime,
+            thread.loadPercent});
+    }
+
     http::RequestResult result(http::StatusCode::ok);
     result.body = std::make_unique<http::BufferSource>(
         http::header::ContentType::kJson,
@@ -1,16 +1,30 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
 #include <chrono>
+#include <cstdint>
+#include <vector>
 
 #include <nx/reflect/instrument.h>
 
 namespace nx::network::maintenance::statistics {
 
+struct NX_NETWORK_API AioThreadStatistics
+{
+    std::size_t socketCount = 0;
+    std::uint64_t handlerCallCount = 0;
+    std::chrono::microseconds handlerCallTimeUsec{0};
+    int loadPercent = 0;
+};
+
+NX_REFLECTION_INSTRUMENT(AioThreadStatistics,
+    (socketCount)(handlerCallCount)(handlerCallTimeUsec)(loadPercent))
+
 struct NX_NETWORK_API Statistics
 {
     std::chrono::milliseconds uptimeMsec{0};
+    std::vector<AioThreadStatistics> aioThreads;
 };
 
-NX_REFLECTION_INSTRUMENT(Statistics, (uptimeMsec))
+NX_REFLECTION_INSTRUMENT(Statistics, (uptimeMsec)(aioThreads))
 
 } // namespace nx::network::maintenance::statistics
@@ -28,6 +28,15 @@ struct NX_NETWORK_API Ini: nx::kit::IniConfig
         "Minimum duration of socket send() to log as WARNING, in microseconds. Lesser durations\n"
         "are logged as VERBOSE.");
 
+    NX_INI_FLAG(false, useIoUringPollSet,
+        "[Linux] Use io_uring instead of epoll in AIO threads if UDT is disabled. Falls back to\n"
+        "epoll if the kernel does not support io_uring.");
+
+    NX_INI_FLAG(false, aioThreadLoadAwarePlacement,
+        "Select AIO thread for a new socket considering the time the threads spend in event\n"
+        "handlers. Otherwise, only the number of sockets handled by each thread is considered.\n"
+        "Experimental: the effect on real workloads has not been measured yet.");
+
     NX_INI_FLAG(false, traceIoObjectsLifetime,
         "Enables reporting creation stack traces of dangling HTTP clients during server shutdown");
 };
@@ -15,9 +15,17 @@ AcceptConnectionHandler::AcceptConnectionHandler(
             std::unique_ptr<AbstractStreamSocket> connection,
             http::RequestContext ctx)
         {
+            // The same check as in validateRequest(), so the compression is used only if it has
+            // been accepted in the response.
+            const auto negotiatedDeflateParams = deflateParams(ctx.request.headers);
             auto webSocket = std::make_unique<WebSocket>(
                 std::move(connection), SendMode::singleMessage, ReceiveMode::message,
-                Role::server, FrameType::binary, CompressionType::perMessageDeflate);
+                Role::server, FrameType::binary,
+                negotiatedDeflateParams
+                    ? CompressionType::perMessageDeflate
+                    : CompressionType::none);
+            if (negotiatedDeflateParams)
+                webSocket->setDeflateParams(*negotiatedDeflateParams);
             webSocket->start();
             onConnectionCreated(std::move(webSocket), std::move(ctx.requestPathParams));
         })
@@ -34,7 +34,8 @@ WebSocket::WebSocket(
         frameType == FrameType::binary || frameType == FrameType::text
             ? frameType
             : FrameType::binary),
-    m_compressionType(compressionType)
+    m_compressionType(compressionType),
+    m_role(role)
 {
     SocketGlobals::instance().allocationAnalyzer().recordObjectCreation(this);
     ++SocketGlobals::instance().debugCounters().websocketConnectionCount;
@@ -248,18 +249,18 @@ void WebSocket::sendAsync(const nx::Buffer* buffer, IoCompletionHandler handler)
             nx::Buffer writeBuffer;
             if (m_sendMode == SendMode::singleMessage)
             {
-                writeBuffer = m_serializer.prepareMessage(buffer, m_frameType, m_compressionType);
+                m_serializer.prepareMessage(buffer, m_frameType, m_compressionType, &writeBuffer);
             }
             else
             {
                 FrameType type = !m_isFirstFrame ? FrameType::continuation : m_frameType;
-                writeBuffer = m_serializer.prepareFrame(buffer, type, m_isLastFrame);
+                m_serializer.prepareFrame(buffer, type, m_isLastFrame, &writeBuffer);
                 m_isFirstFrame = m_isLastFrame;
                 if (m_isLastFrame)
                     m_isLastFrame = false;
             }
 
-            sendMessage(writeBuffer, buffer.size(), std::move(handler));
+            sendMessage(std::move(writeBuffer), buffer.size(), std::move(handler));
         });
 }
 
@@ -268,12 +269,30 @@ void WebSocket::setAliveTimeout(std::chrono::milliseconds timeout)
     m_aliveTimeout = timeout;
 }
 
+void WebSocket::setDeflateParams(const DeflateParams& params)
+{
+    NX_VERBOSE(this, "Compression context takeover: %1, window bits: %2",
+        params.contextTakeover(m_role), params.maxWindowBits(m_role));
+    m_serializer.setCompressionParams(
+        params.contextTakeover(m_role), params.maxWindowBits(m_role));
+}
+
+CompressionStatistics WebSocket::compressionStatistics() const
+{
+    auto result = m_serializer.compressionStatistics();
+    const auto& received = m_parser.compressionStatistics();
+    result.compressedBytesReceived = received.compressedBytesReceived;
+    result.uncompressedBytesReceived = received.uncompressedBytesReceived;
+    result.decompressionTime = received.decompressionTime;
+    return result;
+}
+
 void WebSocket::sendCloseAsync()
 {
     post([this]() { sendControlRequest(FrameType::close); });
 }
 
-void WebSocket::sendMessage(const nx::Buffer& message, int writeSize, IoCompletionHandler handler)
+void WebSocket::sendMessage(nx::Buffer frame, std::size_t writeSize, IoCompletionHandler handler)
 {
     NX_VERBOSE(this, "SendMessage: IsFailed: %1, Write size: %2", m_failed, writeSize);
     if (m_failed)
@@ -285,26 +304,40 @@ void WebSocket::sendMessage(const nx::Buffer& message, int writeSize, IoCompleti
         return;
     }
 
-    m_writeQueue.emplace(std::move(handler), message);
-    if (m_writeQueue.size() == 1)
+    // The front batch is being sent, so only the following ones can be appended to.
+    if (m_sendQueue.size() > 1
+        && m_sendQueue.back().frames.size() + frame.size() <= kMaxSendBatchSize)
     {
-        m_socket->sendAsync(
-            &m_writeQueue.front().second,
-            [this, writeSize](SystemError::ErrorCode error, size_t transferred)
-            {
-                onWrite(error, transferred == 0 ? 0 : writeSize);
-            });
+        auto& batch = m_sendQueue.back();
+        batch.frames.append(frame.data(), frame.size());
+        batch.writes.push_back({std::move(handler), writeSize});
+        return;
     }
+
+    m_sendQueue.push_back({std::move(frame), {}});
+    m_sendQueue.back().writes.push_back({std::move(handler), writeSize});
+    if (m_sendQueue.size() == 1)
+        sendFrontBatch();
+}
+
+void WebSocket::sendFrontBatch()
+{
+    m_socket->sendAsync(
+        &m_sendQueue.front().frames,
+        [this](SystemError::ErrorCode error, size_t transferred)
+        {
+            onWrite(error, transferred);
+        });
 }
 
 void WebSocket::onWrite(SystemError::ErrorCode error, size_t transferred)
 {
     if (m_failed)
     {
-        while (!m_writeQueue.empty())
+        while (!m_sendQueue.empty())
         {
             utils::InterruptionFlag::Watcher watcher(&m_destructionFlag);
-            callOnWriteHandler(SystemError::connectionAbort, 0);
+            callOnWriteHandler(SystemError::connectionAbort);
             if (watcher.interrupted())
                 return;
         }
@@ -314,10 +347,10 @@ void WebSocket::onWrite(SystemError::ErrorCode error, size_t transferred)
     if (error != SystemError::noError)
     {
         m_failed = true;
-        while (!m_writeQueue.empty())
+        while (!m_sendQueue.empty())
         {
             utils::InterruptionFlag::Watcher watcher(&m_destructionFlag);
-            callOnWriteHandler(error, 0);
+            callOnWriteHandler(error);
             if (watcher.interrupted())
                 return;
         }
@@ -325,38 +358,43 @@ void WebSocket::onWrite(SystemError::ErrorCode error, size_t transferred)
     else if (transferred == 0)
     {
         m_failed = true;
-        while (!m_writeQueue.empty())
+        while (!m_sendQueue.empty())
         {
             utils::InterruptionFlag::Watcher watcher(&m_destructionFlag);
-            callOnWriteHandler(SystemError::connectionAbort, 0);
+            callOnWriteHandler(SystemError::connectionAbort);
             if (watcher.interrupted())
                 return;
         }
     }
     else
     {
-        utils::InterruptionFlag::Watcher watcher(&m_destructionFlag);
-        callOnWriteHandler(SystemError::noError, transferred);
-        if (watcher.interrupted())
-            return;
-
-        if (!m_writeQueue.empty())
+        // The batch stays in the queue while the handlers are called, so that messages sent by
+        // them are not appended to it.
+        for (std::size_t i = 0; i < m_sendQueue.front().writes.size(); ++i)
         {
-            m_socket->sendAsync(
-                &m_writeQueue.front().second,
-                [this](SystemError::ErrorCode error, size_t transferred)
-                {
-                    onWrite(error, transferred);
-                });
+            auto& write = m_sendQueue.front().writes[i];
+            const auto handler = std::move(write.handler);
+            const auto writeSize = write.writeSize;
+            utils::InterruptionFlag::Watcher watcher(&m_destructionFlag);
+            handler(SystemError::noError, writeSize);
+            if (watcher.interrupted())
+                return;
         }
+        m_sendQueue.pop_front();
+
+        if (!m_sendQueue.empty())
+            sendFrontBatch();
     }
 }
 
-void WebSocket::callOnWriteHandler(SystemError::ErrorCode error, size_t transferred)
+void WebSocket::callOnWriteHandler(SystemError::ErrorCode error)
 {
-    const auto userWritePair = std::move(m_writeQueue.front());
-    m_writeQueue.pop();
-    userWritePair.first(error, transferred);
+    auto& batch = m_sendQueue.front();
+    const auto handler = std::move(batch.writes.front().handler);
+    batch.writes.erase(batch.writes.begin());
+    if (batch.writes.empty())
+        m_sendQueue.pop_front();
+    handler(error, 0);
 }
 
 void WebSocket::cancelIoInAioThread(nx::network::aio::EventType eventType)
@@ -410,8 +448,9 @@ void WebSocket::sendControlResponse(FrameType type)
         m_serializer.prepareMessage(m_controlBuffer, type, m_compressionType);
     m_controlBuffer.resize(0);
 
+    const auto frameSize = responseFrame.size();
     sendMessage(
-        responseFrame, responseFrame.size(),
+        std::move(responseFrame), frameSize,
         [this, type](SystemError::ErrorCode error, size_t /*transferred*/)
         {
             NX_VERBOSE(
@@ -425,8 +464,9 @@ void WebSocket::sendControlResponse(FrameType type)
 void WebSocket::sendControlRequest(FrameType type)
 {
     nx::Buffer requestFrame = m_serializer.prepareMessage("", type, m_compressionType);
+    const auto frameSize = requestFrame.size();
     sendMessage(
-        requestFrame, requestFrame.size(),
+        std::move(requestFrame), frameSize,
         [this, type](SystemError::ErrorCode error, size_t /*transferred*/)
         {
             NX_VERBOSE(
@@ -2,8 +2,9 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
-#include <queue>
+#include <vector>
 
 #include <nx/network/aio/abstract_async_channel.h>
 #include <nx/network/aio/timer.h>
@@ -79,6 +80,19 @@ public:
      */
     void disablePingPong();
 
+    /**
+     * Sets the permessage-deflate parameters negotiated during the handshake (see
+     * deflateParams()). Without it, messages are compressed without context takeover, which any
+     * peer can decompress.
+     * NOTE: Should be called before start().
+     */
+    void setDeflateParams(const DeflateParams& params);
+
+    /**
+     * NOTE: Should be called within the object's AIO thread.
+     */
+    CompressionStatistics compressionStatistics() const;
+
 private:
     struct UserReadContext
     {
@@ -92,6 +106,25 @@ private:
     };
     using UserReadContextPtr = std::unique_ptr<UserReadContext>;
 
+    struct WriteContext
+    {
+        IoCompletionHandler handler;
+        std::size_t writeSize = 0;
+    };
+
+    /** Frames sent with a single socket call. */
+    struct SendBatch
+    {
+        nx::Buffer frames;
+        std::vector<WriteContext> writes;
+    };
+
+    /**
+     * Frames of up to this total size queued while the socket is busy are sent with a single
+     * call. Larger frames are not copied to a batch.
+     */
+    static constexpr std::size_t kMaxSendBatchSize = 64 * 1024;
+
     std::unique_ptr<AbstractStreamSocket> m_socket;
     Parser m_parser;
     Serializer m_serializer;
@@ -99,7 +132,8 @@ private:
     ReceiveMode m_receiveMode;
     bool m_isLastFrame = false;
     bool m_isFirstFrame = true;
-    std::queue<std::pair<IoCompletionHandler, nx::Buffer>> m_writeQueue;
+    /** The front batch is being sent. */
+    std::deque<SendBatch> m_sendQueue;
     UserReadContextPtr m_userReadContext;
     websocket::MultiBuffer m_incomingMessageQueue;
     nx::Buffer m_controlBuffer;
@@ -111,6 +145,7 @@ private:
     bool m_failed = false;
     FrameType m_frameType;
     network::websocket::CompressionType m_compressionType;
+    Role m_role;
     bool m_readingCeased = false;
     bool m_pingPongDisabled = false;
 
@@ -120,14 +155,15 @@ private:
     void gotFrame(FrameType type, const nx::Buffer& data, bool fin);
 
     /** Own helper functions*/
-    void sendMessage(const nx::Buffer& message, int writeSize, IoCompletionHandler handler);
+    void sendMessage(nx::Buffer frame, std::size_t writeSize, IoCompletionHandler handler);
+    void sendFrontBatch();
     void sendControlResponse(FrameType type);
     void sendControlRequest(FrameType type);
     void onPingTimer();
     void onRead(SystemError::ErrorCode ecode, size_t transferred);
     void onWrite(SystemError::ErrorCode ecode, size_t transferred);
     void callOnReadhandler(SystemError::ErrorCode error, size_t transferred);
-    void callOnWriteHandler(SystemError::ErrorCode error, size_t transferred);
+    void callOnWriteHandler(SystemError::ErrorCode error);
 };
 
 } // namespace websocket
@@ -2,6 +2,18 @@
 
 #include "websocket_common_types.h"
 
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif (defined(_MSC_VER) && (defined(_M_AMD64) || defined(_M_X64))) || defined(__SSE2__)
+    #define NX_WEBSOCKET_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
 namespace nx::network::websocket {
 
 std::string toString(Error error)
@@ -25,4 +37,56 @@ std::string toString(Error error)
     return "unknown";
 }
 
+int copyMasked(
+    const char* src, char* dst, std::size_t size, unsigned int mask, int maskPos)
+{
+    // Rotating the key so that its first byte is applied to src[0]. Since every block size used
+    // below is a multiple of 4, the same key word is applied to all blocks.
+    const auto maskBytes = (const unsigned char*) &mask;
+    unsigned char rotatedBytes[4];
+    for (int i = 0; i < 4; ++i)
+        rotatedBytes[i] = maskBytes[(maskPos + i) % 4];
+    std::uint32_t key = 0;
+    std::memcpy(&key, rotatedBytes, sizeof(key));
+
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i key256 = _mm256_set1_epi32((int) key);
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m256i block = _mm256_loadu_si256((const __m256i*) (src + i));
+        _mm256_storeu_si256((__m256i*) (dst + i), _mm256_xor_si256(block, key256));
+    }
+#elif defined(NX_WEBSOCKET_SSE2)
+    const __m128i key128 = _mm_set1_epi32((int) key);
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i block = _mm_loadu_si128((const __m128i*) (src + i));
+        _mm_storeu_si128((__m128i*) (dst + i), _mm_xor_si128(block, key128));
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t key128 = vreinterpretq_u8_u32(vdupq_n_u32(key));
+    for (; i + 16 <= size; i += 16)
+    {
+        const uint8x16_t block = vld1q_u8((const uint8_t*) (src + i));
+        vst1q_u8((uint8_t*) (dst + i), veorq_u8(block, key128));
+    }
+#endif
+
+    const std::uint64_t key64 = ((std::uint64_t) key << 32) | key;
+    for (; i + 8 <= size; i += 8)
+    {
+        std::uint64_t block = 0;
+        std::memcpy(&block, src + i, sizeof(block));
+        block ^= key64;
+        std::memcpy(dst + i, &block, sizeof(block));
+    }
+
+    for (; i < size; ++i)
+        dst[i] = src[i] ^ rotatedBytes[i % 4];
+
+    return (int) ((maskPos + size) % 4);
+}
+
 } // namespace nx::network::websocket
@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <string>
 
@@ -115,5 +118,77 @@ inline bool shouldMessageBeCompressed(
     return payloadLen > kCompressionMessageThreshold;
 }
 
+/**
+ * Parameters of the permessage-deflate extension (rfc7692, section 7.1). The default values are
+ * the ones implied when the parameters are not present in the negotiation.
+ */
+struct DeflateParams
+{
+    static constexpr int kMinWindowBits = 9;
+    static constexpr int kMaxWindowBits = 15;
+
+    bool serverNoContextTakeover = false;
+    bool clientNoContextTakeover = false;
+    int serverMaxWindowBits = kMaxWindowBits;
+    int clientMaxWindowBits = kMaxWindowBits;
+
+    /** Whether the compressor of the endpoint with the given role keeps its state. */
+    bool contextTakeover(Role role) const
+    {
+        return role == Role::server ? !serverNoContextTakeover : !clientNoContextTakeover;
+    }
+
+    /** Window size of the compressor of the endpoint with the given role. */
+    int maxWindowBits(Role role) const
+    {
+        return role == Role::server ? serverMaxWindowBits : clientMaxWindowBits;
+    }
+
+    bool operator==(const DeflateParams&) const = default;
+};
+
+/** Compression statistics of a single connection. */
+struct CompressionStatistics
+{
+    std::uint64_t uncompressedBytesSent = 0;
+    std::uint64_t compressedBytesSent = 0;
+    std::uint64_t compressedBytesReceived = 0;
+    std::uint64_t uncompressedBytesReceived = 0;
+
+    /**
+     * Time spent in zlib. Messages are compressed synchronously in the AIO thread, so this is the
+     * CPU time spent by the thread on the connection compression.
+     */
+    std::chrono::microseconds compressionTime{0};
+    std::chrono::microseconds decompressionTime{0};
+
+    /** Size of the sent data before compression divided by its size after. */
+    double sentCompressionRatio() const
+    {
+        return compressedBytesSent > 0
+            ? (double) uncompressedBytesSent / compressedBytesSent
+            : 0.0;
+    }
+
+    /** Size of the received data after decompression divided by its size before. */
+    double receivedCompressionRatio() const
+    {
+        return compressedBytesReceived > 0
+            ? (double) uncompressedBytesReceived / compressedBytesReceived
+            : 0.0;
+    }
+};
+
+/**
+ * Copies size bytes from src to dst XORing them with the masking key (rfc6455, 5.3). src and dst
+ * may point to the same memory. Uses SIMD instructions where available.
+ * @param mask Masking key as it is stored in the frame header, i.e. its first byte in memory is
+ *     applied first.
+ * @param maskPos Index of the masking key byte to apply to src[0].
+ * @return Index of the masking key byte to apply to the byte following src[size - 1].
+ */
+NX_NETWORK_API int copyMasked(
+    const char* src, char* dst, std::size_t size, unsigned int mask, int maskPos = 0);
+
 } // namespace nx::network::websocket
 
@@ -2,9 +2,13 @@
 
 #include "websocket_handshake.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <nx/utils/cryptographic_hash.h>
 #include <nx/utils/random.h>
 #include <nx/utils/std/algorithm.h>
+#include <nx/utils/std_string_utils.h>
 
 namespace nx::network::websocket {
 
@@ -19,12 +23,77 @@ static const std::string kProtocol = "Sec-WebSocket-Protocol";
 static const std::string kAccept = "Sec-WebSocket-Accept";
 static const std::string kExtension = "Sec-WebSocket-Extensions";
 static const std::string kCompressionAllowed = "permessage-deflate";
+static const std::string kServerNoContextTakeover = "server_no_context_takeover";
+static const std::string kClientNoContextTakeover = "client_no_context_takeover";
+static const std::string kServerMaxWindowBits = "server_max_window_bits";
+static const std::string kClientMaxWindowBits = "client_max_window_bits";
 
 static const std::string kVersionNum = "13";
 static const std::string kMagic = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
 
 static const nx::utils::log::Tag kWebsocketTag{QString("websocket")};
 
+static bool parseWindowBits(std::string_view value, int* windowBits)
+{
+    value = nx::utils::trim(value, "\"");
+    if (value.empty() || value.size() > 2
+        || !std::all_of(value.begin(), value.end(), [](char ch) { return ch >= '0' && ch <= '9'; }))
+    {
+        return false;
+    }
+
+    // zlib does not support raw DEFLATE with 256-byte window, so 8 is not supported.
+    *windowBits = nx::utils::stoi(value);
+    return *windowBits >= DeflateParams::kMinWindowBits
+        && *windowBits <= DeflateParams::kMaxWindowBits;
+}
+
+static std::optional<DeflateParams> parseDeflateExtension(const std::string_view& extension)
+{
+    std::vector<std::string_view> tokens;
+    nx::utils::split(
+        extension, ';',
+        [&tokens](const std::string_view& token) { tokens.push_back(nx::utils::trim(token)); });
+    if (tokens.empty() || nx::utils::stricmp(tokens.front(), kCompressionAllowed) != 0)
+        return std::nullopt;
+
+    DeflateParams params;
+    for (auto it = std::next(tokens.begin()); it != tokens.end(); ++it)
+    {
+        const auto [nameValue, count] = nx::utils::split_n<2>(*it, '=');
+        const auto name = nx::utils::trim(nameValue[0]);
+        const auto value = count > 1 ? nx::utils::trim(nameValue[1]) : std::string_view();
+
+        if (name == kServerNoContextTakeover && value.empty())
+        {
+            params.serverNoContextTakeover = true;
+        }
+        else if (name == kClientNoContextTakeover && value.empty())
+        {
+            params.clientNoContextTakeover = true;
+        }
+        else if (name == kServerMaxWindowBits)
+        {
+            if (!parseWindowBits(value, &params.serverMaxWindowBits))
+                return std::nullopt;
+        }
+        else if (name == kClientMaxWindowBits)
+        {
+            // The parameter without a value in the client offer only means that the client
+            // supports it.
+            if (!value.empty() && !parseWindowBits(value, &params.clientMaxWindowBits))
+                return std::nullopt;
+        }
+        else
+        {
+            // rfc7692, section 5: an offer with an unknown parameter is declined.
+            return std::nullopt;
+        }
+    }
+
+    return params;
+}
+
 static nx::Buffer makeClientKey()
 {
     return nx::Buffer(nx::utils::random::generate(16).toBase64());
@@ -148,6 +217,41 @@ CompressionType compressionType(const nx::network::http::HttpHeaders& headers)
     return CompressionType::none;
 }
 
+std::optional<DeflateParams> deflateParams(const nx::network::http::HttpHeaders& headers)
+{
+    auto [begin, end] = headers.equal_range(kExtension);
+    for (auto it = begin; it != end; ++it)
+    {
+        std::optional<DeflateParams> result;
+        nx::utils::split(
+            it->second, ',',
+            [&result](const std::string_view& extension)
+            {
+                if (!result)
+                    result = parseDeflateExtension(extension);
+            });
+
+        if (result)
+            return result;
+    }
+
+    return std::nullopt;
+}
+
+std::string toString(const DeflateParams& params)
+{
+    std::string result = kCompressionAllowed;
+    if (params.serverNoContextTakeover)
+        result += "; " + kServerNoContextTakeover;
+    if (params.clientNoContextTakeover)
+        result += "; " + kClientNoContextTakeover;
+    if (params.serverMaxWindowBits != DeflateParams::kMaxWindowBits)
+        result += "; " + kServerMaxWindowBits + "=" + std::to_string(params.serverMaxWindowBits);
+    if (params.clientMaxWindowBits != DeflateParams::kMaxWindowBits)
+        result += "; " + kClientMaxWindowBits + "=" + std::to_string(params.clientMaxWindowBits);
+    return result;
+}
+
 Error validateRequest(
     const nx::network::http::Request& request,
     nx::network::http::Response* response,
@@ -183,8 +287,12 @@ Error validateRequest(
     if (websocketProtocolIt != request.headers.cend())
         responseHeaders->emplace(kProtocol, websocketProtocolIt->second);
 
-    if (compressionType(request.headers) != CompressionType::none && !disableCompression)
-        responseHeaders->emplace(kExtension, kCompressionAllowed);
+    if (!disableCompression)
+    {
+        // Accepting the offer as is, so the response contains the same parameters.
+        if (const auto params = deflateParams(request.headers))
+            responseHeaders->emplace(kExtension, toString(*params));
+    }
 
     return Error::noError;
 }
@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <optional>
+#include <string>
+
 #include <nx/network/http/http_async_client.h>
 #include <nx/network/http/http_client.h>
 #include <nx/network/http/http_types.h>
@@ -54,4 +57,18 @@ NX_NETWORK_API Error validateResponse(
 
 NX_NETWORK_API CompressionType compressionType(const nx::network::http::HttpHeaders& headers);
 
+/**
+ * Parses the first permessage-deflate extension with supported parameters in
+ * Sec-WebSocket-Extensions headers. Can be used both for the client offer and the server
+ * response.
+ * @return std::nullopt if there is no such extension.
+ */
+NX_NETWORK_API std::optional<DeflateParams> deflateParams(
+    const nx::network::http::HttpHeaders& headers);
+
+/**
+ * @return Sec-WebSocket-Extensions header value with only the non-default parameters.
+ */
+NX_NETWORK_API std::string toString(const DeflateParams& params);
+
 } // namespace nx::network::websocket
@@ -5,6 +5,7 @@
 #include <nx/utils/gzip/gzip_compressor.h>
 
 #include <algorithm>
+#include <chrono>
 #include <stdint.h>
 
 namespace nx::network::websocket {
@@ -40,13 +41,16 @@ Parser::ParseState Parser::processPayload(char* data, int len)
     int outLen = std::min(len, m_payloadLen);
     if (m_masked)
     {
-        for (int i = 0; i < outLen; i++)
-        {
-            data[i] = data[i] ^ ((unsigned char*)(&m_mask))[m_maskPos % 4];
-            m_maskPos++;
-        }
+        // Unmasking while copying to the frame buffer, so that the payload is passed once.
+        const auto frameBufferSize = m_frameBuffer.size();
+        m_frameBuffer.resize(frameBufferSize + outLen);
+        m_maskPos = copyMasked(
+            data, m_frameBuffer.data() + frameBufferSize, outLen, m_mask, m_maskPos);
+    }
+    else
+    {
+        m_frameBuffer.append(data, outLen);
     }
-    m_frameBuffer.append(data, outLen);
     m_payloadLen -= outLen;
     m_pos += outLen;
     if (m_payloadLen == 0)
@@ -141,6 +145,9 @@ void Parser::handleFrame()
 {
     if (m_doUncompress)
     {
+        const auto startTime = std::chrono::steady_clock::now();
+        m_statistics.compressedBytesReceived += m_frameBuffer.size();
+
         if (nx::utils::bstream::gzip::Compressor::isZlibCompressed(m_frameBuffer))
         {
             // Fallback for vms 5.0 and older.
@@ -149,8 +156,10 @@ void Parser::handleFrame()
         }
         else
         {
+            // The uncompressor keeps its state between messages, which supports the peers
+            // compressing with context takeover.
             m_uncompressor.processData(m_frameBuffer);
-            m_frameBuffer = m_uncompressed;
+            m_frameBuffer = std::move(m_uncompressed);
 
             if (m_fin)
             {
@@ -163,6 +172,10 @@ void Parser::handleFrame()
 
             m_uncompressed.clear();
         }
+
+        m_statistics.uncompressedBytesReceived += m_frameBuffer.size();
+        m_statistics.decompressionTime += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime);
     }
 
     m_frameHandler(m_firstFrame ? m_opCode : FrameType::continuation, m_frameBuffer, m_fin);
@@ -224,4 +237,9 @@ int Parser::frameSize() const
     return m_payloadLen;
 }
 
+const CompressionStatistics& Parser::compressionStatistics() const
+{
+    return m_statistics;
+}
+
 } // namespace nx::network::websocket
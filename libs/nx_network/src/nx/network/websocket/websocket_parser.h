@@ -39,6 +39,9 @@ public:
     FrameType frameType() const;
     int frameSize() const;
 
+    /** Only the fields related to the received data are filled. */
+    const CompressionStatistics& compressionStatistics() const;
+
 private:
     Role m_role;
     GotFrameHandler m_frameHandler;
@@ -57,6 +60,7 @@ private:
     bool m_firstFrame = true;
     bool m_doUncompress = false;
     nx::utils::bstream::gzip::Uncompressor m_uncompressor;
+    CompressionStatistics m_statistics;
 
     void parse(char* data, int len);
     void processPart(
@@ -3,8 +3,8 @@
 #include "websocket_serializer.h"
 
 #include <nx/network/socket_common.h>
+#include <nx/utils/log/log.h>
 #include <nx/utils/random.h>
-#include <nx/utils/gzip/gzip_compressor.h>
 
 #include <stdint.h>
 
@@ -33,43 +33,93 @@ static int payloadLenTypeByLen(int64_t len)
 
 } // namespace <anonymous>
 
-Serializer::Serializer(bool masked, unsigned mask)
+Serializer::Serializer(bool masked, unsigned mask):
+    m_deflater(std::make_unique<nx::utils::bstream::gzip::MessageDeflater>())
 {
     setMasked(masked, mask);
 }
 
 nx::Buffer Serializer::prepareMessage(
     const nx::Buffer& payload, FrameType type, CompressionType compressionType)
+{
+    nx::Buffer frame;
+    prepareMessage(payload, type, compressionType, &frame);
+    return frame;
+}
+
+nx::Buffer Serializer::prepareFrame(const nx::Buffer& payload, FrameType type, bool fin)
+{
+    nx::Buffer frame;
+    prepareFrame(payload, type, fin, &frame);
+    return frame;
+}
+
+void Serializer::prepareMessage(
+    const nx::Buffer& payload,
+    FrameType type,
+    CompressionType compressionType,
+    nx::Buffer* outFrames)
 {
     m_doCompress = shouldMessageBeCompressed(type, compressionType, payload.size());
-    return prepareFrame(payload, type, /*fin*/true);
+    prepareFrame(payload, type, /*fin*/true, outFrames);
 }
 
-nx::Buffer Serializer::prepareFrame(nx::Buffer payload, FrameType type, bool fin)
+void Serializer::prepareFrame(
+    const nx::Buffer& payload, FrameType type, bool fin, nx::Buffer* outFrames)
 {
+    const nx::Buffer* data = &payload;
     if (m_doCompress)
     {
-        payload = nx::utils::bstream::gzip::Compressor::deflateData(std::move(payload));
-        /* https://datatracker.ietf.org/doc/html/rfc7692#section-7.2.3.4
-         * deflateData() generates DEFLATE block with BFINAL bit set.
-         * Such payload should be flushed with empty uncompressed DEFLATE block with BFINAL set to 0.
-         * */
-        payload.append("\x0", 1);
+        const auto startTime = std::chrono::steady_clock::now();
+        m_compressedPayload.resize(0);
+        if (m_deflater->compress(payload, &m_compressedPayload))
+        {
+            m_statistics.compressionTime += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - startTime);
+            m_statistics.uncompressedBytesSent += payload.size();
+            m_statistics.compressedBytesSent += m_compressedPayload.size();
+            data = &m_compressedPayload;
+        }
+        else
+        {
+            NX_DEBUG(this, "Failed to compress a message of %1 bytes, sending it as is",
+                payload.size());
+            m_doCompress = false;
+            // The compression context may be broken, so it is not used for the next messages.
+            setCompressionParams(m_deflater->contextTakeover(), m_deflater->windowBits());
+        }
     }
 
-    nx::Buffer header;
-    int payloadLenType = payloadLenTypeByLen(payload.size());
-    header.resize(calcHeaderSize(m_masked, payloadLenType));
-    memset(header.data(), 0, header.size());
-    fillHeader(header.data(), fin, type, payloadLenType, payload.size());
+    const int payloadLenType = payloadLenTypeByLen(data->size());
+    const int headerSize = calcHeaderSize(m_masked, payloadLenType);
+    const std::size_t frameOffset = outFrames->size();
+
+    outFrames->reserve(frameOffset + headerSize + data->size());
+    // The header bits are set with OR, so the header must be zeroed which resize() does.
+    outFrames->resize(frameOffset + headerSize);
+    fillHeader(outFrames->data() + frameOffset, fin, type, payloadLenType, data->size());
 
     if (m_masked)
     {
-        for (std::size_t i = 0; i < payload.size(); ++i)
-            payload[i] = payload[i] ^ ((unsigned char*) (&m_mask))[i % 4];
+        outFrames->resize(frameOffset + headerSize + data->size());
+        copyMasked(
+            data->data(), outFrames->data() + frameOffset + headerSize, data->size(), m_mask);
     }
+    else
+    {
+        outFrames->append(data->data(), data->size());
+    }
+}
 
-    return header + payload;
+void Serializer::setCompressionParams(bool contextTakeover, int windowBits)
+{
+    m_deflater = std::make_unique<nx::utils::bstream::gzip::MessageDeflater>(
+        contextTakeover, windowBits);
+}
+
+const CompressionStatistics& Serializer::compressionStatistics() const
+{
+    return m_statistics;
 }
 
 void Serializer::setMasked(bool masked, unsigned mask)
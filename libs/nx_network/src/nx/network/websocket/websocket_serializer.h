@@ -2,7 +2,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include <nx/utils/buffer.h>
+#include <nx/utils/gzip/message_deflater.h>
 
 #include "websocket_common_types.h"
 
@@ -14,12 +17,40 @@ public:
     Serializer(bool masked, unsigned mask = 0);
 
     nx::Buffer prepareMessage(const nx::Buffer& payload, FrameType type, CompressionType compressionType);
-    nx::Buffer prepareFrame(nx::Buffer payload, FrameType type, bool fin);
+    nx::Buffer prepareFrame(const nx::Buffer& payload, FrameType type, bool fin);
+
+    /**
+     * Appends the message to outFrames. Several frames can be serialized to the same buffer to
+     * be sent with a single socket call.
+     */
+    void prepareMessage(
+        const nx::Buffer& payload,
+        FrameType type,
+        CompressionType compressionType,
+        nx::Buffer* outFrames);
+
+    /**
+     * Appends the frame to outFrames. The header and the (masked) payload are written to
+     * outFrames directly.
+     */
+    void prepareFrame(const nx::Buffer& payload, FrameType type, bool fin, nx::Buffer* outFrames);
+
+    /**
+     * Sets parameters of the permessage-deflate compression. By default, messages are compressed
+     * without context takeover and with the maximum window size, which any peer can decompress.
+     */
+    void setCompressionParams(bool contextTakeover, int windowBits);
+
+    /** Only the fields related to the sent data are filled. */
+    const CompressionStatistics& compressionStatistics() const;
 
 private:
     bool m_masked = false;
     bool m_doCompress = false;
     unsigned m_mask = 0;
+    std::unique_ptr<nx::utils::bstream::gzip::MessageDeflater> m_deflater;
+    nx::Buffer m_compressedPayload;
+    CompressionStatistics m_statistics;
 
     void setMasked(bool masked, unsigned mask = 0);
     int fillHeader(char* data, bool fin, FrameType opCode, int payloadLenType, int payloadLen);
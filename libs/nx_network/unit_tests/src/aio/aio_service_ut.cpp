@@ -1,10 +1,13 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <future>
 #include <memory>
+#include <thread>
 
 #include <gtest/gtest.h>
 
 #include <nx/network/aio/aio_service.h>
+#include <nx/network/nx_network_ini.h>
 #include <nx/network/system_socket.h>
 #include <nx/network/test_support/synchronous_tcp_server.h>
 #include <nx/utils/random.h>
@@ -193,6 +196,65 @@ TEST_F(AIOService, duplicate_start_monitoring_call_is_ignored)
     thenEventHasBeenReported();
 }
 
+//-------------------------------------------------------------------------------------------------
+
+class AIOServiceLoadBalancing:
+    public ::testing::Test
+{
+protected:
+    virtual void SetUp() override
+    {
+        m_iniTweaks.set(&nx::network::ini().aioThreadLoadAwarePlacement, true);
+        ASSERT_TRUE(m_service.initialize(2));
+    }
+
+    void givenBusyThread()
+    {
+        m_busyThread = m_service.getAllAioThreads().front();
+
+        std::promise<void> done;
+        m_busyThread->post(
+            nullptr,
+            [&done]()
+            {
+                std::this_thread::sleep_for(
+                    AioThread::kLoadMeasurementPeriod + std::chrono::milliseconds(100));
+                done.set_value();
+            });
+        done.get_future().wait();
+    }
+
+    void thenBusyThreadLoadIsReported()
+    {
+        // The load is sampled by the thread itself after the handler returns.
+        while (m_service.statistics().front().loadPercent < 50)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        const auto statistics = m_service.statistics();
+        ASSERT_EQ(2U, statistics.size());
+        ASSERT_GT(statistics.front().handlerCallTime, AioThread::kLoadMeasurementPeriod);
+        ASSERT_LT(statistics.back().loadPercent, 50);
+    }
+
+    void thenNewObjectIsPlacedToAnotherThread()
+    {
+        ASSERT_NE(m_busyThread, m_service.findLeastUsedAioThread());
+    }
+
+private:
+    nx::kit::IniConfig::Tweaks m_iniTweaks;
+    aio::AIOService m_service;
+    AbstractAioThread* m_busyThread = nullptr;
+};
+
+TEST_F(AIOServiceLoadBalancing, busy_thread_is_avoided)
+{
+    givenBusyThread();
+
+    thenBusyThreadLoadIsReported();
+    thenNewObjectIsPlacedToAnotherThread();
+}
+
 } // namespace test
 } // namespace aio
 } // namespace network
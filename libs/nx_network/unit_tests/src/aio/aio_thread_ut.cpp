@@ -1,7 +1,11 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <atomic>
 #include <future>
+#include <iostream>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -198,6 +202,49 @@ TEST_F(AioThread, socket_timer_is_removed_when_deleting_socket)
     thenTimerTaskIsRemovedFromAio();
 }
 
+TEST_F(AioThread, calls_posted_from_several_threads_are_executed_in_posting_order)
+{
+    static constexpr int kProducerCount = 8;
+    static constexpr int kCallsPerProducer = 10'000;
+
+    // Accessed from the AIO thread only.
+    std::vector<std::vector<int>> executedCalls(kProducerCount);
+    std::atomic<int> callsLeft = kProducerCount * kCallsPerProducer;
+    std::promise<void> done;
+
+    std::vector<std::thread> producers;
+    for (int i = 0; i < kProducerCount; ++i)
+    {
+        producers.emplace_back(
+            [&, i]()
+            {
+                for (int j = 0; j < kCallsPerProducer; ++j)
+                {
+                    m_aioThread.post(
+                        nullptr,
+                        [&, i, j]()
+                        {
+                            executedCalls[i].push_back(j);
+                            if (--callsLeft == 0)
+                                done.set_value();
+                        });
+                }
+            });
+    }
+
+    for (auto& producer: producers)
+        producer.join();
+    done.get_future().wait();
+
+    // Calls of different threads may interleave, but calls of one thread keep their order.
+    for (const auto& calls: executedCalls)
+    {
+        ASSERT_EQ(kCallsPerProducer, (int) calls.size());
+        for (int j = 0; j < kCallsPerProducer; ++j)
+            ASSERT_EQ(j, calls[j]);
+    }
+}
+
 //-------------------------------------------------------------------------------------------------
 
 class FailingPollSet:
@@ -288,4 +335,65 @@ TEST_F(AIOThreadWithFailingPollSet, stop_monitoring_does_nothing_after_failed_st
     thenStopMonitoringCompletedSuccessfully();
 }
 
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * Measures throughput of AioThread::post called concurrently by the given number of threads.
+ */
+class AioThreadPostPerformance:
+    public ::testing::TestWithParam<int>
+{
+protected:
+    static constexpr int kTotalCallCount = 1'000'000;
+
+    void runTest()
+    {
+        using namespace std::chrono;
+
+        const int producerCount = GetParam();
+        const int callsPerProducer = kTotalCallCount / producerCount;
+        const int totalCallCount = callsPerProducer * producerCount;
+
+        aio::AioThread aioThread;
+        aioThread.start();
+
+        std::atomic<int> callsDone = 0;
+        const auto startTime = steady_clock::now();
+
+        std::vector<std::thread> producers;
+        for (int i = 0; i < producerCount; ++i)
+        {
+            producers.emplace_back(
+                [&aioThread, &callsDone, callsPerProducer]()
+                {
+                    for (int j = 0; j < callsPerProducer; ++j)
+                        aioThread.post(nullptr, [&callsDone]() { ++callsDone; });
+                });
+        }
+
+        for (auto& producer: producers)
+            producer.join();
+
+        while (callsDone.load() < totalCallCount)
+            std::this_thread::yield();
+
+        const auto duration = duration_cast<milliseconds>(steady_clock::now() - startTime);
+        aioThread.pleaseStop();
+        aioThread.wait();
+
+        std::cout << "post performance. " << producerCount << " producer threads made "
+            << totalCallCount << " calls in " << duration.count() << " ms. That gives "
+            << (totalCallCount * 1000LL / std::max<long long>(duration.count(), 1))
+            << " calls per second" << std::endl;
+    }
+};
+
+TEST_P(AioThreadPostPerformance, DISABLED_post)
+{
+    runTest();
+}
+
+INSTANTIATE_TEST_SUITE_P(AioThread, AioThreadPostPerformance,
+    ::testing::Values(1, 2, 4, 8, 16, 32, 64));
+
 } // namespace nx::network::aio::test
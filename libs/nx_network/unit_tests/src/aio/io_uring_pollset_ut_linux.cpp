@@ -0,0 +1,205 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include <nx/network/aio/io_uring_pollset.h>
+#include <nx/network/aio/pollset.h>
+#include <nx/network/aio/pollset_wrapper.h>
+#include <nx/utils/random.h>
+#include <nx/utils/test_support/utils.h>
+
+#include "pollset_test_common.h"
+#include "pollset_performance_tests.h"
+
+namespace nx::network::aio::test {
+
+class IoUringPollSetHelper
+{
+public:
+    using PollSet = aio::IoUringPollSet;
+
+    bool simulateSocketEvent(Pollable* socket, int /*eventMask*/)
+    {
+        const auto udpSocket = static_cast<UDPSocket*>(socket);
+
+        char buf[16];
+        NX_GTEST_ASSERT_TRUE(udpSocket->sendTo(buf, sizeof(buf), udpSocket->getLocalAddress()));
+
+        return true;
+    }
+
+    std::unique_ptr<Pollable> createRegularSocket()
+    {
+        auto udpSocket = std::make_unique<UDPSocket>(AF_INET);
+        NX_GTEST_ASSERT_TRUE(udpSocket->bind(SocketAddress(HostAddress::localhost, 0)));
+        return udpSocket;
+    }
+
+    std::unique_ptr<Pollable> createSocketOfRandomType()
+    {
+        return createRegularSocket();
+    }
+
+    std::vector<std::unique_ptr<Pollable>> createSocketOfAllSupportedTypes()
+    {
+        std::vector<std::unique_ptr<Pollable>> sockets;
+        sockets.push_back(createRegularSocket());
+        return sockets;
+    }
+};
+
+INSTANTIATE_TYPED_TEST_SUITE_P(IoUringPollSet, PollSetAcceptance, IoUringPollSetHelper);
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * Counts system calls made by the epoll-based PollSet: every poll is an epoll_wait and every
+ * add/remove is an epoll_ctl.
+ */
+class EpollSyscallCounter:
+    public PollSetWrapper<aio::PollSet>
+{
+    using base_type = PollSetWrapper<aio::PollSet>;
+
+public:
+    virtual bool add(Pollable* const sock, EventType eventType, void* userData = nullptr) override
+    {
+        ++m_syscalls;
+        return base_type::add(sock, eventType, userData);
+    }
+
+    virtual void remove(Pollable* const sock, EventType eventType) override
+    {
+        ++m_syscalls;
+        base_type::remove(sock, eventType);
+    }
+
+    virtual int poll(int millisToWait = kInfiniteTimeout) override
+    {
+        ++m_syscalls;
+        return base_type::poll(millisToWait);
+    }
+
+    std::uint64_t syscalls() const { return m_syscalls; }
+
+private:
+    std::uint64_t m_syscalls = 0;
+};
+
+/**
+ * Emulates an AIO thread serving lots of sockets with one-shot asynchronous reads: every reported
+ * socket is read, unsubscribed and subscribed again.
+ */
+class IoUringPollSetPerformance:
+    public ::testing::Test
+{
+protected:
+    static constexpr int kSocketCount = 1000;
+    static constexpr int kIterationCount = 10'000;
+
+    struct Result
+    {
+        std::uint64_t syscalls = 0;
+        std::chrono::microseconds p50Latency{0};
+        std::chrono::microseconds p99Latency{0};
+    };
+
+    virtual void SetUp() override
+    {
+        if (!IoUringPollSet::isSupported())
+            GTEST_SKIP() << "io_uring is not supported by the kernel";
+
+        for (int i = 0; i < kSocketCount; ++i)
+        {
+            auto socket = std::make_unique<UDPSocket>(AF_INET);
+            ASSERT_TRUE(socket->bind(SocketAddress(HostAddress::localhost, 0)));
+            ASSERT_TRUE(socket->setNonBlockingMode(true));
+            m_sockets.push_back(std::move(socket));
+        }
+    }
+
+    template<typename PollSetType, typename SyscallCountFunc>
+    Result measure(PollSetType* pollSet, SyscallCountFunc syscallCount)
+    {
+        using namespace std::chrono;
+
+        for (const auto& socket: m_sockets)
+            pollSet->add(socket.get(), aio::etRead);
+
+        const auto initialSyscallCount = syscallCount();
+        std::vector<microseconds> latencies;
+        latencies.reserve(kIterationCount);
+
+        char buf[16];
+        for (int i = 0; i < kIterationCount; ++i)
+        {
+            auto& socket = nx::utils::random::choice(m_sockets);
+            const auto sendTime = steady_clock::now();
+            NX_GTEST_ASSERT_TRUE(socket->sendTo(buf, sizeof(buf), socket->getLocalAddress()));
+
+            bool reported = false;
+            while (!reported)
+            {
+                NX_GTEST_ASSERT_GT(pollSet->poll(), 0);
+                auto it = pollSet->getSocketEventsIterator();
+                while (it->next())
+                {
+                    auto udpSocket = static_cast<UDPSocket*>(it->socket());
+                    reported |= udpSocket == socket.get();
+                    udpSocket->recv(buf, sizeof(buf), 0);
+                    pollSet->remove(udpSocket, aio::etRead);
+                    pollSet->add(udpSocket, aio::etRead);
+                }
+            }
+            latencies.push_back(duration_cast<microseconds>(steady_clock::now() - sendTime));
+        }
+
+        for (const auto& socket: m_sockets)
+            pollSet->remove(socket.get(), aio::etRead);
+
+        std::sort(latencies.begin(), latencies.end());
+        Result result;
+        result.syscalls = syscallCount() - initialSyscallCount;
+        result.p50Latency = latencies[latencies.size() / 2];
+        result.p99Latency = latencies[latencies.size() * 99 / 100];
+        return result;
+    }
+
+    void print(const char* name, const Result& result)
+    {
+        std::cout << name << ": " << kIterationCount << " events on " << kSocketCount
+            << " sockets. " << result.syscalls << " poll set syscalls ("
+            << (double) result.syscalls / kIterationCount << " per event), latency p50 "
+            << result.p50Latency.count() << " us, p99 " << result.p99Latency.count() << " us"
+            << std::endl;
+    }
+
+private:
+    std::vector<std::unique_ptr<UDPSocket>> m_sockets;
+};
+
+TEST_F(IoUringPollSetPerformance, compare_with_epoll)
+{
+    EpollSyscallCounter epollPollSet;
+    const auto epollResult =
+        measure(&epollPollSet, [&epollPollSet]() { return epollPollSet.syscalls(); });
+
+    IoUringPollSet ioUringPollSet;
+    ASSERT_TRUE(ioUringPollSet.isValid());
+    const auto ioUringResult = measure(
+        &ioUringPollSet,
+        [&ioUringPollSet]() { return ioUringPollSet.statistics().syscalls; });
+
+    print("epoll", epollResult);
+    print("io_uring", ioUringResult);
+
+    ASSERT_LT(ioUringResult.syscalls, epollResult.syscalls);
+}
+
+INSTANTIATE_TYPED_TEST_SUITE_P(IoUringPollSet, PollSetPerformance, aio::IoUringPollSet);
+
+} // namespace nx::network::aio::test
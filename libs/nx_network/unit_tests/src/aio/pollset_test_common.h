@@ -24,6 +24,12 @@ class PollSetAcceptance:
     public ::testing::Test
 {
 protected:
+    virtual void SetUp() override
+    {
+        if (!m_pollset.isValid())
+            GTEST_SKIP() << "The poll set is not supported on this system";
+    }
+
     void initializeSocketOfRandomType();
     void initializeUdtSocket();
     void subscribeSocketsToEvents(int events);
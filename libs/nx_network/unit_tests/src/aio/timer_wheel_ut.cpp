@@ -0,0 +1,300 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nx/network/aio/detail/timer_wheel.h>
+#include <nx/utils/random.h>
+
+namespace nx::network::aio::detail::test {
+
+class TimerWheel:
+    public ::testing::Test
+{
+protected:
+    static constexpr std::int64_t kStartClock = 1'000'000;
+
+    struct Timer
+    {
+        TimerId id = kInvalidTimerId;
+        std::int64_t clock = 0;
+    };
+
+    detail::TimerWheel<int> m_wheel;
+    std::int64_t m_now = kStartClock;
+    /** Reference model: value -> timer. */
+    std::map<int, Timer> m_timers;
+    int m_prevValue = 0;
+
+    void addTimer(std::int64_t clock)
+    {
+        const int value = ++m_prevValue;
+        m_timers[value] = Timer{m_wheel.add(clock, value), clock};
+    }
+
+    void rescheduleRandomTimer(std::int64_t clock)
+    {
+        auto& timer = randomTimer();
+        m_wheel.reschedule(timer.id, clock);
+        timer.clock = clock;
+    }
+
+    void removeRandomTimer()
+    {
+        auto it = randomTimerIter();
+        ASSERT_EQ(it->first, m_wheel.remove(it->second.id));
+        m_timers.erase(it);
+    }
+
+    void advanceClockAndAssertExpiredTimersAreTaken(std::int64_t delta)
+    {
+        m_now += delta;
+
+        while (auto value = m_wheel.takeNextExpired(m_now))
+        {
+            auto it = m_timers.find(*value);
+            ASSERT_NE(m_timers.end(), it);
+            ASSERT_LE(it->second.clock, m_now);
+            m_timers.erase(it);
+        }
+
+        assertNoTimersExpiredBefore(m_now);
+        assertNextClockIsCorrect();
+        ASSERT_EQ(m_timers.size(), m_wheel.size());
+    }
+
+    void assertNoTimersExpiredBefore(std::int64_t clock)
+    {
+        for (const auto& [value, timer]: m_timers)
+            ASSERT_GT(timer.clock, clock);
+    }
+
+    void assertNextClockIsCorrect()
+    {
+        if (m_timers.empty())
+        {
+            ASSERT_EQ(0, m_wheel.nextClock());
+            return;
+        }
+
+        std::int64_t minClock = std::numeric_limits<std::int64_t>::max();
+        for (const auto& [value, timer]: m_timers)
+            minClock = std::min(minClock, timer.clock);
+
+        ASSERT_LE(m_wheel.nextClock(), minClock);
+        ASSERT_GT(m_wheel.nextClock(), m_now);
+        // The clock is exact for timers of the current 64-millisecond interval.
+        if (minClock / 64 == m_now / 64)
+        {
+            ASSERT_EQ(minClock, m_wheel.nextClock());
+        }
+    }
+
+    std::int64_t randomDelay()
+    {
+        switch (nx::utils::random::number<int>(0, 3))
+        {
+            case 0:
+                return nx::utils::random::number<std::int64_t>(0, 63);
+            case 1:
+                return nx::utils::random::number<std::int64_t>(0, 10'000);
+            case 2:
+                return nx::utils::random::number<std::int64_t>(0, 1LL << 30);
+            default:
+                return nx::utils::random::number<std::int64_t>(0, 1LL << 40);
+        }
+    }
+
+private:
+    std::map<int, Timer>::iterator randomTimerIter()
+    {
+        return std::next(
+            m_timers.begin(), nx::utils::random::number<std::size_t>(0, m_timers.size() - 1));
+    }
+
+    Timer& randomTimer()
+    {
+        return randomTimerIter()->second;
+    }
+};
+
+TEST_F(TimerWheel, timers_are_taken_in_clock_order)
+{
+    for (const auto delay: {100, 5, 70'000, 64, 63, 4097})
+        addTimer(m_now + delay);
+    addTimer(m_now - 10);
+
+    std::vector<int> expectedOrder{7, 2, 5, 4, 1, 6, 3};
+    std::vector<int> actualOrder;
+    while (auto value = m_wheel.takeNextExpired(m_now + 100'000))
+        actualOrder.push_back(*value);
+
+    ASSERT_EQ(expectedOrder, actualOrder);
+    ASSERT_TRUE(m_wheel.empty());
+}
+
+TEST_F(TimerWheel, timer_is_not_taken_before_its_clock)
+{
+    addTimer(m_now + 100'000);
+
+    for (std::int64_t clock = m_now; clock < m_now + 100'000; clock += 997)
+    {
+        ASSERT_FALSE(m_wheel.takeNextExpired(clock));
+        ASSERT_GT(m_wheel.nextClock(), clock);
+    }
+
+    ASSERT_EQ(1, m_wheel.takeNextExpired(m_now + 100'000));
+}
+
+TEST_F(TimerWheel, rescheduled_timer_is_taken_at_the_new_clock)
+{
+    addTimer(m_now + 10);
+    rescheduleRandomTimer(m_now + 10'000);
+
+    ASSERT_FALSE(m_wheel.takeNextExpired(m_now + 9'999));
+    ASSERT_EQ(1, m_wheel.takeNextExpired(m_now + 10'000));
+    ASSERT_EQ(1U, m_wheel.statistics().rescheduled);
+}
+
+TEST_F(TimerWheel, removed_timer_is_not_taken)
+{
+    addTimer(m_now + 10);
+    removeRandomTimer();
+
+    ASSERT_FALSE(m_wheel.takeNextExpired(m_now + 10));
+    ASSERT_TRUE(m_wheel.empty());
+    ASSERT_EQ(0, m_wheel.nextClock());
+}
+
+TEST_F(TimerWheel, timer_beyond_the_wheel_range_is_taken_in_time)
+{
+    const std::int64_t clock = m_now + (1LL << 40);
+    addTimer(clock);
+
+    ASSERT_FALSE(m_wheel.takeNextExpired(clock - 1));
+    ASSERT_EQ(1, m_wheel.takeNextExpired(clock));
+}
+
+TEST_F(TimerWheel, matches_reference_model)
+{
+    for (int i = 0; i < 100'000; ++i)
+    {
+        switch (nx::utils::random::number<int>(0, 9))
+        {
+            case 0:
+            case 1:
+            case 2:
+            case 3:
+                addTimer(m_now + randomDelay() - nx::utils::random::number<int>(0, 2));
+                break;
+
+            case 4:
+                if (!m_timers.empty())
+                    rescheduleRandomTimer(m_now + randomDelay());
+                break;
+
+            case 5:
+                if (!m_timers.empty())
+                    removeRandomTimer();
+                break;
+
+            default:
+                advanceClockAndAssertExpiredTimersAreTaken(
+                    nx::utils::random::number<int>(0, 2) == 0
+                        ? randomDelay()
+                        : nx::utils::random::number<std::int64_t>(0, 100));
+                break;
+        }
+
+        if (HasFatalFailure())
+            return;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * Emulates socket timeouts: lots of timers that are rescheduled much more often than they expire.
+ */
+class TimerWheelPerformance:
+    public ::testing::Test
+{
+protected:
+    static constexpr int kTimerCount = 100'000;
+    static constexpr int kIterationCount = 1'000'000;
+
+    template<typename AddFunc, typename RescheduleFunc, typename TakeFunc>
+    std::chrono::milliseconds measure(AddFunc add, RescheduleFunc reschedule, TakeFunc take)
+    {
+        using namespace std::chrono;
+
+        const auto startTime = steady_clock::now();
+
+        std::int64_t now = 0;
+        for (int i = 0; i < kTimerCount; ++i)
+            add(i, now + nx::utils::random::number<int>(1'000, 60'000));
+
+        for (int i = 0; i < kIterationCount; ++i)
+        {
+            if (i % 100 == 0)
+            {
+                ++now;
+                take(now);
+            }
+
+            reschedule(i % kTimerCount, now + nx::utils::random::number<int>(1'000, 60'000));
+        }
+
+        return duration_cast<milliseconds>(steady_clock::now() - startTime);
+    }
+};
+
+TEST_F(TimerWheelPerformance, DISABLED_compare_with_multimap)
+{
+    std::multimap<std::int64_t, int> map;
+    std::vector<std::multimap<std::int64_t, int>::iterator> mapIters(kTimerCount, map.end());
+    const auto mapDuration = measure(
+        [&](int timer, std::int64_t clock) { mapIters[timer] = map.emplace(clock, timer); },
+        [&](int timer, std::int64_t clock)
+        {
+            if (mapIters[timer] == map.end())
+                return;
+            map.erase(mapIters[timer]);
+            mapIters[timer] = map.emplace(clock, timer);
+        },
+        [&](std::int64_t now)
+        {
+            while (!map.empty() && map.begin()->first <= now)
+            {
+                mapIters[map.begin()->second] = map.end();
+                map.erase(map.begin());
+            }
+        });
+
+    detail::TimerWheel<int> wheel;
+    std::vector<TimerId> wheelIds(kTimerCount, kInvalidTimerId);
+    const auto wheelDuration = measure(
+        [&](int timer, std::int64_t clock) { wheelIds[timer] = wheel.add(clock, timer); },
+        [&](int timer, std::int64_t clock)
+        {
+            if (wheelIds[timer] != kInvalidTimerId)
+                wheel.reschedule(wheelIds[timer], clock);
+        },
+        [&](std::int64_t now)
+        {
+            while (auto timer = wheel.takeNextExpired(now))
+                wheelIds[*timer] = kInvalidTimerId;
+        });
+
+    std::cout << kTimerCount << " timers, " << kIterationCount << " reschedules. "
+        << "std::multimap: " << mapDuration.count() << " ms, "
+        << "timer wheel: " << wheelDuration.count() << " ms ("
+        << wheel.statistics().cascaded << " cascades)" << std::endl;
+}
+
+} // namespace nx::network::aio::detail::test
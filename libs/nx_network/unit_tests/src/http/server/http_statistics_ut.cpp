@@ -380,8 +380,8 @@ TEST_F(MultiEndpointServerHttpStatistics, percentiles_present)
     while (requestsHandled != 100)
         std::this_thread::sleep_for(std::chrono::milliseconds(1));
 
-    // Need to advance time past initial collection period to trigger value caching in the
-    // PercentilePerPeriod instances.
+    // Need to advance time past initial collection period to make the collected histogram the
+    // reported one.
     fixedTime.applyRelativeShift(std::chrono::minutes(1));
 
     auto stats = whenRequestHttpStatistics();
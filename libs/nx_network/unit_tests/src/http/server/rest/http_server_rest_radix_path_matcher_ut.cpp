@@ -0,0 +1,267 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include <nx/network/http/server/rest/http_server_rest_radix_path_matcher.h>
+
+namespace nx::network::http::server::rest::test {
+
+class RestRadixPathMatcher:
+    public ::testing::Test
+{
+protected:
+    void givenRegisteredPaths(const std::vector<std::string>& pathTemplates)
+    {
+        for (const auto& pathTemplate: pathTemplates)
+        {
+            ASSERT_TRUE(m_regexMatcher.add(pathTemplate, m_pathCount));
+            ASSERT_TRUE(m_radixMatcher.add(pathTemplate, m_pathCount));
+            ++m_pathCount;
+        }
+    }
+
+    void assertPathMatches(
+        const std::string& path,
+        int expectedValue,
+        RequestPathParams expectedParams)
+    {
+        const auto result = m_radixMatcher.match(path);
+
+        ASSERT_TRUE(static_cast<bool>(result));
+        ASSERT_EQ(expectedValue, result->value);
+        ASSERT_EQ(expectedParams, result->pathParams);
+
+        assertMatchedAsRegexMatcherDoes(path);
+    }
+
+    void assertPathNotMatched(const std::string& path)
+    {
+        ASSERT_FALSE(m_radixMatcher.match(path));
+
+        assertMatchedAsRegexMatcherDoes(path);
+    }
+
+    void assertMatchedAsRegexMatcherDoes(const std::string& path)
+    {
+        const auto expected = m_regexMatcher.match(path);
+        const auto actual = m_radixMatcher.match(path);
+
+        ASSERT_EQ((bool) expected, (bool) actual) << path;
+        if (!expected)
+            return;
+
+        ASSERT_EQ(expected->value, actual->value) << path;
+        ASSERT_EQ(expected->pathTemplate, actual->pathTemplate) << path;
+        ASSERT_EQ(expected->pathParams, actual->pathParams) << path;
+    }
+
+    const RadixPathMatcher<int>& radixMatcher() const { return m_radixMatcher; }
+    const PathMatcher<int>& regexMatcher() const { return m_regexMatcher; }
+
+private:
+    PathMatcher<int> m_regexMatcher;
+    RadixPathMatcher<int> m_radixMatcher;
+    int m_pathCount = 0;
+};
+
+TEST_F(RestRadixPathMatcher, first_registered_template_wins)
+{
+    givenRegisteredPaths({
+        "/account/{accountId}/systems",
+        "/account/self/systems",
+        "/account/self/{resource}",
+        "/account/{accountId}"});
+
+    assertPathMatches("/account/self/systems", 0, {{"accountId", "self"}});
+    assertPathMatches("/account/self/users", 2, {{"resource", "users"}});
+    assertPathMatches("/account/self", 3, {{"accountId", "self"}});
+    assertPathNotMatched("/account/self/");
+}
+
+TEST_F(RestRadixPathMatcher, literals_with_common_prefix)
+{
+    givenRegisteredPaths({"/system", "/systems", "/sys", "/systems/{id}/users", "/SYSTEMS/x"});
+
+    assertPathMatches("/sys", 2, {});
+    assertPathMatches("/System", 0, {});
+    assertPathMatches("/systems", 1, {});
+    assertPathMatches("/systems/x", 4, {});
+    assertPathMatches("/systems/1/users", 3, {{"id", "1"}});
+    assertPathNotMatched("/systemsx");
+    assertPathNotMatched("/sy");
+}
+
+TEST_F(RestRadixPathMatcher, parameters_inside_path_segment)
+{
+    givenRegisteredPaths({"/files/{name}-{version}", "/items/{a}{b}/info", "/v{version}/info"});
+
+    assertPathMatches("/files/a-b-c", 0, {{"name", "a-b"}, {"version", "c"}});
+    assertPathMatches("/v2/info", 2, {{"version", "2"}});
+    assertPathNotMatched("/files/a-");
+    assertPathNotMatched("/v/info");
+
+    // The first parameter takes the whole segment, so the second one is empty.
+    assertPathNotMatched("/items/ab/info");
+}
+
+TEST_F(RestRadixPathMatcher, any_suffix)
+{
+    givenRegisteredPaths({"/relay/server/{serverId}/.*", "/relay/server/{serverId}/info"});
+
+    assertPathMatches("/relay/server/s1/", 0, {{"serverId", "s1"}});
+    assertPathMatches("/relay/server/s1/info", 0, {{"serverId", "s1"}});
+    assertPathMatches("/relay/server/s1/a/b", 0, {{"serverId", "s1"}});
+    assertPathNotMatched("/relay/server/s1");
+    assertPathNotMatched("/relay/server//a");
+}
+
+TEST_F(RestRadixPathMatcher, regular_expression_templates_keep_registration_order)
+{
+    givenRegisteredPaths({"/files/{name}", "/files/[a-c]*/x", "/file.json", "/files/a/{x}"});
+
+    assertPathMatches("/files/a", 0, {{"name", "a"}});
+    assertPathMatches("/files/abc/x", 1, {});
+    assertPathMatches("/file.json", 2, {});
+    assertPathMatches("/file_json", 2, {});
+    assertPathMatches("/files/a/y", 3, {{"x", "y"}});
+}
+
+TEST_F(RestRadixPathMatcher, invalid_templates_are_not_registered)
+{
+    RadixPathMatcher<int> matcher;
+    ASSERT_TRUE(matcher.add("/account/{accountId}", 0));
+    ASSERT_FALSE(matcher.add("/account/{accountId}", 1));
+    ASSERT_FALSE(matcher.add("/account/{accountId}/subAccount/{accountId}", 2));
+
+    std::string tooManyParams;
+    for (size_t i = 0; i <= RadixPathMatcher<int>::kMaxParamCount; ++i)
+        tooManyParams += "/{p" + std::to_string(i) + "}";
+    ASSERT_FALSE(matcher.add(tooManyParams, 3));
+}
+
+TEST_F(RestRadixPathMatcher, match_view_references_path)
+{
+    givenRegisteredPaths({"/account/{accountId}/system/{systemName}"});
+
+    const std::string path = "/account/a1/system/s1";
+    const auto result = radixMatcher().matchView(path);
+
+    ASSERT_TRUE(result);
+    ASSERT_EQ(0, result->value);
+    ASSERT_EQ((std::vector<std::string>{"accountId", "systemName"}), result->paramNames);
+    ASSERT_EQ(path.data() + 9, result->paramValues[0].data());
+    ASSERT_EQ("a1", result->paramValues[0]);
+    ASSERT_EQ("s1", result->paramValues[1]);
+}
+
+TEST_F(RestRadixPathMatcher, matches_as_regex_matcher_random_paths)
+{
+    static const std::vector<std::string> kTemplateParts = {
+        "/a", "/b", "/A", "/ab", "/{p}", "/{q}", "-{r}", "{s}", "/x{t}", ".*", "/c", "/"};
+    static const std::vector<std::string> kPathParts = {
+        "/a", "/b", "/ab", "/AB", "/foo", "/x1", "-", "/", "//", "/c", "z", "x", "/a-b"};
+
+    std::mt19937 random(0);
+    const auto randomString =
+        [&random](const std::vector<std::string>& parts)
+        {
+            std::string result;
+            for (int i = random() % 5; i > 0; --i)
+                result += parts[random() % parts.size()];
+            return result;
+        };
+
+    for (int i = 0; i < 100; ++i)
+    {
+        RadixPathMatcher<int> radix;
+        PathMatcher<int> regex;
+        for (int j = 0; j < 8; ++j)
+        {
+            const auto pathTemplate = randomString(kTemplateParts);
+            ASSERT_EQ(regex.add(pathTemplate, j), radix.add(pathTemplate, j));
+        }
+
+        for (int j = 0; j < 100; ++j)
+        {
+            const auto path = randomString(kPathParts);
+            const auto expected = regex.match(path);
+            const auto actual = radix.match(path);
+            ASSERT_EQ((bool) expected, (bool) actual) << path;
+            if (expected)
+            {
+                ASSERT_EQ(expected->value, actual->value) << path;
+                ASSERT_EQ(expected->pathParams, actual->pathParams) << path;
+            }
+        }
+    }
+}
+
+TEST_F(RestRadixPathMatcher, DISABLED_performance)
+{
+    static const std::vector<std::string> kResources = {
+        "users", "systems", "servers", "devices", "layouts", "videowalls", "storages",
+        "eventRules", "webPages", "licenses", "userGroups", "analytics", "bookmarks",
+        "plugins", "jobs", "metrics"};
+    static const std::vector<std::string> kSubResources = {
+        "", "/{id}", "/{id}/info", "/{id}/status", "/{id}/settings", "/{id}/attributes",
+        "/{id}/children/{childId}", "/{id}/history", "/{id}/history/{time}", "/{id}/files/.*",
+        "/search", "/count", "/{id}/restart", "/{id}/{param}/value", "/statistics",
+        "/{id}/relations", "/{id}/image.jpg", "/{id}/backup", "/{id}/footage/{period}"};
+
+    std::vector<std::string> routes;
+    std::vector<std::string> paths;
+    for (const auto& version: {"v1", "v2"})
+    {
+        for (const auto& resource: kResources)
+        {
+            for (const auto& subResource: kSubResources)
+            {
+                routes.push_back(std::string("/rest/") + version + "/" + resource + subResource);
+                std::string path = routes.back();
+                for (const auto& [param, value]: std::vector<std::pair<std::string, std::string>>{
+                    {"{id}", "5b1dbd1e-04c9-4b91-9d83-1c7e31ce0c8f"}, {"{childId}", "12"},
+                    {"{time}", "1660000000000"}, {"{param}", "name"}, {"{period}", "day"},
+                    {".*", "x/y"}})
+                {
+                    if (const auto pos = path.find(param); pos != std::string::npos)
+                        path.replace(pos, param.size(), value);
+                }
+                paths.push_back(std::move(path));
+            }
+        }
+    }
+    givenRegisteredPaths(routes);
+    std::cout << routes.size() << " routes" << std::endl;
+
+    const auto measure =
+        [&paths](const char* name, const auto& matcher)
+        {
+            static constexpr int kRepeatCount = 10;
+            int matchedCount = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kRepeatCount; ++i)
+            {
+                for (const auto& path: paths)
+                    matchedCount += matcher.match(path) ? 1 : 0;
+            }
+            const auto duration = std::chrono::steady_clock::now() - start;
+
+            ASSERT_EQ((int) paths.size() * kRepeatCount, matchedCount);
+            std::cout << name << ": "
+                << std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()
+                    / matchedCount
+                << " ns per match" << std::endl;
+        };
+
+    measure("Regex matcher", regexMatcher());
+    measure("Radix matcher", radixMatcher());
+
+    for (const auto& path: paths)
+        assertMatchedAsRegexMatcherDoes(path);
+}
+
+} // namespace nx::network::http::server::rest::test
@@ -2,8 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <nx/network/aio/aio_service.h>
 #include <nx/network/http/http_client.h>
 #include <nx/network/http/test_http_server.h>
+#include <nx/network/socket_global.h>
 #include <nx/network/url/url_builder.h>
 
 #include <nx/network/maintenance/request_path.h>
@@ -50,6 +52,9 @@ protected:
         const auto [statistics, err] =
             nx::reflect::json::deserialize<statistics::Statistics>(*msgBody);
         ASSERT_TRUE(statistics.uptimeMsec >= std::chrono::milliseconds(1));
+        ASSERT_EQ(
+            SocketGlobals::aioService().getAllAioThreads().size(),
+            statistics.aioThreads.size());
 
         NX_DEBUG(this, "serialized: %1", *msgBody);
         NX_DEBUG(this, "server uptime: %1", statistics.uptimeMsec);
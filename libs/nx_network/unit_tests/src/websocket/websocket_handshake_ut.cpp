@@ -1,5 +1,8 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <optional>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include <nx/network/websocket/websocket_handshake.h>
@@ -125,6 +128,79 @@ TEST(WebsocketHandshake, validateRequest_response_Compression)
     ASSERT_EQ(response.headers.find("Sec-WebSocket-Extensions")->second, "permessage-deflate");
 }
 
+static std::optional<std::string> extensionsAcceptedByServer(const std::string& offer)
+{
+    nx::network::http::Request request;
+    givenCorrectRequestLine(&request);
+    givenCorrectRequestHeaders(&request);
+    request.headers.emplace("Sec-WebSocket-Extensions", offer);
+
+    nx::network::http::Response response;
+    if (validateRequest(request, &response.headers) != Error::noError)
+        return std::nullopt;
+
+    const auto it = response.headers.find("Sec-WebSocket-Extensions");
+    if (it == response.headers.cend())
+        return std::string();
+    return it->second;
+}
+
+TEST(WebsocketHandshake, deflateParams)
+{
+    nx::network::http::HttpHeaders headers;
+    ASSERT_FALSE(deflateParams(headers));
+
+    headers.emplace("Sec-WebSocket-Extensions",
+        "x-webkit-deflate-frame, permessage-deflate; client_no_context_takeover; "
+        "server_max_window_bits=10; client_max_window_bits");
+    const auto params = deflateParams(headers);
+    ASSERT_TRUE(params);
+    ASSERT_FALSE(params->serverNoContextTakeover);
+    ASSERT_TRUE(params->clientNoContextTakeover);
+    ASSERT_EQ(10, params->serverMaxWindowBits);
+    ASSERT_EQ(DeflateParams::kMaxWindowBits, params->clientMaxWindowBits);
+
+    ASSERT_TRUE(params->contextTakeover(Role::server));
+    ASSERT_FALSE(params->contextTakeover(Role::client));
+    ASSERT_EQ(10, params->maxWindowBits(Role::server));
+    ASSERT_EQ(DeflateParams::kMaxWindowBits, params->maxWindowBits(Role::client));
+}
+
+TEST(WebsocketHandshake, deflateParams_toString)
+{
+    ASSERT_EQ("permessage-deflate", toString(DeflateParams()));
+
+    DeflateParams params;
+    params.serverNoContextTakeover = true;
+    params.clientMaxWindowBits = 9;
+    ASSERT_EQ("permessage-deflate; server_no_context_takeover; client_max_window_bits=9",
+        toString(params));
+
+    nx::network::http::HttpHeaders headers;
+    headers.emplace("Sec-WebSocket-Extensions", toString(params));
+    ASSERT_EQ(params, deflateParams(headers));
+}
+
+TEST(WebsocketHandshake, validateRequest_response_CompressionParams)
+{
+    ASSERT_EQ("permessage-deflate; server_no_context_takeover; client_max_window_bits=10",
+        extensionsAcceptedByServer(
+            "permessage-deflate; server_no_context_takeover; client_max_window_bits=10"));
+
+    ASSERT_EQ("permessage-deflate; client_no_context_takeover",
+        extensionsAcceptedByServer(
+            "permessage-deflate; unknown_param, permessage-deflate; client_no_context_takeover"));
+}
+
+TEST(WebsocketHandshake, validateRequest_response_InvalidCompressionParamsAreDeclined)
+{
+    ASSERT_EQ("", extensionsAcceptedByServer("permessage-deflate; unknown_param"));
+    ASSERT_EQ("", extensionsAcceptedByServer("permessage-deflate; server_max_window_bits=8"));
+    ASSERT_EQ("", extensionsAcceptedByServer("permessage-deflate; server_max_window_bits=16"));
+    ASSERT_EQ("", extensionsAcceptedByServer("permessage-deflate; server_max_window_bits"));
+    ASSERT_EQ("", extensionsAcceptedByServer("permessage-deflate; client_no_context_takeover=1"));
+}
+
 TEST(WebsocketHandshake, addClientHeaders)
 {
     nx::network::http::Request request;
@@ -2,7 +2,10 @@
 
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <iostream>
 #include <iterator>
+#include <string>
 #include <thread>
 #include <cstring>
 #include <gtest/gtest.h>
@@ -140,3 +143,175 @@ INSTANTIATE_TEST_SUITE_P(WebsocketParserSerializer_differentCompressionModes,
         ParserTestParams(CompressionType::perMessageDeflate, 20),
         ParserTestParams(CompressionType::none, 1000),
         ParserTestParams(CompressionType::perMessageDeflate, 1000)));
+
+TEST(WebsocketMask, copyMasked_matches_bytewise_masking)
+{
+    static constexpr unsigned int kMask = 0xfa121a23;
+    const auto maskBytes = (const unsigned char*) &kMask;
+
+    std::vector<char> source(200);
+    for (std::size_t i = 0; i < source.size(); ++i)
+        source[i] = (char) (i * 7);
+
+    // Unaligned offsets and sizes around the block sizes are checked.
+    for (int offset = 0; offset < 4; ++offset)
+    {
+        for (std::size_t size = 0; size + offset <= source.size(); ++size)
+        {
+            for (int maskPos = 0; maskPos < 4; ++maskPos)
+            {
+                std::vector<char> expected(size);
+                for (std::size_t i = 0; i < size; ++i)
+                    expected[i] = source[offset + i] ^ maskBytes[(maskPos + i) % 4];
+
+                std::vector<char> actual(size + 1);
+                const int nextMaskPos = copyMasked(
+                    source.data() + offset, actual.data() + 1, size, kMask, maskPos);
+                ASSERT_EQ((int) ((maskPos + size) % 4), nextMaskPos);
+                ASSERT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin() + 1));
+
+                std::vector<char> inPlace(source.begin() + offset, source.begin() + offset + size);
+                copyMasked(inPlace.data(), inPlace.data(), size, kMask, maskPos);
+                ASSERT_EQ(expected, inPlace);
+            }
+        }
+    }
+}
+
+TEST(WebsocketSerializer, frames_appended_to_same_buffer_are_parsed)
+{
+    std::vector<nx::Buffer> payloads;
+    Parser parser(
+        Role::server,
+        [&payloads](FrameType, const nx::Buffer& payload, bool) { payloads.push_back(payload); });
+
+    Serializer serializer(/*masked*/true, 0x12345678);
+    nx::Buffer frames;
+    serializer.prepareMessage("first", FrameType::binary, CompressionType::none, &frames);
+    serializer.prepareMessage(
+        fillDummyPayload(70000), FrameType::binary, CompressionType::none, &frames);
+    serializer.prepareMessage("third", FrameType::text, CompressionType::none, &frames);
+    parser.consume(frames);
+
+    ASSERT_EQ(3, payloads.size());
+    ASSERT_EQ("first", payloads[0]);
+    ASSERT_EQ(fillDummyPayload(70000), payloads[1]);
+    ASSERT_EQ("third", payloads[2]);
+}
+
+static std::vector<nx::Buffer> jsonMessages(int count)
+{
+    std::vector<nx::Buffer> messages;
+    for (int i = 0; i < count; ++i)
+    {
+        messages.push_back(nx::Buffer(
+            "{\"jsonrpc\": \"2.0\", \"method\": \"rest.v3.servers.info.update\", "
+            "\"params\": {\"id\": \"" + std::to_string(i) + "\", \"status\": \"Online\", "
+            "\"url\": \"https://localhost:7001/rest/v3/servers/" + std::to_string(i * 7) + "\"}}"));
+    }
+    return messages;
+}
+
+class WebsocketCompression: public ::testing::TestWithParam<bool>
+{
+};
+
+TEST_P(WebsocketCompression, messages_are_decompressed)
+{
+    const bool contextTakeover = GetParam();
+    const auto messages = jsonMessages(100);
+
+    std::vector<nx::Buffer> payloads;
+    Parser parser(
+        Role::server,
+        [&payloads](FrameType, const nx::Buffer& payload, bool) { payloads.push_back(payload); });
+
+    Serializer serializer(/*masked*/true, 0x12345678);
+    serializer.setCompressionParams(contextTakeover, DeflateParams::kMaxWindowBits);
+    for (const auto& message: messages)
+    {
+        parser.consume(serializer.prepareMessage(
+            message, FrameType::text, CompressionType::perMessageDeflate));
+    }
+
+    ASSERT_EQ(messages, payloads);
+
+    const auto& sent = serializer.compressionStatistics();
+    ASSERT_GT(sent.uncompressedBytesSent, sent.compressedBytesSent);
+    const auto& received = parser.compressionStatistics();
+    ASSERT_EQ(sent.uncompressedBytesSent, received.uncompressedBytesReceived);
+    ASSERT_EQ(sent.compressedBytesSent, received.compressedBytesReceived);
+}
+
+INSTANTIATE_TEST_SUITE_P(ContextTakeover, WebsocketCompression, ::testing::Values(false, true));
+
+TEST(WebsocketCompression, DISABLED_context_takeover_performance)
+{
+    static constexpr int kMessageCount = 10000;
+    const auto messages = jsonMessages(kMessageCount);
+
+    for (const bool contextTakeover: {false, true})
+    {
+        Parser parser(Role::client, [](FrameType, const nx::Buffer&, bool) {});
+        Serializer serializer(/*masked*/false, 0);
+        serializer.setCompressionParams(contextTakeover, DeflateParams::kMaxWindowBits);
+        for (const auto& message: messages)
+        {
+            parser.consume(serializer.prepareMessage(
+                message, FrameType::text, CompressionType::perMessageDeflate));
+        }
+
+        const auto& sent = serializer.compressionStatistics();
+        const auto& received = parser.compressionStatistics();
+        std::cout << (contextTakeover ? "Context takeover" : "No context takeover")
+            << ": compression ratio " << sent.sentCompressionRatio()
+            << ", compression " << sent.compressionTime.count() * 1000 / kMessageCount
+            << " ns per message, decompression "
+            << received.decompressionTime.count() * 1000 / kMessageCount << " ns per message"
+            << std::endl;
+    }
+}
+
+TEST(WebsocketParserSerializer, DISABLED_performance)
+{
+    static constexpr int kPayloadSize = 64 * 1024;
+    static constexpr int kMessageCount = 2000;
+
+    const auto payload = fillDummyPayload(kPayloadSize);
+
+    for (const bool masked: {false, true})
+    {
+        std::size_t receivedSize = 0;
+        Parser parser(
+            masked ? Role::server : Role::client,
+            [&receivedSize](FrameType, const nx::Buffer& frame, bool)
+            {
+                receivedSize += frame.size();
+            });
+        Serializer serializer(masked, 0x12345678);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kMessageCount; ++i)
+        {
+            auto frame =
+                serializer.prepareMessage(payload, FrameType::binary, CompressionType::none);
+            parser.consume(frame);
+        }
+        const auto duration = std::chrono::steady_clock::now() - start;
+
+        ASSERT_EQ((std::size_t) kPayloadSize * kMessageCount, receivedSize);
+        std::cout << (masked ? "Masked" : "Not masked") << " messages: "
+            << (int64_t) (receivedSize / std::chrono::duration<double>(duration).count() / 1e6)
+            << " MB/s" << std::endl;
+    }
+
+    std::vector<char> data(kPayloadSize);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kMessageCount; ++i)
+        copyMasked(data.data(), data.data(), data.size(), 0x12345678);
+    const auto duration = std::chrono::steady_clock::now() - start;
+    std::cout << "Unmasking: "
+        << (int64_t) ((double) kPayloadSize * kMessageCount
+            / std::chrono::duration<double>(duration).count() / 1e6)
+        << " MB/s" << std::endl;
+}
@@ -408,6 +408,29 @@ protected:
         readyFuture.wait();
     }
 
+    void whenClientSendsWithoutWaitingForCompletion(int messageCount)
+    {
+        auto readyPromise = std::make_shared<nx::utils::promise<void>>();
+        auto readyFuture = readyPromise->get_future();
+        auto sentCount = std::make_shared<int>(0);
+
+        for (int i = 0; i < messageCount; ++i)
+        {
+            clientWebSocket->sendAsync(
+                &clientSendBuf,
+                [this, sentCount, messageCount, readyPromise](
+                    SystemError::ErrorCode error, size_t transferred)
+                {
+                    ASSERT_EQ(SystemError::noError, error);
+                    ASSERT_EQ(clientSendBuf.size(), transferred);
+                    if (++(*sentCount) == messageCount)
+                        readyPromise->set_value();
+                });
+        }
+
+        readyFuture.wait();
+    }
+
     void whenServerStartsReading()
     {
         serverReadCb =
@@ -1238,6 +1261,18 @@ TEST_P(WebSocket, imcomingMessagesQueueOverflow)
     thenAllMessagesShouldBeReceived(/*messageCount*/1100);
 }
 
+TEST_P(WebSocket, messagesQueuedWhileSendingAreDelivered)
+{
+    givenClientModes(SendMode::singleMessage, ReceiveMode::message);
+    givenServerModes(SendMode::singleMessage, ReceiveMode::message);
+    givenClientTestDataPrepared(100);
+    givenServerClientWebSockets();
+
+    whenServerStartsReading();
+    whenClientSendsWithoutWaitingForCompletion(/*messageCount*/1000);
+    thenAllMessagesShouldBeReceived(/*messageCount*/1000);
+}
+
 INSTANTIATE_TEST_SUITE_P(Websockets_PingPong_differentCompressionModes,
     WebSocket_PingPong,
     ::testing::Values(CompressionType::none, CompressionType::perMessageDeflate));
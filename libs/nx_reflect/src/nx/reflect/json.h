@@ -4,3 +4,4 @@
 
 #include "json/deserializer.h"
 #include "json/serializer.h"
+#include "json/streaming_deserializer.h"
@@ -2,71 +2,122 @@
 
 #include "serializer.h"
 
+#include <algorithm>
+
+#include <rapidjson/stringbuffer.h>
+
 namespace nx::reflect::json::detail {
 
-JsonComposer::JsonComposer():
-    m_writer(m_buffer)
+void StringOutputStream::reserve(std::size_t count)
+{
+    const auto required = m_text.size() + count;
+    if (required > m_text.capacity())
+        m_text.reserve(std::max(required, m_text.capacity() * 2));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+JsonComposer::JsonComposer(Format format, std::size_t sizeHint):
+    m_writer(m_stream)
+{
+    m_stream.reserve(sizeHint);
+    if (format == Format::pretty)
+        m_prettyWriter.emplace(m_stream);
+}
+
+template<typename Func>
+void JsonComposer::write(Func func)
 {
+    if (m_prettyWriter)
+        func(*m_prettyWriter);
+    else
+        func(m_writer);
 }
 
 void JsonComposer::startArray()
 {
-    m_writer.StartArray();
+    write([](auto& writer) { writer.StartArray(); });
 }
 
 void JsonComposer::endArray()
 {
-    m_writer.EndArray();
+    write([](auto& writer) { writer.EndArray(); });
 }
 
 void JsonComposer::startObject()
 {
-    m_writer.StartObject();
+    write([](auto& writer) { writer.StartObject(); });
 }
 
 void JsonComposer::endObject()
 {
-    m_writer.EndObject();
+    write([](auto& writer) { writer.EndObject(); });
 }
 
 void JsonComposer::writeBool(bool val)
 {
-    m_writer.Bool(val);
+    write([val](auto& writer) { writer.Bool(val); });
 }
 
 void JsonComposer::writeInt(const std::int64_t& val)
 {
-    m_writer.Int64(val);
+    write([val](auto& writer) { writer.Int64(val); });
 }
 
 void JsonComposer::writeFloat(const double& val)
 {
-    m_writer.Double(val);
+    write([val](auto& writer) { writer.Double(val); });
 }
 
 void JsonComposer::writeString(const std::string_view& val)
 {
-    m_writer.String(val.data(), (rapidjson::SizeType) val.size());
+    write([val](auto& writer) { writer.String(val.data(), (rapidjson::SizeType) val.size()); });
 }
 
 void JsonComposer::writeRawString(const std::string_view& val)
 {
-    m_writer.RawValue(val.data(), (rapidjson::SizeType) val.size(), (rapidjson::Type::kStringType));
+    write(
+        [val](auto& writer)
+        {
+            writer.RawValue(val.data(), (rapidjson::SizeType) val.size(), rapidjson::kStringType);
+        });
 }
 
 void JsonComposer::writeNull()
 {
-    m_writer.Null();
+    write([](auto& writer) { writer.Null(); });
 }
 
 void JsonComposer::writeAttributeName(const std::string_view& name)
 {
-    m_writer.Key(name.data(), (rapidjson::SizeType) name.size());
+    write([name](auto& writer) { writer.Key(name.data(), (rapidjson::SizeType) name.size()); });
+}
+
+void JsonComposer::writeQuotedAttributeName(const std::string_view& quotedName)
+{
+    // The writer handles a raw string value exactly as a key: inserts the separators and
+    // indentation but does not escape it again.
+    write(
+        [quotedName](auto& writer)
+        {
+            writer.RawValue(
+                quotedName.data(), (rapidjson::SizeType) quotedName.size(), rapidjson::kStringType);
+        });
 }
 
 std::string JsonComposer::take()
 {
-    return m_buffer.GetString();
+    return std::move(m_stream.text());
+}
+
+//-------------------------------------------------------------------------------------------------
+
+std::string quotedName(const std::string_view& name)
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.String(name.data(), (rapidjson::SizeType) name.size());
+    return std::string(buffer.GetString(), buffer.GetSize());
 }
 
 } // namespace nx::reflect::json::detail
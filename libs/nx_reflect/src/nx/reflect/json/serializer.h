@@ -2,25 +2,64 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <optional>
 #include <string>
+#include <vector>
 
-#include <rapidjson/stringbuffer.h>
+#include <rapidjson/prettywriter.h>
 #include <rapidjson/writer.h>
 
 #include <nx/reflect/basic_serializer.h>
+#include <nx/reflect/generic_visitor.h>
 #include <nx/reflect/type_utils.h>
 
 #include "json_tags.h"
 
 namespace nx::reflect::json {
 
+enum class Format
+{
+    compact,
+    /** Every value on a separate line, indented with 4 spaces. */
+    pretty,
+};
+
 namespace detail {
 
+/**
+ * rapidjson output stream that appends to std::string, so the result can be moved out without
+ * copying.
+ */
+class NX_REFLECT_API StringOutputStream
+{
+public:
+    using Ch = char;
+
+    void Put(char c) { m_text.push_back(c); }
+    void Flush() {}
+
+    void reserve(std::size_t count);
+
+    std::string& text() { return m_text; }
+
+private:
+    std::string m_text;
+};
+
+// Found by ADL from rapidjson::Writer so that escaping a string reserves its space once.
+inline void PutReserve(StringOutputStream& stream, std::size_t count) { stream.reserve(count); }
+inline void PutUnsafe(StringOutputStream& stream, char c) { stream.Put(c); }
+
 class NX_REFLECT_API JsonComposer:
     public AbstractComposer<std::string>
 {
 public:
-    JsonComposer();
+    /**
+     * @param sizeHint Expected size of the result. The output buffer is preallocated for it.
+     */
+    JsonComposer(Format format = Format::compact, std::size_t sizeHint = 0);
 
     virtual void startArray() override;
     virtual void endArray() override;
@@ -34,18 +73,68 @@ public:
     virtual void writeNull() override;
     virtual void writeAttributeName(const std::string_view& name) override;
 
+    /**
+     * Writes the name that is already quoted and escaped (e.g., by quotedName()).
+     */
+    void writeQuotedAttributeName(const std::string_view& quotedName);
+
     virtual std::string take() override;
 
 private:
-    std::string m_text;
-    rapidjson::StringBuffer m_buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> m_writer;
+    template<typename Func>
+    void write(Func func);
+
+private:
+    StringOutputStream m_stream;
+    rapidjson::Writer<StringOutputStream> m_writer;
+    std::optional<rapidjson::PrettyWriter<StringOutputStream>> m_prettyWriter;
+};
+
+/**
+ * @return JSON string literal for name: quoted, with the special characters escaped.
+ */
+NX_REFLECT_API std::string quotedName(const std::string_view& name);
+
+/**
+ * Quoted names of the Data fields in the order they are visited. Computed once per type, so that
+ * the field names are not escaped every time an object is serialized.
+ */
+template<typename Data>
+class QuotedFieldNames:
+    public nx::reflect::GenericVisitor<QuotedFieldNames<Data>>
+{
+public:
+    static const std::vector<std::string>& get()
+    {
+        static const std::vector<std::string> names =
+            []()
+            {
+                QuotedFieldNames visitor;
+                nx::reflect::visitAllFields<Data>(visitor);
+                return std::move(visitor.m_names);
+            }();
+        return names;
+    }
+
+    template<typename WrappedField>
+    void visitField(const WrappedField& field)
+    {
+        m_names.push_back(quotedName(field.name()));
+    }
+
+private:
+    std::vector<std::string> m_names;
 };
 
 struct SerializationContext
 {
     JsonComposer composer;
 
+    SerializationContext(Format format = Format::compact, std::size_t sizeHint = 0):
+        composer(format, sizeHint)
+    {
+    }
+
     template<typename T>
     bool beforeSerialize(const T&)
     {
@@ -86,11 +175,76 @@ void serialize(SerializationContext* ctx, const Data& data)
  * - void toString(const T&, std::string* str)
  */
 template<typename Data>
-std::string serialize(const Data& data)
+std::string serialize(const Data& data, Format format = Format::compact)
 {
-    SerializationContext ctx;
+    // The output buffer is preallocated for the size of the last result of the same type and
+    // format. The hint is capped, and a result much smaller than its buffer gives the unused
+    // memory back, so that one large result does not make the following small ones hold it.
+    static constexpr std::size_t kMaxSizeHint = 1024 * 1024;
+    static constexpr std::size_t kMaxUnusedCapacity = 4 * 1024;
+    static std::atomic<std::size_t> lastSize[2]{};
+    auto& sizeHint = lastSize[format == Format::pretty ? 1 : 0];
+
+    SerializationContext ctx(format, sizeHint.load(std::memory_order_relaxed));
     serialize(&ctx, data);
-    return ctx.composer.take();
+    auto result = ctx.composer.take();
+    sizeHint.store(std::min(result.size(), kMaxSizeHint), std::memory_order_relaxed);
+    if (result.capacity() - result.size() > std::max(result.size(), kMaxUnusedCapacity))
+        result.shrink_to_fit();
+    return result;
 }
 
 } // namespace nx::reflect::json
+
+namespace nx::reflect {
+
+/**
+ * JSON-specific visitor of instrumented types. Writes the field names quoted once per type
+ * instead of escaping them for each serialized object.
+ */
+template<typename Data>
+class Visitor<json::detail::SerializationContext, Data>:
+    public nx::reflect::GenericVisitor<Visitor<json::detail::SerializationContext, Data>>
+{
+public:
+    Visitor(json::detail::SerializationContext* ctx, const Data& data):
+        m_ctx(ctx),
+        m_data(data),
+        m_names(json::detail::QuotedFieldNames<Data>::get())
+    {
+        m_ctx->composer.startObject();
+    }
+
+    ~Visitor()
+    {
+        m_ctx->composer.endObject();
+    }
+
+    template<typename WrappedField>
+    void visitField(const WrappedField& field)
+    {
+        writeAttribute(m_names[m_fieldIndex++], field.get(m_data));
+    }
+
+private:
+    json::detail::SerializationContext* m_ctx = nullptr;
+    const Data& m_data;
+    const std::vector<std::string>& m_names;
+    std::size_t m_fieldIndex = 0;
+
+    template<typename Value>
+    void writeAttribute(const std::string& quotedName, const std::optional<Value>& value)
+    {
+        if (value)
+            writeAttribute(quotedName, *value);
+    }
+
+    template<typename Value>
+    void writeAttribute(const std::string& quotedName, const Value& value)
+    {
+        m_ctx->composer.writeQuotedAttributeName(quotedName);
+        BasicSerializer::serializeAdl(m_ctx, value);
+    }
+};
+
+} // namespace nx::reflect
@@ -0,0 +1,197 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "streaming_deserializer.h"
+
+#include <rapidjson/reader.h>
+
+namespace nx::reflect::json_detail {
+
+void StreamingDeserializer::push(std::unique_ptr<AbstractStreamingFrame> frame)
+{
+    m_stack.push_back(std::move(frame));
+}
+
+bool StreamingDeserializer::fail(DeserializationResult result)
+{
+    for (auto it = m_stack.rbegin(); it != m_stack.rend(); ++it)
+        (*it)->describeError(&result);
+
+    m_error = std::move(result);
+    return false;
+}
+
+DeserializationResult StreamingDeserializer::parse(
+    std::string_view json, std::unique_ptr<AbstractStreamingFrame> root)
+{
+    m_stack.clear();
+    m_stack.push_back(std::move(root));
+    m_skipNextValue = false;
+    m_skippedDepth = 0;
+    m_error.reset();
+
+    std::string buffer(json);
+    rapidjson::InsituStringStream stream(buffer.data());
+    rapidjson::Reader reader;
+    const auto parseResult = reader.Parse<rapidjson::kParseInsituFlag>(stream, *this);
+
+    if (m_error)
+        return std::move(*m_error);
+
+    if (parseResult.IsError())
+        return DeserializationResult(false, parseErrorToString(parseResult), std::string(json));
+
+    return m_stack.front()->finish(m_flags);
+}
+
+template<typename WriteToSubtree>
+bool StreamingDeserializer::scalar(const rapidjson::Value& value, WriteToSubtree writeToSubtree)
+{
+    if (m_skippedDepth > 0)
+        return true;
+
+    if (m_skipNextValue)
+    {
+        m_skipNextValue = false;
+        return true;
+    }
+
+    auto& frame = *m_stack.back();
+    if (auto subtree = frame.subtreeWriter())
+        return writeToSubtree(subtree->writer);
+
+    return frame.value(this, value);
+}
+
+bool StreamingDeserializer::start(bool isObject)
+{
+    if (m_skippedDepth > 0)
+    {
+        ++m_skippedDepth;
+        return true;
+    }
+
+    if (m_skipNextValue)
+    {
+        m_skipNextValue = false;
+        m_skippedDepth = 1;
+        return true;
+    }
+
+    auto& frame = *m_stack.back();
+    if (auto subtree = frame.subtreeWriter())
+    {
+        ++subtree->depth;
+        return isObject ? subtree->writer.StartObject() : subtree->writer.StartArray();
+    }
+
+    return frame.start(this, isObject);
+}
+
+bool StreamingDeserializer::end(bool isObject)
+{
+    if (m_skippedDepth > 0)
+    {
+        --m_skippedDepth;
+        return true;
+    }
+
+    auto& frame = *m_stack.back();
+    if (auto subtree = frame.subtreeWriter())
+    {
+        if (!(isObject ? subtree->writer.EndObject() : subtree->writer.EndArray()))
+            return false;
+
+        if (--subtree->depth > 0)
+            return true;
+    }
+
+    auto result = frame.finish(m_flags);
+    if (!result.success && !ignoresErrors())
+        return fail(std::move(result));
+
+    const auto child = std::move(m_stack.back());
+    m_stack.pop_back();
+    return m_stack.back()->childFinished(this, child.get(), std::move(result));
+}
+
+bool StreamingDeserializer::Null()
+{
+    return scalar(rapidjson::Value(), [](auto& writer) { return writer.Null(); });
+}
+
+bool StreamingDeserializer::Bool(bool value)
+{
+    return scalar(rapidjson::Value(value), [value](auto& writer) { return writer.Bool(value); });
+}
+
+bool StreamingDeserializer::Int(int value)
+{
+    return scalar(rapidjson::Value(value), [value](auto& writer) { return writer.Int(value); });
+}
+
+bool StreamingDeserializer::Uint(unsigned value)
+{
+    return scalar(rapidjson::Value(value), [value](auto& writer) { return writer.Uint(value); });
+}
+
+bool StreamingDeserializer::Int64(int64_t value)
+{
+    return scalar(rapidjson::Value(value), [value](auto& writer) { return writer.Int64(value); });
+}
+
+bool StreamingDeserializer::Uint64(uint64_t value)
+{
+    return scalar(rapidjson::Value(value), [value](auto& writer) { return writer.Uint64(value); });
+}
+
+bool StreamingDeserializer::Double(double value)
+{
+    return scalar(rapidjson::Value(value), [value](auto& writer) { return writer.Double(value); });
+}
+
+bool StreamingDeserializer::RawNumber(const char*, rapidjson::SizeType, bool)
+{
+    // Numbers are not parsed as strings.
+    return false;
+}
+
+bool StreamingDeserializer::String(const char* str, rapidjson::SizeType length, bool copy)
+{
+    return scalar(
+        rapidjson::Value(rapidjson::StringRef(str, length)),
+        [&](auto& writer) { return writer.String(str, length, copy); });
+}
+
+bool StreamingDeserializer::StartObject()
+{
+    return start(/*isObject*/ true);
+}
+
+bool StreamingDeserializer::Key(const char* str, rapidjson::SizeType length, bool copy)
+{
+    if (m_skippedDepth > 0)
+        return true;
+
+    auto& frame = *m_stack.back();
+    if (auto subtree = frame.subtreeWriter())
+        return subtree->writer.Key(str, length, copy);
+
+    return frame.key(this, std::string_view(str, length));
+}
+
+bool StreamingDeserializer::EndObject(rapidjson::SizeType)
+{
+    return end(/*isObject*/ true);
+}
+
+bool StreamingDeserializer::StartArray()
+{
+    return start(/*isObject*/ false);
+}
+
+bool StreamingDeserializer::EndArray(rapidjson::SizeType)
+{
+    return end(/*isObject*/ false);
+}
+
+} // namespace nx::reflect::json_detail
@@ -0,0 +1,743 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <nx/reflect/generic_visitor.h>
+#include <nx/reflect/instrument.h>
+#include <nx/reflect/type_utils.h>
+
+#include "deserializer.h"
+
+namespace nx::reflect {
+
+/**
+ * Custom deserialization functions are found here by ADL only. This namespace is not enclosing
+ * json_detail, so the generic functions from there do not hide the absence of a custom one.
+ */
+namespace json_custom_deserializer_probe {
+
+struct Context
+{
+    operator const json_detail::DeserializationContext&() const;
+};
+
+template<typename T, typename = std::void_t<>>
+struct HasCustomDeserializer: std::false_type {};
+
+template<typename T>
+struct HasCustomDeserializer<
+    T,
+    std::void_t<decltype(deserialize(std::declval<const Context&>(), (T*) nullptr))>>
+:
+    std::true_type
+{
+};
+
+} // namespace json_custom_deserializer_probe
+
+namespace json_detail {
+
+template<typename T>
+inline constexpr bool HasCustomDeserializerV =
+    json_custom_deserializer_probe::HasCustomDeserializer<T>::value;
+
+template<typename T>
+struct IsStdOptional: std::false_type {};
+
+template<typename T>
+struct IsStdOptional<std::optional<T>>: std::true_type {};
+
+class StreamingDeserializer;
+
+/**
+ * Collects a JSON subtree, which is deserialized with the DOM deserializer when it is complete.
+ */
+struct SubtreeWriter
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+    int depth = 0;
+};
+
+/**
+ * State of deserialization of a JSON object or array.
+ */
+class AbstractStreamingFrame
+{
+public:
+    virtual ~AbstractStreamingFrame() = default;
+
+    /** A scalar field value or array element. */
+    virtual bool value(StreamingDeserializer* deserializer, const rapidjson::Value& value) = 0;
+
+    /** An object or array as a field value or array element. Pushes the frame for it. */
+    virtual bool start(StreamingDeserializer* deserializer, bool isObject) = 0;
+
+    virtual bool key(StreamingDeserializer* deserializer, std::string_view name) = 0;
+
+    /** The object or array of this frame has ended. */
+    virtual DeserializationResult finish(int flags) = 0;
+
+    /** The frame pushed by start() has finished with the given result. */
+    virtual bool childFinished(
+        StreamingDeserializer* deserializer,
+        AbstractStreamingFrame* child,
+        DeserializationResult result) = 0;
+
+    /** Adds the location of the error, if the frame knows it. */
+    virtual void describeError(DeserializationResult* /*result*/) const {}
+
+    /** Not null if the frame collects the subtree instead of handling the events. */
+    virtual SubtreeWriter* subtreeWriter() { return nullptr; }
+};
+
+/**
+ * rapidjson SAX handler that passes the events to the frame on top of the stack.
+ */
+class NX_REFLECT_API StreamingDeserializer
+{
+public:
+    explicit StreamingDeserializer(int flags): m_flags(flags) {}
+
+    int flags() const { return m_flags; }
+
+    bool ignoresErrors() const
+    {
+        return m_flags & (int) json::DeserializationFlag::ignoreFieldTypeMismatch;
+    }
+
+    void push(std::unique_ptr<AbstractStreamingFrame> frame);
+
+    /** The next value of the current frame (a scalar, an object or an array) is skipped. */
+    void skipValue() { m_skipNextValue = true; }
+
+    /** Stops the parsing with the error, which gets the location from the frames. */
+    bool fail(DeserializationResult result);
+
+    /**
+     * Parses a copy of the text in place: strings are unescaped in the copy and are referenced by
+     * the events, instead of being allocated one by one.
+     * @param root The frame that receives the top-level value.
+     */
+    DeserializationResult parse(
+        std::string_view json, std::unique_ptr<AbstractStreamingFrame> root);
+
+    //---------------------------------------------------------------------------------------------
+    // rapidjson handler.
+
+    bool Null();
+    bool Bool(bool value);
+    bool Int(int value);
+    bool Uint(unsigned value);
+    bool Int64(int64_t value);
+    bool Uint64(uint64_t value);
+    bool Double(double value);
+    bool RawNumber(const char* str, rapidjson::SizeType length, bool copy);
+    bool String(const char* str, rapidjson::SizeType length, bool copy);
+    bool StartObject();
+    bool Key(const char* str, rapidjson::SizeType length, bool copy);
+    bool EndObject(rapidjson::SizeType memberCount);
+    bool StartArray();
+    bool EndArray(rapidjson::SizeType elementCount);
+
+private:
+    template<typename WriteToSubtree>
+    bool scalar(const rapidjson::Value& value, WriteToSubtree writeToSubtree);
+
+    bool start(bool isObject);
+    bool end(bool isObject);
+
+private:
+    const int m_flags = 0;
+    std::vector<std::unique_ptr<AbstractStreamingFrame>> m_stack;
+    bool m_skipNextValue = false;
+    int m_skippedDepth = 0;
+    std::optional<DeserializationResult> m_error;
+};
+
+template<typename T>
+std::unique_ptr<AbstractStreamingFrame> makeStreamingFrame(T* target, bool isObject, int flags);
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * Frame that produces a value of type T, either into its own storage or into the given target.
+ */
+template<typename T>
+class StreamingValueFrame: public AbstractStreamingFrame
+{
+public:
+    explicit StreamingValueFrame(T* target): m_target(target ? target : &m_value) {}
+
+    T& data() { return *m_target; }
+
+private:
+    T m_value = T();
+    T* m_target = nullptr;
+};
+
+template<typename T>
+T& dataOf(AbstractStreamingFrame* frame)
+{
+    return static_cast<StreamingValueFrame<T>*>(frame)->data();
+}
+
+/**
+ * Deserializes the value with the DOM deserializer. Used for the types that are not natively
+ * supported by the streaming deserializer (variants, custom deserialization functions, etc.) and
+ * for the JSON values of unexpected type, so that the result is exactly the same.
+ */
+template<typename T>
+class DomStreamingFrame: public StreamingValueFrame<T>
+{
+public:
+    DomStreamingFrame(T* target, bool isObject): StreamingValueFrame<T>(target)
+    {
+        if (isObject)
+            m_subtree.writer.StartObject();
+        else
+            m_subtree.writer.StartArray();
+        m_subtree.depth = 1;
+    }
+
+    virtual bool value(StreamingDeserializer*, const rapidjson::Value&) override { return false; }
+    virtual bool start(StreamingDeserializer*, bool) override { return false; }
+    virtual bool key(StreamingDeserializer*, std::string_view) override { return false; }
+
+    virtual DeserializationResult finish(int flags) override
+    {
+        rapidjson::Document document;
+        document.Parse(m_subtree.buffer.GetString(), m_subtree.buffer.GetSize());
+        return deserializeValue(DeserializationContext{document, flags}, &this->data());
+    }
+
+    virtual bool childFinished(
+        StreamingDeserializer*, AbstractStreamingFrame*, DeserializationResult) override
+    {
+        return false;
+    }
+
+    virtual SubtreeWriter* subtreeWriter() override { return &m_subtree; }
+
+private:
+    SubtreeWriter m_subtree;
+};
+
+/**
+ * Receives the top-level value.
+ */
+template<typename T>
+class RootStreamingFrame: public AbstractStreamingFrame
+{
+public:
+    explicit RootStreamingFrame(T* data): m_data(data) {}
+
+    virtual bool value(StreamingDeserializer* deserializer, const rapidjson::Value& value) override
+    {
+        m_result = deserializeValue(DeserializationContext{value, deserializer->flags()}, m_data);
+        return true;
+    }
+
+    virtual bool start(StreamingDeserializer* deserializer, bool isObject) override
+    {
+        deserializer->push(makeStreamingFrame<T>(m_data, isObject, deserializer->flags()));
+        return true;
+    }
+
+    virtual bool key(StreamingDeserializer*, std::string_view) override { return false; }
+
+    virtual DeserializationResult finish(int) override { return m_result; }
+
+    virtual bool childFinished(
+        StreamingDeserializer*, AbstractStreamingFrame*, DeserializationResult result) override
+    {
+        m_result = std::move(result);
+        return true;
+    }
+
+private:
+    T* m_data = nullptr;
+    DeserializationResult m_result{true};
+};
+
+//-------------------------------------------------------------------------------------------------
+// Instrumented types.
+
+template<typename Data>
+class AbstractStreamingField
+{
+public:
+    explicit AbstractStreamingField(std::string_view name): m_name(name) {}
+    virtual ~AbstractStreamingField() = default;
+
+    std::string_view name() const { return m_name; }
+
+    virtual DeserializationResult deserialize(
+        Data* data, const rapidjson::Value& value, int flags) const = 0;
+
+    virtual std::unique_ptr<AbstractStreamingFrame> makeFrame(bool isObject, int flags) const = 0;
+
+    virtual void set(
+        Data* data, AbstractStreamingFrame* frame, const DeserializationResult& result) const = 0;
+
+    /** Called if the field is missing in the JSON object. */
+    virtual void setMissing(Data* data) const = 0;
+
+private:
+    std::string_view m_name;
+};
+
+/**
+ * Follows json_detail::Deserializer::deserializeField() rules.
+ */
+template<typename Data, typename WrappedField>
+class StreamingField: public AbstractStreamingField<Data>
+{
+    using Type = typename WrappedField::Type;
+    static constexpr bool kIsOptional = IsStdOptional<Type>::value;
+
+    template<typename T> struct ValueTypeOf { using Type = T; };
+    template<typename T> struct ValueTypeOf<std::optional<T>> { using Type = T; };
+    using ValueType = typename ValueTypeOf<Type>::Type;
+
+public:
+    explicit StreamingField(const WrappedField& field):
+        AbstractStreamingField<Data>(field.name()),
+        m_field(field)
+    {
+    }
+
+    virtual DeserializationResult deserialize(
+        Data* data, const rapidjson::Value& value, int flags) const override
+    {
+        if constexpr (kIsOptional)
+        {
+            std::optional<ValueType> optional = ValueType();
+            auto result = deserializeValue(DeserializationContext{value, flags}, &*optional);
+            m_field.set(data, std::move(optional));
+            return result;
+        }
+        else
+        {
+            ValueType fieldData;
+            auto result = deserializeValue(DeserializationContext{value, flags}, &fieldData);
+            if (result.success)
+                m_field.set(data, std::move(fieldData));
+            else if (value.IsNull()) //< Null that cannot be converted to the type is ignored.
+                return DeserializationResult(true);
+            return result;
+        }
+    }
+
+    virtual std::unique_ptr<AbstractStreamingFrame> makeFrame(
+        bool isObject, int flags) const override
+    {
+        return makeStreamingFrame<ValueType>(nullptr, isObject, flags);
+    }
+
+    virtual void set(
+        Data* data,
+        AbstractStreamingFrame* frame,
+        const DeserializationResult& result) const override
+    {
+        if (kIsOptional || result.success)
+            m_field.set(data, std::move(dataOf<ValueType>(frame)));
+    }
+
+    virtual void setMissing(Data* data) const override
+    {
+        if constexpr (kIsOptional)
+            m_field.set(data, std::optional<ValueType>());
+    }
+
+private:
+    WrappedField m_field;
+};
+
+template<typename Data>
+class StreamingFieldTable
+{
+public:
+    static const StreamingFieldTable& instance()
+    {
+        static const StreamingFieldTable table;
+        return table;
+    }
+
+    /**
+     * Fields with the same name are all filled from one JSON value by the DOM deserializer. This
+     * can not be done from the stream, so such types are deserialized with DOM.
+     */
+    bool isStreamable() const { return m_index.size() == m_fields.size(); }
+
+    int size() const { return (int) m_fields.size(); }
+
+    const AbstractStreamingField<Data>& field(int index) const { return *m_fields[index]; }
+
+    /**
+     * @param hint Index to check first. JSON objects usually have the fields in the declaration
+     *     order, so the next field after the previous one is tried before the hash lookup.
+     * @return -1 if not found.
+     */
+    int find(std::string_view name, int hint) const
+    {
+        if (hint < size() && m_fields[hint]->name() == name)
+            return hint;
+
+        const auto it = m_index.find(name);
+        return it == m_index.end() ? -1 : it->second;
+    }
+
+private:
+    class Builder: public GenericVisitor<Builder>
+    {
+    public:
+        Builder(StreamingFieldTable* table): m_table(table) {}
+
+        template<typename WrappedField>
+        void visitField(const WrappedField& field)
+        {
+            m_table->m_fields.push_back(
+                std::make_unique<StreamingField<Data, WrappedField>>(field));
+            m_table->m_index.emplace(field.name(), (int) m_table->m_fields.size() - 1);
+        }
+
+    private:
+        StreamingFieldTable* m_table = nullptr;
+    };
+
+    StreamingFieldTable()
+    {
+        nx::reflect::visitAllFields<Data>(Builder(this));
+    }
+
+private:
+    std::vector<std::unique_ptr<AbstractStreamingField<Data>>> m_fields;
+    std::unordered_map<std::string_view, int> m_index;
+};
+
+template<typename Data>
+class ObjectStreamingFrame: public StreamingValueFrame<Data>
+{
+    using base_type = StreamingValueFrame<Data>;
+
+public:
+    explicit ObjectStreamingFrame(Data* target):
+        base_type(target),
+        m_table(StreamingFieldTable<Data>::instance())
+    {
+    }
+
+    virtual bool value(StreamingDeserializer* deserializer, const rapidjson::Value& value) override
+    {
+        auto result = m_table.field(m_current).deserialize(
+            &this->data(), value, deserializer->flags());
+        if (!result.success && !deserializer->ignoresErrors())
+            return deserializer->fail(std::move(result));
+        return true;
+    }
+
+    virtual bool start(StreamingDeserializer* deserializer, bool isObject) override
+    {
+        deserializer->push(m_table.field(m_current).makeFrame(isObject, deserializer->flags()));
+        return true;
+    }
+
+    virtual bool key(StreamingDeserializer* deserializer, std::string_view name) override
+    {
+        const int index = m_table.find(name, m_current + 1);
+
+        // The DOM deserializer takes the first one of the duplicate keys.
+        if (index < 0 || isSeen(index))
+        {
+            deserializer->skipValue();
+            return true;
+        }
+
+        m_current = index;
+        setSeen(index);
+        return true;
+    }
+
+    virtual DeserializationResult finish(int) override
+    {
+        for (int i = 0; i < m_table.size(); ++i)
+        {
+            if (!isSeen(i))
+                m_table.field(i).setMissing(&this->data());
+        }
+        return DeserializationResult(true);
+    }
+
+    virtual bool childFinished(
+        StreamingDeserializer*,
+        AbstractStreamingFrame* child,
+        DeserializationResult result) override
+    {
+        // Errors are passed here only if they are ignored.
+        m_table.field(m_current).set(&this->data(), child, result);
+        return true;
+    }
+
+    virtual void describeError(DeserializationResult* result) const override
+    {
+        if (!result->firstNonDeserializedField && m_current >= 0)
+            result->firstNonDeserializedField = std::string(m_table.field(m_current).name());
+    }
+
+private:
+    bool isSeen(int index) const
+    {
+        return index < 64 ? (m_seen & (uint64_t(1) << index)) : m_seenAfter64.count(index);
+    }
+
+    void setSeen(int index)
+    {
+        if (index < 64)
+            m_seen |= uint64_t(1) << index;
+        else
+            m_seenAfter64.emplace(index, true);
+    }
+
+private:
+    const StreamingFieldTable<Data>& m_table;
+    int m_current = -1;
+    uint64_t m_seen = 0;
+    std::unordered_map<int, bool> m_seenAfter64;
+};
+
+//-------------------------------------------------------------------------------------------------
+// Containers.
+
+/**
+ * Follows the json_detail::deserialize() rules for sequence and set containers.
+ */
+template<typename C>
+class ArrayStreamingFrame: public StreamingValueFrame<C>
+{
+    using Element = typename C::value_type;
+
+public:
+    explicit ArrayStreamingFrame(C* target): StreamingValueFrame<C>(target)
+    {
+        this->data() = C();
+    }
+
+    virtual bool value(StreamingDeserializer* deserializer, const rapidjson::Value& value) override
+    {
+        Element element;
+        auto result = deserializeValue(
+            DeserializationContext{value, deserializer->flags()}, &element);
+        if (!result.success)
+            return deserializer->ignoresErrors() || deserializer->fail(std::move(result));
+
+        std::inserter(this->data(), this->data().end()) = std::move(element);
+        return true;
+    }
+
+    virtual bool start(StreamingDeserializer* deserializer, bool isObject) override
+    {
+        deserializer->push(
+            makeStreamingFrame<Element>(nullptr, isObject, deserializer->flags()));
+        return true;
+    }
+
+    virtual bool key(StreamingDeserializer*, std::string_view) override { return false; }
+
+    virtual DeserializationResult finish(int) override { return DeserializationResult(true); }
+
+    virtual bool childFinished(
+        StreamingDeserializer*,
+        AbstractStreamingFrame* child,
+        DeserializationResult result) override
+    {
+        if (result.success)
+            std::inserter(this->data(), this->data().end()) = std::move(dataOf<Element>(child));
+        return true;
+    }
+};
+
+/**
+ * Follows the json_detail::deserialize() rules for associative containers, except that the
+ * fragment reported for a bad key is the key itself instead of the whole object.
+ */
+template<typename C>
+class MapStreamingFrame: public StreamingValueFrame<C>
+{
+    using Element = typename C::mapped_type;
+
+public:
+    using StreamingValueFrame<C>::StreamingValueFrame;
+
+    virtual bool value(StreamingDeserializer* deserializer, const rapidjson::Value& value) override
+    {
+        Element element;
+        auto result = deserializeValue(
+            DeserializationContext{value, deserializer->flags()}, &element);
+        if (!result.success)
+            return deserializer->ignoresErrors() || deserializer->fail(std::move(result));
+
+        return insert(deserializer, std::move(element));
+    }
+
+    virtual bool start(StreamingDeserializer* deserializer, bool isObject) override
+    {
+        deserializer->push(
+            makeStreamingFrame<Element>(nullptr, isObject, deserializer->flags()));
+        return true;
+    }
+
+    virtual bool key(StreamingDeserializer*, std::string_view name) override
+    {
+        m_key = name;
+        return true;
+    }
+
+    virtual DeserializationResult finish(int) override { return DeserializationResult(true); }
+
+    virtual bool childFinished(
+        StreamingDeserializer* deserializer,
+        AbstractStreamingFrame* child,
+        DeserializationResult result) override
+    {
+        if (!result.success)
+            return true;
+
+        return insert(deserializer, std::move(dataOf<Element>(child)));
+    }
+
+private:
+    bool insert(StreamingDeserializer* deserializer, Element element)
+    {
+        typename C::key_type key;
+        if (!nx::reflect::fromString(m_key, &key))
+        {
+            return deserializer->ignoresErrors() || deserializer->fail({
+                false,
+                "In a key-value container a key should be a string",
+                std::string(m_key)});
+        }
+
+        if constexpr (HasSquareBracketOperatorV<C, decltype(key)>)
+            this->data()[std::move(key)] = std::move(element); //< E.g., std::map
+        else
+            this->data().emplace(std::move(key), std::move(element)); //< E.g., std::multimap
+        return true;
+    }
+
+private:
+    std::string_view m_key;
+};
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * Chooses the frame for an object or array value of type T in the same order as
+ * deserializeValue() chooses the deserialization method. Types and values that are not natively
+ * supported go to the DOM deserializer.
+ */
+template<typename T>
+std::unique_ptr<AbstractStreamingFrame> makeStreamingFrame(T* target, bool isObject, int /*flags*/)
+{
+    if constexpr (HasCustomDeserializerV<T>)
+    {
+        return std::make_unique<DomStreamingFrame<T>>(target, isObject);
+    }
+    else if constexpr (nx::reflect::IsInstrumentedV<T>)
+    {
+        if (isObject && StreamingFieldTable<T>::instance().isStreamable())
+            return std::make_unique<ObjectStreamingFrame<T>>(target);
+    }
+    else if constexpr (
+        (IsSequenceContainerV<T> || IsSetContainerV<T> || IsUnorderedSetContainerV<T>)
+        && !IsStringAlikeV<T>)
+    {
+        if (!isObject)
+            return std::make_unique<ArrayStreamingFrame<T>>(target);
+    }
+    else if constexpr (
+        (IsAssociativeContainerV<T> && !IsSetContainerV<T>)
+        || (IsUnorderedAssociativeContainerV<T> && !IsUnorderedSetContainerV<T>))
+    {
+        if (isObject)
+            return std::make_unique<MapStreamingFrame<T>>(target);
+    }
+
+    return std::make_unique<DomStreamingFrame<T>>(target, isObject);
+}
+
+} // namespace json_detail
+
+//-------------------------------------------------------------------------------------------------
+
+namespace json {
+
+/**
+ * Deserializes JSON text like deserialize(), but fills the data directly from the parser events
+ * instead of building the whole document first. A copy of the text is parsed in place, so
+ * strings are not allocated before they are converted to the field types.
+ *
+ * Instrumented types, STL-like containers and scalar values are deserialized from the stream.
+ * Values of other types (variants, types with custom deserialization functions) are collected and
+ * passed to the DOM deserializer, so the result is the same as of deserialize(), except:
+ * - Deserialization stops at the first error in the text order, not in the field order. The data
+ *   may be partially filled, also if the text has a syntax error after the filled values.
+ * - For a bad key of an associative container, the key is reported as the bad fragment.
+ * - For an exception, the whole text is reported as the bad fragment.
+ */
+template<typename Data>
+DeserializationResult deserializeStreaming(
+    const std::string_view& json,
+    Data* data,
+    json::DeserializationFlag skipErrors = json::DeserializationFlag::none)
+{
+    json_detail::StreamingDeserializer deserializer((int) skipErrors);
+    try
+    {
+        return deserializer.parse(
+            json, std::make_unique<json_detail::RootStreamingFrame<Data>>(data));
+    }
+    catch (const std::exception& e)
+    {
+        *data = Data();
+        return {
+            false,
+            "Exception during json deserialization: " + std::string(e.what()),
+            std::string(json)};
+    }
+}
+
+/**
+ * Deserializes JSON text into an object of supported type Data.
+ * This is a convenience overload. See the previous deserializeStreaming for details.
+ * @return std::tuple<deserialized value, result>
+ */
+template<typename Data>
+std::tuple<Data, DeserializationResult> deserializeStreaming(
+    const std::string_view& json,
+    json::DeserializationFlag skipErrors = json::DeserializationFlag::none)
+{
+    Data data;
+    auto result = deserializeStreaming<Data>(json, &data, skipErrors);
+    return std::make_tuple(std::move(data), std::move(result));
+}
+
+} // namespace json
+
+} // namespace nx::reflect
@@ -15,6 +15,7 @@
 
 #include <nx/reflect/json/serializer.h>
 #include <nx/reflect/json/deserializer.h>
+#include <nx/reflect/json/streaming_deserializer.h>
 
 #include "serialization_acceptance_tests.h"
 
@@ -774,4 +775,202 @@ TEST_F(Json, array_with_chrono_duration_is_serialized_as_number_if_asked_explici
     testSerialization("[{\"d\":1},{\"d\":2}]", v);
 }
 
+TEST_F(Json, pretty_format)
+{
+    ASSERT_EQ(
+        "{\n    \"num\": 1,\n    \"t\": [\n        {\n            \"s\": \"a\"\n        }\n    ]\n}",
+        json::serialize(FooObjArray{1, {X{"a"}}}, json::Format::pretty));
+}
+
+TEST_F(Json, repeated_serialization_gives_same_result)
+{
+    FooStringizableMap value{12, {{Stringizable{"key1"}, Stringizable{"val1"}}}};
+    const auto expected = R"({"num":12,"t":{"key1":"val1"}})";
+
+    ASSERT_EQ(expected, json::serialize(value));
+    ASSERT_EQ(expected, json::serialize(value));
+
+    value.t.clear();
+    ASSERT_EQ(R"({"num":12,"t":{}})", json::serialize(value));
+}
+
+TEST_F(Json, small_result_does_not_hold_buffer_of_previous_large_one)
+{
+    const auto large = json::serialize(std::vector<int>(100'000, 12345));
+    const auto small = json::serialize(std::vector<int>{1});
+
+    ASSERT_EQ("[1]", small);
+    ASSERT_LT(small.capacity(), large.size() / 2);
+}
+
+TEST_F(Json, field_name_is_quoted_and_escaped)
+{
+    ASSERT_EQ(R"("name")", json::detail::quotedName("name"));
+    ASSERT_EQ(R"("a\"b\\c\n")", json::detail::quotedName("a\"b\\c\n"));
+}
+
+//-------------------------------------------------------------------------------------------------
+// Streaming deserialization.
+
+struct StreamingJsonTypeSet: JsonTypeSet
+{
+    template<typename... Args>
+    static auto deserialize(Args&&... args)
+    {
+        return nx::reflect::json::deserializeStreaming(std::move(args)...);
+    }
+};
+
+INSTANTIATE_TYPED_TEST_SUITE_P(
+    JsonStreaming,
+    FormatAcceptance,
+    StreamingJsonTypeSet);
+
+using FooVariant = Foo<std::variant<int, X>>;
+NX_REFLECTION_INSTRUMENT(FooVariant, (num)(t))
+
+class JsonStreaming:
+    public ::testing::Test
+{
+protected:
+    template<typename T>
+    void assertSameAsDom(
+        const std::string& json,
+        json::DeserializationFlag flags = json::DeserializationFlag::none,
+        const T& initialValue = T())
+    {
+        T expected = initialValue;
+        const auto expectedResult = json::deserialize(json, &expected, flags);
+
+        T actual = initialValue;
+        const auto actualResult = json::deserializeStreaming(json, &actual, flags);
+
+        ASSERT_EQ(expected, actual) << json;
+        ASSERT_EQ(expectedResult.success, actualResult.success) << json;
+        ASSERT_EQ(expectedResult.errorDescription, actualResult.errorDescription) << json;
+        ASSERT_EQ(expectedResult.firstBadFragment, actualResult.firstBadFragment) << json;
+        ASSERT_EQ(expectedResult.firstNonDeserializedField,
+            actualResult.firstNonDeserializedField) << json;
+    }
+};
+
+TEST_F(JsonStreaming, scalar_fields)
+{
+    assertSameAsDom<FooBuiltInTypes>(R"({"n":12,"b":true,"d":56.193})");
+    assertSameAsDom<FooBuiltInTypes>(R"({"n":"12","b":"true","d":56})");
+    assertSameAsDom<FooString>(R"({"s":"Hello\nHello Ж"})");
+    assertSameAsDom<FooStringizable>(R"({"num":"231","t":"foo"})");
+    assertSameAsDom<FooBase64Convertible>(R"json({"num":12,"t":"base64(Hello)"})json");
+    assertSameAsDom<FooChrono>(R"({"s":3,"ms":"13","us":23,"t":"45"})");
+    assertSameAsDom<std::string>(R"("qweasd123")");
+    assertSameAsDom<int>("123");
+}
+
+TEST_F(JsonStreaming, optional_fields)
+{
+    assertSameAsDom<FooOptional>(R"({"num":12})");
+    assertSameAsDom<FooOptional>(R"({"num":12,"t":"Hello"})");
+    assertSameAsDom<FooOptional>(R"({"num":12,"t":null})");
+    assertSameAsDom<FooOptionalWithCustomDefault>(R"({"num":12})");
+}
+
+TEST_F(JsonStreaming, containers)
+{
+    assertSameAsDom<FooObjArray>(R"({"num":12,"t":[{"s":"ab"},{"s":"ac"}]})");
+    assertSameAsDom<FooStringList>(R"({"num":12,"t":["ab","ac"]})");
+    assertSameAsDom<FooStringizableSet>(R"({"num":12,"t":["ab","ac"]})");
+    assertSameAsDom<FooStringizableUnorderedSet>(R"({"num":12,"t":["ab"]})");
+    assertSameAsDom<FooStringizableMap>(R"({"num":12,"t":{"key1":"val1","key2":"val2"}})");
+    assertSameAsDom<FooStringizableUnorderedMap>(R"({"num":12,"t":{"key1":"val1"}})");
+    assertSameAsDom<std::vector<X>>(R"([{"s":"1"},{"s":"2"}])");
+    assertSameAsDom<NonTemplateContainer>(R"([{"s":"1"},{"s":"2"}])");
+    assertSameAsDom<FooStringizableNonTemplateContainer>(R"({"num":12,"t":"1,2"})");
+    assertSameAsDom<std::vector<std::vector<int>>>("[[1,2],[],[3]]");
+
+    assertSameAsDom<std::map<std::string, std::string>>(
+        R"({"color":"red","shape":"square"})",
+        json::DeserializationFlag::none,
+        {{"color", "yellow"}});
+
+    assertSameAsDom<std::multimap<std::string, std::string>>(
+        R"({"foo":"bar1","foo":"bar2","fu":"bar"})",
+        json::DeserializationFlag::none,
+        {{"foo", "bar0"}});
+}
+
+TEST_F(JsonStreaming, values_of_other_types_are_passed_to_dom_deserializer)
+{
+    assertSameAsDom<FooCustomSerializable>(R"({"num":12,"t":23})");
+    assertSameAsDom<FooCustomSerializable>(R"({"num":12,"t":{"y":23}})");
+    assertSameAsDom<FooVariant>(R"({"num":12,"t":7})");
+    assertSameAsDom<FooVariant>(R"({"num":12,"t":{"s":"x"}})");
+    assertSameAsDom<FooStringizable>(R"({"num":12,"t":{"s":"x"}})");
+    assertSameAsDom<std::vector<int>>(R"({"s":1})");
+}
+
+TEST_F(JsonStreaming, unknown_and_duplicate_fields_are_skipped)
+{
+    assertSameAsDom<FooStringizable>(
+        R"({"unknown":{"a":[1,{"b":[]}],"c":null},"num":1,"more":[[{}]],"t":"x"})");
+    assertSameAsDom<FooBool>(R"({"num":1,"t":true,"num":2,"t":{"a":1}})");
+}
+
+TEST_F(JsonStreaming, error_reporting)
+{
+    assertSameAsDom<FooBuiltInTypes>(R"({"n":12,"b":"not a bool","d":56.193})");
+    assertSameAsDom<FooBuiltInTypes>(R"({"n":false,"b":"true","d":56.193})");
+    assertSameAsDom<FooBuiltInTypes>(R"("not an object")");
+    assertSameAsDom<FooBuiltInTypes>(R"([{"n":1}])");
+    assertSameAsDom<X>(R"({"s":1})");
+    assertSameAsDom<FooIntVec>(R"({"num": 0,"t":[1,2,3,false]})");
+    assertSameAsDom<FooObjArray>(R"({"num":12,"t":[{"s":"ab"},{"s":2}]})");
+    assertSameAsDom<FooCustomSerializable>(R"({"num":12,"t":{"y":23}})");
+}
+
+TEST_F(JsonStreaming, errors_are_skipped_if_requested)
+{
+    const S initialValue{"str", {{"a", 1}, {"b", 2}}, {true, false}, false, {1, false}};
+
+    for (const auto& json: {
+        R"({"str":123,"map":{"a":1,"b":2},"vec":[true,false],"b":false,"foo":{"num":1,"t":false}})",
+        R"({"str":"str","map":{"a":1,"b":2,"c":false},"vec":[true,false],"b":false})",
+        R"({"str":"str","map":{"a":1,"b":2},"vec":[true,"ququ",false],"b":false})",
+        R"({"str":"str","map":{"a":1,"b":2},"vec":[true,false],"b":10})",
+        R"({"str":"str","map":{"a":1,"b":2},"vec":[true,false],"foo":"not_an_obj"})",
+        R"({"map":{"a":1,"b":[2]},"vec":[{},[]],"foo":{"num":[],"t":{}}})"})
+    {
+        assertSameAsDom<S>(json, json::DeserializationFlag::ignoreFieldTypeMismatch, initialValue);
+    }
+}
+
+TEST_F(JsonStreaming, explicit_null_deserialization)
+{
+    const S initialValue{"str", {{"a", 1}, {"b", 2}}, {true, false}, true, FooBool()};
+    assertSameAsDom<S>(
+        R"({"str":null,"map":null,"vec":null,"b":null,"foo":null})",
+        json::DeserializationFlag::none,
+        initialValue);
+}
+
+TEST_F(JsonStreaming, syntax_error_is_reported)
+{
+    static constexpr char kJson[] = R"({"num":12,"t":["ab")";
+
+    FooStringVector expected;
+    const auto expectedResult = json::deserialize(kJson, &expected);
+    FooStringVector actual;
+    const auto actualResult = json::deserializeStreaming(kJson, &actual);
+
+    ASSERT_FALSE(actualResult);
+    ASSERT_EQ(expectedResult.errorDescription, actualResult.errorDescription);
+    ASSERT_EQ(expectedResult.firstBadFragment, actualResult.firstBadFragment);
+}
+
+TEST_F(JsonStreaming, exception_thrown_during_deserialization_is_handled)
+{
+    const auto [parsed, success] = json::deserializeStreaming<MillisAndInt>(kMillisAndIntJson);
+    ASSERT_FALSE(success);
+    ASSERT_EQ(kMillisAndIntJson, success.firstBadFragment);
+}
+
 } // namespace nx::reflect::test
@@ -8,11 +8,41 @@
 
 namespace nx::sql {
 
+namespace {
+
+static constexpr std::pair<const char*, double> kPercentiles[] = {
+    {"50", 0.5}, {"95", 0.95}, {"99", 0.99}};
+
+// Longer durations are reported as this value.
+static constexpr std::chrono::hours kMaxDuration(1);
+
+} // namespace
+
 StatisticsCollector::DurationStatisticsCalculationContext::DurationStatisticsCalculationContext(
     DurationStatistics* result)
     :
-    result(result)
+    result(result),
+    histogram(kMaxDuration)
+{
+}
+
+void StatisticsCollector::DurationStatisticsCalculationContext::clear()
+{
+    *result = DurationStatistics();
+    currentSum = std::chrono::milliseconds::zero();
+    count = 0;
+    recalcMinMax = false;
+    histogram.clear();
+}
+
+void StatisticsCollector::DurationStatisticsCalculationContext::updatePercentiles()
 {
+    result->percentiles.clear();
+    if (histogram.empty())
+        return;
+
+    for (const auto& [name, percentile]: kPercentiles)
+        result->percentiles.emplace(name, histogram.valueAtPercentile(percentile));
 }
 
 StatisticsCollector::StatisticsRecordContext::StatisticsRecordContext(QueryExecutionInfo data):
@@ -46,7 +76,10 @@ QueryStatistics StatisticsCollector::getQueryStatistics() const
     QueryStatistics result;
     {
         NX_MUTEX_LOCKER lock(&m_mutex);
-        const_cast<StatisticsCollector*>(this)->removeExpiredRecords(lock);
+        auto self = const_cast<StatisticsCollector*>(this);
+        self->removeExpiredRecords(lock);
+        self->m_requestExecutionTimesCalculationContext.updatePercentiles();
+        self->m_waitingForExecutionTimesCalculationContext.updatePercentiles();
         result = m_currentStatistics;
     }
 
@@ -64,10 +97,8 @@ void StatisticsCollector::clearStatistics()
     m_recordQueue.clear();
     m_currentStatistics = QueryStatistics();
     m_currentStatistics.statisticalPeriod = m_period;
-    m_requestExecutionTimesCalculationContext =
-        DurationStatisticsCalculationContext(&m_currentStatistics.requestExecutionTimes);
-    m_waitingForExecutionTimesCalculationContext =
-        DurationStatisticsCalculationContext(&m_currentStatistics.waitingForExecutionTimes);
+    m_requestExecutionTimesCalculationContext.clear();
+    m_waitingForExecutionTimesCalculationContext.clear();
 }
 
 void StatisticsCollector::updateStatisticsWithNewValue(
@@ -103,6 +134,7 @@ void StatisticsCollector::addValue(
 {
     calculationContext->currentSum += value;
     updateMinMax(calculationContext->result, value);
+    calculationContext->histogram.add(value);
     ++calculationContext->count;
     calculationContext->result->average =
         calculationContext->currentSum / calculationContext->count;
@@ -161,6 +193,7 @@ void StatisticsCollector::removeValue(
     using namespace std::chrono;
 
     calculationContext->currentSum -= value;
+    calculationContext->histogram.remove(value);
     if (calculationContext->result->min == value || calculationContext->result->max == value)
         calculationContext->recalcMinMax = true;
     // TODO: #akolesnikov apply min_max_queue here.
@@ -6,6 +6,7 @@
 #include <deque>
 
 #include <nx/reflect/instrument.h>
+#include <nx/utils/math/histogram.h>
 #include <nx/utils/std/optional.h>
 #include <nx/utils/thread/mutex.h>
 
@@ -45,8 +46,12 @@ private:
         std::chrono::milliseconds currentSum = std::chrono::milliseconds::zero();
         std::size_t count = 0;
         bool recalcMinMax = false;
+        nx::utils::math::Histogram<std::chrono::milliseconds> histogram;
 
         DurationStatisticsCalculationContext(DurationStatistics* result);
+
+        void clear();
+        void updatePercentiles();
     };
 
     struct StatisticsRecordContext
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <chrono>
+#include <map>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -150,9 +151,10 @@ struct DurationStatistics
     std::chrono::milliseconds min = std::chrono::milliseconds::max();
     std::chrono::milliseconds max = std::chrono::milliseconds::min();
     std::chrono::milliseconds average = std::chrono::milliseconds::zero();
+    std::map<std::string /*percent*/, std::chrono::milliseconds> percentiles;
 };
 
-NX_REFLECTION_INSTRUMENT(DurationStatistics, (min)(max)(average))
+NX_REFLECTION_INSTRUMENT(DurationStatistics, (min)(max)(average)(percentiles))
 
 struct QueryStatistics
 {
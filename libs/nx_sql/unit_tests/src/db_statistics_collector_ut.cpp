@@ -92,6 +92,11 @@ protected:
         assertEqual(queryStatistics, m_statisticsCollector.getQueryStatistics());
     }
 
+    QueryStatistics whenRequestStatistics()
+    {
+        return m_statisticsCollector.getQueryStatistics();
+    }
+
     void assertWaitForExecutionTimeMinMaxAverageEqualTo(
         std::chrono::milliseconds expectedMin,
         std::chrono::milliseconds expectedMax,
@@ -193,6 +198,30 @@ TEST_F(DbStatisticsCollector, execution_time_min_max_average)
         (one + two) / 2);
 }
 
+TEST_F(DbStatisticsCollector, execution_time_percentiles)
+{
+    for (int i = 1; i <= 100; ++i)
+        recordRequestWithExecutionTime(std::chrono::milliseconds(i));
+
+    const auto percentiles = whenRequestStatistics().requestExecutionTimes.percentiles;
+    ASSERT_EQ(std::chrono::milliseconds(50), percentiles.at("50"));
+    ASSERT_EQ(std::chrono::milliseconds(95), percentiles.at("95"));
+    ASSERT_EQ(std::chrono::milliseconds(99), percentiles.at("99"));
+}
+
+TEST_F(DbStatisticsCollector, expired_elements_are_removed_from_percentiles)
+{
+    recordRequestWithExecutionTime(std::chrono::milliseconds(90));
+    waitForStatisticsToExpire();
+    recordRequestWithExecutionTime(std::chrono::milliseconds(10));
+
+    const auto percentiles = whenRequestStatistics().requestExecutionTimes.percentiles;
+    ASSERT_EQ(std::chrono::milliseconds(10), percentiles.at("99"));
+
+    waitForStatisticsToExpire();
+    ASSERT_TRUE(whenRequestStatistics().requestExecutionTimes.percentiles.empty());
+}
+
 TEST_F(DbStatisticsCollector, expired_elements_are_removed)
 {
     addRandomRecord();
@@ -5,15 +5,19 @@
 #include <nx/kit/utils.h>
 #include <nx/utils/log/assert.h>
 
+#include "byte_array_pool.h"
+
 namespace nx::utils {
 
 ByteArray::ByteArray(
     size_t alignment,
     size_t capacity,
-    size_t padding)
+    size_t padding,
+    std::shared_ptr<ByteArrayPool> pool)
     :
     m_alignment(alignment),
-    m_padding(padding)
+    m_padding(padding),
+    m_pool(std::move(pool))
 {
     NX_ASSERT(m_alignment != 0, "Aligment could not be zero!");
     if (capacity > 0)
@@ -22,7 +26,7 @@ ByteArray::ByteArray(
 
 ByteArray::~ByteArray()
 {
-    nx::kit::utils::freeAligned(m_data);
+    freeBuffer(m_data, m_capacity);
 }
 
 void ByteArray::clear()
@@ -140,14 +144,15 @@ ByteArray& ByteArray::operator=(const ByteArray& right)
     if (&right == this)
         return *this;
 
-    nx::kit::utils::freeAligned(m_data);
+    freeBuffer(m_data, m_capacity);
 
     m_alignment = right.m_alignment;
     m_capacity = right.m_size;
     m_size = right.m_size;
     m_padding = right.m_padding;
+    m_pool = right.m_pool;
 
-    m_data = allocateBuffer(m_capacity);
+    m_data = allocateBuffer(&m_capacity);
 
     memcpy(m_data, right.constData(), right.size());
     m_ignore = 0;
@@ -160,14 +165,15 @@ ByteArray& ByteArray::operator=(ByteArray&& right)
     if (&right == this)
         return *this;
 
-    nx::kit::utils::freeAligned(m_data);
+    freeBuffer(m_data, m_capacity);
 
     m_alignment = std::move(right.m_alignment);
-    m_capacity = std::move(right.m_size);
+    m_capacity = std::move(right.m_capacity);
     m_size = std::move(right.m_size);
     m_padding = std::move(right.m_padding);
     m_ignore = std::move(right.m_ignore);
     m_data = std::move(right.m_data);
+    m_pool = std::move(right.m_pool);
 
     // Avoid data double-free.
     right.m_data = nullptr;
@@ -175,17 +181,39 @@ ByteArray& ByteArray::operator=(ByteArray&& right)
     return *this;
 }
 
-char* ByteArray::allocateBuffer(size_t capacity)
+char* ByteArray::allocateBuffer(size_t* capacity)
 {
-    char* data = (char*) nx::kit::utils::mallocAligned((size_t) capacity + m_padding, m_alignment);
+    char* data = nullptr;
+    if (m_pool)
+    {
+        size_t size = *capacity + m_padding;
+        data = (char*) m_pool->allocate(&size, m_alignment);
+        if (data)
+            *capacity = size - m_padding;
+    }
+    else
+    {
+        data = (char*) nx::kit::utils::mallocAligned(*capacity + m_padding, m_alignment);
+    }
 
     // If the first 23 bits of the additional bytes are not 0, then damaged MPEG bitstreams could
     // cause overread and segfault.
     if (data)
-        memset(data + capacity, 0, m_padding);
+        memset(data + *capacity, 0, m_padding);
     return data;
 }
 
+void ByteArray::freeBuffer(char* data, size_t capacity)
+{
+    if (!data)
+        return;
+
+    if (m_pool)
+        m_pool->release(data, capacity + m_padding, m_alignment);
+    else
+        nx::kit::utils::freeAligned(data);
+}
+
 bool ByteArray::reallocate(size_t capacity)
 {
     if (!(NX_ASSERT(capacity >= m_size,
@@ -197,7 +225,7 @@ bool ByteArray::reallocate(size_t capacity)
     if (capacity < m_capacity)
         return true;
 
-    char* data = allocateBuffer(capacity);
+    char* data = allocateBuffer(&capacity);
 
     if (!data)
         return false;
@@ -205,9 +233,7 @@ bool ByteArray::reallocate(size_t capacity)
     if (m_data && m_size)
         memcpy(data, m_data, m_size);
 
-
-    if (m_data)
-        nx::kit::utils::freeAligned(m_data);
+    freeBuffer(m_data, m_capacity);
 
     m_capacity = capacity;
     m_data = data;
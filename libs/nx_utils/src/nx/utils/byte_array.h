@@ -2,11 +2,15 @@
 
 #pragma once
 
+#include <memory>
+
 #include <QtCore/QByteArray>
 #include <QtCore/qglobal.h>
 
 namespace nx::utils {
 
+class ByteArrayPool;
+
 /**
  * Container class for aligned memory chunks.
  */
@@ -18,11 +22,14 @@ public:
      * @param capacity Initial array capacity.
      * @param padding Additional data beyond the array capacity, which will be filled with zeros.
      *     Used to prevent overread and segfault for damaged MPEG bitstreams.
+     * @param pool Pool to allocate the data from. If null, the data is allocated with
+     *     nx::kit::utils::mallocAligned. Copies of the array use the same pool.
      */
     explicit ByteArray(
         size_t alignment,
         size_t capacity,
-        size_t padding);
+        size_t padding,
+        std::shared_ptr<ByteArrayPool> pool = nullptr);
     ~ByteArray();
 
     ByteArray() = default;
@@ -152,7 +159,9 @@ public:
 
 private:
     bool reallocate(size_t capacity);
-    char* allocateBuffer(size_t capacity);
+    /** @param capacity Can be increased if the pool gives out a larger block. */
+    char* allocateBuffer(size_t* capacity);
+    void freeBuffer(char* data, size_t capacity);
 
 private:
     size_t m_alignment = 1;
@@ -161,6 +170,7 @@ private:
     size_t m_padding = 0;
     size_t m_ignore = 0;
     char* m_data = nullptr;
+    std::shared_ptr<ByteArrayPool> m_pool;
 };
 
 } // namespace nx::utils
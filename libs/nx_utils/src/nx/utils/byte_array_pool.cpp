@@ -0,0 +1,243 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "byte_array_pool.h"
+
+#include <algorithm>
+
+#include <nx/kit/utils.h>
+#include <nx/utils/log/assert.h>
+#include <nx/utils/nx_utils_ini.h>
+
+namespace nx::utils {
+
+/**
+ * Free blocks of a single thread. Returned to the shared cache when the thread exits.
+ */
+class ByteArrayPool::ThreadCache
+{
+public:
+    ThreadCache(std::shared_ptr<ByteArrayPool> pool):
+        m_pool(std::move(pool))
+    {
+    }
+
+    ~ThreadCache()
+    {
+        for (int i = 0; i < kSizeClassCount; ++i)
+            m_pool->putToSharedCache(i, &freeBlocks[i], freeBlocks[i].size());
+    }
+
+    const ByteArrayPool* pool() const { return m_pool.get(); }
+
+    std::array<std::vector<void*>, kSizeClassCount> freeBlocks;
+
+private:
+    std::shared_ptr<ByteArrayPool> m_pool;
+};
+
+/** Set when the thread caches of the current thread have been destroyed on thread exit. */
+static thread_local bool threadCachesDestroyed = false;
+
+const std::array<std::size_t, ByteArrayPool::kSizeClassCount> ByteArrayPool::kBlockSizes =
+    ByteArrayPool::makeBlockSizes();
+
+ByteArrayPool::ByteArrayPool(PrivateTag, std::size_t maxCachedBytes):
+    m_maxCachedBytes(maxCachedBytes)
+{
+}
+
+ByteArrayPool::~ByteArrayPool()
+{
+    for (auto& blocks: m_freeBlocks)
+    {
+        for (void* block: blocks)
+            nx::kit::utils::freeAligned(block);
+    }
+}
+
+std::shared_ptr<ByteArrayPool> ByteArrayPool::create(std::size_t maxCachedBytes)
+{
+    return std::make_shared<ByteArrayPool>(PrivateTag(), maxCachedBytes);
+}
+
+std::shared_ptr<ByteArrayPool> ByteArrayPool::instance()
+{
+    static const std::shared_ptr<ByteArrayPool> pool =
+        ini().useByteArrayPool ? create() : nullptr;
+    return pool;
+}
+
+void* ByteArrayPool::allocate(std::size_t* size, std::size_t alignment)
+{
+    const int sizeClass = this->sizeClass(*size, alignment);
+    if (sizeClass < 0)
+    {
+        ++m_unpooledAllocations;
+        return nx::kit::utils::mallocAligned(*size, alignment);
+    }
+
+    *size = kBlockSizes[sizeClass];
+    m_usedBytes += *size;
+
+    std::vector<void*> uncachedBlocks;
+    auto cache = threadCache();
+    auto& blocks = cache ? cache->freeBlocks[sizeClass] : uncachedBlocks;
+    if (blocks.empty())
+    {
+        const std::size_t count = cache ? (threadCacheCapacity(sizeClass) + 1) / 2 : 1;
+        takeFromSharedCache(sizeClass, &blocks, count);
+    }
+
+    if (!blocks.empty())
+    {
+        void* block = blocks.back();
+        blocks.pop_back();
+        m_cachedBytes -= *size;
+        ++m_cacheHits;
+        return block;
+    }
+
+    ++m_cacheMisses;
+    void* block = nx::kit::utils::mallocAligned(*size, kAlignment);
+    if (!block)
+        m_usedBytes -= *size;
+    return block;
+}
+
+void ByteArrayPool::release(void* block, std::size_t size, std::size_t alignment)
+{
+    if (!block)
+        return;
+
+    const int sizeClass = this->sizeClass(size, alignment);
+    if (sizeClass < 0)
+    {
+        nx::kit::utils::freeAligned(block);
+        return;
+    }
+
+    NX_ASSERT(kBlockSizes[sizeClass] == size, "Unexpected block size %1", size);
+
+    m_usedBytes -= size;
+
+    // The limit covers the blocks in the thread caches too, otherwise every thread could keep up
+    // to kThreadCacheBytesPerSizeClass of every size class on top of it.
+    if (m_cachedBytes.fetch_add(size) + size > m_maxCachedBytes)
+    {
+        m_cachedBytes -= size;
+        nx::kit::utils::freeAligned(block);
+        return;
+    }
+
+    auto cache = threadCache();
+    if (!cache)
+    {
+        std::vector<void*> blocks{block};
+        putToSharedCache(sizeClass, &blocks, blocks.size());
+        return;
+    }
+
+    auto& blocks = cache->freeBlocks[sizeClass];
+    blocks.push_back(block);
+
+    const auto capacity = threadCacheCapacity(sizeClass);
+    if (blocks.size() > capacity)
+        putToSharedCache(sizeClass, &blocks, blocks.size() - capacity / 2);
+}
+
+ByteArrayPool::Statistics ByteArrayPool::statistics() const
+{
+    Statistics result;
+    result.usedBytes = m_usedBytes;
+    result.cachedBytes = m_cachedBytes;
+    result.cacheHits = m_cacheHits;
+    result.cacheMisses = m_cacheMisses;
+    result.unpooledAllocations = m_unpooledAllocations;
+    return result;
+}
+
+std::array<std::size_t, ByteArrayPool::kSizeClassCount> ByteArrayPool::makeBlockSizes()
+{
+    std::array<std::size_t, kSizeClassCount> result;
+
+    std::size_t powerOfTwo = kMinBlockSize;
+    result[0] = kMinBlockSize;
+    for (int i = 1; i < kSizeClassCount; ++i)
+    {
+        const int step = (i - 1) % kSizeClassesPerPowerOfTwo + 1;
+        result[i] = powerOfTwo + powerOfTwo / kSizeClassesPerPowerOfTwo * step;
+        if (step == kSizeClassesPerPowerOfTwo)
+            powerOfTwo *= 2;
+    }
+
+    NX_ASSERT(result.back() == kMaxBlockSize);
+    return result;
+}
+
+int ByteArrayPool::sizeClass(std::size_t size, std::size_t alignment)
+{
+    if (size > kMaxBlockSize || alignment == 0 || kAlignment % alignment != 0)
+        return -1;
+
+    return (int) (std::lower_bound(kBlockSizes.begin(), kBlockSizes.end(), size)
+        - kBlockSizes.begin());
+}
+
+ByteArrayPool::ThreadCache* ByteArrayPool::threadCache()
+{
+    /** Thread caches of all pools used by the current thread. Usually, there is only one pool. */
+    struct ThreadCaches
+    {
+        std::vector<std::unique_ptr<ThreadCache>> caches;
+
+        ~ThreadCaches()
+        {
+            threadCachesDestroyed = true;
+            caches.clear();
+        }
+    };
+
+    // A block can be released by a destructor of another thread-local object after the thread
+    // caches have been destroyed.
+    if (threadCachesDestroyed)
+        return nullptr;
+
+    thread_local ThreadCaches threadCaches;
+
+    auto& caches = threadCaches.caches;
+    const auto it = std::find_if(caches.begin(), caches.end(),
+        [this](const auto& cache) { return cache->pool() == this; });
+    if (it != caches.end())
+        return it->get();
+
+    caches.push_back(std::make_unique<ThreadCache>(shared_from_this()));
+    return caches.back().get();
+}
+
+std::size_t ByteArrayPool::threadCacheCapacity(int sizeClass) const
+{
+    return std::max<std::size_t>(kThreadCacheBytesPerSizeClass / kBlockSizes[sizeClass], 1);
+}
+
+void ByteArrayPool::takeFromSharedCache(
+    int sizeClass, std::vector<void*>* blocks, std::size_t count)
+{
+    NX_MUTEX_LOCKER lock(&m_mutex);
+
+    auto& freeBlocks = m_freeBlocks[sizeClass];
+    count = std::min(count, freeBlocks.size());
+    blocks->insert(blocks->end(), freeBlocks.end() - count, freeBlocks.end());
+    freeBlocks.resize(freeBlocks.size() - count);
+}
+
+void ByteArrayPool::putToSharedCache(
+    int sizeClass, std::vector<void*>* blocks, std::size_t count)
+{
+    NX_MUTEX_LOCKER lock(&m_mutex);
+
+    auto& freeBlocks = m_freeBlocks[sizeClass];
+    freeBlocks.insert(freeBlocks.end(), blocks->end() - count, blocks->end());
+    blocks->resize(blocks->size() - count);
+}
+
+} // namespace nx::utils
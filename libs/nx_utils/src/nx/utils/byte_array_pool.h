@@ -0,0 +1,130 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <nx/utils/thread/mutex.h>
+
+namespace nx::utils {
+
+/**
+ * Pool of aligned memory blocks for nx::utils::ByteArray. Intended for media packet payloads
+ * which are allocated and freed at a high rate and have similar sizes.
+ *
+ * Requested sizes are rounded up to one of the size classes: four classes per power of two from
+ * ByteArrayPool::kMinBlockSize to ByteArrayPool::kMaxBlockSize, so no more than 25% of a block is
+ * wasted. Freed blocks are kept in a cache of the releasing thread and are reused by the next
+ * allocation of the same size class in that thread without any locking. When the thread cache of
+ * a size class is full (or empty), a half of it is moved to (or taken from) the shared cache
+ * protected by a mutex. So, the blocks freed by a consumer thread reach the producer thread in
+ * batches. A freed block is returned to the system if caching it would make the total size of
+ * the free blocks in all the thread caches and the shared cache exceed the pool limit.
+ *
+ * Larger blocks and blocks with alignment greater than ByteArrayPool::kAlignment are allocated
+ * with nx::kit::utils::mallocAligned directly.
+ *
+ * The pool is reference-counted: every block user and every thread cache holds a reference to
+ * it, so the pool is destroyed after the last block is freed and the last thread that used the
+ * pool has exited.
+ * NOTE: All methods are thread-safe.
+ */
+class NX_UTILS_API ByteArrayPool:
+    public std::enable_shared_from_this<ByteArrayPool>
+{
+    struct PrivateTag {};
+
+public:
+    struct Statistics
+    {
+        /** Total size of the blocks given out and not freed yet. */
+        std::size_t usedBytes = 0;
+        /** Total size of the free blocks kept in the thread caches and in the shared cache. */
+        std::size_t cachedBytes = 0;
+        /** Number of allocations served from the cache. */
+        std::uint64_t cacheHits = 0;
+        /** Number of allocations of a pooled size served by the system allocator. */
+        std::uint64_t cacheMisses = 0;
+        /** Number of allocations which are not pooled due to their size or alignment. */
+        std::uint64_t unpooledAllocations = 0;
+    };
+
+    static constexpr std::size_t kAlignment = 64;
+    static constexpr std::size_t kMinBlockSize = 1024;
+    static constexpr std::size_t kMaxBlockSize = 16 * 1024 * 1024;
+    static constexpr std::size_t kDefaultMaxCachedBytes = 256 * 1024 * 1024;
+    /**
+     * Total size of free blocks of a size class a single thread may keep. The blocks are
+     * counted against the pool limit as well.
+     */
+    static constexpr std::size_t kThreadCacheBytesPerSizeClass = 1024 * 1024;
+
+    ByteArrayPool(PrivateTag, std::size_t maxCachedBytes);
+    ~ByteArrayPool();
+
+    ByteArrayPool(const ByteArrayPool&) = delete;
+    ByteArrayPool& operator=(const ByteArrayPool&) = delete;
+
+    /**
+     * @param maxCachedBytes Maximum total size of free blocks in the thread caches and the shared
+     *     cache.
+     */
+    static std::shared_ptr<ByteArrayPool> create(
+        std::size_t maxCachedBytes = kDefaultMaxCachedBytes);
+
+    /**
+     * @return The process-wide pool used for media packets. nullptr if pooling is disabled with
+     *     nx_utils.ini.
+     */
+    static std::shared_ptr<ByteArrayPool> instance();
+
+    /**
+     * @param size Requested size. Set to the size of the allocated block which is not less than
+     *     the requested one. The whole block can be used.
+     * @return nullptr if the system is out of memory.
+     */
+    void* allocate(std::size_t* size, std::size_t alignment);
+
+    /**
+     * @param size Size of the block as reported by ByteArrayPool::allocate.
+     * @param alignment The same value as passed to ByteArrayPool::allocate.
+     */
+    void release(void* block, std::size_t size, std::size_t alignment);
+
+    Statistics statistics() const;
+
+private:
+    class ThreadCache;
+
+    static constexpr int kSizeClassesPerPowerOfTwo = 4;
+    static constexpr int kSizeClassCount = 57;
+
+    static std::array<std::size_t, kSizeClassCount> makeBlockSizes();
+    static const std::array<std::size_t, kSizeClassCount> kBlockSizes;
+
+    const std::size_t m_maxCachedBytes;
+    mutable nx::Mutex m_mutex;
+    std::array<std::vector<void*>, kSizeClassCount> m_freeBlocks;
+
+    std::atomic<std::size_t> m_usedBytes = 0;
+    std::atomic<std::size_t> m_cachedBytes = 0;
+    std::atomic<std::uint64_t> m_cacheHits = 0;
+    std::atomic<std::uint64_t> m_cacheMisses = 0;
+    std::atomic<std::uint64_t> m_unpooledAllocations = 0;
+
+    static int sizeClass(std::size_t size, std::size_t alignment);
+    /** @return nullptr if the current thread is exiting. */
+    ThreadCache* threadCache();
+    std::size_t threadCacheCapacity(int sizeClass) const;
+
+    /** Moves up to count blocks from the shared cache to blocks. */
+    void takeFromSharedCache(int sizeClass, std::vector<void*>* blocks, std::size_t count);
+    /** Moves count blocks from the end of blocks to the shared cache. */
+    void putToSharedCache(int sizeClass, std::vector<void*>* blocks, std::size_t count);
+};
+
+} // namespace nx::utils
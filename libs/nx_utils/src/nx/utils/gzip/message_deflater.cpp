@@ -0,0 +1,179 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "message_deflater.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <nx/utils/log/assert.h>
+#include <nx/utils/zlib.h>
+
+namespace nx::utils::bstream::gzip {
+
+namespace {
+
+/** deflateBound() does not take into account the empty stored block added by Z_SYNC_FLUSH. */
+static constexpr std::size_t kFlushReserve = 16;
+static constexpr std::size_t kOutputBufferIncrement = 16 * 1024;
+static constexpr char kFlushTail[] = {'\x00', '\x00', '\xff', '\xff'};
+static constexpr char kEmptyBlock[] = {'\x00'};
+static constexpr std::size_t kMaxPooledStreamsPerThread = 4;
+
+} // namespace
+
+class MessageDeflater::Stream
+{
+public:
+    Stream(int windowBits):
+        m_windowBits(windowBits)
+    {
+        memset(&m_zStream, 0, sizeof(m_zStream));
+        // Negative windowBits makes zlib generate raw DEFLATE data without the zlib header.
+        m_initialized = deflateInit2(
+            &m_zStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -windowBits, /*memLevel*/ 8,
+            Z_DEFAULT_STRATEGY) == Z_OK;
+        NX_ASSERT(m_initialized, "windowBits: %1", windowBits);
+    }
+
+    ~Stream()
+    {
+        if (m_initialized)
+            deflateEnd(&m_zStream);
+    }
+
+    Stream(const Stream&) = delete;
+    Stream& operator=(const Stream&) = delete;
+
+    int windowBits() const { return m_windowBits; }
+
+    bool deflate(const ConstBufferRefType& message, nx::Buffer* outData)
+    {
+        if (!m_initialized)
+            return false;
+
+        // zlib produces nothing for an empty input if the previous call flushed the stream, so the
+        // empty stored block is added manually (RFC 7692, 7.2.3.6).
+        if (message.empty())
+        {
+            outData->append(kEmptyBlock, sizeof(kEmptyBlock));
+            return true;
+        }
+
+        const std::size_t initialSize = outData->size();
+        std::size_t outSize = initialSize;
+        std::size_t outCapacity = deflateBound(&m_zStream, (uLong) message.size()) + kFlushReserve;
+
+        m_zStream.next_in = (Bytef*) message.data();
+        m_zStream.avail_in = (uInt) message.size();
+        for (;;)
+        {
+            outData->resize(outSize + outCapacity);
+            m_zStream.next_out = (Bytef*) outData->data() + outSize;
+            m_zStream.avail_out = (uInt) outCapacity;
+
+            const int result = ::deflate(&m_zStream, Z_SYNC_FLUSH);
+            outSize += outCapacity - m_zStream.avail_out;
+            if (result != Z_OK && result != Z_BUF_ERROR)
+            {
+                outData->resize(initialSize);
+                return false;
+            }
+
+            // The flush is complete if zlib has not used all of the output buffer.
+            if (m_zStream.avail_out > 0)
+                break;
+
+            outCapacity = kOutputBufferIncrement;
+        }
+
+        if (outSize - initialSize < sizeof(kFlushTail)
+            || memcmp(outData->data() + outSize - sizeof(kFlushTail),
+                kFlushTail, sizeof(kFlushTail)) != 0)
+        {
+            NX_ASSERT(false, "Unexpected end of the flushed DEFLATE stream");
+            outData->resize(initialSize);
+            return false;
+        }
+
+        outData->resize(outSize - sizeof(kFlushTail));
+        return true;
+    }
+
+    void reset()
+    {
+        if (m_initialized)
+            deflateReset(&m_zStream);
+    }
+
+private:
+    const int m_windowBits;
+    z_stream m_zStream;
+    bool m_initialized = false;
+};
+
+//-------------------------------------------------------------------------------------------------
+
+MessageDeflater::MessageDeflater(bool contextTakeover, int windowBits):
+    m_contextTakeover(contextTakeover),
+    m_windowBits(std::clamp(windowBits, kMinWindowBits, kMaxWindowBits))
+{
+    NX_ASSERT(windowBits == m_windowBits, "windowBits: %1", windowBits);
+}
+
+MessageDeflater::~MessageDeflater() = default;
+
+bool MessageDeflater::compress(const ConstBufferRefType& message, nx::Buffer* outData)
+{
+    if (m_contextTakeover)
+    {
+        if (!m_stream)
+            m_stream = std::make_unique<Stream>(m_windowBits);
+        return m_stream->deflate(message, outData);
+    }
+
+    auto stream = takeStream(m_windowBits);
+    const bool result = stream->deflate(message, outData);
+    stream->reset();
+    releaseStream(std::move(stream));
+    return result;
+}
+
+bool MessageDeflater::contextTakeover() const
+{
+    return m_contextTakeover;
+}
+
+int MessageDeflater::windowBits() const
+{
+    return m_windowBits;
+}
+
+std::vector<std::unique_ptr<MessageDeflater::Stream>>& MessageDeflater::streamPool()
+{
+    // Messages of a connection are compressed in its AIO thread, so the pool is effectively per
+    // AIO thread and needs no synchronization.
+    static thread_local std::vector<std::unique_ptr<Stream>> pool;
+    return pool;
+}
+
+std::unique_ptr<MessageDeflater::Stream> MessageDeflater::takeStream(int windowBits)
+{
+    auto& pool = streamPool();
+    const auto it = std::find_if(pool.begin(), pool.end(),
+        [windowBits](const auto& stream) { return stream->windowBits() == windowBits; });
+    if (it == pool.end())
+        return std::make_unique<Stream>(windowBits);
+
+    auto stream = std::move(*it);
+    pool.erase(it);
+    return stream;
+}
+
+void MessageDeflater::releaseStream(std::unique_ptr<Stream> stream)
+{
+    auto& pool = streamPool();
+    if (pool.size() < kMaxPooledStreamsPerThread)
+        pool.push_back(std::move(stream));
+}
+
+} // namespace nx::utils::bstream::gzip
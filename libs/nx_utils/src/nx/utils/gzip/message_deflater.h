@@ -0,0 +1,60 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "../buffer.h"
+
+namespace nx::utils::bstream::gzip {
+
+/**
+ * Compresses separate messages to raw DEFLATE data as the permessage-deflate websocket extension
+ * requires (rfc7692, section 7.2.1): every message is terminated with an empty stored block which
+ * tail (0x00 0x00 0xff 0xff) is removed.
+ *
+ * With context takeover, the compression state is kept between messages, so a message can refer
+ * to the previous ones. That greatly improves the compression of small similar messages (e.g.,
+ * JSON events). Without it, zlib streams are taken from a per-thread pool for every message, so
+ * that the stream is not allocated and initialized for each message.
+ */
+class NX_UTILS_API MessageDeflater
+{
+public:
+    static constexpr int kMinWindowBits = 9;
+    static constexpr int kMaxWindowBits = 15;
+
+    /**
+     * @param windowBits Base-two logarithm of the LZ77 sliding window size, kMinWindowBits to
+     *     kMaxWindowBits.
+     */
+    MessageDeflater(bool contextTakeover = false, int windowBits = kMaxWindowBits);
+    ~MessageDeflater();
+
+    MessageDeflater(const MessageDeflater&) = delete;
+    MessageDeflater& operator=(const MessageDeflater&) = delete;
+
+    /**
+     * Appends the compressed message to outData.
+     * @return False in case of a zlib error. outData is not changed in this case.
+     */
+    bool compress(const ConstBufferRefType& message, nx::Buffer* outData);
+
+    bool contextTakeover() const;
+    int windowBits() const;
+
+private:
+    class Stream;
+
+    const bool m_contextTakeover;
+    const int m_windowBits;
+    /** Used with context takeover only. */
+    std::unique_ptr<Stream> m_stream;
+
+    static std::vector<std::unique_ptr<Stream>>& streamPool();
+    static std::unique_ptr<Stream> takeStream(int windowBits);
+    static void releaseStream(std::unique_ptr<Stream> stream);
+};
+
+} // namespace nx::utils::bstream::gzip
@@ -76,6 +76,13 @@ QString Logger::OneSecondCache::now()
     return m_cachedDateTime.arg(onlyMsec, 3, 10, QChar('0'));
 }
 
+static File* fileWriter(AbstractWriter* writer)
+{
+    if (const auto asyncWriter = dynamic_cast<AsyncWriter*>(writer))
+        writer = asyncWriter->writer();
+    return dynamic_cast<File*>(writer);
+}
+
 Logger::Logger(
     std::set<Filter> filters,
     Level defaultLevel,
@@ -181,7 +188,7 @@ void Logger::setSettings(const LoggerSettings& loggerSettings)
 
     m_settings = loggerSettings;
 
-    if (auto file = dynamic_cast<File*>(m_writer.get()); file)
+    if (auto file = fileWriter(m_writer.get()); file)
     {
         File::Settings fileSettings;
         fileSettings.maxFileTimePeriodS = m_settings.maxFileTimePeriodS;
@@ -232,7 +239,7 @@ std::optional<QString> Logger::filePath() const
 {
     NX_MUTEX_LOCKER lock(&m_mutex);
 
-    if (const auto file = dynamic_cast<File*>(m_writer.get()); file)
+    if (const auto file = fileWriter(m_writer.get()); file)
         return file->getFileName();
 
     return std::nullopt;
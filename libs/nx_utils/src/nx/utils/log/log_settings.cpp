@@ -4,6 +4,7 @@
 
 #include <QtCore/QSettings>
 
+#include <nx/reflect/enum_string_conversion.h>
 #include <nx/utils/deprecated_settings.h>
 #include <nx/utils/string.h>
 #include <nx/utils/std/filesystem.h>
@@ -66,6 +67,15 @@ bool LoggerSettings::parse(const QString& str)
         {
             archivingEnabled = QVariant(param.second.c_str()).toBool();
         }
+        else if (param.first == kLogAsyncWritingEnabledSymbolicName)
+        {
+            asyncWritingEnabled = QVariant(param.second.c_str()).toBool();
+        }
+        else if (param.first == kLogAsyncOverflowPolicySymbolicName)
+        {
+            parseSucceeded = parseSucceeded
+                && nx::reflect::enumeration::fromString(param.second, &asyncOverflowPolicy);
+        }
     }
 
     if (!NX_ASSERT(maxVolumeSizeB >= maxFileSizeB))
@@ -87,6 +97,8 @@ bool LoggerSettings::operator==(const LoggerSettings& right) const
         && maxFileSizeB == right.maxFileSizeB
         && maxVolumeSizeB == right.maxVolumeSizeB
         && maxFileTimePeriodS == right.maxFileTimePeriodS
+        && asyncWritingEnabled == right.asyncWritingEnabled
+        && asyncOverflowPolicy == right.asyncOverflowPolicy
         && logBaseName == right.logBaseName;
 }
 
@@ -103,6 +115,14 @@ static void readRotationParams(
         kMaxLogFileTimePeriodSymbolicName, (int) defaults.maxFileTimePeriodS.count()).toLongLong());
     target->archivingEnabled = settings->value(
         kLogArchivingEnabledSymbolicName, defaults.archivingEnabled).toBool();
+    target->asyncWritingEnabled = settings->value(
+        kLogAsyncWritingEnabledSymbolicName, defaults.asyncWritingEnabled).toBool();
+    if (!nx::reflect::enumeration::fromString(
+        settings->value(kLogAsyncOverflowPolicySymbolicName).toString().toStdString(),
+        &target->asyncOverflowPolicy))
+    {
+        target->asyncOverflowPolicy = defaults.asyncOverflowPolicy;
+    }
 
     if (!NX_ASSERT(target->maxVolumeSizeB >= target->maxFileSizeB,
         "Volume size %1 is less then file size %2", target->maxVolumeSizeB, target->maxFileSizeB))
@@ -134,7 +154,9 @@ Settings::Settings(QSettings* settings)
             if (levelKey == kMaxLogVolumeSizeSymbolicName
                 || levelKey == kMaxLogFileSizeSymbolicName
                 || levelKey == kMaxLogFileTimePeriodSymbolicName
-                || levelKey == kLogArchivingEnabledSymbolicName)
+                || levelKey == kLogArchivingEnabledSymbolicName
+                || levelKey == kLogAsyncWritingEnabledSymbolicName
+                || levelKey == kLogAsyncOverflowPolicySymbolicName)
             {
                 continue; //< Already parsed by readRotationParams.
             }
@@ -233,6 +255,11 @@ void Settings::loadCompatibilityLogger(
         loggerSettings.maxFileTimePeriodS = std::chrono::duration_cast<std::chrono::seconds>(duration.value());
 
     loggerSettings.archivingEnabled = settings.value(makeKey(kLogArchivingEnabledSymbolicName)).toBool();
+    loggerSettings.asyncWritingEnabled =
+        settings.value(makeKey(kLogAsyncWritingEnabledSymbolicName)).toBool();
+    nx::reflect::enumeration::fromString(
+        settings.value(makeKey(kLogAsyncOverflowPolicySymbolicName)).toString().toStdString(),
+        &loggerSettings.asyncOverflowPolicy);
 
     loggerSettings.logBaseName = settings.value(makeKey("baseName")).toString();
     if (loggerSettings.logBaseName.isEmpty())
@@ -18,6 +18,8 @@ static constexpr char kMaxLogVolumeSizeSymbolicName[] = "maxLogVolumeSizeB";
 static constexpr char kMaxLogFileSizeSymbolicName[] = "maxLogFileSizeB";
 static constexpr char kMaxLogFileTimePeriodSymbolicName[] = "maxLogFileTimePeriodS";
 static constexpr char kLogArchivingEnabledSymbolicName[] = "logArchivingEnabled";
+static constexpr char kLogAsyncWritingEnabledSymbolicName[] = "logAsyncWritingEnabled";
+static constexpr char kLogAsyncOverflowPolicySymbolicName[] = "logAsyncOverflowPolicy";
 
 /**
  * Specifies configuration of a logger.
@@ -28,9 +30,11 @@ static constexpr char kLogArchivingEnabledSymbolicName[] = "logArchivingEnabled"
  * param = key [= value]
  * value = TEXT
  * param = file | dir | maxLogVolumeSizeB | maxLogFileSizeB | maxLogFileTimePeriodS | level
+ *     | logArchivingEnabled | logAsyncWritingEnabled | logAsyncOverflowPolicy
  * level = LogLevel ["[" messageTagPrefixes "]"]
  * messageTagPrefixes = messageTagPrefix (", " messageTagPrefix)*
  * file = - | fileName
+ * logAsyncOverflowPolicy = drop | block
  * </code></pre>
  *
  * "-" means STDOUT
@@ -66,6 +70,11 @@ public:
     qint64 maxFileSizeB = kDefaultMaxLogFileSizeB; //< 10 MB.
     std::chrono::seconds maxFileTimePeriodS = kDefaultMaxLogFileTimePeriodS; //< 0.
     bool archivingEnabled = kDefaultLogArchivingEnabled;
+
+    /** Messages are written from a dedicated thread, see AsyncWriter. */
+    bool asyncWritingEnabled = kDefaultLogAsyncWritingEnabled;
+    AsyncWriter::OverflowPolicy asyncOverflowPolicy = AsyncWriter::OverflowPolicy::drop;
+
     QString logBaseName;
 
     bool parse(const QString& str);
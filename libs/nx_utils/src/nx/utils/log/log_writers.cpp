@@ -2,6 +2,8 @@
 
 #include "log_writers.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 #include <QtCore/QDateTime>
@@ -19,11 +21,21 @@
 #include "to_string.h"
 
 static constexpr int kBufferSize = 64 * 1024;
+static constexpr std::chrono::milliseconds kAsyncWritePeriod(100);
 
 namespace nx {
 namespace utils {
 namespace log {
 
+void AbstractWriter::writeBatch(const std::vector<Record>& records)
+{
+    for (const auto& record: records)
+    {
+        write(record.level, QString::fromUtf8(
+            record.message.data(), (qsizetype) record.message.size()));
+    }
+}
+
 cf::future<cf::unit> AbstractWriter::stopArchivingAsync()
 {
     return cf::make_ready_future(cf::unit());
@@ -92,6 +104,28 @@ void File::write(Level /*level*/, const QString& message)
     rotateIfNeeded(&lock);
 }
 
+void File::writeBatch(const std::vector<Record>& records)
+{
+    NX_MUTEX_LOCKER lock(&m_mutex);
+    for (const auto& record: records)
+    {
+        if (!openFile())
+        {
+            std::cerr << std::string(record.message) + '\n';
+            continue;
+        }
+
+        m_file.write(record.message.data(), (std::streamsize) record.message.size());
+        m_file.put('\n');
+        m_currentPos += record.message.size() + 1;
+        rotateIfNeeded(&lock); //< Closes and so flushes the file if it is rotated.
+    }
+
+    // The whole batch is flushed at once.
+    if (m_file.is_open())
+        m_file.flush();
+}
+
 QString File::makeFileName(QString fileName, size_t backupNumber, File::Extension ext)
 {
     auto removedExtension = fileName;
@@ -501,6 +535,341 @@ qint64 File::totalVolumeSize()
     return size;
 }
 
+//-------------------------------------------------------------------------------------------------
+
+/** Most of the threads log rarely, so their buffers are not grown to the full size. */
+static constexpr size_t kInitialAsyncLogThreadBufferSizeB = 4 * 1024;
+
+/**
+ * Single producer, single consumer ring buffer of the messages of one logging thread. Positions
+ * grow monotonically and are taken modulo the buffer size. The buffer starts small and grows to
+ * the maximum size on the first overflow.
+ */
+class AsyncWriter::ThreadBuffer
+{
+public:
+    struct Header
+    {
+        quint64 sequence = 0;
+        quint32 size = 0;
+        Level level = Level::undefined;
+    };
+
+    ThreadBuffer(size_t maxSize):
+        m_data(std::min(maxSize, kInitialAsyncLogThreadBufferSizeB)),
+        m_maxSize(maxSize)
+    {
+    }
+
+    bool fits(size_t messageSize) const { return sizeof(Header) + messageSize <= m_maxSize; }
+    bool isEmpty() const { return m_readPos.load() == m_writePos.load(); }
+    bool canGrow() const { return m_data.size() < m_maxSize && !m_isClosed; }
+
+    /**
+     * Called by the owning thread only, when the buffer is empty and the writer thread does not
+     * take the messages (the write mutex is locked).
+     */
+    void grow()
+    {
+        m_data.resize(m_maxSize);
+        m_writePos = 0;
+        m_readPos = 0;
+    }
+
+    /**
+     * Called by the writer when it is destroyed. Frees the ring, so that the threads which still
+     * hold the buffer keep only the empty object until they remove it.
+     */
+    void close()
+    {
+        m_data = {};
+        m_isClosed = true;
+    }
+
+    bool isClosed() const { return m_isClosed; }
+
+    /**
+     * Called by the owning thread only.
+     * @param isHalfFull Set to true if the buffer has become at least half full.
+     * @return False if there is not enough space.
+     */
+    bool push(const Header& header, const char* message, bool* isHalfFull)
+    {
+        const size_t writePos = m_writePos.load(std::memory_order_relaxed);
+        const size_t used = writePos - m_readPos.load(std::memory_order_acquire);
+        const size_t size = sizeof(Header) + header.size;
+        if (m_data.size() - used < size)
+            return false;
+
+        copyIn(writePos, &header, sizeof(Header));
+        copyIn(writePos + sizeof(Header), message, header.size);
+        m_writePos.store(writePos + size, std::memory_order_release);
+
+        *isHalfFull = used < m_data.size() / 2 && used + size >= m_data.size() / 2;
+        return true;
+    }
+
+    /** Called by the writer thread only. Appends the raw records to the data. */
+    void take(std::string* data)
+    {
+        const size_t readPos = m_readPos.load(std::memory_order_relaxed);
+        const size_t writePos = m_writePos.load(std::memory_order_acquire);
+        const size_t size = writePos - readPos;
+        if (size == 0)
+            return;
+
+        const size_t offset = readPos % m_data.size();
+        const size_t firstPart = std::min(size, m_data.size() - offset);
+        data->append(m_data.data() + offset, firstPart);
+        data->append(m_data.data(), size - firstPart);
+        m_readPos.store(writePos, std::memory_order_release);
+    }
+
+private:
+    void copyIn(size_t pos, const void* source, size_t size)
+    {
+        const size_t offset = pos % m_data.size();
+        const size_t firstPart = std::min(size, m_data.size() - offset);
+        memcpy(m_data.data() + offset, source, firstPart);
+        memcpy(m_data.data(), (const char*) source + firstPart, size - firstPart);
+    }
+
+private:
+    std::vector<char> m_data;
+    const size_t m_maxSize;
+    std::atomic<size_t> m_writePos{0};
+    std::atomic<size_t> m_readPos{0};
+    std::atomic<bool> m_isClosed{false};
+};
+
+/** Buffers of the writers the thread has written to, by writer id. */
+struct AsyncWriter::ThreadBuffers
+{
+    std::vector<std::pair<int, std::shared_ptr<ThreadBuffer>>> buffers;
+
+    ~ThreadBuffers() { isDestroyed = true; }
+
+    static thread_local bool isDestroyed;
+};
+
+thread_local bool AsyncWriter::ThreadBuffers::isDestroyed = false;
+
+static std::atomic<int> asyncWriterCounter{0};
+
+AsyncWriter::AsyncWriter(
+    std::unique_ptr<AbstractWriter> writer,
+    OverflowPolicy overflowPolicy,
+    size_t threadBufferSize)
+    :
+    m_writer(std::move(writer)),
+    m_overflowPolicy(overflowPolicy),
+    m_threadBufferSize(threadBufferSize),
+    m_id(++asyncWriterCounter)
+{
+    m_thread = std::thread([this]() { run(); });
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    {
+        NX_MUTEX_LOCKER lock(&m_mutex);
+        m_needToStop = true;
+        m_dataAvailable.wakeAll();
+        m_spaceAvailable.wakeAll();
+    }
+    m_thread.join();
+    flush();
+
+    NX_MUTEX_LOCKER lock(&m_mutex);
+    for (const auto& buffer: m_buffers)
+        buffer->close();
+}
+
+void AsyncWriter::write(Level level, const QString& message)
+{
+    const QByteArray data = message.toUtf8();
+    ThreadBuffer* const buffer = threadBuffer();
+    if (!buffer || !buffer->fits(data.size()))
+    {
+        // The message is written synchronously after the messages of the thread in the buffer.
+        NX_MUTEX_LOCKER lock(&m_writeMutex);
+        writeBuffers(&lock);
+        m_writer->write(level, message);
+        return;
+    }
+
+    ThreadBuffer::Header header;
+    header.sequence = ++m_sequence;
+    header.size = (quint32) data.size();
+    header.level = level;
+
+    bool isHalfFull = false;
+    if (buffer->push(header, data.constData(), &isHalfFull))
+    {
+        if (isHalfFull)
+            wakeUpWriterThread();
+        return;
+    }
+
+    if (buffer->canGrow())
+    {
+        // The messages in the buffer are written before it is grown, so the order is kept.
+        NX_MUTEX_LOCKER lock(&m_writeMutex);
+        writeBuffers(&lock);
+        buffer->grow();
+        if (buffer->push(header, data.constData(), &isHalfFull))
+            return;
+    }
+
+    if (m_overflowPolicy == OverflowPolicy::drop)
+    {
+        ++m_droppedMessageCount;
+        return;
+    }
+
+    NX_MUTEX_LOCKER lock(&m_mutex);
+    while (!buffer->push(header, data.constData(), &isHalfFull))
+    {
+        if (m_needToStop)
+        {
+            ++m_droppedMessageCount;
+            return;
+        }
+        m_dataAvailable.wakeOne();
+        m_spaceAvailable.wait(lock.mutex());
+    }
+}
+
+cf::future<cf::unit> AsyncWriter::stopArchivingAsync()
+{
+    flush();
+    return m_writer->stopArchivingAsync();
+}
+
+void AsyncWriter::flush()
+{
+    NX_MUTEX_LOCKER lock(&m_writeMutex);
+    writeBuffers(&lock);
+}
+
+size_t AsyncWriter::currentThreadBufferCount()
+{
+    const auto threadBuffers = currentThreadBuffers();
+    return threadBuffers ? threadBuffers->buffers.size() : 0;
+}
+
+AsyncWriter::ThreadBuffers* AsyncWriter::currentThreadBuffers()
+{
+    if (ThreadBuffers::isDestroyed)
+        return nullptr; //< Thread local objects of the exiting thread may still log something.
+    static thread_local ThreadBuffers threadBuffers;
+    return &threadBuffers;
+}
+
+AsyncWriter::ThreadBuffer* AsyncWriter::threadBuffer()
+{
+    const auto threadBuffers = currentThreadBuffers();
+    if (!threadBuffers)
+        return nullptr;
+
+    for (const auto& [id, buffer]: threadBuffers->buffers)
+    {
+        if (id == m_id)
+            return buffer.get();
+    }
+
+    // The buffers of the destroyed writers (e.g. after the loggers are rebuilt) are dropped when
+    // the thread writes to a new one.
+    std::erase_if(threadBuffers->buffers,
+        [](const auto& item) { return item.second->isClosed(); });
+
+    auto buffer = std::make_shared<ThreadBuffer>(m_threadBufferSize);
+    {
+        NX_MUTEX_LOCKER lock(&m_mutex);
+        m_buffers.push_back(buffer);
+    }
+    threadBuffers->buffers.emplace_back(m_id, buffer);
+    return buffer.get();
+}
+
+void AsyncWriter::wakeUpWriterThread()
+{
+    NX_MUTEX_LOCKER lock(&m_mutex);
+    m_dataAvailable.wakeOne();
+}
+
+void AsyncWriter::run()
+{
+    NX_MUTEX_LOCKER lock(&m_mutex);
+    while (!m_needToStop)
+    {
+        m_dataAvailable.wait(lock.mutex(), kAsyncWritePeriod);
+        {
+            nx::Unlocker<nx::Mutex> unlocker(&lock);
+            flush();
+        }
+        m_spaceAvailable.wakeAll();
+    }
+}
+
+void AsyncWriter::writeBuffers(nx::Locker<nx::Mutex>* /*writeLock*/)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        NX_MUTEX_LOCKER lock(&m_mutex);
+
+        // The buffers of the exited threads are removed once they are written.
+        std::erase_if(m_buffers,
+            [](const auto& buffer) { return buffer.use_count() == 1 && buffer->isEmpty(); });
+        buffers = m_buffers;
+    }
+
+    m_data.clear();
+    for (const auto& buffer: buffers)
+        buffer->take(&m_data);
+
+    std::vector<std::pair<quint64, Record>> records;
+    for (size_t pos = 0; pos < m_data.size(); )
+    {
+        ThreadBuffer::Header header;
+        memcpy(&header, m_data.data() + pos, sizeof(header));
+        pos += sizeof(header);
+        records.emplace_back(
+            header.sequence,
+            Record{header.level, std::string_view(m_data.data() + pos, header.size)});
+        pos += header.size;
+    }
+
+    std::string droppedMessage;
+    const size_t droppedMessageCount = m_droppedMessageCount;
+    if (droppedMessageCount != m_reportedDroppedMessageCount)
+    {
+        droppedMessage = nx::format("%1 WARNING AsyncWriter: %2 message(s) are dropped because "
+            "the log buffer is full").args(
+                QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm:ss.zzz"),
+                droppedMessageCount - m_reportedDroppedMessageCount).toStdString();
+        m_reportedDroppedMessageCount = droppedMessageCount;
+    }
+
+    if (records.empty() && droppedMessage.empty())
+        return;
+
+    // The messages of the different threads are put in the order they were written.
+    std::sort(records.begin(), records.end(),
+        [](const auto& left, const auto& right) { return left.first < right.first; });
+
+    std::vector<Record> batch;
+    batch.reserve(records.size() + 1);
+    for (const auto& record: records)
+        batch.push_back(record.second);
+    if (!droppedMessage.empty())
+        batch.push_back(Record{Level::warning, droppedMessage});
+
+    m_writer->writeBatch(batch);
+}
+
+//-------------------------------------------------------------------------------------------------
+
 void Buffer::write(Level /*level*/, const QString& message)
 {
     NX_MUTEX_LOCKER lock(&m_mutex);
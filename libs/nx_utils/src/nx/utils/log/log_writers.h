@@ -2,8 +2,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <fstream>
 #include <future>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include <QtCore/QDateTime>
 #include <QtCore/QFileInfo>
@@ -22,12 +27,26 @@ static constexpr qint64 kDefaultMaxLogVolumeSizeB = 250 * 1024 * 1024;
 static constexpr qint64 kDefaultMaxLogFileSizeB = 10 * 1024 * 1024;
 static constexpr std::chrono::seconds kDefaultMaxLogFileTimePeriodS = std::chrono::seconds::zero();
 static constexpr bool kDefaultLogArchivingEnabled = true;
+static constexpr bool kDefaultLogAsyncWritingEnabled = false;
+static constexpr size_t kDefaultAsyncLogThreadBufferSizeB = 256 * 1024;
 
 class NX_UTILS_API AbstractWriter
 {
 public:
+    struct Record
+    {
+        Level level = Level::undefined;
+        std::string_view message; /**< UTF-8 encoded. */
+    };
+
     virtual ~AbstractWriter() = default;
     virtual void write(Level level, const QString& message) = 0;
+
+    /**
+     * Writes the messages in the given order. Default implementation writes them one by one.
+     */
+    virtual void writeBatch(const std::vector<Record>& records);
+
     virtual cf::future<cf::unit> stopArchivingAsync();
 };
 
@@ -86,6 +105,7 @@ public:
     File(Settings settings);
     virtual ~File();
     virtual void write(Level level, const QString& message) override;
+    virtual void writeBatch(const std::vector<Record>& records) override;
     virtual cf::future<cf::unit> stopArchivingAsync() override;
     QString getFileName(size_t backupNumber = 0) const;
 
@@ -115,6 +135,86 @@ private:
 
 NX_UTILS_API QString toQString(File::Extension ext);
 
+/**
+ * Passes messages to another writer from a dedicated thread, so the logging threads do not wait
+ * for the messages to be written. Every logging thread puts UTF-8 encoded messages to its own ring
+ * buffer without locking, and the writer thread takes the messages of all threads in batches,
+ * ordered the same way they were written. A thread buffer is small until it overflows for the
+ * first time, and then grows to threadBufferSize.
+ */
+class NX_UTILS_API AsyncWriter: public AbstractWriter
+{
+public:
+    /** What the logging thread does if its buffer is full. */
+    enum class OverflowPolicy
+    {
+        /** The message is dropped. The number of dropped messages is written to the log. */
+        drop,
+        /** The thread waits until the writer thread frees the buffer. */
+        block,
+    };
+
+    template<typename Visitor>
+    friend constexpr auto nxReflectVisitAllEnumItems(OverflowPolicy*, Visitor&& visitor)
+    {
+        using Item = nx::reflect::enumeration::Item<OverflowPolicy>;
+        return visitor(
+            Item{OverflowPolicy::drop, "drop"},
+            Item{OverflowPolicy::block, "block"}
+        );
+    }
+
+    AsyncWriter(
+        std::unique_ptr<AbstractWriter> writer,
+        OverflowPolicy overflowPolicy = OverflowPolicy::drop,
+        size_t threadBufferSize = kDefaultAsyncLogThreadBufferSizeB);
+    virtual ~AsyncWriter() override;
+
+    virtual void write(Level level, const QString& message) override;
+    virtual cf::future<cf::unit> stopArchivingAsync() override;
+
+    /** Passes the messages which are in the buffers to the writer in the calling thread. */
+    void flush();
+
+    AbstractWriter* writer() const { return m_writer.get(); }
+    size_t droppedMessageCount() const { return m_droppedMessageCount; }
+
+    /** The number of AsyncWriter buffers the calling thread holds. Used in tests. */
+    static size_t currentThreadBufferCount();
+
+private:
+    class ThreadBuffer;
+    struct ThreadBuffers;
+
+    static ThreadBuffers* currentThreadBuffers();
+    ThreadBuffer* threadBuffer();
+    void wakeUpWriterThread();
+    void run();
+    void writeBuffers(nx::Locker<nx::Mutex>* writeLock);
+
+private:
+    const std::unique_ptr<AbstractWriter> m_writer;
+    const OverflowPolicy m_overflowPolicy;
+    const size_t m_threadBufferSize;
+    const int m_id;
+
+    std::atomic<quint64> m_sequence{0};
+    std::atomic<size_t> m_droppedMessageCount{0};
+    size_t m_reportedDroppedMessageCount = 0;
+
+    nx::Mutex m_mutex;
+    nx::WaitCondition m_dataAvailable;
+    nx::WaitCondition m_spaceAvailable;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+    bool m_needToStop = false;
+
+    /** Only one thread at a time takes the messages from the buffers. */
+    nx::Mutex m_writeMutex;
+    std::string m_data;
+
+    std::thread m_thread;
+};
+
 /**
  * Writes messages to internal buffer.
  */
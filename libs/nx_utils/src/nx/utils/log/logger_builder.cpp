@@ -104,6 +104,12 @@ std::unique_ptr<Logger> LoggerBuilder::buildLogger(
         {
             writer = std::make_unique<StdOut>();
         }
+
+        if (settings.asyncWritingEnabled)
+        {
+            writer = std::make_unique<AsyncWriter>(
+                std::move(writer), settings.asyncOverflowPolicy);
+        }
     }
 
     for (const auto& expression: invalidFilters)
@@ -0,0 +1,299 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <nx/reflect/type_utils.h>
+
+#include "../log/assert.h"
+
+namespace nx::utils::math {
+
+/**
+ * Counts values in log-linear buckets (the HdrHistogram layout), so that any percentile of the
+ * series can be read with a bounded relative error while the memory stays fixed.
+ *
+ * Values below 2^precisionBits have a bucket each. Every following power-of-two range is split
+ * into 2^(precisionBits - 1) equal buckets, so the relative error of a reported value does not
+ * exceed 2^-(precisionBits - 1). Negative values are counted as zero, values above maxValue are
+ * counted as maxValue.
+ *
+ * add() and remove() are lock-free and can be called concurrently. Reading a percentile while the
+ * histogram is modified gives some value between the results before and after the modification.
+ */
+template<typename ValueType>
+requires std::disjunction_v<
+    std::is_arithmetic<ValueType>,
+    nx::reflect::IsStdChronoDuration<ValueType>>
+class Histogram
+{
+public:
+    static constexpr int kDefaultPrecisionBits = 7;
+
+    /**
+     * @param maxValue The largest value that is counted precisely.
+     * @param precisionBits In the range [2, 16].
+     */
+    Histogram(ValueType maxValue, int precisionBits = kDefaultPrecisionBits):
+        m_precisionBits(std::clamp(precisionBits, 2, 16)),
+        m_subBucketCount(std::uint64_t(1) << m_precisionBits),
+        m_halfSubBucketCount(m_subBucketCount / 2),
+        m_maxValue(std::min(toInteger(maxValue), std::uint64_t(1) << 62))
+    {
+        NX_ASSERT(precisionBits == m_precisionBits, "precisionBits: %1", precisionBits);
+
+        m_bucketCount = bucketIndex(m_maxValue) + 1;
+        m_buckets = std::make_unique<std::atomic<std::uint64_t>[]>(m_bucketCount);
+    }
+
+    Histogram(const Histogram& other):
+        m_precisionBits(other.m_precisionBits),
+        m_subBucketCount(other.m_subBucketCount),
+        m_halfSubBucketCount(other.m_halfSubBucketCount),
+        m_maxValue(other.m_maxValue),
+        m_bucketCount(other.m_bucketCount),
+        m_buckets(std::make_unique<std::atomic<std::uint64_t>[]>(m_bucketCount))
+    {
+        merge(other);
+    }
+
+    Histogram(Histogram&& other) noexcept:
+        m_precisionBits(other.m_precisionBits),
+        m_subBucketCount(other.m_subBucketCount),
+        m_halfSubBucketCount(other.m_halfSubBucketCount),
+        m_maxValue(other.m_maxValue),
+        m_bucketCount(other.m_bucketCount),
+        m_buckets(std::move(other.m_buckets)),
+        m_count(other.m_count.load())
+    {
+    }
+
+    Histogram& operator=(const Histogram&) = delete;
+    Histogram& operator=(Histogram&&) = delete;
+
+    void swap(Histogram& other)
+    {
+        NX_ASSERT(hasSameLayout(other));
+        std::swap(m_buckets, other.m_buckets);
+        const auto count = m_count.exchange(other.m_count.load());
+        other.m_count = count;
+    }
+
+    void add(ValueType value, std::uint64_t count = 1)
+    {
+        m_buckets[bucketIndex(toInteger(value))].fetch_add(count, std::memory_order_relaxed);
+        m_count.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * Removes the value added before. E.g., when it leaves a sliding window.
+     */
+    void remove(ValueType value, std::uint64_t count = 1)
+    {
+        auto& bucket = m_buckets[bucketIndex(toInteger(value))];
+        NX_ASSERT(bucket.load(std::memory_order_relaxed) >= count);
+        bucket.fetch_sub(count, std::memory_order_relaxed);
+        m_count.fetch_sub(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * Adds all values of other. Both histograms must be created with the same parameters.
+     */
+    void merge(const Histogram& other)
+    {
+        if (!NX_ASSERT(hasSameLayout(other)))
+            return;
+
+        for (std::size_t i = 0; i < m_bucketCount; ++i)
+        {
+            if (const auto count = other.m_buckets[i].load(std::memory_order_relaxed))
+                m_buckets[i].fetch_add(count, std::memory_order_relaxed);
+        }
+        m_count.fetch_add(other.m_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    void clear()
+    {
+        for (std::size_t i = 0; i < m_bucketCount; ++i)
+            m_buckets[i].store(0, std::memory_order_relaxed);
+        m_count.store(0, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+    bool empty() const { return count() == 0; }
+
+    /**
+     * @param percentile A value in the range (0, 1].
+     * @return The largest value of the bucket that contains the requested percentile.
+     *     ValueType{} if the histogram is empty.
+     */
+    ValueType valueAtPercentile(double percentile) const
+    {
+        NX_ASSERT(0 < percentile && percentile <= 1, "percentile: %1", percentile);
+
+        const auto total = count();
+        if (total == 0)
+            return ValueType{};
+
+        const auto rank = std::clamp<std::uint64_t>(
+            (std::uint64_t) std::ceil(std::clamp(percentile, 0.0, 1.0) * total), 1, total);
+
+        std::uint64_t countSoFar = 0;
+        for (std::size_t i = 0; i < m_bucketCount; ++i)
+        {
+            countSoFar += m_buckets[i].load(std::memory_order_relaxed);
+            if (countSoFar >= rank)
+                return fromInteger(std::min(highestEquivalentValue(i), m_maxValue));
+        }
+
+        // Buckets have been modified concurrently.
+        return fromInteger(m_maxValue);
+    }
+
+    /**
+     * @return The number of counters. The memory used by the histogram is proportional to it.
+     */
+    std::size_t bucketCount() const { return m_bucketCount; }
+
+private:
+    bool hasSameLayout(const Histogram& other) const
+    {
+        return m_precisionBits == other.m_precisionBits && m_maxValue == other.m_maxValue;
+    }
+
+    std::size_t bucketIndex(std::uint64_t value) const
+    {
+        value = std::min(value, m_maxValue);
+        if (value < m_subBucketCount)
+            return (std::size_t) value;
+
+        // value >> shift is in [m_halfSubBucketCount, m_subBucketCount).
+        const int shift = std::bit_width(value) - m_precisionBits;
+        return (std::size_t) (m_subBucketCount
+            + (shift - 1) * m_halfSubBucketCount
+            + (value >> shift) - m_halfSubBucketCount);
+    }
+
+    std::uint64_t highestEquivalentValue(std::size_t index) const
+    {
+        if (index < m_subBucketCount)
+            return index;
+
+        const auto offset = index - m_subBucketCount;
+        const int shift = (int) (offset / m_halfSubBucketCount) + 1;
+        const auto subBucket = offset % m_halfSubBucketCount + m_halfSubBucketCount;
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+    template<typename T>
+    static std::uint64_t toUnsigned(T value)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+            return value > 0 ? (std::uint64_t) std::llround(value) : 0;
+        else if constexpr (std::is_signed_v<T>)
+            return value > 0 ? (std::uint64_t) value : 0;
+        else
+            return (std::uint64_t) value;
+    }
+
+    static std::uint64_t toInteger(ValueType value)
+    {
+        if constexpr (nx::reflect::IsStdChronoDurationV<ValueType>)
+            return toUnsigned(value.count());
+        else
+            return toUnsigned(value);
+    }
+
+    static ValueType fromInteger(std::uint64_t value)
+    {
+        if constexpr (nx::reflect::IsStdChronoDurationV<ValueType>)
+            return ValueType((typename ValueType::rep) value);
+        else
+            return (ValueType) value;
+    }
+
+private:
+    const int m_precisionBits;
+    const std::uint64_t m_subBucketCount;
+    const std::uint64_t m_halfSubBucketCount;
+    const std::uint64_t m_maxValue;
+    std::size_t m_bucketCount = 0;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_buckets;
+    std::atomic<std::uint64_t> m_count{0};
+};
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * A set of Histograms written by different threads. Threads adding values concurrently do not
+ * share counters, so the add() calls do not contend for the same cache lines.
+ * The shards are merged when the data is read.
+ */
+template<typename ValueType>
+class ShardedHistogram
+{
+public:
+    /**
+     * @param shardCount 0 means the number of hardware threads.
+     */
+    ShardedHistogram(
+        ValueType maxValue,
+        int precisionBits = Histogram<ValueType>::kDefaultPrecisionBits,
+        std::size_t shardCount = 0)
+    {
+        if (shardCount == 0)
+            shardCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+        m_shards.reserve(shardCount);
+        for (std::size_t i = 0; i < shardCount; ++i)
+            m_shards.emplace_back(maxValue, precisionBits);
+    }
+
+    void add(ValueType value, std::uint64_t count = 1)
+    {
+        m_shards[currentShard()].add(value, count);
+    }
+
+    /**
+     * @return All values added to all shards.
+     */
+    Histogram<ValueType> merged() const
+    {
+        Histogram<ValueType> result(m_shards.front());
+        for (std::size_t i = 1; i < m_shards.size(); ++i)
+            result.merge(m_shards[i]);
+        return result;
+    }
+
+    void clear()
+    {
+        for (auto& shard: m_shards)
+            shard.clear();
+    }
+
+    std::size_t shardCount() const { return m_shards.size(); }
+
+private:
+    std::size_t currentShard() const
+    {
+        static thread_local const std::size_t threadHash =
+            std::hash<std::thread::id>()(std::this_thread::get_id());
+        return threadHash % m_shards.size();
+    }
+
+private:
+    std::vector<Histogram<ValueType>> m_shards;
+};
+
+} // namespace nx::utils::math
@@ -0,0 +1,154 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "../time.h"
+#include "histogram.h"
+
+namespace nx::utils::math {
+
+/**
+ * Collects a Histogram of a number series over a fixed-duration sliding window, so that any
+ * percentile of the window can be read. Unlike PercentilePerPeriod, the memory does not depend on
+ * the number of values added, and one instance serves all percentiles.
+ *
+ * The collection periods of the histograms overlap the same way as in PercentilePerPeriod. When a
+ * histogram collection period ends, the histogram becomes the reported one until the next period
+ * ends.
+ */
+template<typename ValueType>
+class HistogramPerPeriod
+{
+private:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    struct Context
+    {
+        Histogram<ValueType> histogram;
+        time_point collectionStartTime;
+        time_point collectionEndTime;
+
+        Context(ValueType maxValue, int precisionBits): histogram(maxValue, precisionBits) {}
+    };
+
+public:
+    /**
+     * @param maxValue, precisionBits See Histogram.
+     */
+    HistogramPerPeriod(
+        std::chrono::milliseconds period,
+        ValueType maxValue,
+        int precisionBits = Histogram<ValueType>::kDefaultPrecisionBits,
+        std::size_t histogramCount = 2)
+        :
+        m_period(period),
+        m_reported(maxValue, precisionBits)
+    {
+        using namespace std::chrono;
+
+        NX_ASSERT(m_period > milliseconds(2));
+        if (m_period <= milliseconds(2))
+            const_cast<milliseconds&>(m_period) = milliseconds(2);
+
+        NX_ASSERT(histogramCount >= 2);
+        if (histogramCount < 2)
+            histogramCount = 2;
+
+        NX_ASSERT(m_period / histogramCount > milliseconds::zero(),
+            "collection period overlap is too small! period: %1, histogramCount: %2",
+            m_period, histogramCount);
+        if (m_period / histogramCount == milliseconds::zero())
+            histogramCount = 2;
+
+        m_histograms.reserve(histogramCount);
+        for (std::size_t i = 0; i < histogramCount; ++i)
+            m_histograms.emplace_back(maxValue, precisionBits);
+    }
+
+    void add(const ValueType& value)
+    {
+        const auto now = nx::utils::monotonicTime();
+
+        clearExpiredHistograms(now);
+
+        for (auto& context: m_histograms)
+        {
+            if (context.collectionStartTime <= now && now < context.collectionEndTime)
+                context.histogram.add(value);
+        }
+    }
+
+    /**
+     * @param percentile A value in the range (0, 1].
+     * @return The value at the percentile over the last complete period.
+     */
+    ValueType valueAtPercentile(double percentile) const
+    {
+        return histogram().valueAtPercentile(percentile);
+    }
+
+    /**
+     * @return The histogram of the last complete period.
+     */
+    const Histogram<ValueType>& histogram() const
+    {
+        const auto now = nx::utils::monotonicTime();
+
+        const_cast<HistogramPerPeriod<ValueType>*>(this)->clearExpiredHistograms(now);
+
+        return m_reported;
+    }
+
+private:
+    void initialize(time_point now)
+    {
+        const auto overlap = m_period / m_histograms.size();
+        for (std::size_t i = 0; i < m_histograms.size(); ++i)
+        {
+            auto& context = m_histograms[i];
+            context.collectionStartTime = now + overlap * i;
+            context.collectionEndTime = context.collectionStartTime + m_period;
+            context.histogram.clear();
+        }
+
+        m_reported.clear();
+        m_earliest = 0;
+    }
+
+    void clearExpiredHistograms(time_point now)
+    {
+        if (m_histograms[m_earliest].collectionEndTime + m_period <= now
+            || m_histograms[m_earliest].collectionEndTime == time_point{})
+        {
+            // Too much time has passed for collection times to fix themselves.
+            initialize(now);
+            return;
+        }
+
+        for (std::size_t i = 0; i < m_histograms.size(); ++i)
+        {
+            auto& context = m_histograms[i];
+            if (context.collectionEndTime <= now)
+            {
+                m_earliest = i == m_histograms.size() - 1 ? 0 : i + 1;
+                // The collected histogram is reported, the previously reported one is reused.
+                m_reported.swap(context.histogram);
+                context.histogram.clear();
+                context.collectionStartTime = context.collectionEndTime;
+                context.collectionEndTime = context.collectionStartTime + m_period;
+            }
+        }
+    }
+
+private:
+    const std::chrono::milliseconds m_period;
+
+    std::vector<Context> m_histograms;
+    Histogram<ValueType> m_reported;
+    std::size_t m_earliest{0};
+};
+
+} // namespace nx::utils::math
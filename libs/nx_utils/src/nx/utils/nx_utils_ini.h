@@ -73,6 +73,10 @@ struct NX_UTILS_API Ini: nx::kit::IniConfig
 
     NX_INI_INT(86400, cameraTimestampThresholdS,
         "Threshold in seconds for analytic timestamps checking.");
+
+    NX_INI_FLAG(1, useByteArrayPool,
+        "Allocate media packet payloads from the process-wide nx::utils::ByteArrayPool instead of\n"
+        "allocating every payload with the system allocator.");
 };
 
 NX_UTILS_API Ini& ini();
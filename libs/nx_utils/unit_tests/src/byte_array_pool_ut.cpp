@@ -0,0 +1,253 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nx/kit/utils.h>
+#include <nx/utils/byte_array.h>
+#include <nx/utils/byte_array_pool.h>
+
+namespace nx::utils::test {
+
+class ByteArrayPool:
+    public ::testing::Test
+{
+protected:
+    static constexpr std::size_t kAlignment = 32;
+
+    std::shared_ptr<nx::utils::ByteArrayPool> m_pool = nx::utils::ByteArrayPool::create();
+
+    void* allocate(std::size_t* size)
+    {
+        void* block = m_pool->allocate(size, kAlignment);
+        EXPECT_NE(nullptr, block);
+        EXPECT_EQ(0U, (std::uintptr_t) block % kAlignment);
+        return block;
+    }
+};
+
+TEST_F(ByteArrayPool, size_is_rounded_up_to_size_class)
+{
+    std::size_t size = 1;
+    void* block = allocate(&size);
+    ASSERT_EQ(nx::utils::ByteArrayPool::kMinBlockSize, size);
+    m_pool->release(block, size, kAlignment);
+
+    size = 1025;
+    block = allocate(&size);
+    ASSERT_EQ(1280U, size);
+    std::memset(block, 0, size); //< The whole block is usable.
+    m_pool->release(block, size, kAlignment);
+
+    size = 100'000;
+    block = allocate(&size);
+    ASSERT_GE(size, 100'000U);
+    ASSERT_LE(size, 100'000U * 5 / 4);
+    m_pool->release(block, size, kAlignment);
+}
+
+TEST_F(ByteArrayPool, freed_block_is_reused_by_the_same_thread)
+{
+    std::size_t size = 10'000;
+    void* block = allocate(&size);
+    m_pool->release(block, size, kAlignment);
+
+    std::size_t size2 = 10'000;
+    ASSERT_EQ(block, allocate(&size2));
+    ASSERT_EQ(size, size2);
+    m_pool->release(block, size2, kAlignment);
+
+    const auto statistics = m_pool->statistics();
+    ASSERT_EQ(1U, statistics.cacheMisses);
+    ASSERT_EQ(1U, statistics.cacheHits);
+    ASSERT_EQ(0U, statistics.usedBytes);
+    ASSERT_EQ(size, statistics.cachedBytes);
+}
+
+TEST_F(ByteArrayPool, blocks_freed_by_another_thread_are_reused)
+{
+    constexpr int kBlockCount = 1000;
+
+    std::vector<void*> blocks;
+    std::size_t size = 4'000;
+    for (int i = 0; i < kBlockCount; ++i)
+        blocks.push_back(allocate(&size));
+
+    std::thread(
+        [this, &blocks, size]()
+        {
+            for (void* block: blocks)
+                m_pool->release(block, size, kAlignment);
+        }).join();
+
+    // The exited thread has returned its cache to the shared cache.
+    ASSERT_EQ(size * kBlockCount, m_pool->statistics().cachedBytes);
+
+    for (int i = 0; i < kBlockCount; ++i)
+        blocks[i] = allocate(&size);
+
+    const auto statistics = m_pool->statistics();
+    ASSERT_EQ((std::uint64_t) kBlockCount, statistics.cacheHits);
+    ASSERT_EQ(0U, statistics.cachedBytes);
+    ASSERT_EQ(size * kBlockCount, statistics.usedBytes);
+
+    for (void* block: blocks)
+        m_pool->release(block, size, kAlignment);
+}
+
+TEST_F(ByteArrayPool, large_and_overaligned_blocks_are_not_pooled)
+{
+    std::size_t size = nx::utils::ByteArrayPool::kMaxBlockSize + 1;
+    void* block = allocate(&size);
+    ASSERT_EQ(nx::utils::ByteArrayPool::kMaxBlockSize + 1, size);
+    m_pool->release(block, size, kAlignment);
+
+    constexpr std::size_t kLargeAlignment = nx::utils::ByteArrayPool::kAlignment * 2;
+    size = 1000;
+    block = m_pool->allocate(&size, kLargeAlignment);
+    ASSERT_EQ(0U, (std::uintptr_t) block % kLargeAlignment);
+    ASSERT_EQ(1000U, size);
+    m_pool->release(block, size, kLargeAlignment);
+
+    const auto statistics = m_pool->statistics();
+    ASSERT_EQ(2U, statistics.unpooledAllocations);
+    ASSERT_EQ(0U, statistics.cachedBytes);
+    ASSERT_EQ(0U, statistics.usedBytes);
+}
+
+TEST_F(ByteArrayPool, shared_cache_size_is_limited)
+{
+    constexpr std::size_t kMaxCachedBytes = 1024 * 1024;
+    m_pool = nx::utils::ByteArrayPool::create(kMaxCachedBytes);
+
+    std::vector<void*> blocks;
+    std::size_t size = 64 * 1024;
+    for (int i = 0; i < 100; ++i)
+        blocks.push_back(allocate(&size));
+
+    std::thread(
+        [this, &blocks, size]()
+        {
+            for (void* block: blocks)
+                m_pool->release(block, size, kAlignment);
+        }).join();
+
+    ASSERT_EQ(kMaxCachedBytes, m_pool->statistics().cachedBytes);
+}
+
+TEST_F(ByteArrayPool, thread_caches_are_counted_against_the_limit)
+{
+    constexpr std::size_t kMaxCachedBytes = 256 * 1024;
+    m_pool = nx::utils::ByteArrayPool::create(kMaxCachedBytes);
+
+    std::vector<void*> blocks;
+    std::size_t size = 64 * 1024;
+    for (int i = 0; i < 10; ++i)
+        blocks.push_back(allocate(&size));
+
+    // All the blocks would fit the thread cache of this size class.
+    for (void* block: blocks)
+        m_pool->release(block, size, kAlignment);
+
+    ASSERT_EQ(kMaxCachedBytes, m_pool->statistics().cachedBytes);
+}
+
+TEST_F(ByteArrayPool, byte_array_uses_pool)
+{
+    constexpr std::size_t kPadding = 64;
+    const std::string kData(5000, 'x');
+
+    {
+        ByteArray array(kAlignment, 100, kPadding, m_pool);
+        ASSERT_EQ(nx::utils::ByteArrayPool::kMinBlockSize - kPadding, array.capacity());
+
+        array.write(kData.data(), kData.size());
+        ASSERT_EQ(kData, std::string(array.constData(), array.size()));
+        ASSERT_EQ(0U, (std::uintptr_t) array.constData() % kAlignment);
+
+        ByteArray copy(array);
+        ASSERT_EQ(kData, std::string(copy.constData(), copy.size()));
+
+        ByteArray moved(std::move(copy));
+        ASSERT_EQ(kData, std::string(moved.constData(), moved.size()));
+        ASSERT_EQ(moved.capacity() + kPadding, m_pool->statistics().usedBytes / 2);
+
+        moved = array;
+        ASSERT_EQ(kData, std::string(moved.constData(), moved.size()));
+
+        ByteArray unpooled(kAlignment, 100, kPadding);
+        unpooled = std::move(moved);
+        ASSERT_EQ(kData, std::string(unpooled.constData(), unpooled.size()));
+    }
+
+    const auto statistics = m_pool->statistics();
+    ASSERT_EQ(0U, statistics.usedBytes);
+    ASSERT_GT(statistics.cacheHits, 0U);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * Emulates a media stream: packets of varying size are allocated by a producer thread and freed by
+ * a consumer thread.
+ */
+TEST(ByteArrayPoolPerformance, DISABLED_compare_with_system_allocator)
+{
+    using namespace std::chrono;
+
+    static constexpr int kPacketCount = 200'000;
+    static constexpr int kQueueSize = 100;
+
+    std::vector<std::size_t> sizes;
+    for (int i = 0; i < kPacketCount; ++i)
+        sizes.push_back(i % 30 == 0 ? 200'000 : 4'000 + (i * 7919) % 20'000);
+
+    const auto measure =
+        [&sizes](auto allocate, auto release)
+        {
+            const auto startTime = steady_clock::now();
+            std::vector<std::pair<void*, std::size_t>> queue;
+            for (std::size_t size: sizes)
+            {
+                void* block = allocate(&size);
+                *(char*) block = 1;
+                queue.emplace_back(block, size);
+                if (queue.size() == kQueueSize)
+                {
+                    std::thread(
+                        [&queue, &release]()
+                        {
+                            for (const auto& [block, size]: queue)
+                                release(block, size);
+                        }).join();
+                    queue.clear();
+                }
+            }
+            for (const auto& [block, size]: queue)
+                release(block, size);
+            return duration_cast<milliseconds>(steady_clock::now() - startTime);
+        };
+
+    const auto systemDuration = measure(
+        [](std::size_t* size) { return nx::kit::utils::mallocAligned(*size, 32); },
+        [](void* block, std::size_t) { nx::kit::utils::freeAligned(block); });
+
+    const auto pool = nx::utils::ByteArrayPool::create();
+    const auto poolDuration = measure(
+        [&pool](std::size_t* size) { return pool->allocate(size, 32); },
+        [&pool](void* block, std::size_t size) { pool->release(block, size, 32); });
+
+    const auto statistics = pool->statistics();
+    std::cout << kPacketCount << " packets. "
+        << "System allocator: " << systemDuration.count() << " ms, "
+        << "pool: " << poolDuration.count() << " ms ("
+        << statistics.cacheHits << " cache hits, "
+        << statistics.cacheMisses << " cache misses)" << std::endl;
+}
+
+} // namespace nx::utils::test
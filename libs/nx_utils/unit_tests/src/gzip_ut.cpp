@@ -3,7 +3,10 @@
 #include <gtest/gtest.h>
 #include <array>
 
+#include <nx/utils/byte_stream/custom_output_stream.h>
 #include <nx/utils/gzip/gzip_compressor.h>
+#include <nx/utils/gzip/gzip_uncompressor.h>
+#include <nx/utils/gzip/message_deflater.h>
 
 namespace nx::utils::test {
 
@@ -49,4 +52,102 @@ TEST(Gzip, DecompressRaw)
         Compressor::uncompressData(QByteArray(compressed.data(), compressed.size())), origin);
 }
 
+class GzipMessageDeflater:
+    public ::testing::TestWithParam<bool /*contextTakeover*/>
+{
+protected:
+    static std::vector<nx::Buffer> messages()
+    {
+        std::vector<nx::Buffer> result;
+        for (int i = 0; i < 100; ++i)
+        {
+            result.push_back(nx::Buffer(
+                "{\"jsonrpc\": \"2.0\", \"method\": \"rest.v3.devices.update\", \"params\": "
+                "{\"id\": \"" + std::to_string(i) + "\", \"status\": \"Online\"}}"));
+        }
+        result.push_back(nx::Buffer(std::string(100'000, 'x')));
+        result.push_back(nx::Buffer());
+        return result;
+    }
+
+    /**
+     * Decompresses the messages with a single stream, the way a websocket peer does.
+     */
+    static void assertDecompressed(
+        const std::vector<nx::Buffer>& compressedMessages,
+        const std::vector<nx::Buffer>& expectedMessages)
+    {
+        nx::Buffer uncompressed;
+        Uncompressor uncompressor(nx::utils::bstream::makeCustomOutputStream(
+            [&uncompressed](const nx::Buffer& data) { uncompressed += data; }));
+
+        ASSERT_EQ(expectedMessages.size(), compressedMessages.size());
+        for (std::size_t i = 0; i < compressedMessages.size(); ++i)
+        {
+            uncompressor.processData(compressedMessages[i]);
+            uncompressor.processData(nx::Buffer("\x00\x00\xff\xff", 4));
+            ASSERT_EQ(expectedMessages[i], uncompressed) << i;
+            uncompressed.clear();
+        }
+    }
+
+    static std::size_t totalSize(const std::vector<nx::Buffer>& messages)
+    {
+        std::size_t result = 0;
+        for (const auto& message: messages)
+            result += message.size();
+        return result;
+    }
+};
+
+TEST_P(GzipMessageDeflater, messages_are_decompressed_by_single_stream)
+{
+    for (const int windowBits:
+        {MessageDeflater::kMinWindowBits, 12, MessageDeflater::kMaxWindowBits})
+    {
+        MessageDeflater deflater(/*contextTakeover*/ GetParam(), windowBits);
+
+        std::vector<nx::Buffer> compressedMessages;
+        for (const auto& message: messages())
+        {
+            compressedMessages.push_back(nx::Buffer());
+            ASSERT_TRUE(deflater.compress(message, &compressedMessages.back()));
+        }
+
+        assertDecompressed(compressedMessages, messages());
+    }
+}
+
+TEST_P(GzipMessageDeflater, compressed_data_is_appended)
+{
+    MessageDeflater deflater(/*contextTakeover*/ GetParam());
+
+    nx::Buffer compressed = "prefix";
+    ASSERT_TRUE(deflater.compress(messages().front(), &compressed));
+    ASSERT_TRUE(compressed.starts_with("prefix"));
+
+    assertDecompressed({compressed.substr(6)}, {messages().front()});
+}
+
+INSTANTIATE_TEST_SUITE_P(ContextTakeover, GzipMessageDeflater, ::testing::Values(false, true));
+
+TEST(GzipMessageDeflaterContextTakeover, similar_messages_are_compressed_better)
+{
+    std::size_t compressedSize[2] = {0, 0};
+    for (const bool contextTakeover: {false, true})
+    {
+        MessageDeflater deflater(contextTakeover);
+        for (int i = 0; i < 100; ++i)
+        {
+            nx::Buffer compressed;
+            ASSERT_TRUE(deflater.compress(nx::Buffer(
+                "{\"method\": \"event\", \"params\": {\"id\": " + std::to_string(i) + "}}"),
+                &compressed));
+            compressedSize[contextTakeover ? 1 : 0] += compressed.size();
+        }
+    }
+
+    ASSERT_LT(compressedSize[1] * 2, compressedSize[0]);
+}
+
 } // namespace nx::utils::test
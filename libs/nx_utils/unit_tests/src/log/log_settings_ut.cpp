@@ -91,6 +91,20 @@ TEST_F(LogSettings, multiple_loggers)
     ASSERT_EQ(logger1Settings, logSettings.loggers[1]);
 }
 
+TEST_F(LogSettings, async_writing)
+{
+    parse({
+        "-log/logger", "file=-,level=WARNING,logAsyncWritingEnabled=true",
+        "-log/logger", "file=-,level=WARNING,logAsyncWritingEnabled=true,logAsyncOverflowPolicy=block",
+    });
+
+    ASSERT_EQ(2U, logSettings.loggers.size());
+    ASSERT_TRUE(logSettings.loggers[0].asyncWritingEnabled);
+    ASSERT_EQ(AsyncWriter::OverflowPolicy::drop, logSettings.loggers[0].asyncOverflowPolicy);
+    ASSERT_TRUE(logSettings.loggers[1].asyncWritingEnabled);
+    ASSERT_EQ(AsyncWriter::OverflowPolicy::block, logSettings.loggers[1].asyncOverflowPolicy);
+}
+
 TEST_F(LogSettings, compatibility_settings)
 {
     parse({
@@ -1,7 +1,10 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <thread>
+
 #include <gtest/gtest.h>
 
+#include <nx/utils/log/format.h>
 #include <nx/utils/log/log_writers.h>
 #include <nx/utils/random.h>
 #include <nx/utils/std/cpp14.h>
@@ -44,6 +47,11 @@ public:
         return std::make_unique<File>(settings);
     }
 
+    std::unique_ptr<AbstractWriter> makeAsyncWriter(size_t file, size_t volume)
+    {
+        return std::make_unique<AsyncWriter>(makeWriter(file, volume));
+    }
+
     void checkFile(
         const std::vector<QByteArray>& messages = {},
         const QString& suffix = {},
@@ -189,6 +197,26 @@ TEST_F(LogFile, Rotation)
     checkFile({"zzz"});
 }
 
+TEST_F(LogFile, AsyncRotation)
+{
+    static constexpr size_t kLogSize = 20;
+    static constexpr size_t kVolumeSize = 500;
+    {
+        auto w = makeAsyncWriter(kLogSize, kVolumeSize);
+        w->write(Level::undefined, "1234567890");
+    }
+    checkFile({"1234567890"});
+
+    {
+        auto w = makeAsyncWriter(kLogSize, kVolumeSize);
+        w->write(Level::undefined, "1234567890"); //< Overflow
+        w->write(Level::undefined, "xxx");
+        w->write(Level::undefined, "yyy");
+    }
+    checkFile({"1234567890", "1234567890"}, "_001", File::Extension::zip);
+    checkFile({"xxx", "yyy"});
+}
+
 TEST_F(LogFile, RotationZipNoZip)
 {
     static constexpr size_t kLogSize = 20;
@@ -251,6 +279,134 @@ TEST_F(LogFile, RotationZipNoZip)
     checkFile({"ddddddddd", "111"});
 }
 
+//-------------------------------------------------------------------------------------------------
+
+class AsyncLogWriter: public ::testing::Test
+{
+protected:
+    static constexpr int kThreadCount = 4;
+
+    void givenWriter(
+        AsyncWriter::OverflowPolicy overflowPolicy,
+        size_t threadBufferSize = kDefaultAsyncLogThreadBufferSizeB)
+    {
+        auto buffer = std::make_unique<Buffer>();
+        m_buffer = buffer.get();
+        m_writer = std::make_unique<AsyncWriter>(
+            std::move(buffer), overflowPolicy, threadBufferSize);
+    }
+
+    void whenThreadsWriteMessages(int messageCount)
+    {
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < kThreadCount; ++thread)
+        {
+            threads.emplace_back(
+                [this, thread, messageCount]()
+                {
+                    for (int i = 0; i < messageCount; ++i)
+                        m_writer->write(Level::info, nx::format("%1 %2").args(thread, i));
+                });
+        }
+        for (auto& thread: threads)
+            thread.join();
+        m_writer->flush();
+    }
+
+    /** @return The number of the written messages. */
+    int assertMessagesOfEveryThreadAreInOrder()
+    {
+        std::vector<int> nextMessage(kThreadCount, 0);
+        int messageCount = 0;
+        for (const auto& message: m_buffer->takeMessages())
+        {
+            if (message.contains("AsyncWriter"))
+                continue; //< Report of the dropped messages.
+
+            const auto parts = message.split(' ');
+            EXPECT_EQ(2, parts.size());
+            const int thread = parts[0].toInt();
+            const int i = parts[1].toInt();
+            EXPECT_LE(nextMessage[thread], i);
+            nextMessage[thread] = i + 1;
+            ++messageCount;
+        }
+        return messageCount;
+    }
+
+    std::unique_ptr<AsyncWriter> m_writer;
+    Buffer* m_buffer = nullptr;
+};
+
+TEST_F(AsyncLogWriter, messages_of_every_thread_are_written_in_order)
+{
+    static constexpr int kMessageCount = 10'000;
+
+    givenWriter(AsyncWriter::OverflowPolicy::block, /*threadBufferSize*/ 1024);
+    whenThreadsWriteMessages(kMessageCount);
+
+    ASSERT_EQ(kThreadCount * kMessageCount, assertMessagesOfEveryThreadAreInOrder());
+    ASSERT_EQ(0U, m_writer->droppedMessageCount());
+}
+
+TEST_F(AsyncLogWriter, dropped_messages_are_counted)
+{
+    static constexpr int kMessageCount = 10'000;
+
+    givenWriter(AsyncWriter::OverflowPolicy::drop, /*threadBufferSize*/ 1024);
+    whenThreadsWriteMessages(kMessageCount);
+
+    const int writtenMessageCount = assertMessagesOfEveryThreadAreInOrder();
+    ASSERT_EQ(kThreadCount * kMessageCount,
+        writtenMessageCount + (int) m_writer->droppedMessageCount());
+}
+
+TEST_F(AsyncLogWriter, small_thread_buffer_grows_instead_of_dropping_messages)
+{
+    static constexpr int kMessageCount = 1'000; //< Much more than the initial buffer size.
+
+    givenWriter(AsyncWriter::OverflowPolicy::drop);
+    for (int i = 0; i < kMessageCount; ++i)
+        m_writer->write(Level::info, nx::format("0 %1").arg(i));
+    m_writer->flush();
+
+    ASSERT_EQ(kMessageCount, assertMessagesOfEveryThreadAreInOrder());
+    ASSERT_EQ(0U, m_writer->droppedMessageCount());
+}
+
+TEST_F(AsyncLogWriter, message_larger_than_buffer_is_written_after_previous_ones)
+{
+    givenWriter(AsyncWriter::OverflowPolicy::drop, /*threadBufferSize*/ 64);
+
+    const QString largeMessage(100, 'x');
+    m_writer->write(Level::info, "first");
+    m_writer->write(Level::info, largeMessage);
+    m_writer->flush();
+
+    ASSERT_EQ((std::vector<QString>{"first", largeMessage}), m_buffer->takeMessages());
+}
+
+TEST_F(AsyncLogWriter, buffers_of_destroyed_writers_are_released_by_long_lived_thread)
+{
+    static constexpr int kWriterRebuildCount = 10;
+
+    std::vector<size_t> bufferCounts;
+    std::thread thread(
+        [this, &bufferCounts]()
+        {
+            for (int i = 0; i < kWriterRebuildCount; ++i)
+            {
+                givenWriter(AsyncWriter::OverflowPolicy::block, /*threadBufferSize*/ 1024);
+                m_writer->write(Level::info, "message");
+                bufferCounts.push_back(AsyncWriter::currentThreadBufferCount());
+                m_writer.reset();
+            }
+        });
+    thread.join();
+
+    ASSERT_EQ(std::vector<size_t>(kWriterRebuildCount, 1), bufferCounts);
+}
+
 } // namespace test
 } // namespace log
 } // namespace utils
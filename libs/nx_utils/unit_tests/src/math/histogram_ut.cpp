@@ -0,0 +1,228 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <nx/utils/math/histogram.h>
+#include <nx/utils/math/histogram_per_period.h>
+#include <nx/utils/random.h>
+#include <nx/utils/time.h>
+
+namespace nx::utils::math::test {
+
+class Histogram: public ::testing::Test
+{
+protected:
+    void assertPercentilesWithinRelativeError(
+        const math::Histogram<std::int64_t>& histogram,
+        std::vector<std::int64_t> values,
+        double maxRelativeError)
+    {
+        std::sort(values.begin(), values.end());
+
+        for (const double percentile: {0.01, 0.1, 0.5, 0.9, 0.95, 0.99, 0.999, 1.0})
+        {
+            const auto expected =
+                values[(std::size_t) std::ceil(percentile * values.size()) - 1];
+            const auto actual = histogram.valueAtPercentile(percentile);
+
+            ASSERT_GE(actual, expected) << "percentile " << percentile;
+            ASSERT_LE(actual - expected, expected * maxRelativeError)
+                << "percentile " << percentile;
+        }
+    }
+};
+
+TEST_F(Histogram, small_values_are_exact)
+{
+    math::Histogram<int> histogram(1000);
+    for (int i = 1; i <= 100; ++i)
+        histogram.add(i);
+
+    ASSERT_EQ(100U, histogram.count());
+    ASSERT_EQ(50, histogram.valueAtPercentile(0.5));
+    ASSERT_EQ(95, histogram.valueAtPercentile(0.95));
+    ASSERT_EQ(99, histogram.valueAtPercentile(0.99));
+    ASSERT_EQ(100, histogram.valueAtPercentile(1));
+}
+
+TEST_F(Histogram, percentiles_are_within_relative_error)
+{
+    static constexpr int kPrecisionBits = 7;
+
+    math::Histogram<std::int64_t> histogram(std::int64_t(1) << 40, kPrecisionBits);
+    std::vector<std::int64_t> values;
+    for (int i = 0; i < 10000; ++i)
+    {
+        values.push_back(nx::utils::random::number<std::int64_t>(0, std::int64_t(1) << 36));
+        histogram.add(values.back());
+    }
+
+    assertPercentilesWithinRelativeError(histogram, values, 1.0 / (1 << (kPrecisionBits - 1)));
+}
+
+TEST_F(Histogram, memory_does_not_depend_on_value_count)
+{
+    math::Histogram<std::chrono::microseconds> histogram(std::chrono::hours(1), 6);
+    const auto bucketCount = histogram.bucketCount();
+    ASSERT_LT(bucketCount, 1000U);
+
+    for (int i = 0; i < 100000; ++i)
+        histogram.add(std::chrono::microseconds(i * 1000));
+
+    ASSERT_EQ(bucketCount, histogram.bucketCount());
+}
+
+TEST_F(Histogram, out_of_range_values_are_clamped)
+{
+    math::Histogram<double> histogram(100.0);
+    histogram.add(-5);
+    histogram.add(1000);
+
+    ASSERT_EQ(0, histogram.valueAtPercentile(0.5));
+    ASSERT_EQ(100, histogram.valueAtPercentile(1));
+}
+
+TEST_F(Histogram, removed_values_are_not_reported)
+{
+    math::Histogram<int> histogram(1000);
+    histogram.add(3);
+    histogram.add(900);
+    histogram.remove(900);
+
+    ASSERT_EQ(1U, histogram.count());
+    ASSERT_EQ(3, histogram.valueAtPercentile(1));
+
+    histogram.remove(3);
+    ASSERT_TRUE(histogram.empty());
+    ASSERT_EQ(0, histogram.valueAtPercentile(0.5));
+}
+
+TEST_F(Histogram, merged_histogram_contains_values_of_both)
+{
+    math::Histogram<std::int64_t> one(1000000);
+    math::Histogram<std::int64_t> two(1000000);
+    std::vector<std::int64_t> values;
+    for (int i = 0; i < 1000; ++i)
+    {
+        values.push_back(i * 7);
+        (i % 2 ? one : two).add(values.back());
+    }
+
+    one.merge(two);
+
+    ASSERT_EQ(values.size(), one.count());
+    assertPercentilesWithinRelativeError(one, values, 1.0 / 64);
+}
+
+TEST_F(Histogram, sharded_histogram_collects_values_from_all_threads)
+{
+    static constexpr int kThreadCount = 4;
+    static constexpr int kValuesPerThread = 10000;
+
+    math::ShardedHistogram<std::int64_t> histogram(1000000, 7, kThreadCount);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreadCount; ++i)
+    {
+        threads.emplace_back(
+            [&histogram]()
+            {
+                for (int j = 1; j <= kValuesPerThread; ++j)
+                    histogram.add(j);
+            });
+    }
+    for (auto& thread: threads)
+        thread.join();
+
+    const auto merged = histogram.merged();
+    ASSERT_EQ((std::uint64_t) kThreadCount * kValuesPerThread, merged.count());
+
+    const auto median = merged.valueAtPercentile(0.5);
+    ASSERT_GE(median, kValuesPerThread / 2);
+    ASSERT_LE(median, kValuesPerThread / 2 * (1 + 1.0 / 64));
+}
+
+//-------------------------------------------------------------------------------------------------
+
+class HistogramPerPeriod: public ::testing::Test
+{
+public:
+    HistogramPerPeriod():
+        m_time(std::chrono::steady_clock::time_point())
+    {
+    }
+
+protected:
+    void givenValues(math::HistogramPerPeriod<int>* histogram, int start, int end)
+    {
+        for (; start < end; ++start)
+            histogram->add(start);
+    }
+
+    void whenTimePasses(std::chrono::milliseconds amountOfTime)
+    {
+        m_time.applyRelativeShift(amountOfTime);
+    }
+
+private:
+    nx::utils::test::ScopedSyntheticMonotonicTime m_time;
+};
+
+TEST_F(HistogramPerPeriod, nothing_is_reported_within_first_collection_period)
+{
+    math::HistogramPerPeriod<int> histogram(std::chrono::seconds(60), 1000);
+
+    givenValues(&histogram, 1, 101);
+
+    ASSERT_TRUE(histogram.histogram().empty());
+    ASSERT_EQ(0, histogram.valueAtPercentile(0.5));
+}
+
+TEST_F(HistogramPerPeriod, all_percentiles_of_last_period_are_reported)
+{
+    math::HistogramPerPeriod<int> histogram(std::chrono::seconds(60), 1000);
+
+    givenValues(&histogram, 1, 101);
+    whenTimePasses(std::chrono::seconds(60));
+
+    ASSERT_EQ(50, histogram.valueAtPercentile(0.5));
+    ASSERT_EQ(99, histogram.valueAtPercentile(0.99));
+}
+
+TEST_F(HistogramPerPeriod, collection_periods_overlap)
+{
+    math::HistogramPerPeriod<int> histogram(std::chrono::seconds(60), 1000);
+
+    givenValues(&histogram, 0, 100);
+    // Time 0s. h1: 0 - 99, h2: -
+
+    whenTimePasses(std::chrono::seconds(30));
+    givenValues(&histogram, 100, 200);
+    // Time 30s. h1: 0 - 199, h2: 100 - 199
+
+    whenTimePasses(std::chrono::seconds(30));
+    // Time 60s. h1 is reported.
+    ASSERT_EQ(200U, histogram.histogram().count());
+    ASSERT_EQ(99, histogram.valueAtPercentile(0.5));
+
+    whenTimePasses(std::chrono::seconds(30));
+    // Time 90s. h2 is reported.
+    ASSERT_EQ(100U, histogram.histogram().count());
+    ASSERT_EQ(149, histogram.valueAtPercentile(0.5));
+}
+
+TEST_F(HistogramPerPeriod, old_values_are_dropped_after_long_inactivity)
+{
+    math::HistogramPerPeriod<int> histogram(std::chrono::seconds(60), 1000);
+
+    givenValues(&histogram, 1, 101);
+    whenTimePasses(std::chrono::minutes(5));
+
+    ASSERT_TRUE(histogram.histogram().empty());
+}
+
+} // namespace nx::utils::math::test
@@ -356,7 +356,8 @@ void ConnectionBase::onHttpClientDone()
         socket->setNonBlockingMode(true);
         m_p2pTransport.reset(new P2PWebsocketTransport(
             std::move(socket), nx::network::websocket::Role::client, frameType, compressionType,
-            m_keepAliveTimeout));
+            m_keepAliveTimeout,
+            websocket::deflateParams(m_httpClient->response()->headers)));
     }
     else
     {
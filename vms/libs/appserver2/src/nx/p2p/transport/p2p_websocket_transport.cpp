@@ -9,12 +9,15 @@ P2PWebsocketTransport::P2PWebsocketTransport(
     network::websocket::Role role,
     network::websocket::FrameType frameType,
     network::websocket::CompressionType compressionType,
-    std::chrono::milliseconds aliveTimeout)
+    std::chrono::milliseconds aliveTimeout,
+    const std::optional<network::websocket::DeflateParams>& deflateParams)
     :
     m_webSocket(new network::WebSocket(std::move(socket), role, frameType, compressionType))
 {
     bindToAioThread(m_webSocket->getAioThread());
     m_webSocket->setAliveTimeout(aliveTimeout);
+    if (deflateParams)
+        m_webSocket->setDeflateParams(*deflateParams);
 }
 
 void P2PWebsocketTransport::start(utils::MoveOnlyFunc<void(SystemError::ErrorCode)> onStart)
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include <nx/network/websocket/websocket.h>
 #include <nx/network/websocket/websocket_common_types.h>
 #include <nx/p2p/transport/i_p2p_transport.h>
@@ -16,7 +18,8 @@ public:
         network::websocket::Role role,
         network::websocket::FrameType frameType,
         network::websocket::CompressionType compressionType,
-        std::chrono::milliseconds aliveTimeout);
+        std::chrono::milliseconds aliveTimeout,
+        const std::optional<network::websocket::DeflateParams>& deflateParams = std::nullopt);
 
     virtual void readSomeAsync(
         nx::Buffer* const buffer,
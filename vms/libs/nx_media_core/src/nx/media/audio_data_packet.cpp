@@ -3,6 +3,7 @@
 #include "audio_data_packet.h"
 
 #include <nx/build_info.h>
+#include <nx/utils/byte_array_pool.h>
 #include <nx/utils/log/assert.h>
 
 ////////////////////////////////////////////////////////////
@@ -44,7 +45,8 @@ QnWritableCompressedAudioData::QnWritableCompressedAudioData(
     CodecParametersConstPtr ctx)
     :
     QnCompressedAudioData(ctx),
-    m_data(CL_MEDIA_ALIGNMENT, capacity, AV_INPUT_BUFFER_PADDING_SIZE)
+    m_data(CL_MEDIA_ALIGNMENT, capacity, AV_INPUT_BUFFER_PADDING_SIZE,
+        nx::utils::ByteArrayPool::instance())
 {
 }
 
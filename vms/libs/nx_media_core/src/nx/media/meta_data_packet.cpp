@@ -8,6 +8,16 @@
 
 #include <nx/utils/log/assert.h>
 
+#if defined(NX_SSE2_SUPPORTED) && !defined(NX_SSE2_SUPPORTED_SSE2NEON)
+    #define NX_AVX2_SUPPORTED
+    #include <immintrin.h>
+    #if defined(Q_CC_GNU)
+        #define avx2_attribute __attribute__ ((__target__ ("avx2")))
+    #else
+        #define avx2_attribute
+    #endif
+#endif
+
 static const QRect kMaxGridRect(0, 0, Qn::kMotionGridWidth, Qn::kMotionGridHeight);
 
 //--------------------------------------- QnMetaDataV1 -------------------------------------------
@@ -107,6 +117,158 @@ bool QnMetaDataV1::matchImage(const quint64* data, const simd128i* mask, int mas
     #endif
 }
 
+// Batch matching kernels. Records are not required to be aligned. Mask words beyond
+// [maskStart, maskEnd] are zero, so a kernel may only read the mask words of that range.
+
+#if defined(__ARM_NEON)
+
+static int matchImages_neon(
+    const quint8* data, int recordCount, int recordSize,
+    const simd128i* mask, int maskStart, int maskEnd, quint8* result)
+{
+    const quint8* maskBytes = (const quint8*) mask;
+    int matchedCount = 0;
+    for (int record = 0; record < recordCount; ++record, data += recordSize)
+    {
+        uint8x16_t matched = vdupq_n_u8(0);
+        for (int i = maskStart; i <= maskEnd; ++i)
+        {
+            matched = vorrq_u8(matched,
+                vandq_u8(vld1q_u8(data + i * 16), vld1q_u8(maskBytes + i * 16)));
+        }
+        const uint64x2_t matched64 = vreinterpretq_u64_u8(matched);
+        result[record] = (vgetq_lane_u64(matched64, 0) | vgetq_lane_u64(matched64, 1)) ? 1 : 0;
+        matchedCount += result[record];
+    }
+    return matchedCount;
+}
+
+#elif defined(NX_SSE2_SUPPORTED)
+
+static int matchImages_sse2(
+    const quint8* data, int recordCount, int recordSize,
+    const simd128i* mask, int maskStart, int maskEnd, quint8* result)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int matchedCount = 0;
+    for (int record = 0; record < recordCount; ++record, data += recordSize)
+    {
+        __m128i matched = zero;
+        for (int i = maskStart; i <= maskEnd; ++i)
+        {
+            matched = _mm_or_si128(matched, _mm_and_si128(
+                _mm_loadu_si128((const __m128i*) (data + i * 16)),
+                _mm_loadu_si128(mask + i)));
+        }
+        result[record] = _mm_movemask_epi8(_mm_cmpeq_epi8(matched, zero)) != 0xffff ? 1 : 0;
+        matchedCount += result[record];
+    }
+    return matchedCount;
+}
+
+#else
+
+static int matchImages_cpu(
+    const quint8* data, int recordCount, int recordSize,
+    const simd128i* mask, int maskStart, int maskEnd, quint8* result)
+{
+    const quint64* maskWords = (const quint64*) mask;
+    int matchedCount = 0;
+    for (int record = 0; record < recordCount; ++record, data += recordSize)
+    {
+        quint64 matched = 0;
+        for (int i = maskStart * 2; i <= maskEnd * 2 + 1; ++i)
+        {
+            quint64 value;
+            memcpy(&value, data + i * sizeof(quint64), sizeof(value));
+            matched |= value & maskWords[i];
+        }
+        result[record] = matched ? 1 : 0;
+        matchedCount += result[record];
+    }
+    return matchedCount;
+}
+
+#endif
+
+#if defined(NX_AVX2_SUPPORTED)
+
+static avx2_attribute int matchImages_avx2(
+    const quint8* data, int recordCount, int recordSize,
+    const simd128i* mask, int maskStart, int maskEnd, quint8* result)
+{
+    static constexpr int kMaxWordPairs =
+        QnMetaDataV1::kMotionDataBufferSize / sizeof(__m256i) + 1;
+
+    // Pairs of 128-bit mask words are processed as 256-bit words. The last word of an odd range
+    // is processed separately to avoid reading beyond the mask.
+    const int pairCount = (maskEnd - maskStart + 1) / 2;
+    const bool hasOddWord = (maskEnd - maskStart + 1) % 2 != 0;
+
+    __m256i maskPairs[kMaxWordPairs];
+    for (int i = 0; i < pairCount; ++i)
+        maskPairs[i] = _mm256_loadu_si256((const __m256i*) (mask + maskStart + i * 2));
+    const __m128i lastMaskWord =
+        hasOddWord ? _mm_loadu_si128(mask + maskEnd) : _mm_setzero_si128();
+
+    int matchedCount = 0;
+    for (int record = 0; record < recordCount; ++record, data += recordSize)
+    {
+        const quint8* words = data + maskStart * 16;
+        __m256i matched = _mm256_setzero_si256();
+        for (int i = 0; i < pairCount; ++i)
+        {
+            matched = _mm256_or_si256(matched, _mm256_and_si256(
+                _mm256_loadu_si256((const __m256i*) (words + i * 32)), maskPairs[i]));
+        }
+
+        bool isMatched = !_mm256_testz_si256(matched, matched);
+        if (hasOddWord)
+        {
+            isMatched |= !_mm_testz_si128(
+                _mm_loadu_si128((const __m128i*) (data + maskEnd * 16)), lastMaskWord);
+        }
+        result[record] = isMatched ? 1 : 0;
+        matchedCount += result[record];
+    }
+    return matchedCount;
+}
+
+#endif
+
+int QnMetaDataV1::matchImages(
+    const quint8* data,
+    int recordCount,
+    int recordSize,
+    const simd128i* mask,
+    int maskStart,
+    int maskEnd,
+    quint8* result)
+{
+    NX_ASSERT(recordSize >= kMotionDataBufferSize);
+    if (maskStart > maskEnd)
+    {
+        memset(result, 0, recordCount);
+        return 0;
+    }
+
+    #if defined(__ARM_NEON)
+        return matchImages_neon(data, recordCount, recordSize, mask, maskStart, maskEnd, result);
+    #elif defined(NX_SSE2_SUPPORTED)
+        #if defined(NX_AVX2_SUPPORTED)
+            static const bool kUseAvx2 = useAVX2();
+            if (kUseAvx2)
+            {
+                return matchImages_avx2(
+                    data, recordCount, recordSize, mask, maskStart, maskEnd, result);
+            }
+        #endif
+        return matchImages_sse2(data, recordCount, recordSize, mask, maskStart, maskEnd, result);
+    #else
+        return matchImages_cpu(data, recordCount, recordSize, mask, maskStart, maskEnd, result);
+    #endif
+}
+
 void QnMetaDataV1::assign(const QnMetaDataV1* other)
 {
     QnAbstractMediaData::assign(other);
@@ -199,6 +199,23 @@ public:
         int maskStart = 0,
         int maskEnd = Qn::kMotionGridWidth * Qn::kMotionGridHeight / 128 - 1);
 
+    /**
+     * Matches a batch of motion grids against the mask created with createMask(). Uses AVX2 (if
+     * supported by the CPU), SSE2 or NEON.
+     * @param data recordCount records, recordSize bytes each, starting with a motion grid. The
+     *     records are not required to be aligned.
+     * @param result Receives 1 for every record matching the mask and 0 for the others.
+     * @return Number of the matching records.
+     */
+    static int matchImages(
+        const quint8* data,
+        int recordCount,
+        int recordSize,
+        const simd128i* mask,
+        int maskStart,
+        int maskEnd,
+        quint8* result);
+
 protected:
     void assign(const QnMetaDataV1* other);
 
@@ -106,6 +106,7 @@ QString getCPUString()
     bool useSSSE3() { return false; }
     bool useSSE41() { return false; }
     bool useSSE42() { return false; }
+    bool useAVX2() { return false; }
 #elif defined(Q_OS_MACX)
     bool useSSE2() { return true; }
     bool useSSE3() { return true; }
@@ -113,10 +114,12 @@ QString getCPUString()
     // TODO: #akolesnikov We are compiling mac client with -msse4.1 - why is it forbidden here?
     bool useSSE41() { return false; }
     bool useSSE42() { return false; }
+    bool useAVX2() { return qCpuHasFeature(AVX2); }
 #else
     bool useSSE2() { return qCpuHasFeature(SSE2); }
     bool useSSE3() { return qCpuHasFeature(SSE3); }
     bool useSSSE3() { return qCpuHasFeature(SSSE3); }
     bool useSSE41() { return qCpuHasFeature(SSE4_1); }
     bool useSSE42() { return qCpuHasFeature(SSE4_2); }
+    bool useAVX2() { return qCpuHasFeature(AVX2); }
 #endif
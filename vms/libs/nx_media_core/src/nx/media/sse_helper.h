@@ -112,5 +112,6 @@ NX_MEDIA_CORE_API bool useSSE3();
 NX_MEDIA_CORE_API bool useSSSE3();
 NX_MEDIA_CORE_API bool useSSE41();
 NX_MEDIA_CORE_API bool useSSE42();
+NX_MEDIA_CORE_API bool useAVX2();
 
 NX_MEDIA_CORE_API QString getCPUString();
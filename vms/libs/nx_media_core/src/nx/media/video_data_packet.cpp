@@ -2,6 +2,8 @@
 
 #include "video_data_packet.h"
 
+#include <nx/utils/byte_array_pool.h>
+
 QnCompressedVideoData::QnCompressedVideoData( CodecParametersConstPtr ctx )
 :
     QnAbstractMediaData( VIDEO ),
@@ -29,7 +31,8 @@ QnWritableCompressedVideoData::QnWritableCompressedVideoData(
     CodecParametersConstPtr ctx)
     :
     QnCompressedVideoData(ctx),
-    m_data(CL_MEDIA_ALIGNMENT, capacity, AV_INPUT_BUFFER_PADDING_SIZE)
+    m_data(CL_MEDIA_ALIGNMENT, capacity, AV_INPUT_BUFFER_PADDING_SIZE,
+        nx::utils::ByteArrayPool::instance())
 {
 }
 
@@ -1,8 +1,13 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include <QtGui/QRegion>
+
 #include <nx/media/meta_data_packet.h>
+#include <nx/utils/random.h>
 
 namespace nx::media::test {
 
@@ -27,4 +32,61 @@ TEST(MetaData, serialization)
     ASSERT_EQ(packet.timestamp, packetCopy->timestamp);
 }
 
+TEST(MetaData, batch_matching_is_equal_to_single_record_matching)
+{
+    static constexpr int kRecordCount = 1000;
+    static constexpr int kGridSize = QnMetaDataV1::kMotionDataBufferSize;
+
+    for (int iteration = 0; iteration < 100; ++iteration)
+    {
+        QRegion region;
+        for (int i = nx::utils::random::number<int>(1, 3); i > 0; --i)
+        {
+            const int x = nx::utils::random::number<int>(0, Qn::kMotionGridWidth - 1);
+            const int y = nx::utils::random::number<int>(0, Qn::kMotionGridHeight - 1);
+            region += QRect(
+                x, y,
+                nx::utils::random::number<int>(1, Qn::kMotionGridWidth - x),
+                nx::utils::random::number<int>(1, Qn::kMotionGridHeight - y));
+        }
+
+        simd128i mask[kGridSize / sizeof(simd128i)];
+        int maskStart = 0;
+        int maskEnd = 0;
+        QnMetaDataV1::createMask(region, (char*) mask, &maskStart, &maskEnd);
+
+        // Records of an odd size at an odd offset are not aligned.
+        const int recordSize = kGridSize + nx::utils::random::number<int>(0, 17);
+        const int offset = nx::utils::random::number<int>(0, 15);
+        std::vector<quint8> data(offset + kRecordCount * recordSize);
+        for (int i = 0; i < kRecordCount; ++i)
+        {
+            quint8* record = data.data() + offset + i * recordSize;
+            // Sparse motion, so some records do not match.
+            for (int bit = nx::utils::random::number<int>(0, 8); bit > 0; --bit)
+            {
+                const int byte = nx::utils::random::number<int>(0, kGridSize - 1);
+                record[byte] |= 1 << nx::utils::random::number<int>(0, 7);
+            }
+        }
+
+        std::vector<quint8> result(kRecordCount);
+        const int matchedCount = QnMetaDataV1::matchImages(
+            data.data() + offset, kRecordCount, recordSize, mask, maskStart, maskEnd,
+            result.data());
+
+        int expectedMatchedCount = 0;
+        for (int i = 0; i < kRecordCount; ++i)
+        {
+            alignas(16) quint8 record[kGridSize];
+            memcpy(record, data.data() + offset + i * recordSize, kGridSize);
+            const bool expected =
+                QnMetaDataV1::matchImage((const quint64*) record, mask, maskStart, maskEnd);
+            ASSERT_EQ(expected ? 1 : 0, result[i]) << "record " << i;
+            expectedMatchedCount += expected ? 1 : 0;
+        }
+        ASSERT_EQ(expectedMatchedCount, matchedCount);
+    }
+}
+
 } // namespace nx::media::test
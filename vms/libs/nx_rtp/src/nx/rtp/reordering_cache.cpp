@@ -12,14 +12,60 @@ constexpr int kMaxCacheSize = std::numeric_limits<uint16_t>::max() / 2;
 // Can't make any reorder with limit < 2.
 constexpr int kMinCacheSize = 2;
 
+void ReorderingCache::FlushQueue::push(nx::utils::ByteArray&& packet)
+{
+    if (m_size == m_packets.size())
+    {
+        // Unroll the ring into the bigger one.
+        std::vector<nx::utils::ByteArray> packets(std::max<size_t>(m_packets.size() * 2, 1));
+        for (size_t i = 0; i < m_size; ++i)
+            packets[i] = std::move(m_packets[(m_begin + i) % m_packets.size()]);
+        m_packets = std::move(packets);
+        m_begin = 0;
+    }
+    m_packets[(m_begin + m_size) % m_packets.size()] = std::move(packet);
+    ++m_size;
+}
+
+bool ReorderingCache::FlushQueue::pop(nx::utils::ByteArray& packet)
+{
+    if (m_size == 0)
+        return false;
+    packet = std::move(m_packets[m_begin]);
+    m_begin = (m_begin + 1) % m_packets.size();
+    --m_size;
+    return true;
+}
+
+void ReorderingCache::FlushQueue::reserve(size_t capacity)
+{
+    NX_ASSERT(m_size == 0);
+    if (m_packets.size() < capacity)
+    {
+        m_packets.resize(capacity);
+        m_begin = 0;
+    }
+}
+
 ReorderingCache::ReorderingCache(int queueLimit)
     :
     m_queueLimit(std::min(queueLimit, kMaxCacheSize))
 {
 }
 
+ReorderingCache::Status ReorderingCache::pushPacket(nx::utils::ByteArray&& packet, uint16_t seq)
+{
+    return pushPacketInternal(std::move(packet), seq);
+}
+
 ReorderingCache::Status ReorderingCache::pushPacket(
     const nx::utils::ByteArray& packet, uint16_t seq)
+{
+    return pushPacketInternal(packet, seq);
+}
+
+template<typename Packet>
+ReorderingCache::Status ReorderingCache::pushPacketInternal(Packet&& packet, uint16_t seq)
 {
     if (m_queueLimit < kMinCacheSize) //< Always pass.
         return ReorderingCache::Status::pass;
@@ -28,6 +74,7 @@ ReorderingCache::Status ReorderingCache::pushPacket(
     if (!m_lastSeq) //< First packet.
     {
         m_lastSeq = linearized;
+        m_firstSeq = linearized + 1;
         return ReorderingCache::Status::pass;
     }
 
@@ -37,18 +84,19 @@ ReorderingCache::Status ReorderingCache::pushPacket(
         resetState(linearized);
         return ReorderingCache::Status::pass;
     }
-    if (linearized - *m_lastSeq == 1
-        && m_lostSequences.empty()) //< Normal case without any drops.
+    if (linearized - *m_lastSeq == 1 && m_lostCount == 0) //< Normal case without any drops.
     {
-        NX_ASSERT(m_packets.empty());
+        NX_ASSERT(getTotalSize() == 0);
         *m_lastSeq = linearized;
+        m_firstSeq = linearized + 1;
         return ReorderingCache::Status::pass;
     }
 
     if (outOfQueue(linearized))
         return ReorderingCache::Status::skip;
 
-    insertPacket({packet, linearized});
+    // The const packet is copied here, the rvalue one is moved.
+    insertPacket(nx::utils::ByteArray(std::forward<Packet>(packet)), linearized);
 
     popPackets();
 
@@ -56,7 +104,7 @@ ReorderingCache::Status ReorderingCache::pushPacket(
     {
         return Status::flush;
     }
-    else if (!m_lostSequences.empty())
+    else if (m_lostCount > 0)
     {
         return Status::wait;
     }
@@ -67,110 +115,103 @@ ReorderingCache::Status ReorderingCache::pushPacket(
     }
 }
 
-bool ReorderingCache::outOfQueue(int64_t linearized)
+bool ReorderingCache::outOfQueue(int64_t linearized) const
 {
-    bool outOfPackets = (m_packets.empty() || linearized < m_packets.front().second);
-    bool outOfLost = (m_lostSequences.empty() || linearized < m_lostSequences.front());
-    bool outOfSeq = (!m_lastSeq || *m_lastSeq >= linearized);
-    return outOfPackets && outOfLost && outOfSeq;
+    // Both received and lost sequences of the window are in the queue.
+    return linearized <= *m_lastSeq && linearized < m_firstSeq;
 }
 
 void ReorderingCache::popPackets()
 {
-    NX_ASSERT(!m_packets.empty());
-    while (!m_packets.empty() || !m_lostSequences.empty())
+    NX_ASSERT(getTotalSize() > 0);
+    while (m_firstSeq <= *m_lastSeq)
     {
-        bool popPackets = false; //< Pop packets queue or lost sequences queue.
-        if (!m_packets.empty() && m_lostSequences.empty())
-        {
-            popPackets = true;
-        }
-        else if (m_packets.empty() && !m_lostSequences.empty())
+        Slot& first = slot(m_firstSeq);
+        if (first.isReceived)
         {
-            popPackets = false;
-        }
-        else
-        {
-            auto firstSequence = m_packets.front().second;
-            auto firstLostSequence = m_lostSequences.front();
-            NX_ASSERT(firstSequence != firstLostSequence);
-            popPackets = (firstSequence < firstLostSequence);
-        }
-        if (popPackets)
-        {
-            // It's a packet.
-            m_packetsToFlush.emplace_back(std::move(m_packets.front().first));
-            m_packets.pop_front();
+            m_packetsToFlush.push(std::move(first.packet));
+            first.isReceived = false;
         }
         else
         {
             // It's a lost packet.
             if (getTotalSize() <= m_queueLimit)
                 break;
-            m_lostSequences.pop_front();
+            --m_lostCount;
         }
+        ++m_firstSeq;
     }
 }
 
-void ReorderingCache::insertPacket(const Packet& packet)
+void ReorderingCache::insertPacket(nx::utils::ByteArray&& packet, int64_t linearized)
 {
-    auto pos = std::lower_bound(
-        m_packets.begin(),
-        m_packets.end(),
-        packet.second,
-        [](const Packet& packet, int64_t linearized)
-        {
-            return packet.second < linearized;
-        });
-    if (pos == m_packets.end())
+    if (m_slots.empty())
     {
-        NX_ASSERT(packet.second >= *m_lastSeq && packet.second - *m_lastSeq <= m_queueLimit);
-        while ((++*m_lastSeq) != packet.second)
-            m_lostSequences.push_back(*m_lastSeq);
+        // The window can grow up to the limit on top of the limit before the packets are popped.
+        m_slots.resize(2 * m_queueLimit + 1);
+        m_packetsToFlush.reserve(m_slots.size());
     }
-    else if (pos->second == packet.second)
+
+    if (linearized > *m_lastSeq)
+    {
+        NX_ASSERT(linearized - *m_lastSeq <= m_queueLimit);
+        while ((++*m_lastSeq) != linearized)
+        {
+            slot(*m_lastSeq).isReceived = false;
+            ++m_lostCount;
+        }
+    }
+    else if (!slot(linearized).isReceived)
     {
-        pos = m_packets.erase(pos);
+        --m_lostCount;
     }
-    std::erase(m_lostSequences, packet.second);
-    m_packets.insert(pos, packet);
+
+    Slot& target = slot(linearized);
+    target.packet = std::move(packet);
+    target.isReceived = true;
 }
 
-int ReorderingCache::getTotalSize() const 
+int ReorderingCache::getTotalSize() const
 {
-    return m_packets.size() + m_lostSequences.size();
+    return (int) (*m_lastSeq - m_firstSeq + 1);
+}
+
+ReorderingCache::Slot& ReorderingCache::slot(int64_t linearized)
+{
+    return m_slots[linearized % (int64_t) m_slots.size()];
+}
+
+const ReorderingCache::Slot& ReorderingCache::slot(int64_t linearized) const
+{
+    return m_slots[linearized % (int64_t) m_slots.size()];
 }
 
 void ReorderingCache::resetState(int64_t linearized)
 {
-    m_packets.clear();
-    m_lostSequences.clear();
+    for (; m_firstSeq <= *m_lastSeq; ++m_firstSeq)
+        slot(m_firstSeq) = Slot();
+    m_lostCount = 0;
     m_lastSeq = linearized;
+    m_firstSeq = linearized + 1;
 }
 
 bool ReorderingCache::getNextPacket(nx::utils::ByteArray& outputPacket)
 {
-    if (m_packetsToFlush.empty())
-        return false;
-    outputPacket = std::move(m_packetsToFlush.front());
-    m_packetsToFlush.pop_front();
-    return true;
+    return m_packetsToFlush.pop(outputPacket);
 }
 
 std::optional<RtcpNackReport> ReorderingCache::getNextNackPacket(
     uint16_t sourceSsrc, uint16_t senderSsrc) const
 {
-    if (m_lostSequences.empty())
+    if (m_lostCount == 0)
         return std::nullopt;
-    std::vector<uint16_t> sequences(m_lostSequences.size());
-    std::transform(
-        m_lostSequences.begin(),
-        m_lostSequences.end(),
-        sequences.begin(),
-        [](int64_t linearized)
-        {
-            return (uint16_t) linearized;
-        });
+    std::vector<uint16_t> sequences;
+    sequences.reserve(m_lostCount);
+    for (int64_t linearized = m_firstSeq; linearized <= *m_lastSeq; ++linearized)
+    {
+        if (!slot(linearized).isReceived)
+            sequences.push_back((uint16_t) linearized);
+    }
     // A simple way - for any moment report about all lost sequences.
     // Maybe this logic should be corrected in future.
     return buildNackReport(sourceSsrc, senderSsrc, sequences);
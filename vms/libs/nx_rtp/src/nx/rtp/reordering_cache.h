@@ -2,8 +2,7 @@
 
 #pragma once
 
-#include <deque>
-#include <list>
+#include <vector>
 
 #include <nx/utils/byte_array.h>
 
@@ -12,6 +11,11 @@
 
 namespace nx::rtp {
 
+/**
+ * Restores the order of RTP packets by their sequence numbers. The packets are kept in a ring
+ * indexed by the linearized sequence number, which is allocated once, so the packets are moved
+ * in and out without copying or allocating memory.
+ */
 class NX_RTP_API ReorderingCache
 {
 public:
@@ -24,23 +28,53 @@ public:
     };
 public:
     ReorderingCache(int queueLimit = (int) kRtcpNackQueueSize);
+    /** The packet is moved to the cache on `wait` and `flush` statuses only. */
+    Status pushPacket(nx::utils::ByteArray&& packet, uint16_t seq);
     Status pushPacket(const nx::utils::ByteArray& packet, uint16_t seq);
     // Call on `flush` status.
     bool getNextPacket(nx::utils::ByteArray& outputPacket);
     // Call on `wait` status.
     std::optional<RtcpNackReport> getNextNackPacket(uint16_t sourceSsrc, uint16_t senderSsrc) const;
 private:
-    using Packet = std::pair<nx::utils::ByteArray, int64_t>;
+    struct Slot
+    {
+        nx::utils::ByteArray packet;
+        bool isReceived = false; //< Otherwise the sequence is lost.
+    };
+
+    /** Packets ready to be flushed. Grows only if they are not taken before the next push. */
+    class FlushQueue
+    {
+    public:
+        void push(nx::utils::ByteArray&& packet);
+        bool pop(nx::utils::ByteArray& packet);
+        bool empty() const { return m_size == 0; }
+        void reserve(size_t capacity);
+
+    private:
+        std::vector<nx::utils::ByteArray> m_packets;
+        size_t m_begin = 0;
+        size_t m_size = 0;
+    };
 private:
+    template<typename Packet>
+    Status pushPacketInternal(Packet&& packet, uint16_t seq);
     void resetState(int64_t linearized);
     void popPackets();
-    void insertPacket(const Packet& packet);
-    bool outOfQueue(int64_t seq);
+    void insertPacket(nx::utils::ByteArray&& packet, int64_t linearized);
+    bool outOfQueue(int64_t linearized) const;
     int getTotalSize() const;
+    Slot& slot(int64_t linearized);
+    const Slot& slot(int64_t linearized) const;
 private:
-    std::deque<Packet> m_packets;
-    std::list<nx::utils::ByteArray> m_packetsToFlush;
-    std::deque<int64_t> m_lostSequences;
+    /**
+     * Ring of the received and lost sequences from m_firstSeq to m_lastSeq. The last one is
+     * always received. It is empty if m_firstSeq is greater than m_lastSeq.
+     */
+    std::vector<Slot> m_slots;
+    int64_t m_firstSeq = 0;
+    int m_lostCount = 0;
+    FlushQueue m_packetsToFlush;
     std::optional<int64_t> m_lastSeq;
     TimeLinearizer<uint16_t> m_linearizer;
     int m_queueLimit = 0;
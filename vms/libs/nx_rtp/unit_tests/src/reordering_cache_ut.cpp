@@ -1,5 +1,10 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <set>
+
 #include <gtest/gtest.h>
 
 #include <nx/rtp/reordering_cache.h>
@@ -148,3 +153,146 @@ TEST(RtpReorderingCache, readWrite)
         ASSERT_EQ(flushToString(cache), "$65535$0$1");
     }
 }
+
+TEST(RtpReorderingCache, movedPacketIsFlushed)
+{
+    using Status = ReorderingCache::Status;
+
+    ReorderingCache cache(5);
+    nx::utils::ByteArray packet;
+    ASSERT_EQ(cache.pushPacket(std::move(packet), 1), Status::pass);
+    ASSERT_EQ(cache.pushPacket(std::move(packet), 3), Status::wait);
+
+    packet.write("$2", 2);
+    ASSERT_EQ(cache.pushPacket(std::move(packet), 2), Status::flush);
+    ASSERT_EQ(flushToString(cache), "$2");
+}
+
+namespace {
+
+/**
+ * Sequence numbers of a synthetic stream, starting close to the wrap-around point. Every
+ * reorderPeriod-th packet is swapped with the next one, every lossPeriod-th packet is resent
+ * resendDelay packets later.
+ */
+std::vector<uint16_t> makeSequences(int count, int reorderPeriod, int lossPeriod, int resendDelay)
+{
+    std::vector<uint16_t> sequences;
+    std::vector<std::pair<int, uint16_t>> resent;
+    for (int i = 0; i < count; ++i)
+    {
+        const uint16_t seq = (uint16_t) (65000 + i);
+        if (lossPeriod > 0 && i % lossPeriod == lossPeriod - 1)
+            resent.emplace_back(i + resendDelay, seq);
+        else
+            sequences.push_back(seq);
+
+        while (!resent.empty() && resent.front().first <= i)
+        {
+            sequences.push_back(resent.front().second);
+            resent.erase(resent.begin());
+        }
+    }
+    for (const auto& [position, seq]: resent)
+        sequences.push_back(seq);
+    if (reorderPeriod > 0)
+    {
+        for (size_t i = reorderPeriod - 1; i + 1 < sequences.size(); i += reorderPeriod)
+            std::swap(sequences[i], sequences[i + 1]);
+    }
+    return sequences;
+}
+
+struct Pattern
+{
+    const char* name;
+    int reorderPeriod = 0;
+    int lossPeriod = 0;
+    int resendDelay = 0;
+};
+
+const Pattern kPatterns[] = {
+    {"in order"},
+    {"adjacent swaps", /*reorderPeriod*/ 10},
+    {"1% loss resent", /*reorderPeriod*/ 0, /*lossPeriod*/ 100, /*resendDelay*/ 20},
+    {"swaps and loss", /*reorderPeriod*/ 10, /*lossPeriod*/ 100, /*resendDelay*/ 20},
+};
+
+} // namespace
+
+TEST(RtpReorderingCache, everyPacketIsOutputOnce)
+{
+    static constexpr int kPacketCount = 2000;
+
+    for (const auto& pattern: kPatterns)
+    {
+        // The stream starts at 65000, so it wraps the sequence number around.
+        const auto sequences = makeSequences(
+            kPacketCount, pattern.reorderPeriod, pattern.lossPeriod, pattern.resendDelay);
+
+        ReorderingCache cache;
+        std::multiset<uint16_t> output;
+        nx::utils::ByteArray packet;
+        for (const auto seq: sequences)
+        {
+            packet.clear();
+            packet.write((const char*) &seq, sizeof(seq));
+            const auto status = cache.pushPacket(std::move(packet), seq);
+            if (status == ReorderingCache::Status::pass)
+            {
+                output.insert(seq);
+            }
+            else if (status == ReorderingCache::Status::flush)
+            {
+                while (cache.getNextPacket(packet))
+                {
+                    uint16_t flushedSeq = 0;
+                    memcpy(&flushedSeq, packet.data(), sizeof(flushedSeq));
+                    output.insert(flushedSeq);
+                    packet.clear();
+                }
+            }
+        }
+
+        ASSERT_EQ(std::multiset<uint16_t>(sequences.begin(), sequences.end()), output)
+            << pattern.name;
+    }
+}
+
+TEST(RtpReorderingCache, DISABLED_performance)
+{
+    static constexpr int kPacketCount = 200'000;
+    static constexpr int kPacketSize = 1400;
+
+    const std::string payload(kPacketSize, 'x');
+    for (const auto& pattern: kPatterns)
+    {
+        const auto sequences = makeSequences(
+            kPacketCount, pattern.reorderPeriod, pattern.lossPeriod, pattern.resendDelay);
+
+        ReorderingCache cache;
+        int outputCount = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto seq: sequences)
+        {
+            nx::utils::ByteArray packet;
+            packet.write(payload.data(), payload.size());
+            const auto status = cache.pushPacket(std::move(packet), seq);
+            if (status == ReorderingCache::Status::pass)
+            {
+                ++outputCount;
+            }
+            else if (status == ReorderingCache::Status::flush)
+            {
+                while (cache.getNextPacket(packet))
+                    ++outputCount;
+            }
+        }
+        const auto duration = std::chrono::steady_clock::now() - start;
+        const auto seconds = std::chrono::duration<double>(duration).count();
+
+        ASSERT_EQ(kPacketCount, outputCount) << pattern.name;
+        std::cout << pattern.name << ": " << (int64_t) (sequences.size() / seconds)
+            << " packets/s" << std::endl;
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include <nx/reflect/json.h>
+#include <nx/vms/api/data/camera_data_ex.h>
+
+namespace nx::vms::api::test {
+
+namespace {
+
+std::vector<CameraDataEx> cameras(int count, int paramsPerCamera)
+{
+    std::vector<CameraDataEx> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        CameraDataEx camera;
+        camera.physicalId = QString("00-1A-07-%1").arg(i, 6, 16, QChar('0'));
+        camera.id = CameraData::physicalIdToId(camera.physicalId);
+        camera.parentId = QnUuid::createUuid();
+        camera.typeId = QnUuid::createUuid();
+        camera.name = QString("Camera %1").arg(i);
+        camera.url = QString("rtsp://10.0.%1.%2/stream").arg(i / 256).arg(i % 256);
+        camera.vendor = "Vendor";
+        camera.model = "Model";
+        camera.status = ResourceStatus::online;
+        camera.userDefinedGroupName = "Group";
+        for (int j = 0; j < paramsPerCamera; ++j)
+            camera.addParams.emplace_back(QString("param%1").arg(j), QString::number(i * j));
+        result.push_back(std::move(camera));
+    }
+    return result;
+}
+
+template<typename Func>
+std::chrono::microseconds measure(int iterations, Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        func();
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start) / iterations;
+}
+
+} // namespace
+
+TEST(ReflectJsonDeserialization, streaming_gives_same_result_as_dom)
+{
+    const auto expected = cameras(/*count*/ 10, /*paramsPerCamera*/ 5);
+    const auto json = nx::reflect::json::serialize(expected);
+
+    std::vector<CameraDataEx> dom;
+    ASSERT_TRUE(nx::reflect::json::deserialize(json, &dom));
+    std::vector<CameraDataEx> streaming;
+    ASSERT_TRUE(nx::reflect::json::deserializeStreaming(json, &streaming));
+
+    ASSERT_TRUE(expected == dom);
+    ASSERT_TRUE(dom == streaming);
+}
+
+TEST(ReflectJsonDeserialization, DISABLED_performance)
+{
+    static constexpr int kIterations = 5;
+
+    const auto json = nx::reflect::json::serialize(
+        cameras(/*count*/ 2000, /*paramsPerCamera*/ 20));
+
+    const auto domTime = measure(kIterations,
+        [&json]()
+        {
+            std::vector<CameraDataEx> data;
+            ASSERT_TRUE(nx::reflect::json::deserialize(json, &data));
+        });
+
+    const auto streamingTime = measure(kIterations,
+        [&json]()
+        {
+            std::vector<CameraDataEx> data;
+            ASSERT_TRUE(nx::reflect::json::deserializeStreaming(json, &data));
+        });
+
+    std::cout << json.size() << " bytes of JSON: DOM " << domTime.count() << "us, streaming "
+        << streamingTime.count() << "us" << std::endl;
+}
+
+} // namespace nx::vms::api::test
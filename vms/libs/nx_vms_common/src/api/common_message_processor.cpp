@@ -630,6 +630,11 @@ void QnCommonMessageProcessor::on_resourceParamChanged(
     if (handleRemoteAnalyticsNotification(param, source))
         return;
 
+    setResourceParam(param);
+}
+
+void QnCommonMessageProcessor::setResourceParam(const nx::vms::api::ResourceParamWithRefData& param)
+{
     QnResourcePtr resource = resourcePool()->getResourceById(param.resourceId);
     if (resource)
     {
@@ -958,13 +963,27 @@ void QnCommonMessageProcessor::resetPropertyList(const ResourceParamWithRefDataL
     // Store existing parameter keys.
     auto existingProperties = m_context->resourcePropertyDictionary()->allPropertyNamesByResource();
 
-    // Update changed values.
+    // Update changed values. The properties of the Resources which are not in the pool yet (all
+    // of them on the first connection) are stored to the dictionary in one batch.
+    ResourceParamWithRefDataList dictionaryParams;
     for (const auto& param: params)
     {
-        on_resourceParamChanged(param, ec2::NotificationSource::Remote);
         if (existingProperties.contains(param.resourceId))
             existingProperties[param.resourceId].remove(param.name);
+
+        if (handleRemoteAnalyticsNotification(param, ec2::NotificationSource::Remote))
+            continue;
+
+        if (param.name != Qn::kResourceDataParamName
+            && !resourcePool()->getResourceById(param.resourceId))
+        {
+            dictionaryParams.push_back(param);
+            continue;
+        }
+
+        setResourceParam(param);
     }
+    m_context->resourcePropertyDictionary()->setValues(dictionaryParams, /*markDirty*/ false);
 
     // Clean values that are not in the list anymore.
     for (auto iter = existingProperties.constBegin(); iter != existingProperties.constEnd(); ++iter)
@@ -188,6 +188,9 @@ private slots:
 protected:
     ec2::AbstractECConnectionPtr m_connection;
 
+private:
+    void setResourceParam(const nx::vms::api::ResourceParamWithRefData& param);
+
 private:
     struct Private;
     nx::utils::ImplPtr<Private> d;
@@ -3,9 +3,13 @@
 #include "access_rights_resolver.h"
 
 #include <memory>
+#include <utility>
 
 #include <QtCore/QPointer>
 
+#include <nx/utils/log/log.h>
+#include <nx/utils/thread/mutex.h>
+
 #include "abstract_access_rights_manager.h"
 #include "resolvers/inherited_resource_access_resolver.h"
 #include "resolvers/intercom_layout_access_resolver.h"
@@ -26,6 +30,11 @@ struct AccessRightsResolver::Private
     std::unique_ptr<IntercomLayoutAccessResolver> intercomLayoutAccessResolver;
     std::unique_ptr<InheritedResourceAccessResolver> inheritedResourceAccessResolver;
 
+    int updateCount = 0;
+    bool pendingReset = false;
+    QSet<QnUuid> pendingChangedSubjectIds;
+    nx::Mutex updateMutex;
+
     explicit Private(
         QnResourcePool* resourcePool,
         AbstractAccessRightsManager* accessRightsManager,
@@ -67,7 +76,34 @@ AccessRightsResolver::AccessRightsResolver(
     const auto internalNotifier = d->inheritedResourceAccessResolver->notifier();
 
     connect(internalNotifier, &InternalNotifier::resourceAccessReset, this,
-        [this]() { emit resourceAccessReset(QPrivateSignal()); }, Qt::DirectConnection);
+        [this]()
+        {
+            NX_MUTEX_LOCKER lk(&d->updateMutex);
+            if (d->updateCount > 0)
+            {
+                d->pendingReset = true;
+                d->pendingChangedSubjectIds.clear();
+                return;
+            }
+
+            lk.unlock();
+            emit resourceAccessReset(QPrivateSignal());
+        }, Qt::DirectConnection);
+
+    connect(internalNotifier, &InternalNotifier::resourceAccessChanged, this,
+        [this](const QSet<QnUuid>& subjectIds)
+        {
+            NX_MUTEX_LOCKER lk(&d->updateMutex);
+            if (d->updateCount > 0)
+            {
+                if (!d->pendingReset)
+                    d->pendingChangedSubjectIds += subjectIds;
+                return;
+            }
+
+            lk.unlock();
+            emit resourceAccessChanged(subjectIds, QPrivateSignal());
+        }, Qt::DirectConnection);
 }
 
 AccessRightsResolver::~AccessRightsResolver()
@@ -120,6 +156,35 @@ AccessRightsResolver::Notifier* AccessRightsResolver::createNotifier(QObject* pa
     return new AccessRightsResolver::Notifier(this, parent);
 }
 
+void AccessRightsResolver::beginUpdate()
+{
+    NX_MUTEX_LOCKER lk(&d->updateMutex);
+    ++d->updateCount;
+}
+
+void AccessRightsResolver::endUpdate()
+{
+    NX_MUTEX_LOCKER lk(&d->updateMutex);
+    if (!NX_ASSERT(d->updateCount > 0) || --d->updateCount > 0)
+        return;
+
+    const bool reset = std::exchange(d->pendingReset, false);
+    const auto changedSubjectIds = std::exchange(d->pendingChangedSubjectIds, {});
+    lk.unlock();
+
+    if (reset)
+    {
+        NX_DEBUG(this, "Update finished, sending the postponed reset notification");
+        emit resourceAccessReset(QPrivateSignal());
+    }
+    else if (!changedSubjectIds.empty())
+    {
+        NX_DEBUG(this, "Update finished, sending the postponed notification about %1 subjects",
+            changedSubjectIds.size());
+        emit resourceAccessChanged(changedSubjectIds, QPrivateSignal());
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // AccessRightsResolver::Notifier
 
@@ -169,17 +234,17 @@ void AccessRightsResolver::Notifier::setSource(AccessRightsResolver* value)
     if (d->source == value)
         return;
 
-    if (d->notifier)
-        d->notifier->disconnect(this);
+    if (d->source)
+        d->source->disconnect(this);
 
     d->unsubscribe();
     d->source = value;
     d->notifier = d->source->d->inheritedResourceAccessResolver->notifier();
     d->subscribe();
 
-    if (d->notifier)
+    if (d->source)
     {
-        connect(d->notifier, &AbstractResourceAccessResolver::Notifier::resourceAccessChanged, this,
+        connect(d->source, &AccessRightsResolver::resourceAccessChanged, this,
             [this](const QSet<QnUuid>& changedSubjectIds)
             {
                 if (changedSubjectIds.contains(d->subjectId))
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 
 #include <core/resource/resource_fwd.h>
 #include <core/resource_access/resource_access_details.h>
@@ -82,10 +83,21 @@ public:
     class Notifier;
     Notifier* createNotifier(QObject* parent = nullptr);
 
+    /**
+     * Between the first `beginUpdate()` and the last `endUpdate()` calls the access rights change
+     * notifications are coalesced and sent once, when the update ends. Cached access rights are
+     * invalidated immediately regardless.
+     */
+    void beginUpdate();
+    void endUpdate();
+
 signals:
     /** Access rights of all subjects have been reset. */
     void resourceAccessReset(QPrivateSignal);
 
+    /** Access rights of the specified watched subjects have been changed. */
+    void resourceAccessChanged(const QSet<QnUuid>& subjectIds, QPrivateSignal);
+
 private:
     struct Private;
     nx::utils::ImplPtr<Private> d;
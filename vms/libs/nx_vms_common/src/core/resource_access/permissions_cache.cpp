@@ -32,6 +32,7 @@ bool PermissionsCache::setPermissions(
                 const int index = m_sparseColumns.front();
                 m_sparseColumns.pop_front();
                 m_resourcesOrder[index] = resourceId;
+                m_indexOfResource.insert(std::make_pair(resourceId, index));
                 return index;
             }
 
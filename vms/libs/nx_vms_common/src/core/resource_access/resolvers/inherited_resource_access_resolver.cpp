@@ -7,7 +7,6 @@
 #include <core/resource_access/subject_hierarchy.h>
 #include <nx/utils/log/assert.h>
 #include <nx/utils/log/log.h>
-#include <nx/utils/range_adapters.h>
 #include <nx/utils/thread/mutex.h>
 
 namespace nx::core::access {
@@ -238,39 +237,46 @@ void InheritedResourceAccessResolver::Private::handleBaseAccessChanged(
     const QSet<QnUuid>& subjectIds)
 {
     NX_DEBUG(q, "Base resolution changed for %1 subjects: %2", subjectIds.size(), subjectIds);
+
+    // Only the changed subjects and their direct and indirect members inherit the change, so the
+    // affected subjects are collected by a single walk down the hierarchy instead of checking
+    // every cached and watched subject against the changed ones.
+    const auto affectedSubjectIds = subjectIds + subjectHierarchy->recursiveMembers(subjectIds);
     QSet<QnUuid> affectedCachedSubjectIds;
 
     {
         NX_MUTEX_LOCKER lk(&mutex);
 
-        for (const auto& cachedSubjectId: nx::utils::keyRange(cachedAccessData))
+        if (affectedSubjectIds.size() < cachedAccessData.size())
         {
-            if (subjectIds.contains(cachedSubjectId)
-                || subjectHierarchy->isRecursiveMember(cachedSubjectId, subjectIds))
+            for (const auto& subjectId: affectedSubjectIds)
             {
-                affectedCachedSubjectIds.insert(cachedSubjectId);
+                if (cachedAccessData.remove(subjectId))
+                    affectedCachedSubjectIds.insert(subjectId);
+            }
+        }
+        else
+        {
+            for (auto it = cachedAccessData.begin(); it != cachedAccessData.end(); )
+            {
+                if (affectedSubjectIds.contains(it.key()))
+                {
+                    affectedCachedSubjectIds.insert(it.key());
+                    it = cachedAccessData.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
             }
         }
-
-        for (const auto& subjectId: affectedCachedSubjectIds)
-            cachedAccessData.remove(subjectId);
     }
 
     NX_DEBUG(q, "Cache invalidated for %1 subjects: %2",
         affectedCachedSubjectIds.size(), affectedCachedSubjectIds);
 
-    const auto watchedSubjectIds = q->notifier()->watchedSubjectIds();
-    QSet<QnUuid> affectedWatchedSubjectIds;
-
-    for (const auto subjectId: watchedSubjectIds)
-    {
-        if (subjectIds.contains(subjectId)
-            || affectedCachedSubjectIds.contains(subjectId)
-            || subjectHierarchy->isRecursiveMember(subjectId, subjectIds))
-        {
-            affectedWatchedSubjectIds.insert(subjectId);
-        }
-    }
+    const auto affectedWatchedSubjectIds =
+        affectedSubjectIds & q->notifier()->watchedSubjectIds();
 
     if (!affectedCachedSubjectIds.empty())
         baseResolver->notifier()->releaseSubjects(affectedCachedSubjectIds);
@@ -326,6 +326,16 @@ QnResourceAccessManager::Notifier* QnResourceAccessManager::createNotifier(QObje
     return m_accessRightsResolver->createNotifier(parent);
 }
 
+void QnResourceAccessManager::beforeUpdate()
+{
+    m_accessRightsResolver->beginUpdate();
+}
+
+void QnResourceAccessManager::afterUpdate()
+{
+    m_accessRightsResolver->endUpdate();
+}
+
 void QnResourceAccessManager::handleResourcesAdded(const QnResourceList& resources)
 {
     for (const auto& resource: resources)
@@ -279,6 +279,10 @@ signals:
     void resourceAccessReset();
     void permissionsDependencyChanged(const QnResourcePtr& resource);
 
+protected:
+    virtual void beforeUpdate() override;
+    virtual void afterUpdate() override;
+
 private:
     bool canCreateResourceInternal(
         const QnResourceAccessSubject& subject,
@@ -2,6 +2,8 @@
 
 #include "resource_pool_p.h"
 
+#include <algorithm>
+
 #include <core/resource/camera_resource.h>
 #include <core/resource/media_server_resource.h>
 #include <core/resource/storage_resource.h>
@@ -20,6 +22,19 @@ QnResourcePool::Private::Private(
 
 void QnResourcePool::Private::handleResourceAdded(const QnResourcePtr& resource)
 {
+    // Parent id may be changed in any thread, and the index must be updated before
+    // getResourcesByParentId() is called by the thread which has changed it. The parent id is read
+    // after connecting, so a change made in between is not lost: its notification waits for the
+    // pool lock and finds the resource already indexed by the new parent.
+    QObject::connect(resource.data(), &QnResource::parentIdChanged, q,
+        [this](const QnResourcePtr& resource, const QnUuid& previousParentId)
+        {
+            NX_WRITE_LOCKER lk(&q->m_resourcesMutex);
+            updateParentId(resource, previousParentId);
+        },
+        Qt::DirectConnection);
+    resourcesByParentId[resource->getParentId()].push_back(resource);
+
     if (const auto server = resource.dynamicCast<QnMediaServerResource>())
     {
         mediaServers.insert(server);
@@ -64,6 +79,9 @@ void QnResourcePool::Private::handleResourceAdded(const QnResourcePtr& resource)
 
 void QnResourcePool::Private::handleResourceRemoved(const QnResourcePtr& resource)
 {
+    resource->disconnect(q);
+    removeFromParent(resource);
+
     if (const auto server = resource.dynamicCast<QnMediaServerResource>())
     {
         mediaServers.remove(server);
@@ -75,13 +93,11 @@ void QnResourcePool::Private::handleResourceRemoved(const QnResourcePtr& resourc
     else if (const auto camera = resource.dynamicCast<QnVirtualCameraResource>())
     {
         resourcesByPhysicalId.remove(camera->getPhysicalId());
-        camera->disconnect(q);
         ioModules.remove(camera);
         hasIoModules = !ioModules.isEmpty();
     }
     else if (const auto user = resource.dynamicCast<QnUserResource>())
     {
-        user->disconnect(q);
         removeUser(user->getName().toLower(), user);
     }
 }
@@ -95,6 +111,41 @@ void QnResourcePool::Private::updateIsIOModule(const QnVirtualCameraResourcePtr&
     hasIoModules = !ioModules.isEmpty();
 }
 
+void QnResourcePool::Private::updateParentId(
+    const QnResourcePtr& resource, const QnUuid& previousParentId)
+{
+    // Notifications of concurrent parent changes may come in any order, so the resource is moved
+    // from the parent it is indexed by to its actual parent.
+    const auto it = resourcesByParentId.find(previousParentId);
+    if (it == resourcesByParentId.end() || !it->removeOne(resource))
+    {
+        // Removed from the pool, already moved by a later notification, or indexed by the actual
+        // parent when it was added.
+        return;
+    }
+
+    if (it->isEmpty())
+        resourcesByParentId.erase(it);
+    resourcesByParentId[resource->getParentId()].push_back(resource);
+}
+
+void QnResourcePool::Private::removeFromParent(const QnResourcePtr& resource)
+{
+    auto it = resourcesByParentId.find(resource->getParentId());
+    if (it == resourcesByParentId.end() || !it->contains(resource))
+    {
+        // The parent change has not been handled yet.
+        it = std::find_if(resourcesByParentId.begin(), resourcesByParentId.end(),
+            [&resource](const QnResourceList& resources) { return resources.contains(resource); });
+        if (!NX_ASSERT(it != resourcesByParentId.end(), "Resource not indexed: %1", resource))
+            return;
+    }
+
+    it->removeOne(resource);
+    if (it->isEmpty())
+        resourcesByParentId.erase(it);
+}
+
 void QnResourcePool::Private::removeUser(const QString& name, const QnUserResourcePtr& user)
 {
     const auto it = usersByName.find(name);
@@ -4,6 +4,7 @@
 
 #include <unordered_map>
 
+#include <QtCore/QHash>
 #include <QtCore/QMap>
 #include <QtCore/QSet>
 #include <QtCore/QString>
@@ -18,6 +19,8 @@ struct QnResourcePool::Private
     void handleResourceRemoved(const QnResourcePtr& resource);
 
     void updateIsIOModule(const QnVirtualCameraResourcePtr& camera);
+    void updateParentId(const QnResourcePtr& resource, const QnUuid& previousParentId);
+    void removeFromParent(const QnResourcePtr& resource);
     void removeUser(const QString& name, const QnUserResourcePtr& user);
 
     struct SameNameUsers
@@ -48,4 +51,5 @@ public:
     QSet<QnStorageResourcePtr> storages;
     QMap<QString, QnNetworkResourcePtr> resourcesByPhysicalId;
     std::unordered_map<QString, SameNameUsers> usersByName;
+    QHash<QnUuid, QnResourceList> resourcesByParentId;
 };
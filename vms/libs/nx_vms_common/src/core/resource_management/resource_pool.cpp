@@ -14,9 +14,11 @@
 #include <core/resource/videowall_item_index.h>
 #include <core/resource/videowall_matrix_index.h>
 #include <core/resource/videowall_resource.h>
+#include <core/resource/webpage_resource.h>
 #include <core/resource_access/resource_access_filter.h>
 #include <nx/utils/log/assert.h>
 #include <nx/utils/log/log.h>
+#include <nx/vms/common/resource/analytics_engine_resource.h>
 #include <nx/vms/common/system_context.h>
 #include <utils/common/checked_cast.h>
 
@@ -47,6 +49,16 @@ QnResourcePool::QnResourcePool(nx::vms::common::SystemContext* systemContext, QO
     m_tranInProgress(false)
 {
     m_threadPool.reset(new QThreadPool());
+
+    addTypeIndex<QnResource>();
+    addTypeIndex<QnVirtualCameraResource>();
+    addTypeIndex<QnMediaServerResource>();
+    addTypeIndex<QnUserResource>();
+    addTypeIndex<QnLayoutResource>();
+    addTypeIndex<QnVideoWallResource>();
+    addTypeIndex<QnWebPageResource>();
+    addTypeIndex<nx::vms::common::AnalyticsEngineResource>();
+
     NX_DEBUG(this, "Created");
 }
 
@@ -130,6 +142,8 @@ void QnResourcePool::addResources(const QnResourceList& resources, AddResourceFl
             else
             {
                 d->handleResourceAdded(resource);
+                for (const auto& [type, index]: m_typeIndexes)
+                    index->add(resource);
                 newResources.insert(resource->getId(), resource);
             }
             m_incompatibleServers.remove(resource->getId());
@@ -211,6 +225,7 @@ void QnResourcePool::removeResources(const QnResourceList& resources)
     }
 
     NX_WRITE_LOCKER lk(&m_resourcesMutex);
+    QnResourceList removedFromPool;
     for (const QnResourcePtr& resource: removedResources)
     {
         // Have to remove by id, since physicalId can be MAC and, as a result, not unique among
@@ -223,6 +238,7 @@ void QnResourcePool::removeResources(const QnResourceList& resources)
         if (resIter != m_resources.cend())
         {
             d->handleResourceRemoved(resource);
+            removedFromPool.push_back(resIter.value());
             m_resources.erase(resIter);
             appendRemovedResource(resource);
         }
@@ -237,6 +253,12 @@ void QnResourcePool::removeResources(const QnResourceList& resources)
         }
     }
 
+    if (!removedFromPool.empty())
+    {
+        for (const auto& [type, index]: m_typeIndexes)
+            index->remove(removedFromPool);
+    }
+
     const bool onlyUsers = removedUsers.size() == removedResources.size();
 
     // After resources removing, we must check if removed layouts left on the videowall items
@@ -320,7 +342,7 @@ void QnResourcePool::removeResources(const QnResourceList& resources)
 QnResourceList QnResourcePool::getResources() const
 {
     NX_READ_LOCKER locker(&m_resourcesMutex);
-    return m_resources.values();
+    return getResourcesUnsafe<QnResource>();
 }
 
 QnResourcePtr QnResourcePool::getResourceById(const QnUuid& id) const
@@ -379,16 +401,28 @@ QnNetworkResourcePtr QnResourcePool::getResourceByMacAddress(const QString& mac)
 QnVirtualCameraResourceList QnResourcePool::getAllCameras(
     const QnUuid& parentId, bool ignoreDesktopCameras) const
 {
+    if (parentId.isNull())
+    {
+        auto cameras = getResources<QnVirtualCameraResource>();
+        if (ignoreDesktopCameras)
+        {
+            cameras.removeIf(
+                [](const QnVirtualCameraResourcePtr& camera)
+                {
+                    return camera->hasFlags(Qn::desktop_camera);
+                });
+        }
+        return cameras;
+    }
+
     QnVirtualCameraResourceList result;
-    NX_READ_LOCKER locker(&m_resourcesMutex);
-    for (const QnResourcePtr& resource: m_resources)
+    for (const QnResourcePtr& resource: getResourcesByParentId(parentId))
     {
         if (ignoreDesktopCameras && resource->hasFlags(Qn::desktop_camera))
             continue;
 
-        QnVirtualCameraResourcePtr camResource = resource.dynamicCast<QnVirtualCameraResource>();
-        if (camResource && (parentId.isNull() || camResource->getParentId() == parentId))
-            result.append(camResource);
+        if (auto camera = resource.dynamicCast<QnVirtualCameraResource>())
+            result.append(std::move(camera));
     }
 
     return result;
@@ -447,11 +481,8 @@ QnMediaServerResourceList QnResourcePool::getAllServers(nx::vms::api::ResourceSt
 
 QnResourceList QnResourcePool::getResourcesByParentId(const QnUuid& parentId) const
 {
-    return getResources(
-        [&parentId](const QnResourcePtr& resource)
-        {
-            return resource->getParentId() == parentId;
-        });
+    NX_READ_LOCKER locker(&m_resourcesMutex);
+    return d->resourcesByParentId.value(parentId);
 }
 
 QnNetworkResourceList QnResourcePool::getAllNetResourceByHostAddress(
@@ -494,10 +525,9 @@ QnUserResourcePtr QnResourcePool::getAdministrator() const
     if (m_adminResource)
         return m_adminResource;
 
-    for (const QnResourcePtr& resource: m_resources)
+    for (const QnUserResourcePtr& user: getResourcesUnsafe<QnUserResource>())
     {
-        QnUserResourcePtr user = resource.dynamicCast<QnUserResource>();
-        if (user && user->isBuiltInAdmin())
+        if (user->isBuiltInAdmin())
         {
             m_adminResource = user;
             return user;
@@ -533,6 +563,8 @@ void QnResourcePool::clear()
         m_resources.clear();
         m_incompatibleServers.clear();
         m_adminResource.clear();
+        for (const auto& [type, index]: m_typeIndexes)
+            index->clear();
 
         d->ioModules.clear();
         d->hasIoModules = false;
@@ -540,6 +572,7 @@ void QnResourcePool::clear()
         d->storages.clear();
         d->resourcesByPhysicalId.clear();
         d->usersByName.clear();
+        d->resourcesByParentId.clear();
     }
 
     for (const auto& resource: std::as_const(tempList))
@@ -581,11 +614,9 @@ QnMediaServerResourceList QnResourcePool::getIncompatibleServers() const
 
 QnVideoWallItemIndex QnResourcePool::getVideoWallItemByUuid(const QnUuid& uuid) const
 {
-    NX_READ_LOCKER lk(&m_resourcesMutex);
-    for (const QnResourcePtr& resource: m_resources)
+    for (const QnVideoWallResourcePtr& videoWall: getResources<QnVideoWallResource>())
     {
-        QnVideoWallResourcePtr videoWall = resource.dynamicCast<QnVideoWallResource>();
-        if (!videoWall || !videoWall->items()->hasItem(uuid))
+        if (!videoWall->items()->hasItem(uuid))
             continue;
         return QnVideoWallItemIndex(videoWall, uuid);
     }
@@ -606,11 +637,9 @@ QnVideoWallItemIndexList QnResourcePool::getVideoWallItemsByUuid(const QList<QnU
 
 QnVideoWallMatrixIndex QnResourcePool::getVideoWallMatrixByUuid(const QnUuid& uuid) const
 {
-    NX_READ_LOCKER lk(&m_resourcesMutex);
-    for (const QnResourcePtr& resource: m_resources)
+    for (const QnVideoWallResourcePtr& videoWall: getResources<QnVideoWallResource>())
     {
-        QnVideoWallResourcePtr videoWall = resource.dynamicCast<QnVideoWallResource>();
-        if (!videoWall || !videoWall->matrices()->hasItem(uuid))
+        if (!videoWall->matrices()->hasItem(uuid))
             continue;
         return QnVideoWallMatrixIndex(videoWall, uuid);
     }
@@ -2,12 +2,17 @@
 
 #pragma once
 
+#include <algorithm>
 #include <functional>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
 #include <vector>
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 
 #include <api/helpers/camera_id_helper.h>
 #include <common/common_globals.h>
@@ -102,6 +107,8 @@ public:
 
     //---------------------------------------------------------------------------------------------
     // Methods to get all resources.
+    // The lists are implicitly shared snapshots of the pool indexes, so getting them is cheap and
+    // iterating over them does not block the pool.
 
     QnResourceList getResources() const;
 
@@ -150,12 +157,12 @@ public:
 
     //---------------------------------------------------------------------------------------------
     // Methods to get resources by custom filter.
+    // The filters are called for a snapshot of the pool resources, without the pool lock.
 
     QnResourceList getResources(ResourceFilter filter) const
     {
-        NX_READ_LOCKER locker(&m_resourcesMutex);
         QnResourceList result;
-        for (const QnResourcePtr& resource: m_resources)
+        for (const QnResourcePtr& resource: getResources())
         {
             if (filter(resource))
                 result.push_back(resource);
@@ -166,15 +173,11 @@ public:
     template<class Resource>
     QnSharedResourcePointerList<Resource> getResources(ResourceClassFilter<Resource> filter) const
     {
-        NX_READ_LOCKER locker(&m_resourcesMutex);
         QnSharedResourcePointerList<Resource> result;
-        for (const QnResourcePtr& resource: m_resources)
+        for (const auto& resource: getResources<Resource>())
         {
-            if (auto derived = resource.template dynamicCast<Resource>())
-            {
-                if (filter(derived))
-                    result.push_back(derived);
-            }
+            if (filter(resource))
+                result.push_back(resource);
         }
         return result;
     }
@@ -182,17 +185,8 @@ public:
     template<class Resource>
     bool contains(ResourceClassFilter<Resource> filter) const
     {
-        NX_READ_LOCKER locker(&m_resourcesMutex);
-        QnSharedResourcePointerList<Resource> result;
-        for (const QnResourcePtr& resource: m_resources)
-        {
-            if (auto derived = resource.template dynamicCast<Resource>())
-            {
-                if (filter(derived))
-                    return true;
-            }
-        }
-        return false;
+        const auto resources = getResources<Resource>();
+        return std::any_of(resources.begin(), resources.end(), filter);
     }
 
     QnNetworkResourceList getAllNetResourceByHostAddress(const nx::String& hostAddress) const;
@@ -235,20 +229,18 @@ public:
 
     QnResourcePtr getResource(ResourceFilter filter) const
     {
-        NX_READ_LOCKER locker(&m_resourcesMutex);
-        auto itr = std::find_if(m_resources.begin(), m_resources.end(), filter);
-        return itr != m_resources.end() ? itr.value() : QnResourcePtr();
+        const auto resources = getResources();
+        auto itr = std::find_if(resources.begin(), resources.end(), filter);
+        return itr != resources.end() ? *itr : QnResourcePtr();
     }
 
     template<class Resource>
     QnSharedResourcePointer<Resource> getResource(ResourceClassFilter<Resource> filter) const
     {
-        NX_READ_LOCKER locker(&m_resourcesMutex);
-        for (const QnResourcePtr& resource: m_resources)
+        for (const auto& resource: getResources<Resource>())
         {
-            if (auto derived = resource.template dynamicCast<Resource>())
-                if (filter(derived))
-                    return derived;
+            if (filter(resource))
+                return resource;
         }
         return QnSharedResourcePointer<Resource>();
     }
@@ -359,14 +351,80 @@ signals:
     void statusChanged(const QnResourcePtr& resource, Qn::StatusChangeReason reason);
 
 private:
+    /**
+     * List of the pool resources of some class. The indexes of the frequently requested classes
+     * are created with the pool and are updated under the write lock when resources are added or
+     * removed, so the readers never modify them.
+     */
+    struct AbstractTypeIndex
+    {
+        virtual ~AbstractTypeIndex() = default;
+        virtual void add(const QnResourcePtr& resource) = 0;
+        virtual void remove(const QnResourceList& removedResources) = 0;
+        virtual void clear() = 0;
+    };
+
+    template<class Resource>
+    struct TypeIndex: AbstractTypeIndex
+    {
+        QnSharedResourcePointerList<Resource> resources;
+
+        virtual void add(const QnResourcePtr& resource) override
+        {
+            if (auto derived = resource.template dynamicCast<Resource>())
+                resources.push_back(std::move(derived));
+        }
+
+        virtual void remove(const QnResourceList& removedResources) override
+        {
+            QSet<const QnResource*> removed;
+            for (const auto& resource: removedResources)
+            {
+                if (dynamic_cast<const Resource*>(resource.get()))
+                    removed.insert(resource.get());
+            }
+
+            // The list is not walked if none of its resources are removed.
+            if (removed.isEmpty())
+                return;
+
+            resources.removeIf(
+                [&removed](const QnSharedResourcePointer<Resource>& resource)
+                {
+                    return removed.contains(resource.get());
+                });
+        }
+
+        virtual void clear() override
+        {
+            resources.clear();
+        }
+    };
+
+    /** Must be called from the constructor, while the pool is empty. */
+    template<class Resource>
+    void addTypeIndex()
+    {
+        m_typeIndexes[std::type_index(typeid(Resource))] = std::make_unique<TypeIndex<Resource>>();
+    }
+
+    /**
+     * Must be called with m_resourcesMutex locked. Returns a copy of the index list, which is
+     * implicitly shared, so no resources are copied until the pool is changed. The resources of
+     * the classes without an index are collected from the whole pool.
+     */
     template<class Resource>
     QnSharedResourcePointerList<Resource> getResourcesUnsafe() const
     {
+        const auto index = m_typeIndexes.find(std::type_index(typeid(Resource)));
+        if (index != m_typeIndexes.end())
+            return static_cast<const TypeIndex<Resource>*>(index->second.get())->resources;
+
         QnSharedResourcePointerList<Resource> result;
         for (const QnResourcePtr& resource: m_resources)
         {
             if (auto derived = resource.template dynamicCast<Resource>())
-                result.push_back(derived);
+                result.push_back(std::move(derived));
         }
         return result;
     }
@@ -376,6 +434,7 @@ private:
     nx::utils::ImplPtr<Private> d;
 
     mutable nx::ReadWriteLock m_resourcesMutex;
+    std::unordered_map<std::type_index, std::unique_ptr<AbstractTypeIndex>> m_typeIndexes;
     bool m_tranInProgress;
 
     QnResourceList m_tmpResources;
@@ -2,18 +2,207 @@
 
 #include "resource_properties.h"
 
-#include <nx/utils/qt_helpers.h>
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <nx/utils/thread/mutex.h>
 #include <nx/vms/common/system_context.h>
 #include <nx_ec/abstract_ec_connection.h>
 #include <nx_ec/managers/abstract_resource_manager.h>
 #include <nx/utils/log/log.h>
 
+namespace {
+
+using QnResourcePropertyList = QMap<QString, QString>;
+
+/**
+ * Property names of all Resources. Each name is stored once, the Resources refer to it by id.
+ * The number of different names is small, so they are never removed.
+ */
+class PropertyKeys
+{
+public:
+    using Id = uint32_t;
+
+    Id intern(const QString& key)
+    {
+        if (const auto id = find(key))
+            return *id;
+
+        NX_WRITE_LOCKER lock(&m_mutex);
+        const auto [it, inserted] = m_ids.emplace(key, (Id) m_names.size());
+        if (inserted)
+            m_names.push_back(key);
+        return it->second;
+    }
+
+    std::optional<Id> find(const QString& key) const
+    {
+        NX_READ_LOCKER lock(&m_mutex);
+        const auto it = m_ids.find(key);
+        if (it == m_ids.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    QString name(Id id) const
+    {
+        NX_READ_LOCKER lock(&m_mutex);
+        return m_names[id];
+    }
+
+private:
+    mutable nx::ReadWriteLock m_mutex;
+    std::unordered_map<QString, Id> m_ids;
+    std::vector<QString> m_names;
+};
+
+/**
+ * Properties of a single Resource, sorted by the name id. A Resource has a few dozens of
+ * properties at most, so the binary search in a flat vector is faster and takes much less memory
+ * than a tree.
+ */
+class PropertyTable
+{
+public:
+    using Value = std::pair<PropertyKeys::Id, QString>;
+
+    const QString* find(PropertyKeys::Id key) const
+    {
+        const auto it = lowerBound(key);
+        return it != m_values.end() && it->first == key ? &it->second : nullptr;
+    }
+
+    /** @return Whether the stored value has been modified. */
+    bool set(PropertyKeys::Id key, const QString& value)
+    {
+        const auto it = lowerBound(key);
+        if (it == m_values.end() || it->first != key)
+        {
+            m_values.emplace(it, key, value);
+            return true;
+        }
+
+        if (it->second == value)
+            return false;
+
+        it->second = value;
+        return true;
+    }
+
+    bool remove(PropertyKeys::Id key)
+    {
+        const auto it = lowerBound(key);
+        if (it == m_values.end() || it->first != key)
+            return false;
+
+        m_values.erase(it);
+        return true;
+    }
+
+    const std::vector<Value>& values() const { return m_values; }
+
+private:
+    std::vector<Value>::const_iterator lowerBound(PropertyKeys::Id key) const
+    {
+        return std::lower_bound(m_values.begin(), m_values.end(), key,
+            [](const Value& value, PropertyKeys::Id key) { return value.first < key; });
+    }
+
+    std::vector<Value>::iterator lowerBound(PropertyKeys::Id key)
+    {
+        return std::lower_bound(m_values.begin(), m_values.end(), key,
+            [](const Value& value, PropertyKeys::Id key) { return value.first < key; });
+    }
+
+private:
+    std::vector<Value> m_values;
+};
+
+struct Shard
+{
+    mutable nx::Mutex mutex;
+    std::unordered_map<QnUuid, PropertyTable> items;
+    QMap<QnUuid, QnResourcePropertyList> modifiedItems;
+};
+
+static constexpr size_t kShardCount = 16;
+
+} // namespace
+
+struct QnResourcePropertyDictionary::Private
+{
+    PropertyKeys keys;
+    std::array<Shard, kShardCount> shards;
+
+    Shard& shard(const QnUuid& resourceId)
+    {
+        return shards[std::hash<QnUuid>()(resourceId) % kShardCount];
+    }
+
+    const Shard& shard(const QnUuid& resourceId) const
+    {
+        return shards[std::hash<QnUuid>()(resourceId) % kShardCount];
+    }
+
+    /** Must be called with the shard mutex locked. */
+    bool setValue(
+        Shard* shard,
+        const QnUuid& resourceId,
+        PropertyKeys::Id keyId,
+        const QString& key,
+        const QString& value,
+        bool markDirty)
+    {
+        if (!shard->items[resourceId].set(keyId, value))
+            return false;
+
+        if (markDirty)
+        {
+            shard->modifiedItems[resourceId][key] = value;
+        }
+        else
+        {
+            // If parameter marked as modified, removing mark,
+            // i.e. parameter value has been reset to already saved value.
+            auto itr = shard->modifiedItems.find(resourceId);
+            if (itr != shard->modifiedItems.end())
+                itr.value().remove(key);
+        }
+        return true;
+    }
+
+    /** Must be called with the shard mutex locked. */
+    static void fromModifiedDataToSavedData(
+        Shard* shard,
+        const QnUuid& resourceId,
+        nx::vms::api::ResourceParamWithRefDataList& outData)
+    {
+        auto itr = shard->modifiedItems.find(resourceId);
+        if (itr != shard->modifiedItems.end())
+        {
+            QnResourcePropertyList& properties = itr.value();
+            for (auto itrParams = properties.begin(); itrParams != properties.end(); ++itrParams)
+                outData.emplace_back(resourceId, itrParams.key(), itrParams.value());
+            shard->modifiedItems.erase(itr);
+        }
+    }
+};
+
 QnResourcePropertyDictionary::QnResourcePropertyDictionary(
     nx::vms::common::SystemContext* context,
     QObject* parent)
     :
     QObject(parent),
-    nx::vms::common::SystemContextAware(context)
+    nx::vms::common::SystemContextAware(context),
+    d(new Private())
+{
+}
+
+QnResourcePropertyDictionary::~QnResourcePropertyDictionary()
 {
 }
 
@@ -21,14 +210,9 @@ bool QnResourcePropertyDictionary::saveParams(const QnUuid& resourceId)
 {
     nx::vms::api::ResourceParamWithRefDataList params;
     {
-        NX_MUTEX_LOCKER lock( &m_mutex );
-        auto itr = m_modifiedItems.find(resourceId);
-        if (itr == m_modifiedItems.end())
-            return true;
-        QnResourcePropertyList& properties = itr.value();
-        for (auto itrParams = properties.begin(); itrParams != properties.end(); ++itrParams)
-            params.emplace_back(resourceId, itrParams.key(), itrParams.value());
-        m_modifiedItems.erase(itr);
+        auto& shard = d->shard(resourceId);
+        NX_MUTEX_LOCKER lock(&shard.mutex);
+        Private::fromModifiedDataToSavedData(&shard, resourceId, params);
     }
 
     if( params.empty() )
@@ -46,20 +230,6 @@ bool QnResourcePropertyDictionary::saveParams(const QnUuid& resourceId)
     return true;
 }
 
-void QnResourcePropertyDictionary::fromModifiedDataToSavedData(
-    const QnUuid& resourceId,
-    nx::vms::api::ResourceParamWithRefDataList& outData)
-{
-    auto itr = m_modifiedItems.find(resourceId);
-    if (itr != m_modifiedItems.end())
-    {
-        QnResourcePropertyList& properties = itr.value();
-        for (auto itrParams = properties.begin(); itrParams != properties.end(); ++itrParams)
-            outData.emplace_back(resourceId, itrParams.key(), itrParams.value());
-        m_modifiedItems.erase(itr);
-    }
-}
-
 int QnResourcePropertyDictionary::saveData(const nx::vms::api::ResourceParamWithRefDataList&& data)
 {
     if (data.empty())
@@ -81,9 +251,10 @@ int QnResourcePropertyDictionary::saveParamsAsync(const QnUuid& resourceId)
 {
     nx::vms::api::ResourceParamWithRefDataList data;
     {
-        NX_MUTEX_LOCKER lock( &m_mutex );
+        auto& shard = d->shard(resourceId);
+        NX_MUTEX_LOCKER lock(&shard.mutex);
         //TODO #rvasilenko is it correct to mark property as saved before it has been actually saved to ec?
-        fromModifiedDataToSavedData(resourceId, data);
+        Private::fromModifiedDataToSavedData(&shard, resourceId, data);
     }
     return saveData(std::move(data));
 }
@@ -91,11 +262,12 @@ int QnResourcePropertyDictionary::saveParamsAsync(const QnUuid& resourceId)
 int QnResourcePropertyDictionary::saveParamsAsync(const QList<QnUuid>& idList)
 {
     nx::vms::api::ResourceParamWithRefDataList data;
+    //TODO #rvasilenko is it correct to mark property as saved before it has been actually saved to ec?
+    for (const QnUuid& resourceId: idList)
     {
-        NX_MUTEX_LOCKER lock( &m_mutex );
-        //TODO #rvasilenko is it correct to mark property as saved before it has been actually saved to ec?
-        for(const QnUuid& resourceId: idList)
-            fromModifiedDataToSavedData(resourceId, data);
+        auto& shard = d->shard(resourceId);
+        NX_MUTEX_LOCKER lock(&shard.mutex);
+        Private::fromModifiedDataToSavedData(&shard, resourceId, data);
     }
     return saveData(std::move(data));
 }
@@ -107,25 +279,37 @@ void QnResourcePropertyDictionary::onRequestDone( int reqID, ec2::ErrorCode erro
 
 QString QnResourcePropertyDictionary::value(const QnUuid& resourceId, const QString& key) const
 {
-    NX_MUTEX_LOCKER lock( &m_mutex );
-    auto itr = m_items.find(resourceId);
-    return itr != m_items.end() ? itr.value().value(key) : QString();
+    const auto keyId = d->keys.find(key);
+    if (!keyId)
+        return QString();
+
+    const auto& shard = d->shard(resourceId);
+    NX_MUTEX_LOCKER lock(&shard.mutex);
+    auto itr = shard.items.find(resourceId);
+    if (itr == shard.items.end())
+        return QString();
+    const QString* value = itr->second.find(*keyId);
+    return value ? *value : QString();
 }
 
 void QnResourcePropertyDictionary::clear()
 {
-    NX_MUTEX_LOCKER lock( &m_mutex );
-    m_items.clear();
-    m_modifiedItems.clear();
+    for (auto& shard: d->shards)
+    {
+        NX_MUTEX_LOCKER lock(&shard.mutex);
+        shard.items.clear();
+        shard.modifiedItems.clear();
+    }
 }
 
 void QnResourcePropertyDictionary::clear(const QVector<QnUuid>& idList)
 {
-    NX_MUTEX_LOCKER lock(&m_mutex);
     for (const QnUuid& id: idList)
     {
-        m_items.remove(id);
-        m_modifiedItems.remove(id);
+        auto& shard = d->shard(id);
+        NX_MUTEX_LOCKER lock(&shard.mutex);
+        shard.items.erase(id);
+        shard.modifiedItems.remove(id);
     }
 }
 
@@ -133,19 +317,20 @@ void QnResourcePropertyDictionary::markAllParamsDirty(
     const QnUuid& resourceId,
     nx::utils::MoveOnlyFunc<bool(const QString& paramName, const QString& paramValue)> filter)
 {
-    NX_MUTEX_LOCKER lock(&m_mutex);
-    auto itr = m_items.find(resourceId);
-    if (itr == m_items.end())
+    auto& shard = d->shard(resourceId);
+    NX_MUTEX_LOCKER lock(&shard.mutex);
+    auto itr = shard.items.find(resourceId);
+    if (itr == shard.items.end())
         return;
-    const QnResourcePropertyList& properties = itr.value();
-    QnResourcePropertyList& modifiedProperties = m_modifiedItems[resourceId];
-    for (auto itrProperty = properties.begin(); itrProperty != properties.end(); ++itrProperty)
+    QnResourcePropertyList& modifiedProperties = shard.modifiedItems[resourceId];
+    for (const auto& [keyId, value]: itr->second.values())
     {
-        if (!modifiedProperties.contains(itrProperty.key()))
+        const QString key = d->keys.name(keyId);
+        if (!modifiedProperties.contains(key))
         {
-            if (filter && !filter(itrProperty.key(), itrProperty.value()))
+            if (filter && !filter(key, value))
                 continue;
-            modifiedProperties[itrProperty.key()] = itrProperty.value();
+            modifiedProperties[key] = value;
         }
     }
 }
@@ -153,53 +338,77 @@ void QnResourcePropertyDictionary::markAllParamsDirty(
 bool QnResourcePropertyDictionary::setValue(const QnUuid& resourceId, const QString& key,
     const QString& value, bool markDirty)
 {
-    NX_MUTEX_LOCKER lock( &m_mutex );
-    auto itr = m_items.find(resourceId);
-    if (itr == m_items.end())
-        itr = m_items.insert(resourceId, QnResourcePropertyList());
-
-    QnResourcePropertyList& properties = itr.value();
-    auto itrValue = properties.find(key);
-    if (itrValue == properties.end())
-        properties.insert(key, value);
-    else if (itrValue.value() != value)
-        itrValue.value() = value;
-    else
+    const auto keyId = d->keys.intern(key);
+
+    auto& shard = d->shard(resourceId);
+    NX_MUTEX_LOCKER lock(&shard.mutex);
+    if (!d->setValue(&shard, resourceId, keyId, key, value, markDirty))
         return false; // nothing to change
-    if (markDirty)
+
+    lock.unlock();
+    emit propertyChanged(resourceId, key);
+    return true;
+}
+
+int QnResourcePropertyDictionary::setValues(
+    const nx::vms::api::ResourceParamWithRefDataList& params, bool markDirty)
+{
+    std::array<std::vector<std::pair<const nx::vms::api::ResourceParamWithRefData*,
+        PropertyKeys::Id>>, kShardCount> paramsByShard;
+    for (const auto& param: params)
     {
-        m_modifiedItems[resourceId][key] = value;
+        const size_t shardIndex = std::hash<QnUuid>()(param.resourceId) % kShardCount;
+        paramsByShard[shardIndex].emplace_back(&param, d->keys.intern(param.name));
     }
-    else
+
+    std::vector<const nx::vms::api::ResourceParamWithRefData*> changedParams;
+    for (size_t i = 0; i < kShardCount; ++i)
     {
-        // If parameter marked as modified, removing mark,
-        // i.e. parameter value has been reset to already saved value.
-        QnResourcePropertyList& modifiedProperties = m_modifiedItems[resourceId];
-        auto propertyIter = modifiedProperties.find( key );
-        if( propertyIter != modifiedProperties.end() )
-            modifiedProperties.erase( propertyIter );
+        if (paramsByShard[i].empty())
+            continue;
+
+        auto& shard = d->shards[i];
+        NX_MUTEX_LOCKER lock(&shard.mutex);
+        for (const auto& [param, keyId]: paramsByShard[i])
+        {
+            if (d->setValue(&shard, param->resourceId, keyId, param->name, param->value, markDirty))
+                changedParams.push_back(param);
+        }
     }
 
-    lock.unlock();
-    emit propertyChanged(resourceId, key);
-    return true;
+    for (const auto& param: changedParams)
+        emit propertyChanged(param->resourceId, param->name);
+
+    return (int) changedParams.size();
 }
 
 bool QnResourcePropertyDictionary::hasProperty(const QnUuid& resourceId, const QString& key) const
 {
-    NX_MUTEX_LOCKER lock( &m_mutex );
-    auto itr = m_items.find(resourceId);
-    return itr != m_items.end() && itr.value().contains(key);
+    const auto keyId = d->keys.find(key);
+    if (!keyId)
+        return false;
+
+    const auto& shard = d->shard(resourceId);
+    NX_MUTEX_LOCKER lock(&shard.mutex);
+    auto itr = shard.items.find(resourceId);
+    return itr != shard.items.end() && itr->second.find(*keyId);
 }
 
 bool QnResourcePropertyDictionary::hasProperty(const QString& key, const QString& value) const
 {
-    NX_MUTEX_LOCKER lock(&m_mutex);
-    for (auto& resProperties: m_items)
+    const auto keyId = d->keys.find(key);
+    if (!keyId)
+        return false;
+
+    for (const auto& shard: d->shards)
     {
-        auto itr = resProperties.find(key);
-        if (itr != resProperties.end() && itr.value() == value)
-            return true;
+        NX_MUTEX_LOCKER lock(&shard.mutex);
+        for (const auto& [resourceId, properties]: shard.items)
+        {
+            const QString* propertyValue = properties.find(*keyId);
+            if (propertyValue && *propertyValue == value)
+                return true;
+        }
     }
     return false;
 }
@@ -209,49 +418,46 @@ nx::vms::api::ResourceParamWithRefDataList QnResourcePropertyDictionary::allProp
     using namespace nx::vms::api;
     ResourceParamWithRefDataList result;
 
-    NX_MUTEX_LOCKER lock(&m_mutex);
-    for (auto resourceItr = m_items.cbegin(); resourceItr != m_items.cend(); ++resourceItr)
+    for (const auto& shard: d->shards)
     {
-        const auto& resProperties = resourceItr.value();
-        for (auto itr = resProperties.begin(); itr != resProperties.end(); ++itr)
+        NX_MUTEX_LOCKER lock(&shard.mutex);
+        for (const auto& [resourceId, properties]: shard.items)
         {
-            result.push_back(ResourceParamWithRefData(
-                resourceItr.key(), itr.key(), itr.value()));
+            for (const auto& [keyId, value]: properties.values())
+                result.push_back(ResourceParamWithRefData(resourceId, d->keys.name(keyId), value));
         }
     }
-    return result;
-}
-
-namespace
-{
-    bool removePropertyFromDictionary(
-        QMap<QnUuid, QMap<QString, QString>>* const dict,
-        const QnUuid& resourceId,
-        const QString& key )
-    {
-        auto resIter = dict->find( resourceId );
-        if( resIter == dict->cend() )
-            return false;
 
-        auto propertyIter = resIter.value().find( key );
-        if( propertyIter == resIter.value().cend() )
-            return false;
-
-        resIter.value().erase( propertyIter );
-        return true;
-    }
+    // Keep the order of the previous QMap-based implementation, the data is sent to the clients.
+    std::sort(result.begin(), result.end(),
+        [](const ResourceParamWithRefData& left, const ResourceParamWithRefData& right)
+        {
+            return left.resourceId != right.resourceId
+                ? left.resourceId < right.resourceId
+                : left.name < right.name;
+        });
+    return result;
 }
 
 bool QnResourcePropertyDictionary::on_resourceParamRemoved(
     const QnUuid& resourceId,
     const QString& key)
 {
-    NX_MUTEX_LOCKER lock(&m_mutex);
+    auto& shard = d->shard(resourceId);
+    NX_MUTEX_LOCKER lock(&shard.mutex);
 
-    if (!removePropertyFromDictionary(&m_items, resourceId, key) &&
-        !removePropertyFromDictionary(&m_modifiedItems, resourceId, key))
+    bool removed = false;
+    if (const auto keyId = d->keys.find(key))
     {
-        return false;
+        const auto itr = shard.items.find(resourceId);
+        removed = itr != shard.items.end() && itr->second.remove(*keyId);
+    }
+
+    if (!removed)
+    {
+        const auto itr = shard.modifiedItems.find(resourceId);
+        if (itr == shard.modifiedItems.end() || itr.value().remove(key) == 0)
+            return false;
     }
 
     lock.unlock();
@@ -264,33 +470,45 @@ nx::vms::api::ResourceParamDataList QnResourcePropertyDictionary::allProperties(
 {
     nx::vms::api::ResourceParamDataList result;
 
-    NX_MUTEX_LOCKER lock( &m_mutex );
-    auto itr = m_items.find(resourceId);
-    if (itr == m_items.end())
-        return result;
-    const QnResourcePropertyList& properties = itr.value();
-    for (auto itr = properties.begin(); itr != properties.end(); ++itr)
-        result.emplace_back(itr.key(), itr.value());
+    {
+        const auto& shard = d->shard(resourceId);
+        NX_MUTEX_LOCKER lock(&shard.mutex);
+        auto itr = shard.items.find(resourceId);
+        if (itr == shard.items.end())
+            return result;
+
+        for (const auto& [keyId, value]: itr->second.values())
+            result.emplace_back(d->keys.name(keyId), value);
+    }
 
+    std::sort(result.begin(), result.end(),
+        [](const auto& left, const auto& right) { return left.name < right.name; });
     return result;
 }
 
 QMap<QString, QString> QnResourcePropertyDictionary::modifiedProperties(
     const QnUuid& resourceId) const
 {
-    NX_MUTEX_LOCKER lock( &m_mutex );
+    const auto& shard = d->shard(resourceId);
+    NX_MUTEX_LOCKER lock(&shard.mutex);
 
-    return m_modifiedItems[resourceId];
+    return shard.modifiedItems.value(resourceId);
 }
 
 QHash<QnUuid, QSet<QString>> QnResourcePropertyDictionary::allPropertyNamesByResource() const
 {
     QHash<QnUuid, QSet<QString>> result;
 
-    NX_MUTEX_LOCKER lock( &m_mutex );
-    for (auto iter = m_items.constBegin(); iter != m_items.constEnd(); ++iter) {
-        QnUuid id = iter.key();
-        result.insert(id, nx::utils::toQSet(iter.value().keys()));
+    for (const auto& shard: d->shards)
+    {
+        NX_MUTEX_LOCKER lock(&shard.mutex);
+        for (const auto& [resourceId, properties]: shard.items)
+        {
+            QSet<QString>& names = result[resourceId];
+            names.reserve((int) properties.values().size());
+            for (const auto& [keyId, value]: properties.values())
+                names.insert(d->keys.name(keyId));
+        }
     }
     return result;
 }
@@ -2,12 +2,19 @@
 
 #pragma once
 
+#include <nx/utils/impl_ptr.h>
 #include <nx/utils/move_only_func.h>
 #include <nx/vms/api/data/resource_data.h>
 #include <nx/vms/common/system_context_aware.h>
 #include <nx_ec/ec_api_fwd.h>
 #include <utils/common/threadsafe_item_storage.h>
 
+/**
+ * Properties of all Resources in the System. The dictionary is split into shards by Resource id,
+ * each shard has its own mutex, so the threads reading properties of different Resources rarely
+ * wait for each other. Property names are interned: each name is stored once and the Resource
+ * properties refer to it by a small integer id.
+ */
 class NX_VMS_COMMON_API QnResourcePropertyDictionary:
     public QObject,
     public nx::vms::common::SystemContextAware
@@ -17,6 +24,7 @@ public:
     QnResourcePropertyDictionary(
         nx::vms::common::SystemContext* context,
         QObject* parent = nullptr);
+    virtual ~QnResourcePropertyDictionary() override;
 
     bool saveParams(const QnUuid& resourceId);
     int saveParamsAsync(const QnUuid& resourceId);
@@ -31,6 +39,13 @@ public:
         const QString& value,
         bool markDirty = true);
 
+    /**
+     * Sets the values like setValue() does, but locks each shard only once. Intended for loading
+     * the properties of many Resources, e.g. from the full info of the transaction log.
+     * @return Number of the stored values modified by this call.
+     */
+    int setValues(const nx::vms::api::ResourceParamWithRefDataList& params, bool markDirty = true);
+
     bool hasProperty(const QnUuid& resourceId, const QString& key) const;
     bool hasProperty(const QString& key, const QString& value) const;
     nx::vms::api::ResourceParamDataList allProperties(const QnUuid& resourceId) const;
@@ -56,13 +71,8 @@ signals:
     void propertyRemoved(const QnUuid& resourceId, const QString& key);
 private:
     void onRequestDone(int reqID, ec2::ErrorCode errorCode);
-    void fromModifiedDataToSavedData(
-        const QnUuid& resourceId,
-        nx::vms::api::ResourceParamWithRefDataList& outData);
     int saveData(const nx::vms::api::ResourceParamWithRefDataList&& data);
 private:
-    using QnResourcePropertyList = QMap<QString, QString>;
-    QMap<QnUuid, QnResourcePropertyList> m_items;
-    QMap<QnUuid, QnResourcePropertyList> m_modifiedItems;
-    mutable nx::Mutex m_mutex;
+    struct Private;
+    nx::utils::ImplPtr<Private> d;
 };
@@ -0,0 +1,66 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "media_cipher.h"
+
+#include <limits>
+
+#include <QtCore/QtEndian>
+
+#include <nx/utils/log/assert.h>
+#include <nx/utils/log/log.h>
+
+namespace nx::vms::crypt {
+
+MediaCipher::MediaCipher(const AesKey& key):
+    m_ivVect(key.ivVect)
+{
+    const auto cipher = toCipher(key.algorithm());
+    if (!cipher)
+        return;
+
+    m_context = EVP_CIPHER_CTX_new();
+    if (!m_context)
+        return;
+
+    // The key schedule is expanded here once. Later calls only reset the counter block.
+    if (!EVP_EncryptInit_ex(m_context, cipher, nullptr, key.cipherKey.data(), m_ivVect.data()))
+    {
+        NX_WARNING(this, "Failed to initialize the media cipher");
+        EVP_CIPHER_CTX_free(m_context);
+        m_context = nullptr;
+    }
+}
+
+MediaCipher::~MediaCipher()
+{
+    if (m_context)
+        EVP_CIPHER_CTX_free(m_context);
+}
+
+std::array<uint8_t, 16> MediaCipher::counterBlock(uint64_t nonce) const
+{
+    std::array<uint8_t, 16> result = m_ivVect;
+    const auto bigEndianNonce = qToBigEndian((quint64) nonce);
+    const auto nonceBytes = (const uint8_t*) &bigEndianNonce;
+    for (size_t i = 0; i < sizeof(bigEndianNonce); ++i)
+        result[i] ^= nonceBytes[i];
+    return result;
+}
+
+bool MediaCipher::encrypt(uint64_t nonce, const uint8_t* source, uint8_t* target, size_t size)
+{
+    if (!NX_ASSERT(m_context) || !NX_ASSERT(size <= (size_t) std::numeric_limits<int>::max()))
+        return false;
+
+    const auto counter = counterBlock(nonce);
+    if (!EVP_EncryptInit_ex(m_context, nullptr, nullptr, nullptr, counter.data()))
+        return false;
+
+    int outSize = 0;
+    if (size > 0 && !EVP_EncryptUpdate(m_context, target, &outSize, source, (int) size))
+        return false;
+
+    return outSize == (int) size;
+}
+
+} // namespace nx::vms::crypt
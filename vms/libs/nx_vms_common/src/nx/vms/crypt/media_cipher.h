@@ -0,0 +1,57 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "crypt.h"
+
+namespace nx::vms::crypt {
+
+/**
+ * AES-CTR cipher of the media packets of one stream. The EVP context and the key schedule are
+ * created once, and only the counter block is reset per packet, so processing a packet does not
+ * allocate. OpenSSL selects the hardware AES implementation (AES-NI, ARMv8 crypto extensions)
+ * when the CPU supports it.
+ *
+ * The initial counter block of a packet is the key ivVect with the big-endian packet nonce
+ * XOR-ed into its first 8 bytes. It is incremented as a 128-bit big-endian number for every
+ * 16-byte block of the packet (standard CTR mode, NIST SP 800-38A). The nonce must be unique per
+ * packet within the key. The ivVect and the nonce are stored with the packet as its encryption
+ * data, see toEncryptionData().
+ *
+ * CTR mode keeps the data size, and encryption and decryption are the same operation, so the
+ * data can be processed in place. Not thread-safe: use one instance per stream.
+ */
+class NX_VMS_COMMON_API MediaCipher
+{
+public:
+    MediaCipher(const AesKey& key);
+    ~MediaCipher();
+
+    MediaCipher(const MediaCipher&) = delete;
+    MediaCipher& operator=(const MediaCipher&) = delete;
+
+    /**
+     * @return False if the key is empty or the cipher could not be initialized.
+     */
+    bool isValid() const { return m_context != nullptr; }
+
+    /**
+     * Encrypts size bytes from source to target. The buffers may be the same.
+     */
+    bool encrypt(uint64_t nonce, const uint8_t* source, uint8_t* target, size_t size);
+    bool decrypt(uint64_t nonce, const uint8_t* source, uint8_t* target, size_t size)
+    {
+        return encrypt(nonce, source, target, size);
+    }
+
+    std::array<uint8_t, 16> counterBlock(uint64_t nonce) const;
+
+private:
+    EVP_CIPHER_CTX* m_context = nullptr;
+    std::array<uint8_t, 16> m_ivVect = {};
+};
+
+} // namespace nx::vms::crypt
@@ -0,0 +1,124 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include "mapped_file_cache.h"
+
+#include <algorithm>
+
+#include <QtCore/QFileInfo>
+
+#if defined(Q_OS_UNIX)
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#include <nx/utils/log/log.h>
+
+namespace nx::vms::metadata {
+
+MappedFile::MappedFile(const QString& fileName):
+    m_file(fileName)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        m_file.unmap(m_data);
+}
+
+std::shared_ptr<MappedFile> MappedFile::map(const QString& fileName)
+{
+    std::shared_ptr<MappedFile> result(new MappedFile(fileName));
+    if (!result->m_file.open(QFile::ReadOnly))
+        return nullptr;
+
+    result->m_size = result->m_file.size();
+    if (result->m_size == 0)
+        return nullptr;
+
+    result->m_data = result->m_file.map(0, result->m_size);
+    if (!result->m_data)
+    {
+        NX_DEBUG(NX_SCOPE_TAG, "Failed to map file %1: %2",
+            fileName, result->m_file.errorString());
+        return nullptr;
+    }
+
+    return result;
+}
+
+void MappedFile::advise(qint64 offset, qint64 size, Access access) const
+{
+    #if defined(Q_OS_UNIX)
+        static const qint64 kPageSize = sysconf(_SC_PAGESIZE);
+
+        offset = std::clamp<qint64>(offset, 0, m_size);
+        size = std::min(size, m_size - offset);
+        if (size <= 0)
+            return;
+
+        // madvise() requires a page-aligned address, and QFile::map() maps from the file start.
+        const auto start = (uintptr_t) (m_data + offset) / kPageSize * kPageSize;
+        const auto end = (uintptr_t) (m_data + offset + size);
+        madvise(
+            (void*) start,
+            end - start,
+            access == Access::sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+    #else
+        (void) offset;
+        (void) size;
+        (void) access;
+    #endif
+}
+
+//-------------------------------------------------------------------------------------------------
+
+std::shared_ptr<const MappedFile> MappedFileCache::get(const QString& fileName)
+{
+    // Checking the size is much cheaper than mapping the file again.
+    const qint64 size = QFileInfo(fileName).size();
+
+    NX_MUTEX_LOCKER lock(&m_mutex);
+
+    std::shared_ptr<const MappedFile> result;
+    for (auto it = m_files.begin(); it != m_files.end();)
+    {
+        auto file = it->lock();
+        if (!file)
+        {
+            it = m_files.erase(it);
+            continue;
+        }
+
+        if (file->fileName() == fileName)
+        {
+            if (file->size() == size)
+                result = std::move(file);
+            it = m_files.erase(it);
+            continue;
+        }
+        ++it;
+    }
+
+    // Mapping is done under the mutex, so concurrent searches of the same file do not map it
+    // twice.
+    if (!result)
+        result = MappedFile::map(fileName);
+
+    if (result)
+        m_files.push_back(result);
+    return result;
+}
+
+void MappedFileCache::remove(const QString& fileName)
+{
+    NX_MUTEX_LOCKER lock(&m_mutex);
+    m_files.remove_if(
+        [&fileName](const auto& weakFile)
+        {
+            const auto file = weakFile.lock();
+            return !file || file->fileName() == fileName;
+        });
+}
+
+} // namespace nx::vms::metadata
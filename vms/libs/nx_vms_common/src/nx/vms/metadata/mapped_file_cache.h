@@ -0,0 +1,83 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#pragma once
+
+#include <list>
+#include <memory>
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include <nx/utils/thread/mutex.h>
+
+namespace nx::vms::metadata {
+
+/**
+ * Read-only memory mapping of a whole file.
+ */
+class NX_VMS_COMMON_API MappedFile
+{
+public:
+    enum class Access
+    {
+        /** The range is going to be read from the beginning to the end. */
+        sequential,
+        /** The range is going to be read soon. */
+        willNeed,
+    };
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @return nullptr if the file does not exist, is empty or can not be mapped.
+     */
+    static std::shared_ptr<MappedFile> map(const QString& fileName);
+
+    QString fileName() const { return m_file.fileName(); }
+    const uchar* data() const { return m_data; }
+    qint64 size() const { return m_size; }
+
+    /**
+     * Passes the access pattern hint for the range to the OS (madvise), so it can read ahead the
+     * pages the search is going to scan. Does nothing on the platforms without madvise.
+     */
+    void advise(qint64 offset, qint64 size, Access access) const;
+
+private:
+    MappedFile(const QString& fileName);
+
+private:
+    QFile m_file;
+    uchar* m_data = nullptr;
+    qint64 m_size = 0;
+};
+
+/**
+ * Memory-mapped files shared by concurrent searches. The cache does not own the mappings: a file
+ * is unmapped and closed as soon as the last search using it releases it, so idle, removed or
+ * truncated files are never kept open. A file is mapped again if its size has changed since it
+ * was mapped, so the records appended by the writer become visible.
+ * NOTE: The files must not be truncated while their mappings are used.
+ */
+class NX_VMS_COMMON_API MappedFileCache
+{
+public:
+    /**
+     * @return nullptr if the file can not be mapped.
+     */
+    std::shared_ptr<const MappedFile> get(const QString& fileName);
+
+    /**
+     * Makes the next get() map the file again, even if its size is the same.
+     */
+    void remove(const QString& fileName);
+
+private:
+    nx::Mutex m_mutex;
+    std::list<std::weak_ptr<const MappedFile>> m_files;
+};
+
+} // namespace nx::vms::metadata
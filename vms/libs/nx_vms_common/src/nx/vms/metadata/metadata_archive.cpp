@@ -2,9 +2,14 @@
 
 #include "metadata_archive.h"
 
+#include <atomic>
+#include <numeric>
+
 #include <QtCore/QDir>
+#include <QtCore/QThreadPool>
 
 #include <nx/media/sse_helper.h>
+#include <nx/utils/concurrent.h>
 #include <nx/utils/log/log_main.h>
 #include <nx/utils/math/math.h>
 #include <nx/utils/scope_guard.h>
@@ -20,6 +25,25 @@ static const int kReadBufferSize = 1024 * 256;
 static const int kAlignment = 16;
 static const int kIndexRecordSize = sizeof(IndexRecord);
 static const int kMetadataIndexHeaderSize = sizeof(IndexHeader);
+/** Number of index records a search scans between releasing the truncation lock. */
+static const int kIndexRecordsPerScanLock = 4096;
+/** Number of the archive files matched concurrently by all the searches of the process. */
+static const int kMaxSearchThreadCount = 4;
+
+static QThreadPool* defaultSearchThreadPool()
+{
+    struct SearchThreadPool: QThreadPool
+    {
+        SearchThreadPool()
+        {
+            // The default is the number of CPU cores.
+            setMaxThreadCount(std::min(kMaxSearchThreadCount, maxThreadCount()));
+        }
+    };
+
+    static SearchThreadPool threadPool;
+    return &threadPool;
+}
 
 inline bool checkPeriod(const Filter* filter, qint64 startTimeMs, qint32 durationMs)
 {
@@ -132,6 +156,166 @@ bool Index::load(QFile& indexFile)
     return read == sizeInBytes;
 }
 
+IndexView::IndexView(const Index& index):
+    header(index.header),
+    begin(index.records.data()),
+    end(index.records.data() + index.records.size())
+{
+}
+
+std::optional<IndexView> IndexView::fromMappedFile(const MappedFile& file, int baseRecordSize)
+{
+    if (file.size() < kMetadataIndexHeaderSize)
+        return std::nullopt;
+
+    IndexView result;
+    memcpy(&result.header, file.data(), kMetadataIndexHeaderSize);
+    if (result.header.version < 2)
+    {
+        // For version < 2 these fields are empty.
+        result.header.recordSize = baseRecordSize;
+    }
+
+    const qint64 recordCount = (file.size() - kMetadataIndexHeaderSize) / kIndexRecordSize;
+    result.begin = (const IndexRecord*) (file.data() + kMetadataIndexHeaderSize);
+    result.end = result.begin + recordCount;
+    return result;
+}
+
+qint64 IndexView::dataOffset(const IndexRecord* record, bool noGeometryMode) const
+{
+    qint64 counter = 0;
+    for (auto i = begin; i < record; ++i)
+        counter += recordCount(i);
+    const int recordSize = noGeometryMode ? header.noGeometryRecordSize() : header.recordSize;
+    return recordSize * counter;
+}
+
+void IndexView::truncateTo(qint64 mediaRecords)
+{
+    qint64 counter = 0;
+    for (auto i = begin; i < end; ++i)
+    {
+        const int indexRecords = recordCount(i);
+        if (counter + indexRecords > mediaRecords)
+        {
+            if (counter < mediaRecords)
+            {
+                truncatedRecord = i;
+                truncatedRecordCount = (int) (mediaRecords - counter);
+                ++i;
+            }
+            end = i;
+            break;
+        }
+        counter += indexRecords;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * Read lock of the truncation lock which is released by a search between the blocks of a file,
+ * so the writer is not blocked until the whole month is scanned.
+ */
+class MetadataArchive::ScanLock
+{
+public:
+    ScanLock(MetadataArchive* archive):
+        m_archive(archive),
+        m_locker(&archive->m_truncationLock, __FILE__, __LINE__),
+        m_truncationCount(archive->m_truncationCount)
+    {
+    }
+
+    void setMappedFilesUsed(bool value) { m_mappedFilesUsed = value; }
+
+    /**
+     * Lets the writer truncate the files.
+     * @return False if the files have been truncated, so the mappings can not be accessed
+     *     anymore and the search must be stopped.
+     */
+    bool yield()
+    {
+        if (!m_mappedFilesUsed)
+            return true;
+
+        m_locker.unlock();
+        m_locker.relock();
+        if (m_archive->m_truncationCount == m_truncationCount)
+            return true;
+
+        NX_DEBUG(m_archive, "The files of camera %1 are truncated during the search, stopping it",
+            m_archive->m_physicalId);
+        return false;
+    }
+
+private:
+    const MetadataArchive* const m_archive;
+    nx::ReadLocker m_locker;
+    const int m_truncationCount;
+    bool m_mappedFilesUsed = false;
+};
+
+//-------------------------------------------------------------------------------------------------
+
+/**
+ * Provides blocks of a metadata file either from its memory mapping or by reading the file.
+ */
+class MetadataArchive::DataReader
+{
+public:
+    DataReader(ScanLock* scanLock, std::shared_ptr<const MappedFile> mappedFile, QFile* file):
+        m_scanLock(scanLock),
+        m_mappedFile(std::move(mappedFile)),
+        m_file(file),
+        m_buffer(kAlignment, 0, 0)
+    {
+    }
+
+    /**
+     * Hints the OS about the range that is going to be scanned, so it can read it ahead.
+     */
+    void prepare(qint64 offset, qint64 size, MappedFile::Access access)
+    {
+        if (m_mappedFile)
+            m_mappedFile->advise(offset, size, access);
+    }
+
+    /**
+     * @param size Number of bytes to read. Set to the number of bytes available.
+     * @return Pointer to the data which is valid until the next call. nullptr if there is no data
+     *     at the offset, or the files have been truncated.
+     */
+    const quint8* read(qint64 offset, int* size)
+    {
+        if (!m_scanLock->yield())
+            return nullptr;
+
+        if (m_mappedFile)
+        {
+            if (offset >= m_mappedFile->size())
+                return nullptr;
+            *size = (int) std::min<qint64>(*size, m_mappedFile->size() - offset);
+            return m_mappedFile->data() + offset;
+        }
+
+        m_buffer.reserve(*size);
+        if (!m_file->seek(offset))
+            return nullptr;
+        *size = (int) m_file->read(m_buffer.data(), *size);
+        return *size > 0 ? (const quint8*) m_buffer.data() : nullptr;
+    }
+
+private:
+    ScanLock* const m_scanLock;
+    const std::shared_ptr<const MappedFile> m_mappedFile;
+    QFile* const m_file;
+    nx::utils::ByteArray m_buffer;
+};
+
+//-------------------------------------------------------------------------------------------------
+
 MetadataArchive::MetadataArchive(
     const QString& filePrefix,
     int baseRecordSize,
@@ -145,6 +329,7 @@ MetadataArchive::MetadataArchive(
     m_recordSize(baseRecordSize),
     m_aggregationIntervalSeconds(aggregationIntervalSeconds),
     m_index(this),
+    m_searchThreadPool(defaultSearchThreadPool()),
     m_dataDir(dataDir),
     m_physicalId(physicalId),
     m_channel(channel)
@@ -194,10 +379,21 @@ void MetadataArchive::fillFileNames(qint64 datetimeMs, QFile* metadataFile, bool
     }
 }
 
-bool resizeFile(QFile* file, qint64 size)
+bool MetadataArchive::resizeFile(QFile* file, qint64 size)
 {
-    if (file->size() == size)
+    const qint64 fileSize = file->size();
+    if (fileSize == size)
         return true;
+
+    if (fileSize > size)
+    {
+        // Wait for the searches which may access the truncated part of the mapped file.
+        NX_WRITE_LOCKER lock(&m_truncationLock);
+        ++m_truncationCount;
+        m_mappedFiles.remove(file->fileName());
+        return file->resize(size);
+    }
+
     return file->resize(size);
 }
 
@@ -474,41 +670,44 @@ void MetadataArchive::loadDataFromIndex(
     AddRecordFunc addRecordFunc,
     RecordMatcher* recordMatcher,
     std::function<bool()> interruptionCallback,
-    QFile& metadataFile,
-    const Index& index,
-    QVector<IndexRecord>::iterator startItr,
-    const QVector<IndexRecord>::iterator endItr,
+    DataReader& dataReader,
+    const IndexView& index,
+    const IndexRecord* startItr,
+    const IndexRecord* endItr,
     QnTimePeriodList& rez) const
 {
-    nx::utils::ByteArray buffer(kAlignment, 0, 0);
+    std::vector<quint8> matches;
 
     int mediaRecordsLeft = 0;
     for (auto i = startItr; i < endItr; ++i)
-        mediaRecordsLeft += i->recordCount();
+        mediaRecordsLeft += index.recordCount(i);
     if (mediaRecordsLeft == 0)
         return;
 
     const int recordSize = recordMatcher->isNoGeometryMode()
         ? index.header.noGeometryRecordSize() : index.header.recordSize;
 
-    int indexRecordNumber = startItr - index.records.begin();
-    qint64 dataOffset = index.dataOffset(indexRecordNumber, recordMatcher->isNoGeometryMode());
-    metadataFile.seek(dataOffset);
+    qint64 dataOffset = index.dataOffset(startItr, recordMatcher->isNoGeometryMode());
+    dataReader.prepare(
+        dataOffset, (qint64) mediaRecordsLeft * recordSize, MappedFile::Access::sequential);
 
-    QVector<IndexRecord>::const_iterator i = startItr;
+    const IndexRecord* i = startItr;
     const int maxRecordsInBuffer = kReadBufferSize / recordSize;
-    int mediaRecordsPerIndexRecord = i->recordCount();
+    int mediaRecordsPerIndexRecord = index.recordCount(i);
     while (mediaRecordsLeft > 0)
     {
         const int recordsToRead = qMin(mediaRecordsLeft, maxRecordsInBuffer);
-        const int bufferSize = recordsToRead * recordSize;
-        buffer.reserve(bufferSize);
-        const int read = metadataFile.read(buffer.data(), bufferSize);
-        if (read <= 0)
+        int read = recordsToRead * recordSize;
+        const quint8* const data = dataReader.read(dataOffset, &read);
+        if (!data)
             break;
-        const quint8* dataEnd = (quint8*) buffer.data() + read;
-        quint8* curData = (quint8*) buffer.data();
+        dataOffset += read;
+        const quint8* dataEnd = data + read;
+        const quint8* curData = data;
         const auto filter = recordMatcher->filter();
+        matches.resize(read / recordSize);
+        const bool batchMatched = recordMatcher->matchRecords(
+            curData, recordSize, (int) matches.size(), matches.data());
         while (i < endItr && curData < dataEnd)
         {
             const qint64 fullStartTimeMs = i->start + index.header.startTimeMs;
@@ -519,7 +718,10 @@ void MetadataArchive::loadDataFromIndex(
                     NX_DEBUG(this, "Unexpected metadata file size");
                     break;
                 }
-                if (recordMatcher->matchRecord(fullStartTimeMs, curData, recordSize))
+                const bool isMatched = batchMatched
+                    ? matches[(curData - data) / recordSize] != 0
+                    : recordMatcher->matchRecord(fullStartTimeMs, curData, recordSize);
+                if (isMatched)
                 {
                 if (!addRecordFunc(recordMatcher->filter(), fullStartTimeMs, i->duration(), rez))
                         return;
@@ -533,7 +735,7 @@ void MetadataArchive::loadDataFromIndex(
             if (--mediaRecordsPerIndexRecord == 0)
             {
                 if (++i < endItr)
-                    mediaRecordsPerIndexRecord = i->recordCount();
+                    mediaRecordsPerIndexRecord = index.recordCount(i);
             }
         }
     }
@@ -543,13 +745,16 @@ void MetadataArchive::loadDataFromIndex(
     AddRecordFunc addRecordFunc,
     const Filter* filter,
     std::function<bool()> interruptionCallback,
-    const Index& index,
-    QVector<IndexRecord>::iterator startItr,
-    const QVector<IndexRecord>::iterator endItr,
+    ScanLock& scanLock,
+    const IndexView& index,
+    const IndexRecord* startItr,
+    const IndexRecord* endItr,
     QnTimePeriodList& rez) const
 {
     for(auto i = startItr; i < endItr;  ++i)
     {
+        if ((i + 1 - startItr) % kIndexRecordsPerScanLock == 0 && !scanLock.yield())
+            return;
         const qint64 fullStartTimeMs = i->start + index.header.startTimeMs;
         if (!checkPeriod(filter, fullStartTimeMs, i->duration()))
             continue;
@@ -564,20 +769,20 @@ void MetadataArchive::loadDataFromIndexDesc(
     AddRecordFunc addRecordFunc,
     RecordMatcher* recordMatcher,
     std::function<bool()> interruptionCallback,
-    QFile& metadataFile,
-    const Index& index,
-    QVector<IndexRecord>::iterator startItr,
-    const QVector<IndexRecord>::iterator endItr,
+    DataReader& dataReader,
+    const IndexView& index,
+    const IndexRecord* startItr,
+    const IndexRecord* endItr,
     QnTimePeriodList& rez) const
 {
-    nx::utils::ByteArray buffer(kAlignment, 0, 0);
+    std::vector<quint8> matches;
 
     const int recordSize = recordMatcher->isNoGeometryMode()
         ? index.header.noGeometryRecordSize() : index.header.recordSize;
 
     int mediaRecordsLeft = 0;
     for (auto i = startItr; i < endItr; ++i)
-        mediaRecordsLeft += i->recordCount();
+        mediaRecordsLeft += index.recordCount(i);
     if (mediaRecordsLeft == 0)
         return;
 
@@ -590,7 +795,7 @@ void MetadataArchive::loadDataFromIndexDesc(
             int mediaRecordsInBlock = 0;
             while (currentItr >= startItr)
             {
-                const int records = currentItr->recordCount();
+                const int records = index.recordCount(currentItr);
                 if (mediaRecordsInBlock + records > maxMediaRecords)
                     break;
                 mediaRecordsInBlock += records;
@@ -601,31 +806,39 @@ void MetadataArchive::loadDataFromIndexDesc(
         };
 
     // math file (one month)
-    QVector<IndexRecord>::const_iterator i = endItr - 1;
-    int64_t mediaFileOffset = index.dataOffset(endItr - index.records.begin(), recordMatcher->isNoGeometryMode());
+    const IndexRecord* i = endItr - 1;
+    int64_t mediaFileOffset = index.dataOffset(endItr, recordMatcher->isNoGeometryMode());
+    dataReader.prepare(
+        mediaFileOffset - (qint64) mediaRecordsLeft * recordSize,
+        (qint64) mediaRecordsLeft * recordSize,
+        MappedFile::Access::willNeed);
     while (mediaRecordsLeft > 0)
     {
-        int mediaRecordsPerIndexRecord = i->recordCount();
+        int mediaRecordsPerIndexRecord = index.recordCount(i);
         int recordsToRead = std::min(mediaRecordsLeft, maxRecordsInBuffer);
         int actualRecordsToRead = calcRecordNumberToSeek(i, startItr, recordsToRead);
         mediaFileOffset -= actualRecordsToRead * recordSize;
-        metadataFile.seek(mediaFileOffset);
 
-        int mediaDataSize = actualRecordsToRead * recordSize;
-        buffer.reserve(mediaDataSize);
-        const int read = metadataFile.read(buffer.data(), mediaDataSize);
-        if (read <= 0)
+        int read = actualRecordsToRead * recordSize;
+        const quint8* const data = dataReader.read(mediaFileOffset, &read);
+        if (!data)
             break;
 
-        quint8* dataEnd = (quint8*) buffer.data() + read;
-        quint8* curData = dataEnd - recordSize;
+        const quint8* dataEnd = data + read;
+        const quint8* curData = dataEnd - recordSize;
         const auto filter = recordMatcher->filter();
-        while (i >= startItr && curData >= (quint8*) buffer.data())
+        matches.resize(read / recordSize);
+        const bool batchMatched = recordMatcher->matchRecords(
+            data, recordSize, (int) matches.size(), matches.data());
+        while (i >= startItr && curData >= data)
         {
             qint64 fullStartTimeMs = i->start + index.header.startTimeMs;
             if (checkPeriod(filter, fullStartTimeMs, i->duration()))
             {
-                if (recordMatcher->matchRecord(fullStartTimeMs, curData, recordSize))
+                const bool isMatched = batchMatched
+                    ? matches[(curData - data) / recordSize] != 0
+                    : recordMatcher->matchRecord(fullStartTimeMs, curData, recordSize);
+                if (isMatched)
                 {
                     if (!addRecordFunc(filter, fullStartTimeMs, i->duration(), rez))
                         return;
@@ -639,7 +852,7 @@ void MetadataArchive::loadDataFromIndexDesc(
             if (--mediaRecordsPerIndexRecord == 0)
             {
                 if (--i >= startItr)
-                    mediaRecordsPerIndexRecord = i->recordCount();
+                    mediaRecordsPerIndexRecord = index.recordCount(i);
             }
         }
     }
@@ -649,13 +862,16 @@ void MetadataArchive::loadDataFromIndexDesc(
     AddRecordFunc addRecordFunc,
     const Filter* filter,
     std::function<bool()> interruptionCallback,
-    const Index& index,
-    QVector<IndexRecord>::iterator startItr,
-    const QVector<IndexRecord>::iterator endItr,
+    ScanLock& scanLock,
+    const IndexView& index,
+    const IndexRecord* startItr,
+    const IndexRecord* endItr,
     QnTimePeriodList& rez) const
 {
     for (auto i = endItr - 1; i >= startItr; --i)
     {
+        if ((endItr - i) % kIndexRecordsPerScanLock == 0 && !scanLock.yield())
+            return;
         const qint64 fullStartTimeMs = i->start + index.header.startTimeMs;
         if (!checkPeriod(filter, fullStartTimeMs, i->duration()))
             continue;
@@ -667,6 +883,273 @@ void MetadataArchive::loadDataFromIndexDesc(
     }
 }
 
+void MetadataArchive::setSearchThreadPool(QThreadPool* threadPool)
+{
+    m_searchThreadPool = threadPool;
+}
+
+QThreadPool* MetadataArchive::searchThreadPool() const
+{
+    return m_searchThreadPool;
+}
+
+bool MetadataArchive::matchFile(
+    RecordMatcher* recordMatcher,
+    const FileRange& range,
+    std::function<bool()> interruptionCallback,
+    QnTimePeriodList* result)
+{
+    const bool descendingOrder =
+        recordMatcher->filter()->sortOrder == Qt::SortOrder::DescendingOrder;
+
+    qint64 minTime, maxTime;
+    const auto timePointMs = range.startTimeMs;
+    dateBounds(timePointMs, minTime, maxTime);
+
+    // The mapped files must not be truncated while they are scanned.
+    ScanLock scanLock(this);
+
+    QFile metadataFile;
+    QFile indexFile;
+    fillFileNames(timePointMs, &indexFile);
+
+    // The index is read from the file only if it can not be mapped.
+    Index loadedIndex(this);
+    std::optional<IndexView> index;
+    const auto mappedIndexFile = m_mappedFiles.get(indexFile.fileName());
+    if (mappedIndexFile)
+    {
+        scanLock.setMappedFilesUsed(true);
+        index = IndexView::fromMappedFile(*mappedIndexFile, m_recordSize);
+    }
+    else if (loadedIndex.load(timePointMs))
+        index = IndexView(loadedIndex);
+
+    if (!index)
+        return false;
+
+    const bool hasDiscontinue = index->header.flags & IndexHeader::Flags::hasDiscontinue;
+
+    const bool noGeometryMode = index->header.noGeometryModeSupported()
+        && index->header.noGeometryRecordSize() > 0
+        && recordMatcher->isWholeFrame();
+    recordMatcher->setNoGeometryMode(noGeometryMode);
+    fillFileNames(timePointMs, &metadataFile, noGeometryMode, nullptr);
+    NX_VERBOSE(this, nx::format("Matching metadata periods for camera %1 for month %2")
+        .args(m_physicalId, metadataFile.fileName()));
+
+    std::shared_ptr<const MappedFile> mappedMetadataFile;
+    if (!recordMatcher->isEmpty())
+        mappedMetadataFile = m_mappedFiles.get(metadataFile.fileName());
+    if (mappedMetadataFile)
+        scanLock.setMappedFilesUsed(true);
+
+    if (!recordMatcher->isEmpty()
+        && !mappedMetadataFile
+        && !metadataFile.open(QFile::ReadOnly))
+    {
+        return hasDiscontinue;
+    }
+
+    const int recordSize = noGeometryMode
+        ? index->header.noGeometryRecordSize() : index->header.recordSize;
+    if (mappedMetadataFile)
+        index->truncateTo(mappedMetadataFile->size() / recordSize);
+    else if (metadataFile.isOpen())
+        index->truncateTo(metadataFile.size() / recordSize);
+    DataReader dataReader(&scanLock, mappedMetadataFile, &metadataFile);
+
+    const IndexRecord* startItr = index->begin;
+    const IndexRecord* endItr = index->end;
+
+    if (!hasDiscontinue)
+    {
+        if (range.startTimeMs > minTime)
+        {
+            const quint32 relativeStartTime = range.startTimeMs - index->header.startTimeMs;
+            startItr = std::lower_bound(index->begin, index->end, relativeStartTime);
+            while (startItr != index->end && startItr != index->begin)
+            {
+                const auto prevItr = startItr - 1;
+                const auto prevEnd = prevItr->start + prevItr->duration();
+                if (qBetween(prevItr->start, relativeStartTime, prevEnd))
+                    startItr = prevItr;
+                else
+                    break;
+            }
+        }
+        if (range.endTimeMs < maxTime)
+        {
+            endItr = std::upper_bound(
+                startItr, index->end, range.endTimeMs - index->header.startTimeMs);
+        }
+    }
+
+    // Turn off limit checking for discontinue mode. It is needed to apply limit after sorting data.
+    const auto breakCallback = hasDiscontinue ? nullptr : interruptionCallback;
+
+    // Match one file (one month of data or less).
+    if (recordMatcher->isEmpty())
+    {
+        if (descendingOrder)
+        {
+            loadDataFromIndexDesc(
+                hasDiscontinue ? addToResultDescUnordered : addToResultDesc,
+                recordMatcher->filter(),
+                breakCallback, scanLock, *index, startItr, endItr, *result);
+        }
+        else
+        {
+            loadDataFromIndex(
+                hasDiscontinue ? addToResultAscUnordered : addToResultAsc,
+                recordMatcher->filter(),
+                breakCallback, scanLock, *index, startItr, endItr, *result);
+        }
+    }
+    else
+    {
+        if (descendingOrder)
+        {
+            loadDataFromIndexDesc(
+                hasDiscontinue ? addToResultDescUnordered : addToResultDesc,
+                recordMatcher, breakCallback,
+                dataReader, *index, startItr, endItr,
+                *result);
+        }
+        else
+        {
+            loadDataFromIndex(
+                hasDiscontinue ? addToResultAscUnordered : addToResultAsc,
+                recordMatcher, breakCallback,
+                dataReader, *index, startItr, endItr,
+                *result);
+        }
+    }
+
+    return hasDiscontinue;
+}
+
+QnTimePeriodList MetadataArchive::matchFilesSequentially(
+    RecordMatcher* recordMatcher,
+    const std::vector<FileRange>& ranges,
+    std::function<bool()> interruptionCallback,
+    FixDiscontinue fixDiscontinue)
+{
+    const auto filter = recordMatcher->filter();
+
+    QnTimePeriodList rez;
+    bool needToFixDiscontinuity = false;
+    for (const auto& range: ranges)
+    {
+        const bool hasDiscontinue = matchFile(recordMatcher, range, interruptionCallback, &rez);
+        needToFixDiscontinuity |= hasDiscontinue;
+
+        if (!hasDiscontinue && filter->limit > 0 && rez.size() >= filter->limit)
+            break;
+
+        if (interruptionCallback && interruptionCallback())
+            break;
+    }
+
+    if (needToFixDiscontinuity)
+        fixDiscontinue(&rez, filter->sortOrder == Qt::SortOrder::DescendingOrder, filter);
+    return rez;
+}
+
+QnTimePeriodList MetadataArchive::matchFilesConcurrently(
+    const RecordMatcher& recordMatcher,
+    const std::vector<FileRange>& ranges,
+    std::function<bool()> interruptionCallback,
+    FixDiscontinue fixDiscontinue)
+{
+    struct FileResult
+    {
+        QnTimePeriodList periods;
+        bool hasDiscontinue = false;
+        bool isDone = false;
+    };
+
+    const auto filter = recordMatcher.filter();
+    const bool descendingOrder = filter->sortOrder == Qt::SortOrder::DescendingOrder;
+    const int fileCount = (int) ranges.size();
+
+    nx::Mutex mutex;
+    std::vector<FileResult> results(fileCount);
+    int doneFileCount = 0; //< Number of the first files in the search order which are matched.
+    int periodCount = 0; //< Number of the periods in these files.
+    bool hasDiscontinue = false; //< Whether some of these files have a discontinuity.
+
+    // The files after it are not needed because the limit is reached before them.
+    std::atomic<int> lastNeededFile = fileCount - 1;
+
+    std::vector<int> files(fileCount);
+    std::iota(files.begin(), files.end(), 0);
+    auto future = nx::utils::concurrent::mapped(m_searchThreadPool, files,
+        [&](int file)
+        {
+            const auto isInterrupted =
+                [&, file]()
+                {
+                    return file > lastNeededFile
+                        || (interruptionCallback && interruptionCallback());
+                };
+            if (isInterrupted())
+                return;
+
+            FileResult result;
+            const auto fileMatcher = recordMatcher.clone();
+            result.hasDiscontinue = matchFile(
+                fileMatcher.get(), ranges[file], isInterrupted, &result.periods);
+            result.isDone = true;
+
+            NX_MUTEX_LOCKER lock(&mutex);
+            results[file] = std::move(result);
+            for (; doneFileCount < fileCount && results[doneFileCount].isDone; ++doneFileCount)
+            {
+                hasDiscontinue |= results[doneFileCount].hasDiscontinue;
+                periodCount += (int) results[doneFileCount].periods.size();
+
+                // Every file boundary can join two periods into one.
+                if (!hasDiscontinue
+                    && filter->limit > 0
+                    && periodCount - doneFileCount >= filter->limit)
+                {
+                    lastNeededFile = std::min<int>(lastNeededFile, doneFileCount);
+                }
+            }
+        });
+    future.waitForFinished();
+
+    std::vector<QnTimePeriodList> periods;
+    bool needToFixDiscontinuity = false;
+    for (int i = 0; i <= lastNeededFile; ++i)
+    {
+        needToFixDiscontinuity |= results[i].hasDiscontinue;
+        periods.push_back(std::move(results[i].periods));
+    }
+
+    QnTimePeriodList rez;
+    if (needToFixDiscontinuity)
+    {
+        for (const auto& filePeriods: periods)
+            rez.insert(rez.end(), filePeriods.begin(), filePeriods.end());
+        fixDiscontinue(&rez, descendingOrder, filter);
+    }
+    else if (filter->detailLevel.count() > 0)
+    {
+        // The periods of the adjacent files may be closer than the detail level, so they are
+        // joined the same way as the periods of one file.
+        rez = QnTimePeriodList::mergeTimePeriods(
+            periods, std::numeric_limits<int>::max(), filter->sortOrder);
+        onDiscontinueInMatchedResult(&rez, descendingOrder, filter);
+    }
+    else
+    {
+        rez = QnTimePeriodList::mergeTimePeriods(periods, filter->limit, filter->sortOrder);
+    }
+    return rez;
+}
+
 QnTimePeriodList MetadataArchive::matchPeriodInternal(
     RecordMatcher* recordMatcher,
     std::function<bool()> interruptionCallback,
@@ -684,123 +1167,31 @@ QnTimePeriodList MetadataArchive::matchPeriodInternal(
         (qint64) recordMatcher->filter()->endTime.count(),
         existingRecords.last().startOfDay().addMonths(1).toMSecsSinceEpoch() - 1);
 
-    QnTimePeriodList rez;
+    // Split the time range by the archive files in the search order.
+    std::vector<FileRange> ranges;
     const bool descendingOrder = recordMatcher->filter()->sortOrder == Qt::SortOrder::DescendingOrder;
-    bool needToFixDiscontinuity = false;
     while (msStartTime <= msEndTime)
     {
         qint64 minTime, maxTime;
-        const auto timePointMs = descendingOrder ? msEndTime : msStartTime;
-        dateBounds(timePointMs, minTime, maxTime);
-
-        QFile metadataFile;
-        Index index(this);
-
-        if (index.load(timePointMs))
-        {
-            const bool hasDiscontinue = index.header.flags & IndexHeader::Flags::hasDiscontinue;
-            needToFixDiscontinuity |= hasDiscontinue;
-
-            const bool noGeometryMode = index.header.noGeometryModeSupported()
-                && index.header.noGeometryRecordSize() > 0
-                && recordMatcher->isWholeFrame();
-            recordMatcher->setNoGeometryMode(noGeometryMode);
-            fillFileNames(timePointMs, &metadataFile, noGeometryMode, nullptr);
-            NX_VERBOSE(this, nx::format("Matching metadata periods for camera %1 for month %2")
-                .args(m_physicalId, metadataFile.fileName()));
-
-            if (recordMatcher->isEmpty() || metadataFile.open(QFile::ReadOnly))
-            {
-                const int recordSize = noGeometryMode
-                    ? index.header.noGeometryRecordSize() : index.header.recordSize;
-                if (metadataFile.isOpen())
-                    index.truncateTo(metadataFile.size() / recordSize);
-
-                QVector<IndexRecord>::iterator startItr = index.records.begin();
-                QVector<IndexRecord>::iterator endItr = index.records.end();
-
-                if (!hasDiscontinue)
-                {
-                    if (msStartTime > minTime)
-                    {
-                        const quint32 relativeStartTime = msStartTime - index.header.startTimeMs;
-                        startItr = std::lower_bound(index.records.begin(), index.records.end(), relativeStartTime);
-                        while (startItr != index.records.end() && startItr != index.records.begin())
-                        {
-                            const auto prevItr = startItr - 1;
-                            if (qBetween(prevItr->start, relativeStartTime, prevItr->start + prevItr->duration()))
-                                startItr = prevItr;
-                            else
-                                break;
-                        }
-                    }
-                    if (msEndTime <= maxTime)
-                        endItr = std::upper_bound(startItr, index.records.end(), msEndTime - index.header.startTimeMs);
-                }
-
-                // Turn off limit checking for discontinue mode. It is needed to apply limit after sorting data.
-                const auto breakCallback = hasDiscontinue ? nullptr : interruptionCallback;
-
-                // Match one file (one month of data or less).
-                if (recordMatcher->isEmpty())
-                {
-                    if (descendingOrder)
-                    {
-                        loadDataFromIndexDesc(
-                            hasDiscontinue ? addToResultDescUnordered : addToResultDesc,
-                            recordMatcher->filter(),
-                            breakCallback, index, startItr, endItr, rez);
-                    }
-                    else
-                    {
-                        loadDataFromIndex(
-                            hasDiscontinue ? addToResultAscUnordered : addToResultAsc,
-                            recordMatcher->filter(),
-                            breakCallback, index, startItr, endItr, rez);
-                    }
-                }
-                else
-                {
-                    if (descendingOrder)
-                    {
-                        loadDataFromIndexDesc(
-                            hasDiscontinue ? addToResultDescUnordered : addToResultDesc,
-                            recordMatcher, breakCallback,
-                            metadataFile, index, startItr, endItr,
-                            rez);
-                    }
-                    else
-                    {
-                        loadDataFromIndex(
-                            hasDiscontinue ? addToResultAscUnordered : addToResultAsc,
-                            recordMatcher, breakCallback,
-                            metadataFile, index, startItr, endItr,
-                            rez);
-                    }
-                }
-
-                if (!hasDiscontinue
-                    && recordMatcher->filter()->limit > 0
-                    && rez.size() >= recordMatcher->filter()->limit)
-                {
-                    break;
-                }
-            }
-        }
+        dateBounds(descendingOrder ? msEndTime : msStartTime, minTime, maxTime);
+        ranges.push_back({std::max(msStartTime, minTime), std::min(msEndTime, maxTime)});
 
         if (descendingOrder)
             msEndTime = minTime - 1;
         else
             msStartTime = maxTime + 1;
-
-        if (interruptionCallback && interruptionCallback())
-            break;
     }
+
+    std::unique_ptr<RecordMatcher> clonedMatcher;
+    if (m_searchThreadPool && ranges.size() > 1)
+        clonedMatcher = recordMatcher->clone();
+
+    const auto rez = clonedMatcher
+        ? matchFilesConcurrently(*clonedMatcher, ranges, interruptionCallback, fixDiscontinue)
+        : matchFilesSequentially(recordMatcher, ranges, interruptionCallback, fixDiscontinue);
+
     NX_VERBOSE(this, nx::format("Found %1 metadata period(s) for camera %2 for range %3-%4")
         .args(rez.size(), m_physicalId, recordMatcher->filter()->startTime, recordMatcher->filter()->endTime));
-
-    if (needToFixDiscontinuity)
-        fixDiscontinue(&rez, descendingOrder, recordMatcher->filter());
     return rez;
 }
 
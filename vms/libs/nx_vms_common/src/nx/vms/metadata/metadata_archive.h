@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include <QtCore/QFile>
 #include <QtCore/QString>
 #include <QtCore/QVector>
@@ -10,6 +14,10 @@
 #include <nx/utils/thread/mutex.h>
 #include <recording/time_period_list.h>
 
+#include "mapped_file_cache.h"
+
+class QThreadPool;
+
 namespace nx::vms::metadata {
 
 static const int kGeometrySize = Qn::kMotionGridWidth * Qn::kMotionGridHeight / 8;
@@ -78,6 +86,44 @@ struct NX_VMS_COMMON_API Index
     MetadataArchive* m_owner = nullptr;
 };
 
+/**
+ * Read-only view of index records, either mapped from the index file or loaded to Index.
+ */
+struct NX_VMS_COMMON_API IndexView
+{
+    IndexHeader header;
+    const IndexRecord* begin = nullptr;
+    const IndexRecord* end = nullptr;
+    /** The last index record if its media records are partially beyond the data file end. */
+    const IndexRecord* truncatedRecord = nullptr;
+    int truncatedRecordCount = 0;
+
+    IndexView() = default;
+    IndexView(const Index& index);
+
+    /**
+     * Creates the view of the mapped index file. The mapping must outlive the view.
+     * @return std::nullopt if the file is too small to contain the header.
+     */
+    static std::optional<IndexView> fromMappedFile(const MappedFile& file, int baseRecordSize);
+
+    qint64 dataOffset(const IndexRecord* record, bool noGeometryMode) const;
+
+    /**
+     * Number of media records of the index record, with the truncation taken into account.
+     */
+    int recordCount(const IndexRecord* record) const
+    {
+        return record == truncatedRecord ? truncatedRecordCount : record->recordCount();
+    }
+
+    /**
+     * The same as Index::truncateTo(), but the mapped records are not modified: the media record
+     * count of the last partially written index record is kept in the view.
+     */
+    void truncateTo(qint64 mediaRecords);
+};
+
 struct NX_VMS_COMMON_API Filter
 {
     std::chrono::milliseconds startTime{ 0 };
@@ -91,12 +137,32 @@ class NX_VMS_COMMON_API RecordMatcher
 {
 public:
     RecordMatcher(const Filter* filter): m_filter(filter) {}
+    virtual ~RecordMatcher() = default;
 
     const Filter* filter() const { return m_filter; }
     virtual bool isWholeFrame() const = 0;
     virtual bool matchRecord(int64_t timestampMs, const uint8_t* data, int recordSize) const = 0;
     virtual bool isEmpty() const = 0;
 
+    /**
+     * Matches recordCount consecutive records at once. Used instead of matchRecord() for the
+     * records read from a metadata file if the matching does not depend on the record timestamp.
+     * @param result Receives 1 for every matching record and 0 for the others.
+     * @return False if batch matching is not supported, so matchRecord() must be used.
+     */
+    virtual bool matchRecords(
+        const uint8_t* /*data*/, int /*recordSize*/, int /*recordCount*/, uint8_t* /*result*/) const
+    {
+        return false;
+    }
+
+    /**
+     * Creates an independent copy of the matcher, so the files of the archive can be matched
+     * concurrently.
+     * @return nullptr if the matcher can not be copied, so the files are matched sequentially.
+     */
+    virtual std::unique_ptr<RecordMatcher> clone() const { return nullptr; }
+
     void setNoGeometryMode(bool value) { m_noGeometryMode = value; }
     bool isNoGeometryMode() const { return m_noGeometryMode; }
 private:
@@ -123,6 +189,15 @@ public:
     QString physicalId() const;
     QString getFilePrefix(const QDate& datetime) const;
 
+    /**
+     * Sets the thread pool to match the archive files concurrently. By default, the pool shared by
+     * all the archives of the process is used. If set to nullptr, the files are matched
+     * sequentially in the calling thread. The search must not be called from a thread of this
+     * pool.
+     */
+    void setSearchThreadPool(QThreadPool* threadPool);
+    QThreadPool* searchThreadPool() const;
+
     static constexpr quint32 kMinimalDurationMs = 125;
 protected:
     friend struct Index;
@@ -134,6 +209,10 @@ protected:
 
     static void onDiscontinueInMatchedResult(QnTimePeriodList* result, bool descendingOrder, const Filter* filter);
 
+    /**
+     * @param interruptionCallback Is called concurrently from the search threads if the search
+     *     thread pool is set.
+     */
     QnTimePeriodList matchPeriodInternal(
         RecordMatcher* recordMatcher,
         std::function<bool()> interruptionCallback = nullptr,
@@ -162,46 +241,81 @@ protected:
     }
 
 private:
+    class ScanLock;
+    class DataReader;
 
     using AddRecordFunc = std::function<bool(const Filter*, qint64, qint32, QnTimePeriodList&)>;
 
+    /** Time range of a search inside one archive file. */
+    struct FileRange
+    {
+        qint64 startTimeMs = 0;
+        qint64 endTimeMs = 0;
+    };
+
+    /**
+     * Matches the records of one archive file. The periods are added to the result in the filter
+     * sort order, or unordered if the file has a discontinuity.
+     * @return Whether the file has a discontinuity.
+     */
+    bool matchFile(
+        RecordMatcher* recordMatcher,
+        const FileRange& range,
+        std::function<bool()> interruptionCallback,
+        QnTimePeriodList* result);
+
+    QnTimePeriodList matchFilesSequentially(
+        RecordMatcher* recordMatcher,
+        const std::vector<FileRange>& ranges,
+        std::function<bool()> interruptionCallback,
+        FixDiscontinue fixDiscontinue);
+
+    QnTimePeriodList matchFilesConcurrently(
+        const RecordMatcher& recordMatcher,
+        const std::vector<FileRange>& ranges,
+        std::function<bool()> interruptionCallback,
+        FixDiscontinue fixDiscontinue);
+
     void loadDataFromIndex(
         AddRecordFunc addRecordFunc,
         RecordMatcher* recordMatcher,
         std::function<bool()> interruptionCallback,
-        QFile& motionFile,
-        const Index& index,
-        QVector<IndexRecord>::iterator startItr,
-        const QVector<IndexRecord>::iterator endItr,
+        DataReader& dataReader,
+        const IndexView& index,
+        const IndexRecord* startItr,
+        const IndexRecord* endItr,
         QnTimePeriodList& rez) const;
     void loadDataFromIndex(
         AddRecordFunc addRecordFunc,
         const Filter* filter,
         std::function<bool()> interruptionCallback,
-        const Index& index,
-        QVector<IndexRecord>::iterator startItr,
-        const QVector<IndexRecord>::iterator endItr,
+        ScanLock& scanLock,
+        const IndexView& index,
+        const IndexRecord* startItr,
+        const IndexRecord* endItr,
         QnTimePeriodList& rez) const;
 
     void loadDataFromIndexDesc(
         AddRecordFunc addRecordFunc,
         RecordMatcher* recordMatcher,
         std::function<bool()> interruptionCallback,
-        QFile& motionFile,
-        const Index& index,
-        QVector<IndexRecord>::iterator startItr,
-        const QVector<IndexRecord>::iterator endItr,
+        DataReader& dataReader,
+        const IndexView& index,
+        const IndexRecord* startItr,
+        const IndexRecord* endItr,
         QnTimePeriodList& rez) const;
     void loadDataFromIndexDesc(
         AddRecordFunc addRecordFunc,
         const Filter* filter,
         std::function<bool()> interruptionCallback,
-        const Index& index,
-        QVector<IndexRecord>::iterator startItr,
-        const QVector<IndexRecord>::iterator endItr,
+        ScanLock& scanLock,
+        const IndexView& index,
+        const IndexRecord* startItr,
+        const IndexRecord* endItr,
         QnTimePeriodList& rez) const;
 
     bool openFiles(qint64 timestampMs);
+    bool resizeFile(QFile* file, qint64 size);
 private:
     QString m_filePrefix;
     int m_recordSize = 0;
@@ -220,6 +334,18 @@ private:
 
     Index m_index;
 
+    /** Mapped index and data files shared by concurrent searches. */
+    MappedFileCache m_mappedFiles;
+    /**
+     * Protects the mapped files from being truncated by the writer: accessing a truncated part of
+     * a mapping crashes the process. The searches release it periodically, see ScanLock.
+     */
+    nx::ReadWriteLock m_truncationLock;
+    /** Number of the file truncations. Protected by m_truncationLock. */
+    int m_truncationCount = 0;
+
+    QThreadPool* m_searchThreadPool = nullptr;
+
 protected:
     const QString m_dataDir;
     const QString m_physicalId;
@@ -23,6 +23,11 @@ MotionRecordMatcher::MotionRecordMatcher(const MotionFilter* filter):
         QnMetaDataV1::createMask(filter->region, (char*) m_mask, &m_maskStart, &m_maskEnd);
 }
 
+std::unique_ptr<RecordMatcher> MotionRecordMatcher::clone() const
+{
+    return std::make_unique<MotionRecordMatcher>(*this);
+}
+
 const MotionFilter* MotionRecordMatcher::filter() const
 {
     return static_cast<const MotionFilter*>(base_type::filter());
@@ -36,5 +41,16 @@ bool MotionRecordMatcher::matchRecord(
     return QnMetaDataV1::matchImage((quint64*)data, m_mask, m_maskStart, m_maskEnd);
 }
 
+bool MotionRecordMatcher::matchRecords(
+    const uint8_t* data, int recordSize, int recordCount, uint8_t* result) const
+{
+    if (m_wholeFrame)
+        memset(result, 1, recordCount);
+    else
+        QnMetaDataV1::matchImages(
+            data, recordCount, recordSize, m_mask, m_maskStart, m_maskEnd, result);
+    return true;
+}
+
 
 } // namespace nx::vms::metadata
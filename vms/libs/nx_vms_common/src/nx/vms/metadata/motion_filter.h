@@ -24,6 +24,9 @@ public:
     MotionRecordMatcher(const MotionFilter* filter);
 
     virtual bool matchRecord(int64_t timestampMs, const uint8_t* data, int recordSize) const override;
+    virtual bool matchRecords(
+        const uint8_t* data, int recordSize, int recordCount, uint8_t* result) const override;
+    virtual std::unique_ptr<RecordMatcher> clone() const override;
     const MotionFilter* filter() const;
 
     virtual bool isWholeFrame() const override { return m_wholeFrame; }
@@ -14,8 +14,10 @@
 #include <nx/media/media_data_packet.h>
 #include <nx/streaming/abstract_media_stream_data_provider.h>
 #include <nx/streaming/archive_stream_reader.h>
+#include <nx/utils/byte_array_pool.h>
 #include <nx/utils/log/log.h>
 #include <nx/vms/common/system_settings.h>
+#include <nx/vms/crypt/media_cipher.h>
 #include <utils/common/util.h>
 
 namespace {
@@ -496,6 +498,48 @@ QnConstAbstractMediaDataPtr QnStreamRecorder::encryptDataIfNeed(const QnConstAbs
     return data;
 }
 
+QnConstAbstractMediaDataPtr QnStreamRecorder::encryptData(
+    const QnConstAbstractMediaDataPtr& data,
+    nx::vms::crypt::MediaCipher* cipher,
+    uint64_t nonce)
+{
+    if (!NX_ASSERT(cipher && cipher->isValid()))
+        return nullptr;
+
+    // The audio and video packets are created without their data, so it is not copied before
+    // being encrypted. Other packets are rare, so their data is copied by clone() and replaced.
+    QnAbstractMediaDataPtr result;
+    if (const auto video = dynamic_cast<const QnCompressedVideoData*>(data.get()))
+    {
+        auto encrypted = std::make_shared<QnWritableCompressedVideoData>();
+        encrypted->QnCompressedVideoData::assign(video);
+        result = std::move(encrypted);
+    }
+    else if (const auto audio = dynamic_cast<const QnCompressedAudioData*>(data.get()))
+    {
+        auto encrypted = std::make_shared<QnWritableCompressedAudioData>();
+        encrypted->QnCompressedAudioData::assign(audio);
+        result = std::move(encrypted);
+    }
+    else
+    {
+        result.reset(data->clone());
+    }
+
+    const size_t size = data->dataSize();
+    nx::utils::ByteArray buffer(CL_MEDIA_ALIGNMENT, size, AV_INPUT_BUFFER_PADDING_SIZE,
+        nx::utils::ByteArrayPool::instance());
+    buffer.resize(size);
+    if (!cipher->encrypt(nonce, (const uint8_t*) data->data(), (uint8_t*) buffer.data(), size))
+    {
+        NX_DEBUG(this, "Failed to encrypt a packet with timestamp %1", data->timestamp);
+        return nullptr;
+    }
+
+    result->setData(std::move(buffer));
+    return result;
+}
+
 AudioLayoutConstPtr QnStreamRecorder::getAudioLayout()
 {
     return m_audioLayout;
@@ -25,6 +25,7 @@
 #include <utils/color_space/image_correction.h>
 
 namespace nx::common::metadata { struct QnCompressedObjectMetadataPacket; }
+namespace nx::vms::crypt { class MediaCipher; }
 
 class NX_VMS_COMMON_API QnStreamRecorder:
     public QnAbstractDataConsumer,
@@ -92,6 +93,17 @@ protected:
     virtual void adjustMetaData(QnAviArchiveMetadata& metaData) const = 0;
     virtual std::vector<uint8_t> prepareEncryptor(quint64 /*nonce*/) { return std::vector<uint8_t>(); }
     virtual QnConstAbstractMediaDataPtr encryptDataIfNeed(const QnConstAbstractMediaDataPtr& data);
+
+    /**
+     * Helper for encryptDataIfNeed() implementations. Encrypts the packet data with the cipher of
+     * the stream directly to the buffer of the new packet, allocated from the media buffer pool.
+     * @return Null on an encryption error.
+     */
+    QnConstAbstractMediaDataPtr encryptData(
+        const QnConstAbstractMediaDataPtr& data,
+        nx::vms::crypt::MediaCipher* cipher,
+        uint64_t nonce);
+
     virtual void setLastError(nx::recording::Error::Code code) = 0;
 
 private:
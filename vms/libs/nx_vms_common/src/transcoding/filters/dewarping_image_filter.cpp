@@ -2,10 +2,14 @@
 
 #include "dewarping_image_filter.h"
 
+#include <algorithm>
+
+#include <QtCore/QThreadPool>
 #include <QtCore/QtMath>
 
 #include <nx/media/config.h>
 #include <nx/media/sse_helper.h>
+#include <nx/utils/concurrent.h>
 #include <nx/utils/math/math.h>
 #include <utils/media/frame_info.h>
 
@@ -15,6 +19,16 @@ namespace {
 
 static constexpr auto k360VRAspectRatio = 16.0 / 9.0;
 
+/** Bands are not made smaller, so that the threading overhead stays low. */
+static constexpr int kMinRowsPerBand = 32;
+
+struct RowBand
+{
+    int plane = 0;
+    int firstRow = 0;
+    int rowCount = 0;
+};
+
 QVector3D operator*(const QMatrix3x3& m, const QVector3D& v)
 {
     return QVector3D(
@@ -153,11 +167,183 @@ quint8 QnDewarpingImageFilter::getPixel(quint8* buffer, int stride, float x, flo
 }
 #endif
 
+namespace {
+
+/**
+ * Bilinear interpolation in fixed point. Interpolating the rows first and then the columns gives
+ * exactly the same value as the sum of four pixels with 2D weights, so the SIMD kernel below can
+ * use 16-bit arithmetic for the first step and still produce the same result.
+ */
+inline quint8 interpolate(
+    const quint8* topLeft, int stride, int xFraction, int yFraction, int fractionBits)
+{
+    const int one = 1 << fractionBits;
+    const int top = topLeft[0] * (one - xFraction) + topLeft[1] * xFraction;
+    const int bottom = topLeft[stride] * (one - xFraction) + topLeft[stride + 1] * xFraction;
+    return quint8((top * (one - yFraction) + bottom * yFraction) >> (2 * fractionBits));
+}
+
+#if defined(NX_SSE2_SUPPORTED)
+
+/**
+ * Multiplies 16-bit unsigned lanes, that must not overflow 32 bits in total, and adds the
+ * products of the lanes of the second pair.
+ */
+inline void mulAdd32(
+    __m128i a, __m128i b, __m128i c, __m128i d, __m128i* resultLow, __m128i* resultHigh)
+{
+    const __m128i abLow = _mm_mullo_epi16(a, b);
+    const __m128i abHigh = _mm_mulhi_epu16(a, b);
+    const __m128i cdLow = _mm_mullo_epi16(c, d);
+    const __m128i cdHigh = _mm_mulhi_epu16(c, d);
+
+    *resultLow = _mm_add_epi32(
+        _mm_unpacklo_epi16(abLow, abHigh), _mm_unpacklo_epi16(cdLow, cdHigh));
+    *resultHigh = _mm_add_epi32(
+        _mm_unpackhi_epi16(abLow, abHigh), _mm_unpackhi_epi16(cdLow, cdHigh));
+}
+
+/** Interpolates 8 pixels. All values are 16-bit lanes. */
+inline __m128i interpolate8(
+    __m128i topLeft, __m128i topRight, __m128i bottomLeft, __m128i bottomRight,
+    __m128i xFraction, __m128i yFraction, int fractionBits)
+{
+    const __m128i one = _mm_set1_epi16(short(1 << fractionBits));
+    const __m128i xWeight = _mm_sub_epi16(one, xFraction);
+    const __m128i yWeight = _mm_sub_epi16(one, yFraction);
+
+    // Pixel * weight fits 16 bits, as well as the sum of the two, since the weights add up to one.
+    const __m128i top = _mm_add_epi16(
+        _mm_mullo_epi16(topLeft, xWeight), _mm_mullo_epi16(topRight, xFraction));
+    const __m128i bottom = _mm_add_epi16(
+        _mm_mullo_epi16(bottomLeft, xWeight), _mm_mullo_epi16(bottomRight, xFraction));
+
+    __m128i low, high;
+    mulAdd32(top, yWeight, bottom, yFraction, &low, &high);
+
+    low = _mm_srli_epi32(low, 2 * fractionBits);
+    high = _mm_srli_epi32(high, 2 * fractionBits);
+    return _mm_packs_epi32(low, high);
+}
+
+#endif // defined(NX_SSE2_SUPPORTED)
+
+} // namespace
+
+QnDewarpingImageFilter::RemapTable QnDewarpingImageFilter::createRemapTable(const QSize& size)
+{
+    const size_t pixelCount = size_t(size.width()) * size.height();
+
+    RemapTable table;
+    table.size = size;
+    table.x.resize(pixelCount);
+    table.y.resize(pixelCount);
+    table.xFraction.resize(pixelCount);
+    table.yFraction.resize(pixelCount);
+    return table;
+}
+
+void QnDewarpingImageFilter::setSourcePoint(RemapTable* table, int index, const QPointF& point)
+{
+    const auto toFixedPoint =
+        [](qreal coordinate, int planeSize, qint16* integer, qint16* fraction)
+        {
+            const int value = qRound(coordinate * kFractionOne);
+            int pixel = value >> kFractionBits;
+            int pixelFraction = value & (kFractionOne - 1);
+
+            // The last row or column is reached from the previous one with the full weight.
+            const int maxPixel = std::max(0, planeSize - 2);
+            if (pixel > maxPixel)
+            {
+                pixelFraction = std::min(
+                    kFractionOne, pixelFraction + (pixel - maxPixel) * kFractionOne);
+                pixel = maxPixel;
+            }
+
+            *integer = qint16(pixel);
+            *fraction = qint16(pixelFraction);
+        };
+
+    toFixedPoint(point.x(), table->size.width(), &table->x[index], &table->xFraction[index]);
+    toFixedPoint(point.y(), table->size.height(), &table->y[index], &table->yFraction[index]);
+}
+
+void QnDewarpingImageFilter::remap(
+    const RemapTable& table,
+    const quint8* src,
+    int srcStride,
+    quint8* dst,
+    int dstStride,
+    int firstRow,
+    int rowCount,
+    bool useSimd)
+{
+    const int width = table.size.width();
+
+    for (int y = firstRow; y < firstRow + rowCount; ++y)
+    {
+        quint8* dstLine = dst + y * dstStride;
+        const int lineIndex = y * width;
+        const qint16* xLine = table.x.data() + lineIndex;
+        const qint16* yLine = table.y.data() + lineIndex;
+        const qint16* xFractionLine = table.xFraction.data() + lineIndex;
+        const qint16* yFractionLine = table.yFraction.data() + lineIndex;
+
+        int x = 0;
+
+        #if defined(NX_SSE2_SUPPORTED)
+            if (useSimd)
+            {
+                // There is no gather in SSE2, so the pixels are loaded one by one, and the
+                // arithmetic is done for 8 pixels at once.
+                alignas(16) qint16 pixels[4][8];
+                for (; x + 8 <= width; x += 8)
+                {
+                    for (int i = 0; i < 8; ++i)
+                    {
+                        const quint8* topLeft =
+                            src + yLine[x + i] * srcStride + xLine[x + i];
+                        pixels[0][i] = topLeft[0];
+                        pixels[1][i] = topLeft[1];
+                        pixels[2][i] = topLeft[srcStride];
+                        pixels[3][i] = topLeft[srcStride + 1];
+                    }
+
+                    const __m128i result = interpolate8(
+                        _mm_load_si128((const __m128i*) pixels[0]),
+                        _mm_load_si128((const __m128i*) pixels[1]),
+                        _mm_load_si128((const __m128i*) pixels[2]),
+                        _mm_load_si128((const __m128i*) pixels[3]),
+                        _mm_loadu_si128((const __m128i*) (xFractionLine + x)),
+                        _mm_loadu_si128((const __m128i*) (yFractionLine + x)),
+                        kFractionBits);
+
+                    _mm_storel_epi64((__m128i*) (dstLine + x), _mm_packus_epi16(result, result));
+                }
+            }
+        #else
+            Q_UNUSED(useSimd);
+        #endif
+
+        for (; x < width; ++x)
+        {
+            dstLine[x] = interpolate(
+                src + yLine[x] * srcStride + xLine[x],
+                srcStride,
+                xFractionLine[x],
+                yFractionLine[x],
+                kFractionBits);
+        }
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 // QnDewarpingImageFilter
 
 QnDewarpingImageFilter::QnDewarpingImageFilter():
-    QnAbstractImageFilter()
+    QnAbstractImageFilter(),
+    m_threadPool(QThreadPool::globalInstance())
 {
 }
 
@@ -179,6 +365,11 @@ void QnDewarpingImageFilter::setParameters(
     m_lastImageFormat = -1;
 }
 
+void QnDewarpingImageFilter::setThreadPool(QThreadPool* threadPool)
+{
+    m_threadPool = threadPool;
+}
+
 CLVideoDecoderOutputPtr QnDewarpingImageFilter::updateImage(const CLVideoDecoderOutputPtr& srcFrame)
 {
     if (!m_itemParams.enabled || !m_mediaParams.enabled)
@@ -224,29 +415,46 @@ CLVideoDecoderOutputPtr QnDewarpingImageFilter::updateImage(const CLVideoDecoder
     CLVideoDecoderOutputPtr outputFrame(new CLVideoDecoderOutput);
     outputFrame->copyFrom(frame.get());
 
+    std::vector<RowBand> bands;
+    const int maxBandsPerPlane = m_threadPool ? std::max(1, m_threadPool->maxThreadCount() + 1) : 1;
     for (int plane = 0; plane < descr->nb_components && outputFrame->data[plane]; ++plane)
     {
-        int index = 0;
-        int w = imageSize.width();
-        int h = imageSize.height();
-        if (plane > 0) {
-            w >>= descr->log2_chroma_w;
-            h >>= descr->log2_chroma_h;
+        const int h = m_remapTables[plane].size.height();
+        const int bandCount = std::clamp(h / kMinRowsPerBand, 1, maxBandsPerPlane);
+        for (int i = 0; i < bandCount; ++i)
+        {
+            const int firstRow = h * i / bandCount;
+            bands.push_back({plane, firstRow, h * (i + 1) / bandCount - firstRow});
         }
+    }
 
-        for (int y = 0; y < h; ++y)
+    const auto remapBand =
+        [this, &frame, &outputFrame](const RowBand& band)
         {
-            quint8* dstLine = outputFrame->data[plane] + y * outputFrame->linesize[plane];
-            for (int x = 0; x < w; ++x)
-            {
-                const QPointF* dstPixel = m_transform[plane].data() + index;
-                quint8 pixel = getPixel(frame->data[plane],
-                    frame->linesize[plane], dstPixel->x(), dstPixel->y(), w, h);
-                dstLine[x] = pixel;
-                index++;
-            }
-        }
+            remap(
+                m_remapTables[band.plane],
+                frame->data[band.plane],
+                frame->linesize[band.plane],
+                outputFrame->data[band.plane],
+                outputFrame->linesize[band.plane],
+                band.firstRow,
+                band.rowCount);
+        };
+
+    if (!m_threadPool || bands.size() < 2)
+    {
+        for (const auto& band: bands)
+            remapBand(band);
+        return outputFrame;
     }
+
+    // The calling thread takes the first band, so the frame is finished even if all threads of
+    // the pool are busy with something else.
+    std::vector<RowBand> pooledBands(bands.begin() + 1, bands.end());
+    auto future = nx::utils::concurrent::mapped(m_threadPool, pooledBands, remapBand);
+    remapBand(bands.front());
+    future.waitForFinished();
+
     return outputFrame;
 }
 
@@ -398,16 +606,14 @@ void QnDewarpingImageFilter::updateTransformMap(
 {
     updateDewarpingParameters(aspectRatio);
 
-    m_transform[plane] = PointsVector(imageSize.width() * imageSize.height());
-    auto dstIt = m_transform[plane].begin();
+    auto& table = m_remapTables[plane];
+    table = createRemapTable(imageSize);
 
+    int index = 0;
     for (int y = 0; y < imageSize.height(); ++y)
     {
         for (int x = 0; x < imageSize.width(); ++x)
-        {
-            *dstIt = transformed(x, y, imageSize);
-            ++dstIt;
-        }
+            setSourcePoint(&table, index++, transformed(x, y, imageSize));
     }
 }
 
@@ -2,8 +2,9 @@
 
 #pragma once
 
+#include <vector>
+
 #include <QtCore/QScopedPointer>
-#include <QtCore/QVector>
 #include <QtGui/QMatrix3x3>
 #include <QtGui/QMatrix4x4>
 #include <QtGui/QVector2D>
@@ -14,6 +15,8 @@
 
 #include "abstract_image_filter.h"
 
+class QThreadPool;
+
 class NX_VMS_COMMON_API QnDewarpingImageFilter: public QnAbstractImageFilter
 {
 public:
@@ -30,6 +33,12 @@ public:
         const nx::vms::api::dewarping::MediaData& mediaDewarping,
         const nx::vms::api::dewarping::ViewData& itemDewarping);
 
+    /**
+     * Row bands of the dewarped planes are filled in the given pool, while the calling thread
+     * fills one of them itself. The global pool is used by default; nullptr disables threading.
+     */
+    void setThreadPool(QThreadPool* threadPool);
+
     static quint8 getPixel(quint8* buffer, int stride, float x, float y, int width, int height);
 
 protected: //< For unit tests.
@@ -58,11 +67,45 @@ private:
     QSize m_lastImageSize;
 
     int m_lastImageFormat = -1;
+    QThreadPool* m_threadPool = nullptr;
 
 protected: //< For unit tests.
+    static constexpr int kFractionBits = 8;
+    static constexpr int kFractionOne = 1 << kFractionBits;
+
+    /**
+     * Source position of each pixel of a dewarped plane in fixed point: the top left pixel of the
+     * bilinear filtering square and the distances to it in 1/kFractionOne of a pixel, from 0 to
+     * kFractionOne inclusive. The square is always inside the plane, so its right and bottom
+     * pixels can be read without checks.
+     */
+    struct RemapTable
+    {
+        QSize size;
+        std::vector<qint16> x;
+        std::vector<qint16> y;
+        std::vector<qint16> xFraction;
+        std::vector<qint16> yFraction;
+    };
+
+    static RemapTable createRemapTable(const QSize& size);
+
+    /** Point coordinates must be within the plane, like the ones returned by transformed(). */
+    static void setSourcePoint(RemapTable* table, int index, const QPointF& point);
+
+    /** Fills the rows [firstRow, firstRow + rowCount) of the destination plane. */
+    static void remap(
+        const RemapTable& table,
+        const quint8* src,
+        int srcStride,
+        quint8* dst,
+        int dstStride,
+        int firstRow,
+        int rowCount,
+        bool useSimd = true);
+
     nx::vms::api::dewarping::MediaData m_mediaParams;
     nx::vms::api::dewarping::ViewData m_itemParams;
 
-    using PointsVector = QVector<QPointF>;
-    PointsVector m_transform[MAX_COLOR_PLANES];
+    RemapTable m_remapTables[MAX_COLOR_PLANES];
 };
@@ -228,7 +228,26 @@ TEST_F(PermissionsCacheTest, removingUserResourceCausesRemovingCorrespondingSubj
 
 TEST_F(PermissionsCacheTest, sparseColumnsTest)
 {
-    // TODO: #vbreus Make full test coverage.
+    PermissionsCache cache;
+
+    const auto subjectId = QnUuid::createUuid();
+    const auto removedResourceId = QnUuid::createUuid();
+    const auto resourceId = QnUuid::createUuid();
+
+    const Permissions permissions = ReadWriteSavePermission;
+
+    cache.setPermissions(subjectId, removedResourceId, ReadPermission);
+    cache.removeResource(removedResourceId);
+    ASSERT_FALSE(bool(cache.permissions(subjectId, removedResourceId)));
+
+    // The column of the removed resource is reused and must be found by the new resource id.
+    ASSERT_TRUE(cache.setPermissions(subjectId, resourceId, permissions));
+    ASSERT_FALSE(cache.setPermissions(subjectId, resourceId, permissions));
+    ASSERT_EQ(cache.permissions(subjectId, resourceId), permissions);
+    ASSERT_FALSE(bool(cache.permissions(subjectId, removedResourceId)));
+    ASSERT_EQ(cache.permissionsForSubject(subjectId).size(), 1);
+
+    ASSERT_TRUE(cache.removePermissions(subjectId, resourceId));
 }
 
 } // namespace test
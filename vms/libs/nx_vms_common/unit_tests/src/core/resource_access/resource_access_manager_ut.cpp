@@ -1,5 +1,7 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <chrono>
+
 #include <gtest/gtest.h>
 
 #include <core/resource/layout_resource.h>
@@ -1759,4 +1761,133 @@ TEST_F(ResourceAccessManagerTest, accessRightsIndependency)
     EXPECT_TRUE(hasPermissions(m_currentUser, camera, Qn::ExportPermission));
 }
 
+// ------------------------------------------------------------------------------------------------
+// Access rights change propagation
+
+TEST_F(ResourceAccessManagerTest, notificationsAreCoalescedDuringUpdate)
+{
+    const auto group = createUserGroup(NoGroup);
+    const auto user = addUser(group.id);
+    const auto camera = addCamera();
+
+    const auto notifier = resourceAccessManager()->createNotifier();
+    notifier->setSubjectId(user->getId());
+    int notificationCount = 0;
+    QObject::connect(notifier, &QnResourceAccessManager::Notifier::resourceAccessChanged,
+        [&notificationCount]() { ++notificationCount; });
+
+    setOwnAccessRights(group.id, {{camera->getId(), AccessRight::view}});
+    ASSERT_EQ(notificationCount, 1);
+
+    resourceAccessManager()->beginUpdate();
+    setOwnAccessRights(group.id, {{camera->getId(), AccessRight::view | AccessRight::edit}});
+    setOwnAccessRights(user->getId(), {{camera->getId(), AccessRight::viewArchive}});
+    ASSERT_EQ(notificationCount, 1);
+
+    // Access rights are recalculated even before the update ends.
+    ASSERT_EQ(resourceAccessManager()->accessRights(user, camera),
+        AccessRight::view | AccessRight::edit | AccessRight::viewArchive);
+
+    resourceAccessManager()->endUpdate();
+    ASSERT_EQ(notificationCount, 2);
+
+    delete notifier;
+}
+
+TEST_F(ResourceAccessManagerTest, groupChangeInvalidatesOnlyInheritingUsers)
+{
+    const auto camera = addCamera();
+    const auto rootGroup = createUserGroup(NoGroup);
+    auto childGroup = createUserGroup(rootGroup.id);
+    const auto siblingGroup = createUserGroup(NoGroup);
+    const auto childUser = addUser(childGroup.id);
+    const auto siblingUser = addUser(siblingGroup.id);
+
+    setOwnAccessRights(siblingGroup.id, {{camera->getId(), AccessRight::view}});
+    ASSERT_EQ(resourceAccessManager()->accessRights(childUser, camera), AccessRights());
+    ASSERT_EQ(resourceAccessManager()->accessRights(siblingUser, camera), AccessRight::view);
+
+    // Own rights of a group are inherited by the users of its child groups only.
+    setOwnAccessRights(rootGroup.id, {{camera->getId(), AccessRight::viewArchive}});
+    ASSERT_EQ(resourceAccessManager()->accessRights(childUser, camera), AccessRight::viewArchive);
+    ASSERT_EQ(resourceAccessManager()->accessRights(siblingUser, camera), AccessRight::view);
+
+    // Detaching the group from its parent drops the inherited rights.
+    childGroup.parentGroupIds = {};
+    addOrUpdateUserGroup(childGroup);
+    ASSERT_EQ(resourceAccessManager()->accessRights(childUser, camera), AccessRights());
+
+    childGroup.parentGroupIds = {rootGroup.id};
+    addOrUpdateUserGroup(childGroup);
+    ASSERT_EQ(resourceAccessManager()->accessRights(childUser, camera), AccessRight::viewArchive);
+}
+
+TEST_F(ResourceAccessManagerTest, DISABLED_groupChangePerformance)
+{
+    static constexpr int kGroupCount = 100;
+    static constexpr int kUsersPerGroup = 50;
+    static constexpr int kChangeCount = 100;
+
+    const auto camera = addCamera();
+    const auto rootGroup = createUserGroup(NoGroup);
+    std::vector<UserGroupData> groups;
+    std::vector<QnUserResourcePtr> users;
+    for (int i = 0; i < kGroupCount; ++i)
+    {
+        groups.push_back(createUserGroup(rootGroup.id));
+        setOwnAccessRights(groups.back().id, {{camera->getId(), AccessRight::view}});
+        for (int j = 0; j < kUsersPerGroup; ++j)
+            users.push_back(addUser(groups.back().id));
+    }
+
+    const auto resolveAll =
+        [&]()
+        {
+            for (const auto& user: users)
+            {
+                ASSERT_TRUE(
+                    resourceAccessManager()->hasAccessRights(user, camera, AccessRight::view));
+            }
+        };
+
+    using namespace std::chrono;
+    resolveAll();
+
+    // Each change affects the users of one group only.
+    auto time = steady_clock::now();
+    for (int i = 0; i < kChangeCount; ++i)
+    {
+        const auto& group = groups[i % kGroupCount];
+        setOwnAccessRights(group.id, {{camera->getId(), AccessRight::view | AccessRight::edit}});
+        setOwnAccessRights(group.id, {{camera->getId(), AccessRight::view}});
+    }
+    NX_INFO(this, "Own access rights change of a group with %1 users among %2: %3 per change",
+        kUsersPerGroup, users.size(), duration_cast<microseconds>(
+            steady_clock::now() - time) / (kChangeCount * 2));
+    resolveAll();
+
+    time = steady_clock::now();
+    for (int i = 0; i < kChangeCount; ++i)
+    {
+        auto group = groups[i % kGroupCount];
+        group.parentGroupIds = {};
+        addOrUpdateUserGroup(group);
+        group.parentGroupIds = {rootGroup.id};
+        addOrUpdateUserGroup(group);
+    }
+    NX_INFO(this, "Parent change of a group with %1 users among %2: %3 per change",
+        kUsersPerGroup, users.size(), duration_cast<microseconds>(
+            steady_clock::now() - time) / (kChangeCount * 2));
+    resolveAll();
+
+    // A change of the root group affects all the users.
+    time = steady_clock::now();
+    setOwnAccessRights(rootGroup.id, {{camera->getId(), AccessRight::viewArchive}});
+    resolveAll();
+    NX_INFO(this, "Own access rights change of a group with %1 users, with the recalculation: %2",
+        users.size(), duration_cast<microseconds>(steady_clock::now() - time));
+    ASSERT_TRUE(resourceAccessManager()->hasAccessRights(
+        users.front(), camera, AccessRight::viewArchive));
+}
+
 } // namespace nx::vms::common::test
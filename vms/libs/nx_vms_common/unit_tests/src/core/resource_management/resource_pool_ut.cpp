@@ -1,11 +1,13 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <chrono>
 #include <thread>
 
 #include <gtest/gtest.h>
 
 #include <api/helpers/camera_id_helper.h>
 #include <core/resource/layout_resource.h>
+#include <core/resource/media_server_resource.h>
 #include <core/resource/videowall_resource.h>
 #include <core/resource_management/resource_pool.h>
 #include <nx/core/access/access_types.h>
@@ -182,4 +184,133 @@ TEST_F(QnResourcePoolTest, userByName)
     ASSERT_EQ(resourcePool()->userByName(kName).first, cloudUser);
 }
 
+TEST_F(QnResourcePoolTest, resourcesOfClassFollowPoolChanges)
+{
+    const auto cameras = addCameras(3);
+    const auto server = addServer();
+
+    ASSERT_EQ(3, resourcePool()->getResources<QnVirtualCameraResource>().size());
+    ASSERT_EQ(1, resourcePool()->servers().size());
+    ASSERT_EQ(4, resourcePool()->getResources().size());
+
+    const auto snapshot = resourcePool()->getResources<QnVirtualCameraResource>();
+    resourcePool()->removeResource(cameras[0]);
+    const auto camera = addCamera();
+
+    ASSERT_EQ(3, snapshot.size());
+    ASSERT_TRUE(snapshot.contains(cameras[0]));
+
+    const auto actual = resourcePool()->getResources<QnVirtualCameraResource>();
+    ASSERT_EQ(3, actual.size());
+    ASSERT_FALSE(actual.contains(cameras[0]));
+    ASSERT_TRUE(actual.contains(camera));
+    ASSERT_TRUE(resourcePool()->getResources<QnMediaServerResource>().contains(server));
+
+    // The class without an index.
+    const auto securityCameras = resourcePool()->getResources<QnSecurityCamResource>();
+    ASSERT_EQ(3, securityCameras.size());
+    ASSERT_FALSE(securityCameras.contains(cameras[0]));
+
+    ASSERT_TRUE(resourcePool()->contains<QnVirtualCameraResource>(
+        [&camera](const auto& resource) { return resource == camera; }));
+
+    resourcePool()->clear();
+    ASSERT_TRUE(resourcePool()->getResources<QnVirtualCameraResource>().empty());
+    ASSERT_TRUE(resourcePool()->getResources().empty());
+}
+
+TEST_F(QnResourcePoolTest, resourcesByParentIdFollowParentChanges)
+{
+    const auto server1 = addServer();
+    const auto server2 = addServer();
+    const auto cameras = addCameras(3);
+    for (const auto& camera: cameras)
+        camera->setParentId(server1->getId());
+
+    ASSERT_EQ(3, resourcePool()->getAllCameras(server1).size());
+    ASSERT_TRUE(resourcePool()->getAllCameras(server2).empty());
+
+    cameras[0]->setParentId(server2->getId());
+    ASSERT_EQ(2, resourcePool()->getResourcesByParentId(server1->getId()).size());
+    ASSERT_EQ(QnResourceList{cameras[0]}, resourcePool()->getResourcesByParentId(server2->getId()));
+
+    resourcePool()->removeResource(cameras[1]);
+    ASSERT_EQ(QnVirtualCameraResourceList{cameras[2]}, resourcePool()->getAllCameras(server1));
+
+    // The resource updated from a copy gets the parent of the copy.
+    QnVirtualCameraResourcePtr copy(new nx::CameraResourceStub());
+    copy->setIdUnsafe(cameras[2]->getId());
+    copy->setPhysicalId(cameras[2]->getPhysicalId());
+    copy->setParentId(server2->getId());
+    resourcePool()->addResource(copy);
+    ASSERT_TRUE(resourcePool()->getAllCameras(server1).empty());
+    ASSERT_EQ(2, resourcePool()->getAllCameras(server2).size());
+    ASSERT_EQ(2, resourcePool()->getAllCameras(QnUuid()).size());
+}
+
+TEST_F(QnResourcePoolTest, DISABLED_lookupPerformance)
+{
+    static constexpr int kServerCount = 100;
+    static constexpr int kRequestCount = 1000;
+
+    std::vector<QnMediaServerResourcePtr> servers;
+    for (int i = 0; i < kServerCount; ++i)
+        servers.push_back(addServer());
+
+    int cameraCount = 0;
+    for (const int targetCameraCount: {10'000, 50'000})
+    {
+        QnResourceList cameras;
+        for (; cameraCount < targetCameraCount; ++cameraCount)
+        {
+            auto camera = createCamera();
+            camera->setParentId(servers[cameraCount % kServerCount]->getId());
+            cameras.push_back(camera);
+        }
+        resourcePool()->addResources(cameras);
+
+        const auto measure =
+            [&](const QString& label, const auto& request)
+            {
+                using namespace std::chrono;
+                const auto time = steady_clock::now();
+                int resourceCount = 0;
+                for (int i = 0; i < kRequestCount; ++i)
+                    resourceCount += request(servers[i % kServerCount]->getId());
+                const auto duration = duration_cast<microseconds>(steady_clock::now() - time);
+                NX_INFO(this, "%1 on %2 cameras: %3 per request, %4 resources",
+                    label, cameraCount, duration / kRequestCount, resourceCount / kRequestCount);
+            };
+
+        measure("getAllCameras",
+            [this](const QnUuid&) { return resourcePool()->getAllCameras().size(); });
+        measure("getAllCameras by full scan",
+            [this](const QnUuid&)
+            {
+                return resourcePool()->getResources(
+                    [](const QnResourcePtr& resource)
+                    {
+                        return (bool) resource.dynamicCast<QnVirtualCameraResource>();
+                    }).size();
+            });
+        measure("getAllCameras by parent",
+            [this](const QnUuid& id) { return resourcePool()->getAllCameras(id).size(); });
+        measure("getResourcesByParentId",
+            [this](const QnUuid& id) { return resourcePool()->getResourcesByParentId(id).size(); });
+        measure("getResourcesByParentId by full scan",
+            [this](const QnUuid& id)
+            {
+                return resourcePool()->getResources(
+                    [&id](const QnResourcePtr& resource)
+                    {
+                        return resource->getParentId() == id;
+                    }).size();
+            });
+
+        ASSERT_EQ(cameraCount, resourcePool()->getAllCameras().size());
+        ASSERT_EQ(cameraCount / kServerCount,
+            resourcePool()->getResourcesByParentId(servers[0]->getId()).size());
+    }
+}
+
 } // namespace nx::vms::common::test
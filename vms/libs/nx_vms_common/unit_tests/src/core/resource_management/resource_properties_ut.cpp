@@ -0,0 +1,227 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <chrono>
+#include <map>
+
+#if defined(__GLIBC__)
+    #include <malloc.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <core/resource/camera_resource.h>
+#include <core/resource_management/resource_properties.h>
+#include <nx/utils/log/log.h>
+#include <nx/vms/common/system_context.h>
+#include <nx/vms/common/test_support/api/message_processor_mock.h>
+#include <nx/vms/common/test_support/test_context.h>
+
+namespace nx::vms::common::test {
+
+class QnResourcePropertyDictionaryTest: public ContextBasedTest
+{
+protected:
+    QnResourcePropertyDictionary* dictionary() const
+    {
+        return systemContext()->resourcePropertyDictionary();
+    }
+};
+
+TEST_F(QnResourcePropertyDictionaryTest, setValue)
+{
+    const auto id = QnUuid::createUuid();
+    ASSERT_FALSE(dictionary()->hasProperty(id, "name"));
+    ASSERT_TRUE(dictionary()->value(id, "name").isNull());
+
+    ASSERT_TRUE(dictionary()->setValue(id, "name", "value"));
+    ASSERT_FALSE(dictionary()->setValue(id, "name", "value"));
+    ASSERT_TRUE(dictionary()->hasProperty(id, "name"));
+    ASSERT_TRUE(dictionary()->hasProperty("name", "value"));
+    ASSERT_FALSE(dictionary()->hasProperty("name", "other value"));
+    ASSERT_EQ("value", dictionary()->value(id, "name"));
+    ASSERT_TRUE(dictionary()->value(QnUuid::createUuid(), "name").isNull());
+
+    ASSERT_TRUE(dictionary()->setValue(id, "name", "other value"));
+    ASSERT_EQ("other value", dictionary()->value(id, "name"));
+}
+
+TEST_F(QnResourcePropertyDictionaryTest, modifiedProperties)
+{
+    const auto id = QnUuid::createUuid();
+    dictionary()->setValue(id, "saved", "value", /*markDirty*/ false);
+    dictionary()->setValue(id, "modified", "value");
+
+    const QMap<QString, QString> expected{{"modified", "value"}};
+    ASSERT_EQ(expected, dictionary()->modifiedProperties(id));
+
+    // Setting the saved value resets the mark.
+    dictionary()->setValue(id, "modified", "saved value", /*markDirty*/ false);
+    ASSERT_TRUE(dictionary()->modifiedProperties(id).isEmpty());
+
+    dictionary()->markAllParamsDirty(id,
+        [](const QString& name, const QString&) { return name != "saved"; });
+    const QMap<QString, QString> expectedDirty{{"modified", "saved value"}};
+    ASSERT_EQ(expectedDirty, dictionary()->modifiedProperties(id));
+}
+
+TEST_F(QnResourcePropertyDictionaryTest, setValues)
+{
+    const auto firstId = QnUuid::createUuid();
+    const auto secondId = QnUuid::createUuid();
+    dictionary()->setValue(firstId, "a", "1");
+
+    int changedCount = 0;
+    QObject::connect(dictionary(), &QnResourcePropertyDictionary::propertyChanged,
+        [&changedCount](const QnUuid&, const QString&) { ++changedCount; });
+
+    nx::vms::api::ResourceParamWithRefDataList params;
+    params.emplace_back(firstId, "a", "1");
+    params.emplace_back(firstId, "b", "2");
+    params.emplace_back(secondId, "b", "3");
+    params.emplace_back(secondId, "a", "4");
+    ASSERT_EQ(3, dictionary()->setValues(params, /*markDirty*/ false));
+    ASSERT_EQ(3, changedCount);
+    ASSERT_TRUE(dictionary()->modifiedProperties(secondId).isEmpty());
+
+    ASSERT_EQ("2", dictionary()->value(firstId, "b"));
+    ASSERT_EQ("4", dictionary()->value(secondId, "a"));
+
+    // Properties are sorted by name like they were in the map-based implementation.
+    const auto properties = dictionary()->allProperties(secondId);
+    ASSERT_EQ(2, properties.size());
+    ASSERT_EQ("a", properties[0].name);
+    ASSERT_EQ("b", properties[1].name);
+
+    const auto names = dictionary()->allPropertyNamesByResource();
+    ASSERT_EQ(2, names.size());
+    ASSERT_EQ(QSet<QString>({"a", "b"}), names.value(firstId));
+    ASSERT_EQ(4, dictionary()->allProperties().size());
+}
+
+TEST_F(QnResourcePropertyDictionaryTest, removeAndClear)
+{
+    const auto firstId = QnUuid::createUuid();
+    const auto secondId = QnUuid::createUuid();
+    dictionary()->setValue(firstId, "name", "value");
+    dictionary()->setValue(secondId, "name", "value");
+
+    ASSERT_TRUE(dictionary()->on_resourceParamRemoved(firstId, "name"));
+    ASSERT_FALSE(dictionary()->on_resourceParamRemoved(firstId, "unknown name"));
+    ASSERT_FALSE(dictionary()->hasProperty(firstId, "name"));
+    ASSERT_TRUE(dictionary()->hasProperty(secondId, "name"));
+
+    dictionary()->clear({secondId});
+    ASSERT_FALSE(dictionary()->hasProperty(secondId, "name"));
+    ASSERT_TRUE(dictionary()->modifiedProperties(secondId).isEmpty());
+
+    dictionary()->setValue(firstId, "name", "value");
+    dictionary()->clear();
+    ASSERT_TRUE(dictionary()->allProperties().empty());
+}
+
+namespace {
+
+class AnalyticsNotificationCounter: public MessageProcessorMock
+{
+public:
+    using MessageProcessorMock::MessageProcessorMock;
+
+    std::map<QString, int> handledNames;
+
+protected:
+    virtual bool handleRemoteAnalyticsNotification(
+        const nx::vms::api::ResourceParamWithRefData& param,
+        ec2::NotificationSource /*source*/) override
+    {
+        ++handledNames[param.name];
+        return param.name.startsWith("analytics");
+    }
+};
+
+} // namespace
+
+TEST_F(QnResourcePropertyDictionaryTest, resetPropertyListHandlesEachParamOnce)
+{
+    const auto processor = systemContext()->createMessageProcessor<AnalyticsNotificationCounter>();
+    const auto camera = addCamera();
+    const auto absentId = QnUuid::createUuid();
+
+    nx::vms::api::ResourceParamWithRefDataList params;
+    params.emplace_back(camera->getId(), "analyticsEngines", "[]");
+    params.emplace_back(camera->getId(), "name", "camera value");
+    params.emplace_back(absentId, "name", "dictionary value");
+    processor->resetPropertyList(params);
+
+    const std::map<QString, int> expected{{"analyticsEngines", 1}, {"name", 2}};
+    ASSERT_EQ(expected, processor->handledNames);
+
+    // The handled notification is not stored as a property.
+    ASSERT_FALSE(dictionary()->hasProperty(camera->getId(), "analyticsEngines"));
+    ASSERT_EQ("camera value", camera->getProperty("name"));
+    ASSERT_EQ("dictionary value", dictionary()->value(absentId, "name"));
+}
+
+namespace {
+
+size_t allocatedMemory()
+{
+    #if defined(__GLIBC__)
+        return mallinfo2().uordblks;
+    #else
+        return 0;
+    #endif
+}
+
+} // namespace
+
+TEST_F(QnResourcePropertyDictionaryTest, DISABLED_memoryAndPerformance)
+{
+    static constexpr int kCameraCount = 10'000;
+    static constexpr int kPropertyCount = 30;
+
+    // Values are shared with the params in both layouts, the names are copied for the map like
+    // they are when parsed from the transaction log one by one.
+    nx::vms::api::ResourceParamWithRefDataList params;
+    std::vector<QnUuid> ids;
+    for (int i = 0; i < kCameraCount; ++i)
+    {
+        ids.push_back(QnUuid::createUuid());
+        for (int j = 0; j < kPropertyCount; ++j)
+        {
+            params.emplace_back(ids.back(),
+                QString("cameraProperty%1").arg(j), QString::number(j % 3));
+        }
+    }
+
+    using namespace std::chrono;
+    size_t memory = allocatedMemory();
+    auto time = steady_clock::now();
+    {
+        // The layout of the previous implementation.
+        QMap<QnUuid, QMap<QString, QString>> items;
+        for (const auto& param: params)
+            items[param.resourceId][QString(param.name.data(), param.name.size())] = param.value;
+        NX_INFO(this, "Map of maps: %1 KB, loaded in %2",
+            (allocatedMemory() - memory) / 1024,
+            duration_cast<milliseconds>(steady_clock::now() - time));
+    }
+
+    memory = allocatedMemory();
+    time = steady_clock::now();
+    ASSERT_EQ(kCameraCount * kPropertyCount, dictionary()->setValues(params, /*markDirty*/ false));
+    NX_INFO(this, "Dictionary: %1 KB, loaded in %2",
+        (allocatedMemory() - memory) / 1024,
+        duration_cast<milliseconds>(steady_clock::now() - time));
+
+    static constexpr int kRequestCount = 1'000'000;
+    const QString name("cameraProperty7");
+    time = steady_clock::now();
+    int found = 0;
+    for (int i = 0; i < kRequestCount; ++i)
+        found += (int) dictionary()->hasProperty(ids[i % kCameraCount], name);
+    NX_INFO(this, "hasProperty: %1 per request",
+        duration_cast<nanoseconds>(steady_clock::now() - time) / kRequestCount);
+    ASSERT_EQ(kRequestCount, found);
+}
+
+} // namespace nx::vms::common::test
@@ -0,0 +1,63 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <gtest/gtest.h>
+
+#include <nx/vms/metadata/metadata_archive.h>
+
+namespace nx::vms::metadata::test {
+
+class IndexView: public ::testing::Test
+{
+protected:
+    virtual void SetUp() override
+    {
+        m_index.header.recordSize = 16;
+        for (int recordCount: {3, 2, 4})
+        {
+            IndexRecord record;
+            record.setRecordCount(recordCount);
+            m_index.records.push_back(record);
+        }
+    }
+
+    /**
+     * The view must see the same records as the index truncated the same way.
+     */
+    void assertTruncatedAsIndex(qint64 mediaRecords)
+    {
+        nx::vms::metadata::IndexView view(m_index);
+        view.truncateTo(mediaRecords);
+
+        Index index = m_index;
+        index.truncateTo(mediaRecords);
+
+        ASSERT_EQ(index.records.size(), view.end - view.begin);
+        for (int i = 0; i < index.records.size(); ++i)
+        {
+            ASSERT_EQ(index.records[i].recordCount(), view.recordCount(view.begin + i));
+            ASSERT_EQ(index.dataOffset(i, false), view.dataOffset(view.begin + i, false));
+        }
+    }
+
+    Index m_index{nullptr};
+};
+
+TEST_F(IndexView, partially_written_record_is_kept)
+{
+    assertTruncatedAsIndex(7);
+    assertTruncatedAsIndex(4);
+}
+
+TEST_F(IndexView, records_beyond_data_end_are_excluded)
+{
+    assertTruncatedAsIndex(5);
+    assertTruncatedAsIndex(0);
+}
+
+TEST_F(IndexView, complete_data_is_not_truncated)
+{
+    assertTruncatedAsIndex(9);
+    assertTruncatedAsIndex(100);
+}
+
+} // namespace nx::vms::metadata::test
@@ -0,0 +1,92 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <gtest/gtest.h>
+
+#include <QtCore/QFile>
+
+#include <nx/utils/test_support/test_with_temporary_directory.h>
+#include <nx/vms/metadata/mapped_file_cache.h>
+
+namespace nx::vms::metadata::test {
+
+class MappedFileCache:
+    public ::testing::Test,
+    public nx::utils::test::TestWithTemporaryDirectory
+{
+protected:
+    QString givenFile(const QString& name, const QByteArray& data)
+    {
+        const QString fileName = testDataDir() + "/" + name;
+        whenAppended(fileName, data);
+        return fileName;
+    }
+
+    void whenAppended(const QString& fileName, const QByteArray& data)
+    {
+        QFile file(fileName);
+        ASSERT_TRUE(file.open(QFile::WriteOnly | QFile::Append));
+        ASSERT_EQ(data.size(), file.write(data));
+    }
+
+    void assertContains(
+        const std::shared_ptr<const MappedFile>& file, const QByteArray& expected)
+    {
+        ASSERT_TRUE(file);
+        ASSERT_EQ(expected, QByteArray((const char*) file->data(), (int) file->size()));
+    }
+
+    nx::vms::metadata::MappedFileCache m_cache;
+};
+
+TEST_F(MappedFileCache, unchanged_file_is_mapped_once)
+{
+    const auto fileName = givenFile("file", "data");
+
+    const auto file = m_cache.get(fileName);
+    assertContains(file, "data");
+    ASSERT_EQ(file, m_cache.get(fileName));
+}
+
+TEST_F(MappedFileCache, appended_data_is_visible)
+{
+    const auto fileName = givenFile("file", "data");
+    const auto file = m_cache.get(fileName);
+
+    whenAppended(fileName, "more");
+
+    assertContains(m_cache.get(fileName), "datamore");
+    assertContains(file, "data"); //< The previous mapping is still valid.
+}
+
+TEST_F(MappedFileCache, unused_file_is_unmapped)
+{
+    const auto fileName1 = givenFile("file1", "data1");
+    const auto fileName2 = givenFile("file2", "data2");
+
+    const auto file1 = m_cache.get(fileName1);
+    const std::weak_ptr<const MappedFile> file2 = m_cache.get(fileName2);
+    ASSERT_TRUE(file2.expired());
+
+    ASSERT_EQ(file1, m_cache.get(fileName1));
+    assertContains(m_cache.get(fileName2), "data2");
+}
+
+TEST_F(MappedFileCache, removed_file_is_mapped_again)
+{
+    const auto fileName = givenFile("file", "data");
+    const auto file = m_cache.get(fileName);
+
+    m_cache.remove(fileName);
+
+    const auto newFile = m_cache.get(fileName);
+    assertContains(newFile, "data");
+    ASSERT_NE(file, newFile);
+}
+
+TEST_F(MappedFileCache, missing_and_empty_files_are_not_mapped)
+{
+    ASSERT_FALSE(m_cache.get(testDataDir() + "/missing"));
+    ASSERT_FALSE(m_cache.get(givenFile("empty", QByteArray())));
+}
+
+} // namespace nx::vms::metadata::test
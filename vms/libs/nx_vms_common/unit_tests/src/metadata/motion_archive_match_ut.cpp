@@ -0,0 +1,229 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <chrono>
+#include <iostream>
+
+#include <gtest/gtest.h>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QThreadPool>
+
+#include <nx/media/meta_data_packet.h>
+#include <nx/utils/random.h>
+#include <nx/utils/test_support/test_with_temporary_directory.h>
+#include <nx/vms/metadata/motion_filter.h>
+
+namespace nx::vms::metadata::test {
+
+namespace {
+
+class TestMotionArchive: public MetadataArchive
+{
+public:
+    TestMotionArchive(const QString& dataDir):
+        MetadataArchive(
+            "motion",
+            QnMetaDataV1::kMotionDataBufferSize,
+            /*wordSize*/ 1,
+            /*aggregationIntervalSeconds*/ 0,
+            dataDir,
+            "camera",
+            /*channel*/ 0)
+    {
+    }
+
+    using MetadataArchive::saveToArchiveInternal;
+    using MetadataArchive::setSearchThreadPool;
+    using MetadataArchive::matchPeriodInternal;
+};
+
+/** Matches every record separately, as it was done before batch matching. */
+class SingleRecordMotionMatcher: public MotionRecordMatcher
+{
+public:
+    using MotionRecordMatcher::MotionRecordMatcher;
+
+    virtual bool matchRecords(const uint8_t*, int, int, uint8_t*) const override
+    {
+        return false;
+    }
+};
+
+} // namespace
+
+class MotionArchiveMatching:
+    public ::testing::Test,
+    public nx::utils::test::TestWithTemporaryDirectory
+{
+protected:
+    static constexpr std::chrono::milliseconds kRecordInterval{5'000};
+    static constexpr std::chrono::milliseconds kRecordDuration{2'000};
+
+    MotionArchiveMatching():
+        m_archive(testDataDir())
+    {
+        m_filter.startTime = std::chrono::milliseconds::zero();
+        m_filter.endTime = std::chrono::milliseconds(QnTimePeriod::kMaxTimeValue);
+        m_filter.region = QRegion(
+            Qn::kMotionGridWidth / 4, Qn::kMotionGridHeight / 4,
+            Qn::kMotionGridWidth / 2, Qn::kMotionGridHeight / 2);
+    }
+
+    /** Generates motion records with sparse random motion. */
+    void givenArchive(
+        std::chrono::hours duration,
+        const QDateTime& startDateTime = QDateTime(QDate(2023, 1, 2), QTime(0, 0)))
+    {
+        using namespace std::chrono;
+
+        const milliseconds startTime(startDateTime.toMSecsSinceEpoch());
+        for (auto time = startTime; time < startTime + duration; time += kRecordInterval)
+        {
+            auto packet = std::make_shared<QnMetaDataV1>(microseconds(time));
+            packet->m_duration = duration_cast<microseconds>(kRecordDuration).count();
+            for (int i = nx::utils::random::number<int>(0, 3); i > 0; --i)
+            {
+                packet->setMotionAt(
+                    nx::utils::random::number<int>(0, Qn::kMotionGridWidth - 1),
+                    nx::utils::random::number<int>(0, Qn::kMotionGridHeight - 1));
+            }
+            ASSERT_TRUE(m_archive.saveToArchiveInternal(packet));
+        }
+    }
+
+    /** Generates the archive files of several months. */
+    void givenMonths(int monthCount, std::chrono::hours durationPerMonth)
+    {
+        for (int i = 0; i < monthCount; ++i)
+            givenArchive(durationPerMonth, QDateTime(QDate(2023, 1, 2).addMonths(i), QTime(0, 0)));
+    }
+
+    template<typename Matcher>
+    QnTimePeriodList match(QThreadPool* threadPool = nullptr)
+    {
+        Matcher matcher(&m_filter);
+        m_archive.setSearchThreadPool(threadPool);
+        return m_archive.matchPeriodInternal(&matcher);
+    }
+
+    template<typename Matcher>
+    std::chrono::milliseconds measure(int iterations, QThreadPool* threadPool = nullptr)
+    {
+        using namespace std::chrono;
+
+        const auto startTime = steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            match<Matcher>(threadPool);
+        return duration_cast<milliseconds>(steady_clock::now() - startTime);
+    }
+
+    void assertConcurrentMatchingGivesSamePeriods()
+    {
+        for (const auto sortOrder: {Qt::AscendingOrder, Qt::DescendingOrder})
+        {
+            m_filter.sortOrder = sortOrder;
+
+            const auto expected = match<MotionRecordMatcher>();
+            const auto actual = match<MotionRecordMatcher>(&m_threadPool);
+            ASSERT_FALSE(actual.empty());
+            ASSERT_EQ(expected, actual);
+        }
+    }
+
+    MotionFilter m_filter;
+    QThreadPool m_threadPool;
+
+private:
+    TestMotionArchive m_archive;
+};
+
+TEST_F(MotionArchiveMatching, batch_and_single_record_matching_give_same_periods)
+{
+    givenArchive(std::chrono::hours(24));
+
+    for (const auto sortOrder: {Qt::AscendingOrder, Qt::DescendingOrder})
+    {
+        m_filter.sortOrder = sortOrder;
+
+        const auto expected = match<SingleRecordMotionMatcher>();
+        const auto actual = match<MotionRecordMatcher>();
+        ASSERT_FALSE(actual.empty());
+        ASSERT_EQ(expected, actual);
+    }
+}
+
+TEST_F(MotionArchiveMatching, concurrent_and_sequential_matching_give_same_periods)
+{
+    givenMonths(/*monthCount*/ 4, std::chrono::hours(24));
+    assertConcurrentMatchingGivesSamePeriods();
+}
+
+TEST_F(MotionArchiveMatching, default_archive_matches_concurrently)
+{
+    givenMonths(/*monthCount*/ 4, std::chrono::hours(24));
+
+    TestMotionArchive defaultArchive(testDataDir());
+    ASSERT_NE(nullptr, defaultArchive.searchThreadPool());
+
+    for (const auto sortOrder: {Qt::AscendingOrder, Qt::DescendingOrder})
+    {
+        m_filter.sortOrder = sortOrder;
+
+        const auto expected = match<MotionRecordMatcher>();
+        MotionRecordMatcher matcher(&m_filter);
+        const auto actual = defaultArchive.matchPeriodInternal(&matcher);
+        ASSERT_FALSE(actual.empty());
+        ASSERT_EQ(expected, actual);
+    }
+}
+
+TEST_F(MotionArchiveMatching, concurrent_matching_honors_limit)
+{
+    givenMonths(/*monthCount*/ 4, std::chrono::hours(24));
+
+    for (const int limit: {1, 10, 1'000'000})
+    {
+        m_filter.limit = limit;
+        assertConcurrentMatchingGivesSamePeriods();
+    }
+}
+
+TEST_F(MotionArchiveMatching, concurrent_matching_joins_periods_of_adjacent_files)
+{
+    // Motion is recorded at the month boundary.
+    givenArchive(std::chrono::hours(2), QDateTime(QDate(2023, 1, 31), QTime(23, 0)));
+
+    m_filter.detailLevel = std::chrono::hours(1);
+    assertConcurrentMatchingGivesSamePeriods();
+}
+
+TEST_F(MotionArchiveMatching, DISABLED_performance)
+{
+    static constexpr int kIterations = 20;
+
+    givenArchive(std::chrono::hours(24 * 7));
+
+    const auto singleRecordDuration = measure<SingleRecordMotionMatcher>(kIterations);
+    const auto batchDuration = measure<MotionRecordMatcher>(kIterations);
+
+    std::cout << kIterations << " searches over a week of motion. "
+        << "Single record matching: " << singleRecordDuration.count() << " ms, "
+        << "batch matching: " << batchDuration.count() << " ms" << std::endl;
+}
+
+TEST_F(MotionArchiveMatching, DISABLED_concurrent_performance)
+{
+    static constexpr int kIterations = 5;
+
+    givenMonths(/*monthCount*/ 8, std::chrono::hours(24 * 7));
+
+    const auto sequentialDuration = measure<MotionRecordMatcher>(kIterations);
+    const auto concurrentDuration = measure<MotionRecordMatcher>(kIterations, &m_threadPool);
+
+    std::cout << kIterations << " searches over 8 months of motion. "
+        << "Sequential matching: " << sequentialDuration.count() << " ms, "
+        << "concurrent matching in " << m_threadPool.maxThreadCount() << " threads: "
+        << concurrentDuration.count() << " ms" << std::endl;
+}
+
+} // namespace nx::vms::metadata::test
@@ -0,0 +1,196 @@
+// Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <QtCore/QByteArray>
+
+#include <nx/vms/crypt/media_cipher.h>
+
+namespace nx::vms::crypt::test {
+
+namespace {
+
+static const QLatin1String kPassword("Hello!");
+static const QByteArray kSalt("salt");
+
+std::vector<uint8_t> fromHex(const char* hex)
+{
+    const auto data = QByteArray::fromHex(hex);
+    return std::vector<uint8_t>(data.begin(), data.end());
+}
+
+std::vector<uint8_t> makeData(size_t size)
+{
+    std::vector<uint8_t> result(size);
+    for (size_t i = 0; i < size; ++i)
+        result[i] = (uint8_t) (i * 31 + 7);
+    return result;
+}
+
+/** Encrypts the data the way it was done before MediaCipher: a new EVP context per packet. */
+std::vector<uint8_t> encryptWithNewContext(
+    const AesKey& key, const std::array<uint8_t, 16>& counterBlock, const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> result(data.size());
+    auto context = EVP_CIPHER_CTX_new();
+    EVP_EncryptInit_ex(
+        context, toCipher(key.algorithm()), nullptr, key.cipherKey.data(), counterBlock.data());
+    int outSize = 0;
+    EVP_EncryptUpdate(context, result.data(), &outSize, data.data(), (int) data.size());
+    EVP_CIPHER_CTX_free(context);
+    return result;
+}
+
+} // namespace
+
+class MediaCipherTest: public ::testing::TestWithParam<Algorithm>
+{
+protected:
+    const AesKey m_key = makeKey(kPassword, GetParam(), kSalt);
+};
+
+TEST_P(MediaCipherTest, encryptedDataIsDecrypted)
+{
+    MediaCipher cipher(m_key);
+    ASSERT_TRUE(cipher.isValid());
+
+    const auto data = makeData(10000);
+    auto buffer = data;
+    ASSERT_TRUE(cipher.encrypt(42, buffer.data(), buffer.data(), buffer.size()));
+    ASSERT_NE(data, buffer);
+
+    ASSERT_TRUE(cipher.decrypt(42, buffer.data(), buffer.data(), buffer.size()));
+    ASSERT_EQ(data, buffer);
+}
+
+TEST_P(MediaCipherTest, reusedContextMatchesNewContextPerPacket)
+{
+    MediaCipher cipher(m_key);
+    for (const uint64_t nonce: {0, 1, 2, 1000})
+    {
+        const auto data = makeData(1000 + nonce);
+        std::vector<uint8_t> encrypted(data.size());
+        ASSERT_TRUE(cipher.encrypt(nonce, data.data(), encrypted.data(), data.size()));
+        ASSERT_EQ(encryptWithNewContext(m_key, cipher.counterBlock(nonce), data), encrypted);
+    }
+}
+
+TEST_P(MediaCipherTest, packetsWithDifferentNoncesDoNotShareKeyStream)
+{
+    MediaCipher cipher(m_key);
+    const std::vector<uint8_t> zeros(1024);
+    std::vector<uint8_t> first(zeros.size());
+    std::vector<uint8_t> second(zeros.size());
+    ASSERT_TRUE(cipher.encrypt(1, zeros.data(), first.data(), zeros.size()));
+    ASSERT_TRUE(cipher.encrypt(2, zeros.data(), second.data(), zeros.size()));
+
+    // The key stream of the second packet is not a shifted key stream of the first one.
+    for (size_t offset = 0; offset < zeros.size(); offset += 16)
+    {
+        ASSERT_NE(
+            std::vector<uint8_t>(first.begin() + offset, first.begin() + offset + 16),
+            std::vector<uint8_t>(second.begin(), second.begin() + 16));
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(MediaCipher, MediaCipherTest,
+    ::testing::Values(Algorithm::aes128, Algorithm::aes256));
+
+/**
+ * The AES-CTR vectors of NIST SP 800-38A F.5.1 and F.5.5. The ivVect is chosen so that XOR-ing
+ * the nonce into it gives the initial counter block of the vectors.
+ */
+TEST(MediaCipher, knownAnswer)
+{
+    static constexpr uint64_t kNonce = 0x0102030405060708;
+    static constexpr char kIvVect[] = "f1f3f1f7f1f3f1fff8f9fafbfcfdfeff";
+    static constexpr char kCounterBlock[] = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+    static constexpr char kPlainText[] =
+        "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+
+    struct Vector
+    {
+        const char* key;
+        const char* cipherText;
+    };
+    static const Vector kVectors[] = {
+        {
+            "2b7e151628aed2a6abf7158809cf4f3c",
+            "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+            "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee"
+        },
+        {
+            "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4",
+            "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+            "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6"
+        },
+    };
+
+    for (const auto& vector: kVectors)
+    {
+        AesKey key;
+        const auto cipherKey = fromHex(vector.key);
+        std::copy(cipherKey.begin(), cipherKey.end(), key.cipherKey.begin());
+        const auto ivVect = fromHex(kIvVect);
+        std::copy(ivVect.begin(), ivVect.end(), key.ivVect.begin());
+
+        MediaCipher cipher(key);
+        ASSERT_TRUE(cipher.isValid());
+
+        const auto counterBlock = cipher.counterBlock(kNonce);
+        ASSERT_EQ(fromHex(kCounterBlock),
+            std::vector<uint8_t>(counterBlock.begin(), counterBlock.end()));
+
+        const auto plainText = fromHex(kPlainText);
+        std::vector<uint8_t> cipherText(plainText.size());
+        ASSERT_TRUE(cipher.encrypt(kNonce, plainText.data(), cipherText.data(), plainText.size()));
+        ASSERT_EQ(fromHex(vector.cipherText), cipherText);
+    }
+}
+
+TEST(MediaCipher, emptyKeyIsInvalid)
+{
+    MediaCipher cipher{AesKey()};
+    ASSERT_FALSE(cipher.isValid());
+}
+
+TEST(MediaCipher, DISABLED_throughputPerformance)
+{
+    using namespace std::chrono;
+
+    static constexpr size_t kPacketCount = 2000;
+    static constexpr size_t kPacketSize = 32 * 1024;
+
+    const auto key = makeKey(kPassword, Algorithm::aes256, kSalt);
+    const auto data = makeData(kPacketSize);
+    MediaCipher cipher(key);
+
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < kPacketCount; ++i)
+        encryptWithNewContext(key, cipher.counterBlock(i), data);
+    const auto perPacketTime = steady_clock::now() - start;
+
+    std::vector<uint8_t> encrypted(kPacketSize);
+    start = steady_clock::now();
+    for (size_t i = 0; i < kPacketCount; ++i)
+        ASSERT_TRUE(cipher.encrypt(i, data.data(), encrypted.data(), data.size()));
+    const auto reusedContextTime = steady_clock::now() - start;
+
+    const auto megabytes = (double) kPacketCount * kPacketSize / (1024 * 1024);
+    const auto throughput =
+        [megabytes](auto elapsed)
+        {
+            return megabytes / std::max(duration_cast<duration<double>>(elapsed).count(), 1e-9);
+        };
+
+    std::cout << "New context per packet: " << throughput(perPacketTime) << " MB/s" << std::endl;
+    std::cout << "Reused context: " << throughput(reusedContextTime) << " MB/s" << std::endl;
+}
+
+} // namespace nx::vms::crypt::test
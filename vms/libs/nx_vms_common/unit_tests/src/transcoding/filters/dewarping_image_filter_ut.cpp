@@ -2,8 +2,13 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
 #include <memory>
 
+#include <QtCore/QThreadPool>
+
+#include <nx/utils/random.h>
 #include <transcoding/filters/dewarping_image_filter.h>
 #include <utils/common/aspect_ratio.h>
 
@@ -1508,4 +1513,181 @@ TEST(DewarpingImageFilterTest, bilinearFiltering)
     ASSERT_EQ(128 + 64 + 32 - 1, pixel);
 }
 
+class DewarpingImageFilterRemapTest:
+    public testing::Test,
+    public QnDewarpingImageFilter
+{
+protected:
+    void givenFisheyeView(const QSize& frameSize)
+    {
+        MediaData mediaData;
+        mediaData.enabled = true;
+        mediaData.cameraProjection = CameraProjection::equidistant;
+        mediaData.viewMode = FisheyeCameraMount::ceiling;
+        mediaData.xCenter = 0.5208;
+        mediaData.yCenter = 0.4630;
+        mediaData.radius = 0.4688;
+        mediaData.hStretch = 1.8;
+
+        ViewData viewData;
+        viewData.enabled = true;
+        viewData.xAngle = qDegreesToRadians(30.0);
+        viewData.yAngle = qDegreesToRadians(-20.0);
+        viewData.fov = qDegreesToRadians(70.0);
+
+        QnDewarpingImageFilter::setParameters(mediaData, viewData);
+        updateDewarpingParameters(QnAspectRatio(frameSize).toFloat());
+
+        m_frame.reset(new CLVideoDecoderOutput(
+            frameSize.width(), frameSize.height(), AV_PIX_FMT_YUV420P));
+        for (int plane = 0; plane < 3; ++plane)
+        {
+            const int height = plane == 0 ? frameSize.height() : frameSize.height() / 2;
+            for (int i = 0; i < m_frame->linesize[plane] * height; ++i)
+                m_frame->data[plane][i] = (quint8) nx::utils::random::number(0, 255);
+        }
+    }
+
+    CLVideoDecoderOutputPtr dewarp(QThreadPool* threadPool)
+    {
+        setThreadPool(threadPool);
+        return updateImage(m_frame);
+    }
+
+    /** Dewarps the luma plane with the floating point filtering, as it was done before. */
+    std::vector<quint8> dewarpWithFloatingPointFiltering(const std::vector<QPointF>& points)
+    {
+        std::vector<quint8> result(points.size());
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            result[i] = getPixel(m_frame->data[0], m_frame->linesize[0],
+                points[i].x(), points[i].y(), m_frame->width, m_frame->height);
+        }
+        return result;
+    }
+
+    std::vector<QPointF> sourcePoints() const
+    {
+        std::vector<QPointF> points;
+        for (int y = 0; y < m_frame->height; ++y)
+        {
+            for (int x = 0; x < m_frame->width; ++x)
+                points.push_back(transformed(x, y, m_frame->size()));
+        }
+        return points;
+    }
+
+    RemapTable remapTable(const std::vector<QPointF>& points) const
+    {
+        auto table = createRemapTable(m_frame->size());
+        for (size_t i = 0; i < points.size(); ++i)
+            setSourcePoint(&table, (int) i, points[i]);
+        return table;
+    }
+
+    std::vector<quint8> dewarpWithRemapTable(const RemapTable& table, bool useSimd)
+    {
+        std::vector<quint8> result(m_frame->width * m_frame->height);
+        remap(table, m_frame->data[0], m_frame->linesize[0], result.data(), m_frame->width,
+            /*firstRow*/ 0, m_frame->height, useSimd);
+        return result;
+    }
+
+    void assertSamePlanes(const CLVideoDecoderOutputPtr& a, const CLVideoDecoderOutputPtr& b)
+    {
+        ASSERT_EQ(a->size(), b->size());
+        for (int plane = 0; plane < 3; ++plane)
+        {
+            const int width = plane == 0 ? a->width : a->width / 2;
+            const int height = plane == 0 ? a->height : a->height / 2;
+            for (int y = 0; y < height; ++y)
+            {
+                ASSERT_EQ(0, memcmp(
+                    a->data[plane] + y * a->linesize[plane],
+                    b->data[plane] + y * b->linesize[plane],
+                    width)) << "plane " << plane << ", row " << y;
+            }
+        }
+    }
+
+    CLVideoDecoderOutputPtr m_frame;
+    QThreadPool m_threadPool;
+};
+
+TEST_F(DewarpingImageFilterRemapTest, remap_table_matches_floating_point_filtering)
+{
+    givenFisheyeView(QSize(320, 180));
+
+    const auto points = sourcePoints();
+    const auto expected = dewarpWithFloatingPointFiltering(points);
+    const auto table = remapTable(points);
+    const auto simdResult = dewarpWithRemapTable(table, /*useSimd*/ true);
+    const auto scalarResult = dewarpWithRemapTable(table, /*useSimd*/ false);
+
+    ASSERT_EQ(simdResult, scalarResult);
+
+    // Fractions are rounded to 1/kFractionOne of a pixel, so the result can differ by one.
+    for (size_t i = 0; i < expected.size(); ++i)
+        ASSERT_LE(std::abs(expected[i] - simdResult[i]), 1) << "pixel " << points[i];
+}
+
+TEST_F(DewarpingImageFilterRemapTest, edge_pixels_are_not_filtered_with_outside_pixels)
+{
+    givenFisheyeView(QSize(32, 16));
+
+    const std::vector<QPointF> points(32 * 16, QPointF(31, 15));
+    const auto result = dewarpWithRemapTable(remapTable(points), /*useSimd*/ true);
+
+    const quint8 lastPixel = m_frame->data[0][15 * m_frame->linesize[0] + 31];
+    for (const quint8 pixel: result)
+        ASSERT_EQ(lastPixel, pixel);
+}
+
+TEST_F(DewarpingImageFilterRemapTest, threaded_and_single_threaded_dewarping_give_same_frame)
+{
+    givenFisheyeView(QSize(640, 360));
+
+    const auto expected = dewarp(/*threadPool*/ nullptr);
+    const auto actual = dewarp(&m_threadPool);
+    assertSamePlanes(expected, actual);
+}
+
+TEST_F(DewarpingImageFilterRemapTest, DISABLED_performance)
+{
+    using namespace std::chrono;
+    static constexpr int kIterations = 20;
+
+    givenFisheyeView(QSize(1920, 1080));
+
+    const auto points = sourcePoints();
+    const auto table = remapTable(points);
+
+    const auto measure =
+        [](auto function)
+        {
+            const auto startTime = steady_clock::now();
+            for (int i = 0; i < kIterations; ++i)
+                function();
+            return duration_cast<milliseconds>(steady_clock::now() - startTime);
+        };
+
+    const auto floatingPointDuration =
+        measure([&]() { dewarpWithFloatingPointFiltering(points); });
+    const auto scalarDuration = measure([&]() { dewarpWithRemapTable(table, false); });
+    const auto simdDuration = measure([&]() { dewarpWithRemapTable(table, true); });
+
+    dewarp(nullptr); //< Builds the remap tables.
+    const auto singleThreadDuration = measure([&]() { dewarp(nullptr); });
+    const auto threadedDuration = measure([&]() { dewarp(&m_threadPool); });
+
+    std::cout << kIterations << " 1920x1080 luma planes. "
+        << "Floating point filtering: " << floatingPointDuration.count() << " ms, "
+        << "fixed point: " << scalarDuration.count() << " ms, "
+        << "fixed point SIMD: " << simdDuration.count() << " ms" << std::endl;
+    std::cout << kIterations << " 1920x1080 YUV420 frames. "
+        << "Single thread: " << singleThreadDuration.count() << " ms, "
+        << m_threadPool.maxThreadCount() << " threads: "
+        << threadedDuration.count() << " ms" << std::endl;
+}
+
 } // namespace transcoding::filters::test
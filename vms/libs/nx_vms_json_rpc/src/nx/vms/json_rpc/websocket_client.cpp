@@ -94,11 +94,17 @@ void WebSocketClient::onUpgrade()
     WebSocketConnection::RequestHandler handler;
     if (m_handler)
         handler = [this](auto&&... args) { m_handler(std::forward<decltype(args)>(args)...); };
+    auto webSocket = std::make_unique<nx::network::websocket::WebSocket>(std::move(socket),
+        nx::network::websocket::Role::client,
+        nx::network::websocket::FrameType::text,
+        nx::network::websocket::CompressionType::perMessageDeflate);
+    if (const auto response = m_handshakeClient->response())
+    {
+        if (const auto deflateParams = nx::network::websocket::deflateParams(response->headers))
+            webSocket->setDeflateParams(*deflateParams);
+    }
     m_connection = std::make_unique<WebSocketConnection>(
-        std::make_unique<nx::network::websocket::WebSocket>(std::move(socket),
-            nx::network::websocket::Role::client,
-            nx::network::websocket::FrameType::text,
-            nx::network::websocket::CompressionType::perMessageDeflate),
+        std::move(webSocket),
         [this](auto connection)
         {
             NX_ASSERT(m_connection.get() == connection);
@@ -2,6 +2,8 @@
 
 #include "aggregator.h"
 
+#include <algorithm>
+
 #include <nx/utils/log/assert.h>
 #include <utils/common/synctime.h>
 
@@ -11,7 +13,8 @@
 namespace nx::vms::rules {
 
 Aggregator::Aggregator(std::chrono::microseconds interval):
-    m_interval(interval)
+    m_interval(interval),
+    m_bucketDuration(std::max(interval / (kBucketCount / 2), std::chrono::microseconds(1)))
 {
 }
 
@@ -32,6 +35,7 @@ bool Aggregator::aggregate(
             && qnSyncTime->currentTimePoint() - aggregationInfo.firstOccurrenceTimestamp >= m_interval)
         {
             aggregationInfo.firstOccurrenceTimestamp = event->timestamp();
+            schedule(it->first, &aggregationInfo);
             return false;
         }
 
@@ -46,11 +50,14 @@ bool Aggregator::aggregate(
                 }),
             event);
 
+        ++m_aggregatedEventCount;
+        ++m_statistics.aggregatedEvents;
         return true;
     }
 
-    m_aggregatedEvents.insert(
-        {key, AggregationData{.firstOccurrenceTimestamp = event->timestamp()}});
+    const auto it = m_aggregatedEvents.emplace(
+        key, AggregationData{.firstOccurrenceTimestamp = event->timestamp()}).first;
+    schedule(it->first, &it->second);
 
     return false;
 }
@@ -58,53 +65,103 @@ bool Aggregator::aggregate(
 std::vector<AggregatedEventPtr> Aggregator::popEvents()
 {
     const auto now = qnSyncTime->currentTimePoint();
+    const auto currentBucket = bucketOf(now);
+
+    // The buckets up to the current one are visited. A longer pause visits each bucket once.
+    const auto lastBucket = std::min(currentBucket, m_nextBucket + kBucketCount - 1);
 
     std::vector<AggregatedEventPtr> result;
-    for (auto it = m_aggregatedEvents.begin(); it != m_aggregatedEvents.end();)
+    for (auto bucket = m_nextBucket; bucket <= lastBucket; ++bucket)
     {
-        auto& aggregationInfo = it->second;
-        const bool isTimeElapsed = now - aggregationInfo.firstOccurrenceTimestamp >= m_interval;
+        auto& scheduledKeys = m_buckets[bucket % kBucketCount];
 
-        if (isTimeElapsed)
+        size_t keptCount = 0;
+        for (const auto& scheduledKey: scheduledKeys)
         {
-            if (!aggregationInfo.eventList.empty())
+            const auto it = m_aggregatedEvents.find(scheduledKey.key);
+
+            // The key has been expired or rescheduled to another bucket.
+            if (it == m_aggregatedEvents.end() || it->second.bucket != scheduledKey.bucket)
+                continue;
+
+            auto& aggregationInfo = it->second;
+            const bool isTimeElapsed = now - aggregationInfo.firstOccurrenceTimestamp >= m_interval;
+
+            if (!isTimeElapsed)
             {
-                const auto lb = std::lower_bound(
-                    result.begin(),
-                    result.end(),
-                    aggregationInfo.eventList.front()->timestamp(),
-                    [](const AggregatedEventPtr& e, std::chrono::microseconds timestamp)
-                    {
-                        return e->timestamp() < timestamp;
-                    });
-                result.insert(lb, AggregatedEventPtr::create(std::move(aggregationInfo.eventList)));
-
-                // Store the time aggregated event is popped out to conform the logic that
-                // events should be processed not often than once per the installed interval.
-                aggregationInfo.firstOccurrenceTimestamp = now;
+                scheduledKeys[keptCount++] = scheduledKey;
+                continue;
             }
-            else
+
+            if (aggregationInfo.eventList.empty())
             {
-                it = m_aggregatedEvents.erase(it);
+                m_aggregatedEvents.erase(it);
+                ++m_statistics.expiredKeys;
                 continue;
             }
+
+            const auto lb = std::lower_bound(
+                result.begin(),
+                result.end(),
+                aggregationInfo.eventList.front()->timestamp(),
+                [](const AggregatedEventPtr& e, std::chrono::microseconds timestamp)
+                {
+                    return e->timestamp() < timestamp;
+                });
+
+            m_aggregatedEventCount -= aggregationInfo.eventList.size();
+            ++m_statistics.poppedEvents;
+            result.insert(lb, AggregatedEventPtr::create(std::move(aggregationInfo.eventList)));
+            aggregationInfo.eventList.clear();
+
+            // Store the time aggregated event is popped out to conform the logic that
+            // events should be processed not often than once per the installed interval.
+            aggregationInfo.firstOccurrenceTimestamp = now;
+
+            // The key can't be added to the bucket being traversed.
+            m_rescheduledKeys.push_back(scheduledKey);
         }
 
-        ++it;
+        scheduledKeys.resize(keptCount);
+    }
+
+    m_nextBucket = std::max(m_nextBucket, currentBucket);
+
+    for (const auto& scheduledKey: m_rescheduledKeys)
+    {
+        if (const auto it = m_aggregatedEvents.find(scheduledKey.key);
+            it != m_aggregatedEvents.end())
+        {
+            schedule(it->first, &it->second);
+        }
     }
+    m_rescheduledKeys.clear();
 
     return result;
 }
 
 bool Aggregator::empty() const
 {
-    for (const auto& [_, aggregationInfo]: m_aggregatedEvents)
-    {
-        if (!aggregationInfo.eventList.empty())
-            return false;
-    }
+    return m_aggregatedEventCount == 0;
+}
+
+Aggregator::Statistics Aggregator::statistics() const
+{
+    return m_statistics;
+}
 
-    return true;
+void Aggregator::schedule(const QString& key, AggregationData* aggregationInfo)
+{
+    // The keys scheduled to the past buckets are handled by the next popEvents() call.
+    aggregationInfo->bucket = std::max(
+        bucketOf(aggregationInfo->firstOccurrenceTimestamp + m_interval), m_nextBucket);
+    m_buckets[aggregationInfo->bucket % kBucketCount].push_back(
+        ScheduledKey{.key = key, .bucket = aggregationInfo->bucket});
+}
+
+int64_t Aggregator::bucketOf(std::chrono::microseconds time) const
+{
+    return std::max<int64_t>(time / m_bucketDuration, 0);
 }
 
 } // namespace nx::vms::rules
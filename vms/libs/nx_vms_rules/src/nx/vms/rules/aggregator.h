@@ -2,19 +2,41 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <unordered_map>
 #include <vector>
 
+#include <QtCore/QHashFunctions>
+#include <QtCore/QString>
+
 #include "rules_fwd.h"
 
 namespace nx::vms::rules {
 
-/** Aggregates events by the aggregation key. */
+/**
+ * Aggregates events by the aggregation key.
+ * The aggregation periods are tracked by a ring of expiration buckets, so aggregating an event and
+ * popping the elapsed events do not depend on the number of keys. The buckets share the key
+ * strings with the aggregated events map.
+ */
 class NX_VMS_RULES_API Aggregator
 {
 public:
+    struct Statistics
+    {
+        /** Events added to the existing aggregation periods. */
+        size_t aggregatedEvents = 0;
+
+        /** Aggregated events popped out. */
+        size_t poppedEvents = 0;
+
+        /** Keys dropped as no events occurred within the aggregation period. */
+        size_t expiredKeys = 0;
+    };
+
     explicit Aggregator(std::chrono::microseconds interval);
 
     /** Returns a key the event will be aggregated by. */
@@ -32,6 +54,8 @@ public:
     /** Returns whether the aggregator has aggregated events. */
     bool empty() const;
 
+    Statistics statistics() const;
+
 private:
     struct AggregationData
     {
@@ -39,10 +63,31 @@ private:
         // elapsed. At the moment it is got from the initial event timestamp.
         std::chrono::microseconds firstOccurrenceTimestamp;
         std::vector<EventPtr> eventList;
+
+        // The expiration bucket the key is scheduled to.
+        int64_t bucket = 0;
+    };
+
+    struct ScheduledKey
+    {
+        QString key;
+        int64_t bucket = 0;
     };
 
+    // The ring spans two aggregation intervals.
+    static constexpr int kBucketCount = 64;
+
+    void schedule(const QString& key, AggregationData* aggregationInfo);
+    int64_t bucketOf(std::chrono::microseconds time) const;
+
     std::chrono::microseconds m_interval;
+    std::chrono::microseconds m_bucketDuration;
     std::unordered_map<QString, AggregationData> m_aggregatedEvents;
+    std::array<std::vector<ScheduledKey>, kBucketCount> m_buckets;
+    std::vector<ScheduledKey> m_rescheduledKeys;
+    int64_t m_nextBucket = 0;
+    size_t m_aggregatedEventCount = 0;
+    Statistics m_statistics;
 };
 
 } // namespace nx::vms::rules
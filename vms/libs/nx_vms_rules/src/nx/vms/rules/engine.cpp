@@ -4,8 +4,10 @@
 
 #include <QtCore/QMetaProperty>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 
 #include <nx/fusion/serialization/json.h>
+#include <nx/utils/concurrent.h>
 #include <nx/utils/log/log.h>
 #include <nx/utils/qobject.h>
 #include <nx/vms/api/rules/rule.h>
@@ -17,6 +19,7 @@
 #include "action_builder.h"
 #include "action_builder_field.h"
 #include "action_executor.h"
+#include "base_fields/resource_filter_field.h"
 #include "basic_action.h"
 #include "basic_event.h"
 #include "event_connector.h"
@@ -50,11 +53,34 @@ bool isDescriptorValid(const ItemDescriptor& descriptor)
     return true;
 }
 
+/** Smaller batches of analytics events are not worth splitting between threads. */
+constexpr int kMinEventsPerTask = 16;
+
+/**
+ * Event fields identifying the event source. A filter that accepts the selected resources only
+ * is indexed by the ids of these resources.
+ */
+const char* const kSourceFieldNames[] = {utils::kCameraIdFieldName, utils::kServerIdFieldName};
+
+/** @return Ids of the resources the filter is restricted to, std::nullopt if it accepts any. */
+std::optional<QSet<QnUuid>> sourceIds(const EventFilter* filter)
+{
+    for (const auto fieldName: kSourceFieldNames)
+    {
+        const auto field = filter->fieldByName<ResourceFilterEventField>(fieldName);
+        if (field && !field->acceptAll())
+            return field->ids();
+    }
+
+    return std::nullopt;
+}
+
 } // namespace
 
 Engine::Engine(std::unique_ptr<Router> router, QObject* parent):
     QObject(parent),
     m_router(std::move(router)),
+    m_ruleIndex(std::make_shared<RuleIndex>()),
     m_eventCache(std::make_unique<EventCache>())
 {
     const QString rulesVersion(ini().rulesEngine);
@@ -106,6 +132,11 @@ bool Engine::addEventConnector(EventConnector *eventConnector)
     return true;
 }
 
+void Engine::setThreadPool(QThreadPool* threadPool)
+{
+    m_threadPool = threadPool;
+}
+
 bool Engine::addActionExecutor(const QString& actionType, ActionExecutor* actionExecutor)
 {
     if (m_executors.contains(actionType))
@@ -189,6 +220,7 @@ void Engine::updateRule(const api::Rule& ruleData)
     auto ruleId = rule->id();
     NX_MUTEX_LOCKER lock(&m_ruleMutex);
     auto result = m_rules.insert_or_assign(ruleId, std::move(rule));
+    updateRuleIndex();
     lock.unlock();
 
     emit ruleAddedOrUpdated(ruleId, result.second);
@@ -198,6 +230,8 @@ void Engine::removeRule(QnUuid ruleId)
 {
     NX_MUTEX_LOCKER lock(&m_ruleMutex);
     const auto erasedCount = m_rules.erase(ruleId);
+    if (erasedCount > 0)
+        updateRuleIndex();
     lock.unlock();
 
     if (erasedCount > 0)
@@ -215,11 +249,47 @@ void Engine::resetRules(const std::vector<api::Rule>& rulesData)
 
     NX_MUTEX_LOCKER lock(&m_ruleMutex);
     m_rules = std::move(ruleSet);
+    updateRuleIndex();
     lock.unlock();
 
     emit rulesReset();
 }
 
+void Engine::updateRuleIndex()
+{
+    auto index = std::make_shared<RuleIndex>();
+    index->rules = m_rules;
+
+    for (const auto& [id, rule]: m_rules)
+    {
+        for (const auto filter: rule->eventFilters())
+        {
+            const IndexedFilter indexed{
+                .ruleId = id, .ruleEnabled = rule->enabled(), .filter = filter};
+            auto& typeFilters = index->filtersByEventType[filter->eventType()];
+
+            if (const auto ids = sourceIds(filter))
+            {
+                // A filter with no selected resources never matches, so it is not indexed.
+                for (const auto& resourceId: *ids)
+                    typeFilters.bySource[resourceId].push_back(indexed);
+            }
+            else
+            {
+                typeFilters.anySource.push_back(indexed);
+            }
+        }
+    }
+
+    m_ruleIndex = std::move(index);
+}
+
+std::shared_ptr<const Engine::RuleIndex> Engine::ruleIndex() const
+{
+    NX_MUTEX_LOCKER lock(&m_ruleMutex);
+    return m_ruleIndex;
+}
+
 bool Engine::registerEvent(const ItemDescriptor& descriptor, const EventConstructor& constructor)
 {
     if (!isDescriptorValid(descriptor))
@@ -277,6 +347,12 @@ bool Engine::registerEventConstructor(const QString& id, const EventConstructor&
     }
 
     m_eventTypes.insert(id, constructor);
+
+    // Event filters are compiled against the event class at rule load.
+    const std::unique_ptr<BasicEvent> prototype(constructor());
+    if (NX_ASSERT(prototype, "Event constructor returns nullptr"))
+        m_eventMetaObjects.insert(id, prototype->metaObject());
+
     return true;
 }
 
@@ -531,6 +607,8 @@ std::unique_ptr<EventFilter> Engine::buildEventFilter(const api::EventFilter& se
         filter->addField(fieldDescriptor.fieldName, std::move(field));
     }
 
+    filter->compile(m_eventMetaObjects.value(serialized.type));
+
     return filter;
 }
 
@@ -573,6 +651,8 @@ std::unique_ptr<EventFilter> Engine::buildEventFilter(const ItemDescriptor& desc
         filter->addField(fieldDescriptor.fieldName, std::move(field));
     }
 
+    filter->compile(m_eventMetaObjects.value(descriptor.id));
+
     return filter;
 }
 
@@ -722,85 +802,146 @@ size_t Engine::processEvent(const EventPtr& event)
         return {};
 
     checkOwnThread();
+
+    if (!isEventAccepted(event))
+        return {};
+
+    return routeMatchedEvent(event, matchEvent(*ruleIndex(), event));
+}
+
+size_t Engine::processAnalyticsEvents(const std::vector<EventPtr>& events)
+{
+    checkOwnThread();
+
+    const int taskCount = m_threadPool
+        ? std::min(m_threadPool->maxThreadCount() + 1, (int) (events.size() / kMinEventsPerTask))
+        : 0;
+
+    if (!m_enabled || taskCount < 2)
+    {
+        size_t matchedRules{};
+        for (const auto& event: events)
+            matchedRules += processEvent(event);
+
+        return matchedRules;
+    }
+
+    // Matching does not depend on the event cache, so all the events are matched in advance.
+    // The snapshot keeps the rules alive even if the rule set is changed meanwhile.
+    const auto index = ruleIndex();
+    std::vector<QSet<QnUuid>> ruleIds(events.size());
+
+    const auto matchEvents =
+        [this, &index, &events, &ruleIds](const std::pair<size_t, size_t>& range)
+        {
+            for (size_t i = range.first; i < range.second; ++i)
+                ruleIds[i] = matchEvent(*index, events[i]);
+        };
+
+    std::vector<std::pair<size_t, size_t>> ranges;
+    for (int i = 0; i < taskCount; ++i)
+        ranges.emplace_back(events.size() * i / taskCount, events.size() * (i + 1) / taskCount);
+
+    // The calling thread takes the first range, so the batch is finished even if all threads of
+    // the pool are busy with something else.
+    std::vector<std::pair<size_t, size_t>> pooledRanges(ranges.begin() + 1, ranges.end());
+    auto future = nx::utils::concurrent::mapped(m_threadPool, pooledRanges, matchEvents);
+    matchEvents(ranges.front());
+    future.waitForFinished();
+
+    size_t matchedRules{};
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        if (isEventAccepted(events[i]))
+            matchedRules += routeMatchedEvent(events[i], ruleIds[i]);
+    }
+
+    return matchedRules;
+}
+
+bool Engine::isEventAccepted(const EventPtr& event)
+{
     NX_DEBUG(this, "Processing Event: %1, state: %2", event->type(), event->state());
 
     const auto cacheKey = event->cacheKey();
     if (m_eventCache->eventWasCached(cacheKey))
     {
         NX_VERBOSE(this, "Skipping cached event with key: %1", cacheKey);
-        return {};
+        return false;
     }
 
-    if (!m_eventCache->checkEventState(event))
-        return {};
+    return m_eventCache->checkEventState(event);
+}
 
-    EventData eventData;
-    QSet<QByteArray> eventFields; // TODO: #spanasenko Cache data.
-    QSet<QnUuid> ruleIds, resources;
+QSet<QnUuid> Engine::matchEvent(const RuleIndex& index, const EventPtr& event) const
+{
+    QSet<QnUuid> ruleIds;
 
-    {
-        NX_MUTEX_LOCKER lock(&m_ruleMutex);
+    const auto typeFilters = index.filtersByEventType.constFind(event->type());
+    if (typeFilters == index.filtersByEventType.cend())
+        return ruleIds;
 
-        // TODO: #spanasenko Add filters-by-type maps?
-        for (const auto& [id, rule]: m_rules)
+    const auto matchFilters =
+        [&](const std::vector<IndexedFilter>& filters)
         {
-            if (!rule->enabled())
-                continue;
-
-            bool matched = false;
-            for (const auto filter: rule->eventFiltersByType(event->type()))
+            for (const auto& [ruleId, ruleEnabled, filter]: filters)
             {
+                if (!ruleEnabled || ruleIds.contains(ruleId))
+                    continue;
+
                 if (filter->match(event))
-                {
-                    matched = true;
-                    break;
-                }
+                    ruleIds += ruleId;
             }
+        };
+
+    matchFilters(typeFilters->anySource);
 
-            if (matched)
+    if (!typeFilters->bySource.empty())
+    {
+        for (const auto fieldName: kSourceFieldNames)
+        {
+            const auto sourceId = event->property(fieldName).value<QnUuid>();
+            if (const auto it = typeFilters->bySource.find(sourceId);
+                it != typeFilters->bySource.end())
             {
-                //for (const auto& builder: rule->actionBuilders())
-                //{
-                //    eventFields += builder->requiredEventFields();
-                //}
-
-                //for (const auto& builder: rule->actionBuilders())
-                //{
-                //    resources += builder->affectedResources(eventData);
-                //}
-
-                for (const auto& fieldName: nx::utils::propertyNames(event.get()))
-                {
-                    eventFields += fieldName;
-                }
-
-                ruleIds += id;
+                matchFilters(it->second);
             }
         }
     }
 
+    return ruleIds;
+}
+
+size_t Engine::routeMatchedEvent(const EventPtr& event, const QSet<QnUuid>& ruleIds)
+{
     NX_DEBUG(this, "Matched with %1 rules", ruleIds.size());
 
-    if (!ruleIds.empty())
-    {
-        m_eventCache->cacheEvent(cacheKey);
+    if (ruleIds.empty())
+        return {};
 
-        eventData = serializeProperties(event.get(), eventFields);
-        m_router->routeEvent(eventData, ruleIds, resources);
-    }
+    EventData eventData;
+    QSet<QByteArray> eventFields; // TODO: #spanasenko Cache data.
+    QSet<QnUuid> resources;
 
-    return ruleIds.size();
-}
+    //for (const auto& builder: rule->actionBuilders())
+    //{
+    //    eventFields += builder->requiredEventFields();
+    //}
 
-size_t Engine::processAnalyticsEvents(const std::vector<EventPtr>& events)
-{
-    checkOwnThread();
+    //for (const auto& builder: rule->actionBuilders())
+    //{
+    //    resources += builder->affectedResources(eventData);
+    //}
 
-    size_t matchedRules{};
-    for (const auto& event: events)
-        matchedRules += processEvent(event);
+    for (const auto& fieldName: nx::utils::propertyNames(event.get()))
+        eventFields += fieldName;
 
-    return matchedRules;
+    m_eventCache->cacheEvent(event->cacheKey());
+
+    eventData = serializeProperties(event.get(), eventFields);
+    m_router->routeEvent(eventData, ruleIds, resources);
+
+    return ruleIds.size();
 }
 
 // TODO: #spanasenko Use a wrapper with additional checks instead of QHash.
@@ -5,6 +5,7 @@
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include <QtCore/QHash>
 #include <QtCore/QList>
@@ -18,6 +19,8 @@
 #include "event_cache.h"
 #include "rules_fwd.h"
 
+class QThreadPool;
+
 namespace nx::vms::api::rules {
 struct ActionBuilder;
 struct EventFilter;
@@ -66,6 +69,14 @@ public:
     bool addEventConnector(EventConnector* eventConnector);
     bool addActionExecutor(const QString& actionType, ActionExecutor* actionExecutor);
 
+    /**
+     * Sets the thread pool that matches the batches of analytics events against the rules. The
+     * engine thread waits for the pool, so it should be a dedicated pool with a bounded number of
+     * threads. By default, and if nullptr is set, the events are matched one by one in the engine
+     * thread.
+     */
+    void setThreadPool(QThreadPool* threadPool);
+
 // Rule management methods.
     /** Returns all the rules engine contains. */
     ConstRuleSet rules() const;
@@ -158,7 +169,12 @@ public:
     /** Processes incoming event and returns matched rule count. */
     size_t processEvent(const EventPtr& event);
 
-    /** Processes incoming analytics events and returns matched rule count. */
+    /**
+     * Processes incoming analytics events and returns matched rule count.
+     * The events of a large batch are matched against the rules in parallel, then the matched
+     * events are cached and routed in the engine thread in the order of the batch. So the events
+     * of each source are handled in the same order as with processEvent() called for each of them.
+     */
     size_t processAnalyticsEvents(const std::vector<EventPtr>& events);
 
     EventCache* eventCache() const;
@@ -215,6 +231,44 @@ private:
     */
     bool registerActionConstructor(const QString& id, const ActionConstructor& constructor);
 
+    struct IndexedFilter
+    {
+        QnUuid ruleId;
+        /** Copied from the rule, so the snapshot is matched without reading the rule. */
+        bool ruleEnabled = false;
+        const EventFilter* filter = nullptr;
+    };
+
+    /** Filters of a single event type, split by the source resources they accept. */
+    struct EventTypeFilters
+    {
+        std::vector<IndexedFilter> anySource;
+        std::unordered_map<QnUuid, std::vector<IndexedFilter>> bySource;
+    };
+
+    /**
+     * Immutable snapshot of the rule set. Holds the rules, so the events may be matched against it
+     * without the rule mutex while the rule set is being changed.
+     */
+    struct RuleIndex
+    {
+        RuleSet rules;
+        QHash<QString, EventTypeFilters> filtersByEventType;
+    };
+
+    /** Rebuilds the rule index from the rule set. Must be called under the rule mutex. */
+    void updateRuleIndex();
+    std::shared_ptr<const RuleIndex> ruleIndex() const;
+
+    /** Checks the event against the event cache. Must be called in the engine thread. */
+    bool isEventAccepted(const EventPtr& event);
+
+    /** @return Ids of the rules matched by the event. Thread-safe. */
+    QSet<QnUuid> matchEvent(const RuleIndex& index, const EventPtr& event) const;
+
+    /** Caches and routes the matched event. Must be called in the engine thread. */
+    size_t routeMatchedEvent(const EventPtr& event, const QSet<QnUuid>& ruleIds);
+
 private:
     bool m_enabled = false;
     bool m_oldEngineEnabled = true;
@@ -229,6 +283,7 @@ private:
     QHash<QString, ActionFieldConstructor> m_actionFields;
 
     QHash<QString, EventConstructor> m_eventTypes;
+    QHash<QString, const QMetaObject*> m_eventMetaObjects;
     QHash<QString, ActionConstructor> m_actionTypes;
 
     QMap<QString, ItemDescriptor> m_eventDescriptors;
@@ -236,8 +291,12 @@ private:
 
     // All the fields above are initialized on startup and remain unmodified at runtime.
     // Rule set is guarded by corresponding mutex.
+    // Rules are never modified in place, so the index is rebuilt on every rule set change only.
     mutable nx::Mutex m_ruleMutex;
     RuleSet m_rules;
+    std::shared_ptr<const RuleIndex> m_ruleIndex;
+
+    QThreadPool* m_threadPool = nullptr;
 
     // The event cache should be used by Engine's thread only.
     std::unique_ptr<EventCache> m_eventCache;
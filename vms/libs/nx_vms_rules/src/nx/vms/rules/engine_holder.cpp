@@ -2,6 +2,8 @@
 
 #include "engine_holder.h"
 
+#include <QtCore/QThreadPool>
+
 #include <api/common_message_processor.h>
 #include <nx/utils/async_handler_executor.h>
 #include <nx/vms/common/system_context.h>
@@ -9,6 +11,7 @@
 #include <nx_ec/managers/abstract_vms_rules_manager.h>
 
 #include "ec2_router.h"
+#include "ini.h"
 #include "plugin.h"
 #include "rule.h"
 
@@ -24,6 +27,13 @@ EngineHolder::EngineHolder(
 {
     m_builtinPlugin->initialize(m_engine.get());
 
+    if (const int threadCount = ini().analyticsEventMatchingThreadCount; threadCount > 0)
+    {
+        m_threadPool = std::make_unique<QThreadPool>();
+        m_threadPool->setMaxThreadCount(threadCount);
+        m_engine->setThreadPool(m_threadPool.get());
+    }
+
     if (separateThread)
     {
         m_thread = std::make_unique<QThread>();
@@ -7,6 +7,7 @@
 namespace nx::vms::common { class SystemContext; }
 
 class QThread;
+class QThreadPool;
 class QnCommonMessageProcessor;
 
 namespace nx::vms::rules {
@@ -32,6 +33,8 @@ public:
 
 private:
     std::unique_ptr<Plugin> m_builtinPlugin;
+    /** Matches the analytics events for the engine, so must outlive it. */
+    std::unique_ptr<QThreadPool> m_threadPool;
     std::unique_ptr<Engine> m_engine;
     std::unique_ptr<QThread> m_thread;
 };
@@ -2,6 +2,8 @@
 
 #include "event_cache.h"
 
+#include <utility>
+
 #include "basic_event.h"
 #include "utils/event.h"
 
@@ -27,26 +29,65 @@ void EventCache::cleanupOldEventsFromCache(
         return;
     m_cacheTimer.restart();
 
-    std::erase_if(
-        m_cachedEvents,
-        [eventTimeout](const auto& pair) { return pair.second.hasExpired(eventTimeout); });
+    // Buckets are ordered by the time of the last cached key.
+    while (!m_buckets.empty() && m_buckets.front().lastCacheTimer.hasExpired(eventTimeout))
+    {
+        auto& bucket = m_buckets.front();
+        for (const auto& key: bucket.keys)
+        {
+            if (const auto it = m_cachedEvents.find(key);
+                it != m_cachedEvents.end() && it->second == bucket.id)
+            {
+                m_cachedEvents.erase(it);
+                ++m_expiredEvents;
+            }
+        }
+
+        bucket.keys.clear();
+        if (bucket.keys.capacity() > m_spareKeys.capacity())
+            m_spareKeys = std::move(bucket.keys);
+        m_buckets.pop_front();
+    }
+
+    // The keys cached from now on expire together.
+    if (m_buckets.empty() || !m_buckets.back().keys.empty())
+        m_buckets.push_back(Bucket{.id = m_nextBucketId++, .keys = std::exchange(m_spareKeys, {})});
 }
 
 bool EventCache::eventWasCached(const QString& cacheKey) const
 {
     // TODO: #amalov Check for cached event expiration here.
-    return !cacheKey.isEmpty() && m_cachedEvents.contains(cacheKey);
+    if (cacheKey.isEmpty() || !m_cachedEvents.contains(cacheKey))
+        return false;
+
+    ++m_hits;
+    return true;
 }
 
 void EventCache::cacheEvent(const QString& eventKey)
 {
-    using namespace nx::utils;
-
     if (eventKey.isEmpty())
         return;
 
     cleanupOldEventsFromCache(kEventTimeout, kCleanupTimeout);
-    m_cachedEvents.emplace(eventKey, ElapsedTimer(ElapsedTimerState::started));
+    if (m_buckets.empty())
+        m_buckets.push_back(Bucket{.id = m_nextBucketId++});
+
+    auto& bucket = m_buckets.back();
+    if (m_cachedEvents.emplace(eventKey, bucket.id).second)
+    {
+        bucket.keys.push_back(eventKey); //< Shares the string data with the map key.
+        bucket.lastCacheTimer.restart();
+    }
+}
+
+EventCache::Statistics EventCache::statistics() const
+{
+    return Statistics{
+        .cachedEvents = m_cachedEvents.size(),
+        .hits = m_hits,
+        .expiredEvents = m_expiredEvents,
+    };
 }
 
 bool EventCache::checkEventState(const EventPtr& event)
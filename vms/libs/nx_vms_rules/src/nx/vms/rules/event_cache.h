@@ -3,8 +3,13 @@
 #pragma once
 
 #include <chrono>
+#include <deque>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
+
+#include <QtCore/QHashFunctions>
+#include <QtCore/QString>
 
 #include <nx/utils/elapsed_timer.h>
 
@@ -12,10 +17,27 @@
 
 namespace nx::vms::rules {
 
-/** Fast simple cache to discard frequent duplicate events. */
+/**
+ * Fast simple cache to discard frequent duplicate events.
+ * Cached keys are grouped into expiration buckets, a new bucket is started on each cleanup, so
+ * the cleanup drops whole buckets instead of checking every key. The buckets share the key
+ * strings with the cache.
+ * A key is dropped when the latest key of its bucket is older than the event timeout.
+ */
 class NX_VMS_RULES_API EventCache
 {
 public:
+    struct Statistics
+    {
+        size_t cachedEvents = 0;
+
+        /** Events found in the cache. */
+        size_t hits = 0;
+
+        /** Events dropped from the cache by timeout. */
+        size_t expiredEvents = 0;
+    };
+
     bool eventWasCached(const QString& cacheKey) const;
     void cacheEvent(const QString& cacheKey);
 
@@ -26,11 +48,27 @@ public:
     /** Check prolonged event on-off consistency.*/
     bool checkEventState(const EventPtr& event);
 
+    Statistics statistics() const;
+
 private:
-    std::unordered_map<QString, nx::utils::ElapsedTimer> m_cachedEvents;
+    struct Bucket
+    {
+        size_t id = 0;
+        nx::utils::ElapsedTimer lastCacheTimer;
+        std::vector<QString> keys;
+    };
+
+    // Key to the id of the bucket the key is stored in.
+    std::unordered_map<QString, size_t> m_cachedEvents;
+    std::deque<Bucket> m_buckets;
+    std::vector<QString> m_spareKeys;
+    size_t m_nextBucketId = 0;
     nx::utils::ElapsedTimer m_cacheTimer;
 
     std::unordered_set<QString> m_runningEvents;
+
+    mutable size_t m_hits = 0;
+    size_t m_expiredEvents = 0;
 };
 
 } // namespace nx::vms::rules
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include <QtCore/QJsonValue>
+#include <QtCore/QMetaProperty>
 #include <QtCore/QScopedValueRollback>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QVariant>
@@ -116,9 +117,37 @@ void EventFilter::addField(const QString& name, std::unique_ptr<EventFilterField
         QMetaMethod::fromSignal(&EventFilter::changed));
 
     m_fields[name] = std::move(field);
+    updateMatchedFields();
     updateState();
 }
 
+void EventFilter::compile(const QMetaObject* eventMetaObject)
+{
+    m_eventMetaObject = eventMetaObject;
+    updateMatchedFields();
+}
+
+void EventFilter::updateMatchedFields()
+{
+    m_matchedFields.clear();
+    m_stateField = fieldByName<StateField>(utils::kStateFieldName);
+
+    for (const auto& [name, field]: m_fields)
+    {
+        if (name == utils::kStateFieldName)
+            continue;
+
+        MatchedField matchedField{.propertyName = name.toUtf8(), .field = field.get()};
+        if (m_eventMetaObject)
+        {
+            matchedField.propertyIndex =
+                m_eventMetaObject->indexOfProperty(matchedField.propertyName.constData());
+        }
+
+        m_matchedFields.push_back(std::move(matchedField));
+    }
+}
+
 const QHash<QString, EventFilterField*> EventFilter::fields() const
 {
     QHash<QString, EventFilterField*> result;
@@ -142,14 +171,16 @@ bool EventFilter::match(const EventPtr& event) const
 
 bool EventFilter::matchFields(const EventPtr& event) const
 {
-    for (const auto& [name, field]: m_fields)
-    {
-        if (name == utils::kStateFieldName)
-            continue;
+    const bool isCompiled = m_eventMetaObject && event->metaObject() == m_eventMetaObject;
 
-        const auto& value = event->property(name.toUtf8().data());
+    for (const auto& [propertyName, propertyIndex, field]: m_matchedFields)
+    {
+        // Dynamic properties have no index and are read by name.
+        const auto& value = (isCompiled && propertyIndex >= 0)
+            ? m_eventMetaObject->property(propertyIndex).read(event.get())
+            : event->property(propertyName.constData());
         NX_VERBOSE(this, "Matching property: %1, valid: %2, null: %3",
-            name, value.isValid(), value.isNull());
+            propertyName, value.isValid(), value.isNull());
 
         if (!value.isValid())
             return false;
@@ -166,9 +197,8 @@ bool EventFilter::matchState(const EventPtr& event) const
 {
     NX_VERBOSE(this, "Matching event state: %1", event->state());
 
-    // TODO: #amalov Consider storing the state as a separate member.
-    if (const auto stateField = fieldByName<StateField>(utils::kStateFieldName))
-        return stateField->match(QVariant::fromValue(event->state()));
+    if (m_stateField)
+        return m_stateField->match(QVariant::fromValue(event->state()));
 
     return true;
 }
@@ -5,6 +5,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -17,6 +18,7 @@
 namespace nx::vms::rules {
 
 class EventFilterField;
+class StateField;
 
 /**
  * Event filters are used to filter events received by VMS rules engine
@@ -66,6 +68,13 @@ public:
 
     bool match(const EventPtr& event) const;
 
+    /**
+     * Resolves the event properties matched by the filter fields to the property indices of the
+     * given event class, so that matching the events of this class does not look the properties
+     * up by name. Events of other classes are matched by property names as before.
+     */
+    void compile(const QMetaObject* eventMetaObject);
+
     void connectSignals();
 
     template<class T>
@@ -105,6 +114,7 @@ private:
     bool matchState(const EventPtr& event) const;
 
     void updateState();
+    void updateMatchedFields();
 
     template<class T>
     T* fieldByNameImpl(const QString& name) const
@@ -131,6 +141,18 @@ private:
     const Rule* m_rule = {};
     std::map<QString, std::unique_ptr<EventFilterField>> m_fields;
     bool m_updateInProgress = false;
+
+    struct MatchedField
+    {
+        QByteArray propertyName;
+        int propertyIndex = -1;
+        const EventFilterField* field = nullptr;
+    };
+
+    // Cached on field addition. Property indices are valid for m_eventMetaObject only.
+    std::vector<MatchedField> m_matchedFields;
+    const StateField* m_stateField = nullptr;
+    const QMetaObject* m_eventMetaObject = nullptr;
 };
 
 } // namespace nx::vms::rules
@@ -19,6 +19,10 @@ struct NX_VMS_RULES_API Ini: public nx::kit::IniConfig
 
     NX_INI_FLAG(false, showSystemRules,
         "Show system rules in the rules editor.");
+
+    NX_INI_INT(0, analyticsEventMatchingThreadCount,
+        "Number of threads matching the batches of analytics events against the rules.\n"
+        "0 means the events are matched one by one in the engine thread.");
 };
 
 NX_VMS_RULES_API Ini& ini();
@@ -1,5 +1,6 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <iostream>
 #include <memory>
 
 #include <gtest/gtest.h>
@@ -244,4 +245,66 @@ TEST_F(AggregatorTest, splitFunctionWorksProperly)
     ASSERT_EQ(splitResult.back()->count(), 4);
 }
 
+TEST_F(AggregatorTest, statistics)
+{
+    constexpr auto kAggregationInterval = 100ms;
+    auto aggregator = makeAggregator(kAggregationInterval);
+
+    ASSERT_FALSE(aggregator.aggregate(makeEvent("a"), aggregationKeyFunction));
+    ASSERT_TRUE(aggregator.aggregate(makeEvent("a"), aggregationKeyFunction));
+    ASSERT_TRUE(aggregator.aggregate(makeEvent("a"), aggregationKeyFunction));
+    ASSERT_FALSE(aggregator.aggregate(makeEvent("b"), aggregationKeyFunction));
+
+    adjustTime(kAggregationInterval);
+    ASSERT_EQ(aggregator.popEvents().size(), 1);
+
+    // Key "a" is expired after the next interval without events.
+    adjustTime(kAggregationInterval);
+    ASSERT_TRUE(aggregator.popEvents().empty());
+
+    const auto statistics = aggregator.statistics();
+    EXPECT_EQ(statistics.aggregatedEvents, 2);
+    EXPECT_EQ(statistics.poppedEvents, 1);
+    EXPECT_EQ(statistics.expiredKeys, 2);
+}
+
+TEST_F(AggregatorTest, DISABLED_sustainedLoadPerformance)
+{
+    constexpr int kEventsPerSecond = 10'000;
+    constexpr int kEventsPerMillisecond = kEventsPerSecond / 1000;
+    constexpr auto kLoadDuration = 120s;
+    constexpr auto kPollInterval = 1s;
+    constexpr int kKeyCount = 10'000;
+
+    auto aggregator = makeAggregator(10s);
+
+    std::vector<QString> keys;
+    for (int i = 0; i < kKeyCount; ++i)
+        keys.push_back(QString("generic_event_%1").arg(i));
+
+    size_t eventCount = 0;
+    size_t poppedCount = 0;
+    const auto start = steady_clock::now();
+    for (milliseconds t{}; t < kLoadDuration; ++t)
+    {
+        adjustTime(1ms);
+        for (int i = 0; i < kEventsPerMillisecond; ++i)
+        {
+            const auto& key = keys[eventCount++ * 7919 % kKeyCount];
+            aggregator.aggregate(makeEvent(), [&key](const EventPtr&) { return key; });
+        }
+
+        if (t % kPollInterval == 0ms)
+            poppedCount += aggregator.popEvents().size();
+    }
+    const auto elapsed = steady_clock::now() - start;
+
+    EXPECT_GT(poppedCount, 0);
+    EXPECT_EQ(aggregator.statistics().poppedEvents, poppedCount);
+
+    const auto elapsedMs = duration<double, std::milli>(elapsed).count();
+    std::cout << eventCount << " events aggregated by " << kKeyCount << " keys in " << elapsedMs
+        << " ms (" << eventCount / elapsedMs * 1000 << " events/s)" << std::endl;
+}
+
 } // namespace nx::vms::rules::test
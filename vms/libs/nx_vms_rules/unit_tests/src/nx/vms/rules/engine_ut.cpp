@@ -1,6 +1,12 @@
 // Copyright 2018-present Network Optix, Inc. Licensed under MPL 2.0: www.mozilla.org/MPL/2.0/
 
+#include <chrono>
+#include <iostream>
+#include <map>
 #include <thread>
+#include <utility>
+
+#include <QtCore/QThreadPool>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -11,9 +17,12 @@
 #include <nx/vms/rules/action_builder_fields/optional_time_field.h>
 #include <nx/vms/rules/engine.h>
 #include <nx/vms/rules/event_filter.h>
+#include <nx/vms/rules/event_filter_fields/source_camera_field.h>
+#include <nx/vms/rules/event_filter_fields/source_server_field.h>
 #include <nx/vms/rules/manifest.h>
 #include <nx/vms/rules/rule.h>
 #include <nx/vms/rules/utils/api.h>
+#include <nx/vms/rules/utils/field.h>
 #include <utils/common/synctime.h>
 
 #include "mock_engine_events.h"
@@ -36,6 +45,25 @@ api::Rule makeEmptyRuleData()
     return {{QnUuid::createUuid()}};
 }
 
+/** Records the routed events in the routing order. */
+class RecordingRouter: public TestRouter
+{
+public:
+    RecordingRouter(std::vector<EventData>* routedEvents): m_routedEvents(routedEvents) {}
+
+    virtual void routeEvent(
+        const EventData& eventData,
+        const QSet<QnUuid>& triggeredRules,
+        const QSet<QnUuid>& affectedResources) override
+    {
+        m_routedEvents->push_back(eventData);
+        TestRouter::routeEvent(eventData, triggeredRules, affectedResources);
+    }
+
+private:
+    std::vector<EventData>* m_routedEvents;
+};
+
 } // namespace
 
 class EngineTest: public ::testing::Test
@@ -573,4 +601,267 @@ TEST_F(EngineTest, notStartedEventIsNotProcessed)
     EXPECT_EQ(engine->processEvent(event), 0);
 }
 
+
+class EngineSourceFilterTest: public EngineTest
+{
+protected:
+    virtual void SetUp() override
+    {
+        engine = std::make_unique<Engine>(std::make_unique<RecordingRouter>(&routedEvents));
+
+        auto descriptor = TestEvent::manifest();
+        descriptor.fields = {
+            makeFieldDescriptor<SourceCameraField>(utils::kCameraIdFieldName, "Camera"),
+            makeFieldDescriptor<SourceServerField>(utils::kServerIdFieldName, "Server"),
+        };
+
+        ASSERT_TRUE(engine->registerEventField(
+            fieldMetatype<SourceCameraField>(), [] { return new SourceCameraField; }));
+        ASSERT_TRUE(engine->registerEventField(
+            fieldMetatype<SourceServerField>(), [] { return new SourceServerField; }));
+        ASSERT_TRUE(engine->registerEvent(descriptor, testEventConstructor));
+    }
+
+    /** An empty id set means any resource is accepted. */
+    api::Rule makeRuleData(
+        const QSet<QnUuid>& cameraIds, const QSet<QnUuid>& serverIds = {}, bool enabled = true)
+    {
+        auto rule = std::make_unique<Rule>(QnUuid::createUuid(), engine.get());
+        auto filter = engine->buildEventFilter(utils::type<TestEvent>());
+
+        auto cameraField = filter->fieldByName<SourceCameraField>(utils::kCameraIdFieldName);
+        cameraField->setAcceptAll(cameraIds.empty());
+        cameraField->setIds(cameraIds);
+
+        auto serverField = filter->fieldByName<SourceServerField>(utils::kServerIdFieldName);
+        serverField->setAcceptAll(serverIds.empty());
+        serverField->setIds(serverIds);
+
+        rule->addEventFilter(std::move(filter));
+        rule->setEnabled(enabled);
+
+        return serialize(rule.get());
+    }
+
+    QnUuid givenRule(
+        const QSet<QnUuid>& cameraIds, const QSet<QnUuid>& serverIds = {}, bool enabled = true)
+    {
+        const auto ruleData = makeRuleData(cameraIds, serverIds, enabled);
+        engine->updateRule(ruleData);
+        return ruleData.id;
+    }
+
+    TestEventPtr makeEvent(
+        const QnUuid& cameraId, const QnUuid& serverId = {}, State state = State::instant)
+    {
+        auto event = TestEventPtr::create(std::chrono::microseconds::zero(), state);
+        event->m_cameraId = cameraId;
+        event->m_serverId = serverId;
+        return event;
+    }
+
+    /** Matches the events in the engine thread or in the thread pool, depending on threadPool. */
+    size_t processEventStorm(
+        const std::vector<EventPtr>& events, int batchCount, QThreadPool* threadPool)
+    {
+        engine->setThreadPool(threadPool);
+
+        size_t matchedRules = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < batchCount; ++i)
+            matchedRules += engine->processAnalyticsEvents(events);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        const auto elapsedMs = std::chrono::duration<double, std::milli>(elapsed).count();
+        std::cout << engine->ruleCount() << " rules, " << events.size() * batchCount
+            << " events processed " << (threadPool ? "in parallel" : "sequentially") << " in "
+            << elapsedMs << " ms (" << events.size() * batchCount / elapsedMs * 1000
+            << " events/s)" << std::endl;
+
+        return matchedRules;
+    }
+
+    std::vector<EventData> routedEvents;
+
+    const QnUuid camera1 = QnUuid::createUuid();
+    const QnUuid camera2 = QnUuid::createUuid();
+    const QnUuid server = QnUuid::createUuid();
+};
+
+TEST_F(EngineSourceFilterTest, ruleIsMatchedBySelectedSourceOnly)
+{
+    givenRule({camera1});
+
+    EXPECT_EQ(engine->processEvent(makeEvent(camera1)), 1);
+    EXPECT_EQ(engine->processEvent(makeEvent(camera2)), 0);
+    EXPECT_EQ(engine->processEvent(makeEvent({})), 0);
+}
+
+TEST_F(EngineSourceFilterTest, ruleAcceptingAnySourceIsMatchedWithSourceRules)
+{
+    givenRule({});
+    givenRule({camera1, camera2});
+    givenRule({camera2});
+
+    EXPECT_EQ(engine->processEvent(makeEvent(camera1)), 2);
+    EXPECT_EQ(engine->processEvent(makeEvent(camera2)), 3);
+    EXPECT_EQ(engine->processEvent(makeEvent(QnUuid::createUuid())), 1);
+}
+
+TEST_F(EngineSourceFilterTest, ruleIsMatchedBySelectedServer)
+{
+    givenRule({}, {server});
+    givenRule({camera1}, {server});
+
+    EXPECT_EQ(engine->processEvent(makeEvent(camera1, server)), 2);
+    EXPECT_EQ(engine->processEvent(makeEvent(camera2, server)), 1);
+    EXPECT_EQ(engine->processEvent(makeEvent(camera1)), 0);
+}
+
+TEST_F(EngineSourceFilterTest, ruleWithEmptySourceSelectionIsNotMatched)
+{
+    auto rule = std::make_unique<Rule>(QnUuid::createUuid(), engine.get());
+    auto filter = engine->buildEventFilter(utils::type<TestEvent>());
+    filter->fieldByName<SourceServerField>(utils::kServerIdFieldName)->setAcceptAll(true);
+    rule->addEventFilter(std::move(filter));
+    engine->updateRule(serialize(rule.get()));
+
+    EXPECT_EQ(engine->processEvent(makeEvent(camera1)), 0);
+    EXPECT_EQ(engine->processEvent(makeEvent({})), 0);
+}
+
+TEST_F(EngineSourceFilterTest, disabledRuleIsNotMatched)
+{
+    givenRule({camera1}, {}, /*enabled*/ false);
+    givenRule({}, {}, /*enabled*/ false);
+
+    EXPECT_EQ(engine->processEvent(makeEvent(camera1)), 0);
+}
+
+TEST_F(EngineSourceFilterTest, ruleIndexFollowsRuleChanges)
+{
+    auto ruleData = makeRuleData({camera1});
+    engine->updateRule(ruleData);
+    EXPECT_EQ(engine->processEvent(makeEvent(camera1)), 1);
+
+    // The updated rule is matched by the new source only.
+    auto updatedRuleData = makeRuleData({camera2});
+    updatedRuleData.id = ruleData.id;
+    engine->updateRule(updatedRuleData);
+    EXPECT_EQ(engine->processEvent(makeEvent(camera1)), 0);
+    EXPECT_EQ(engine->processEvent(makeEvent(camera2)), 1);
+
+    engine->removeRule(ruleData.id);
+    EXPECT_EQ(engine->processEvent(makeEvent(camera2)), 0);
+
+    engine->resetRules({makeRuleData({camera1}), makeRuleData({})});
+    EXPECT_EQ(engine->processEvent(makeEvent(camera1)), 2);
+    EXPECT_EQ(engine->processEvent(makeEvent(camera2)), 1);
+}
+
+TEST_F(EngineSourceFilterTest, batchKeepsEventOrderOfEachSource)
+{
+    static constexpr int kCameraCount = 8;
+    static constexpr int kCyclesPerCamera = 50;
+
+    std::vector<QnUuid> cameras;
+    for (int i = 0; i < kCameraCount; ++i)
+    {
+        cameras.push_back(QnUuid::createUuid());
+        givenRule({cameras.back()});
+    }
+
+    // Repeated states are dropped by the event cache, so the result depends on the event order.
+    std::vector<EventPtr> events;
+    for (int i = 0; i < kCyclesPerCamera; ++i)
+    {
+        for (const auto state: {State::started, State::started, State::stopped, State::stopped})
+        {
+            for (const auto& camera: cameras)
+                events.push_back(makeEvent(camera, {}, state));
+        }
+    }
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(4);
+    engine->setThreadPool(&threadPool);
+
+    ASSERT_EQ(engine->processAnalyticsEvents(events), (size_t) kCameraCount * kCyclesPerCamera * 2);
+
+    std::map<QString, std::vector<QJsonValue>> statesByCamera;
+    for (const auto& eventData: routedEvents)
+    {
+        statesByCamera[eventData.value(utils::kCameraIdFieldName).toString()].push_back(
+            eventData.value("state"));
+    }
+
+    ASSERT_EQ(statesByCamera.size(), (size_t) kCameraCount);
+    for (const auto& [camera, states]: statesByCamera)
+    {
+        ASSERT_EQ(states.size(), (size_t) kCyclesPerCamera * 2);
+        for (size_t i = 0; i < states.size(); ++i)
+            ASSERT_EQ(states[i], states[i % 2]) << i;
+        ASSERT_NE(states[0], states[1]);
+    }
+}
+
+TEST_F(EngineSourceFilterTest, parallelBatchRoutesSameEventsAsSequential)
+{
+    static constexpr int kCameraCount = 20;
+    static constexpr int kBatchSize = 200;
+
+    std::vector<QnUuid> cameras;
+    for (int i = 0; i < kCameraCount; ++i)
+    {
+        cameras.push_back(QnUuid::createUuid());
+        givenRule({cameras.back()});
+    }
+
+    // Disabled rules must be skipped by the pool threads too.
+    givenRule({cameras[0]}, {}, /*enabled*/ false);
+
+    std::vector<EventPtr> events;
+    for (int i = 0; i < kBatchSize; ++i)
+        events.push_back(makeEvent(cameras[i * 7 % kCameraCount]));
+
+    // The events are matched sequentially by default.
+    ASSERT_EQ(engine->processAnalyticsEvents(events), (size_t) kBatchSize);
+    const auto sequentiallyRoutedEvents = std::exchange(routedEvents, {});
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(4);
+    engine->setThreadPool(&threadPool);
+    ASSERT_EQ(engine->processAnalyticsEvents(events), (size_t) kBatchSize);
+    ASSERT_EQ(routedEvents, sequentiallyRoutedEvents);
+}
+
+TEST_F(EngineSourceFilterTest, DISABLED_processAnalyticsEventsPerformance)
+{
+    static constexpr int kCameraCount = 500;
+    static constexpr int kRulesPerCamera = 2;
+    static constexpr int kBatchSize = 1000;
+    static constexpr int kBatchCount = 20;
+
+    std::vector<QnUuid> cameras;
+    for (int i = 0; i < kCameraCount; ++i)
+    {
+        cameras.push_back(QnUuid::createUuid());
+        for (int j = 0; j < kRulesPerCamera; ++j)
+            givenRule({cameras.back()});
+    }
+
+    std::vector<EventPtr> events;
+    for (int i = 0; i < kBatchSize; ++i)
+        events.push_back(makeEvent(cameras[i * 7 % kCameraCount]));
+
+    const size_t expectedMatchedRules = (size_t) kBatchSize * kBatchCount * kRulesPerCamera;
+
+    ASSERT_EQ(processEventStorm(events, kBatchCount, nullptr), expectedMatchedRules);
+    const auto sequentiallyRoutedEvents = std::exchange(routedEvents, {});
+
+    QThreadPool threadPool;
+    ASSERT_EQ(processEventStorm(events, kBatchCount, &threadPool), expectedMatchedRules);
+    ASSERT_EQ(routedEvents, sequentiallyRoutedEvents);
+}
+
 } // namespace nx::vms::rules::test
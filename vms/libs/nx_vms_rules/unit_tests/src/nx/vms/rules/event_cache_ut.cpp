@@ -2,8 +2,11 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
 #include <thread>
 
+#include <nx/utils/time.h>
 #include <nx/vms/rules/event_cache.h>
 
 namespace nx::vms::rules::test {
@@ -44,4 +47,91 @@ TEST(EventCacheTest, cacheTimeout)
     EXPECT_FALSE(cache.eventWasCached("a"));
 }
 
+TEST(EventCacheTest, statistics)
+{
+    using namespace std::chrono;
+
+    nx::utils::test::ScopedSyntheticMonotonicTime time(steady_clock::time_point{});
+    EventCache cache;
+
+    cache.cacheEvent("a");
+    cache.cacheEvent("b");
+    EXPECT_TRUE(cache.eventWasCached("a"));
+    EXPECT_TRUE(cache.eventWasCached("a"));
+    EXPECT_FALSE(cache.eventWasCached("c"));
+
+    time.applyRelativeShift(2s);
+    cache.cleanupOldEventsFromCache(1s, 1s);
+    cache.cacheEvent("c");
+
+    auto statistics = cache.statistics();
+    EXPECT_EQ(statistics.cachedEvents, 1);
+    EXPECT_EQ(statistics.hits, 2);
+    EXPECT_EQ(statistics.expiredEvents, 2);
+}
+
+TEST(EventCacheTest, keysExpireByCleanupPeriods)
+{
+    using namespace std::chrono;
+
+    nx::utils::test::ScopedSyntheticMonotonicTime time(steady_clock::time_point{});
+    EventCache cache;
+
+    cache.cacheEvent("a");
+    time.applyRelativeShift(5s);
+    cache.cleanupOldEventsFromCache(10s, 5s);
+    cache.cacheEvent("b");
+
+    // "a" is cached 10s ago, "b" is cached 5s ago.
+    time.applyRelativeShift(5s);
+    cache.cleanupOldEventsFromCache(10s, 5s);
+    EXPECT_FALSE(cache.eventWasCached("a"));
+    EXPECT_TRUE(cache.eventWasCached("b"));
+
+    time.applyRelativeShift(5s);
+    cache.cleanupOldEventsFromCache(10s, 5s);
+    EXPECT_FALSE(cache.eventWasCached("b"));
+}
+
+TEST(EventCacheTest, DISABLED_sustainedLoadPerformance)
+{
+    using namespace std::chrono;
+
+    static constexpr int kEventsPerSecond = 10'000;
+    static constexpr int kEventsPerMillisecond = kEventsPerSecond / 1000;
+    static constexpr auto kLoadDuration = 120s;
+    static constexpr int kKeyCount = 100'000;
+
+    nx::utils::test::ScopedSyntheticMonotonicTime time(steady_clock::time_point{});
+    EventCache cache;
+
+    std::vector<QString> keys;
+    for (int i = 0; i < kKeyCount; ++i)
+        keys.push_back(QString("generic_event_%1").arg(i));
+
+    size_t eventIndex = 0;
+    const auto start = steady_clock::now();
+    for (milliseconds t{}; t < kLoadDuration; ++t)
+    {
+        time.applyRelativeShift(1ms);
+        cache.cleanupOldEventsFromCache(30s, 5s);
+        for (int i = 0; i < kEventsPerMillisecond; ++i)
+        {
+            const auto& key = keys[eventIndex++ * 7919 % kKeyCount];
+            if (!cache.eventWasCached(key))
+                cache.cacheEvent(key);
+        }
+    }
+    const auto elapsed = steady_clock::now() - start;
+
+    const auto statistics = cache.statistics();
+    EXPECT_GT(statistics.hits, 0);
+    EXPECT_GT(statistics.expiredEvents, 0);
+
+    const auto elapsedMs = duration<double, std::milli>(elapsed).count();
+    std::cout << eventIndex << " events processed in " << elapsedMs << " ms ("
+        << eventIndex / elapsedMs * 1000 << " events/s), hits: " << statistics.hits
+        << ", expired: " << statistics.expiredEvents << std::endl;
+}
+
 } // nx::vms::rules::test
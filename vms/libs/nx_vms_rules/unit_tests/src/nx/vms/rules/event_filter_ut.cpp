@@ -104,4 +104,35 @@ TEST_F(EventFilterTest, oneEventFieldMismatchToFilterFieldTest)
     ASSERT_FALSE(filter->match(genericEvent));
 }
 
+TEST_F(EventFilterTest, compiledFilterMatchesSameAsNotCompiled)
+{
+    auto genericEvent = makeEvent("Source string", "Caption string", "Description string");
+
+    sourceField->setString("Source string");
+    captionField->setString("Caption string");
+    descriptionField->setString("Description string");
+
+    filter->compile(&GenericEvent::staticMetaObject);
+    ASSERT_TRUE(filter->match(genericEvent));
+
+    captionField->setString("Bar");
+    ASSERT_FALSE(filter->match(genericEvent));
+}
+
+TEST_F(EventFilterTest, compiledFilterMatchesDynamicProperties)
+{
+    auto genericEvent = makeEvent("Source string", "Caption string", "Description string");
+    genericEvent->setProperty("extra", "Extra string");
+
+    auto extraField = std::make_unique<KeywordsField>();
+    extraField->setString("Extra");
+    filter->addField("extra", std::move(extraField));
+    filter->compile(&GenericEvent::staticMetaObject);
+
+    ASSERT_TRUE(filter->match(genericEvent));
+
+    genericEvent->setProperty("extra", "Other string");
+    ASSERT_FALSE(filter->match(genericEvent));
+}
+
 } // namespace nx::vms::rules::test